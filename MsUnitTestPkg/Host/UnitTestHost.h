@@ -0,0 +1,59 @@
+/** @file -- UnitTestHost.h
+Private definitions shared by the EDK2 side of the host build of the
+unit test framework (services shim, library instances and runner).
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+
+
+Copyright (C) 2016 Microsoft Corporation. All Rights Reserved.
+
+**/
+
+#ifndef _UNIT_TEST_HOST_H_
+#define _UNIT_TEST_HOST_H_
+
+#include "UnitTestHostOs.h"
+
+/**
+  Sets up gImageHandle, gST, gBS and gRT for the host and loads the
+  simulated non-volatile variable store.
+
+  Must be called after HostOsInitialize() and before anything touches
+  the service tables.
+
+  @retval     EFI_SUCCESS   Services are ready to use.
+  @retval     Others        Something went wrong and the runner should bail.
+
+**/
+EFI_STATUS
+EFIAPI
+UnitTestHostInitializeServices (
+  VOID
+  );
+
+/**
+  Converts a firmware path (L"\\dir\\file") to a host path ("/dir/file").
+
+  @param[in]  Path    The firmware path to convert.
+
+  @retval     !NULL   A pool-allocated UTF-8 string. Must be freed by the caller.
+  @retval     NULL    Out of resources.
+
+**/
+CHAR8*
+EFIAPI
+UnitTestHostConvertPath (
+  IN  CONST CHAR16    *Path
+  );
+
+#endif // _UNIT_TEST_HOST_H_
@@ -0,0 +1,30 @@
+/** @file -- UnitTestHostAutoGen.c
+Stands in for the AutoGen.c that the EDK2 build tools would generate.
+Defines every GUID that the host build of the framework and the test
+applications refer to.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF **/
+
+#include <Uefi.h>
+
+EFI_GUID  gEfiGlobalVariableGuid                      = { 0x8BE4DF61, 0x93CA, 0x11D2, { 0xAA, 0x0D, 0x00, 0xE0, 0x98, 0x03, 0x2B, 0x8C } };
+EFI_GUID  gEfiLoadedImageProtocolGuid                 = { 0x5B1B31A1, 0x9562, 0x11D2, { 0x8E, 0x3F, 0x00, 0xA0, 0xC9, 0x69, 0x72, 0x3B } };
+EFI_GUID  gEfiDevicePathProtocolGuid                  = { 0x09576E91, 0x6D3F, 0x11D2, { 0x8E, 0x39, 0x00, 0xA0, 0xC9, 0x69, 0x72, 0x3B } };
+EFI_GUID  gEfiSimpleFileSystemProtocolGuid            = { 0x964E5B22, 0x6459, 0x11D2, { 0x8E, 0x39, 0x00, 0xA0, 0xC9, 0x69, 0x72, 0x3B } };
+EFI_GUID  gEfiFileInfoGuid                            = { 0x09576E92, 0x6D3F, 0x11D2, { 0x8E, 0x39, 0x00, 0xA0, 0xC9, 0x69, 0x72, 0x3B } };
+EFI_GUID  gEfiFileSystemInfoGuid                      = { 0x09576E93, 0x6D3F, 0x11D2, { 0x8E, 0x39, 0x00, 0xA0, 0xC9, 0x69, 0x72, 0x3B } };
+EFI_GUID  gEfiMpServiceProtocolGuid                   = { 0x3FDDA605, 0xA76E, 0x4F46, { 0xAD, 0x29, 0x12, 0xF4, 0x53, 0x1B, 0x3D, 0x08 } };
+EFI_GUID  gEfiShellParametersProtocolGuid             = { 0x752F3136, 0x4E16, 0x4FDC, { 0xA2, 0x2A, 0xE5, 0xF4, 0x68, 0x12, 0xF4, 0xCA } };
+EFI_GUID  gEfiMemoryAttributesTableGuid               = { 0xDC3641B8, 0x2FA8, 0x4ED3, { 0xBC, 0x1F, 0xF9, 0x96, 0x2A, 0x03, 0x45, 0x4B } };
+EFI_GUID  gEfiMemoryOverwriteControlDataGuid          = { 0xE20939BE, 0x32D4, 0x41BE, { 0xA1, 0x50, 0x89, 0x7F, 0x85, 0xD4, 0x98, 0x29 } };
+EFI_GUID  gEfiMemoryOverwriteRequestControlLockGuid   = { 0xBB983CCF, 0x151D, 0x40E1, { 0xA0, 0x7B, 0x4A, 0x17, 0xBE, 0x16, 0x82, 0x92 } };
+EFI_GUID  gMsUnitTestPkgVariablePersistenceGuid       = { 0x7D3A1C52, 0x94E8, 0x4B6F, { 0xA1, 0x0C, 0x3E, 0x5B, 0x82, 0xD9, 0x4F, 0x16 } };
@@ -0,0 +1,88 @@
+/** @file -- UnitTestHostAutoGen.h
+Stands in for the AutoGen.h that the EDK2 build tools would generate for
+each module. It is force-included into every EDK2-side translation unit of
+the host build and supplies the fixed PCD values that the MdePkg libraries,
+UnitTestLib and the test applications consume.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF **/
+
+#ifndef _UNIT_TEST_HOST_AUTOGEN_H_
+#define _UNIT_TEST_HOST_AUTOGEN_H_
+
+#include <Uefi.h>
+#include <Library/PcdLib.h>
+
+//
+// MdePkg
+//
+#define _PCD_TOKEN_PcdMaximumUnicodeStringLength        0U
+#define _PCD_VALUE_PcdMaximumUnicodeStringLength        1000000U
+#define _PCD_GET_MODE_32_PcdMaximumUnicodeStringLength  _PCD_VALUE_PcdMaximumUnicodeStringLength
+
+#define _PCD_TOKEN_PcdMaximumAsciiStringLength          0U
+#define _PCD_VALUE_PcdMaximumAsciiStringLength          1000000U
+#define _PCD_GET_MODE_32_PcdMaximumAsciiStringLength    _PCD_VALUE_PcdMaximumAsciiStringLength
+
+#define _PCD_TOKEN_PcdMaximumLinkedListLength           0U
+#define _PCD_VALUE_PcdMaximumLinkedListLength           1000000U
+#define _PCD_GET_MODE_32_PcdMaximumLinkedListLength     _PCD_VALUE_PcdMaximumLinkedListLength
+
+#define _PCD_TOKEN_PcdVerifyNodeInList                  0U
+#define _PCD_VALUE_PcdVerifyNodeInList                  ((BOOLEAN)0U)
+#define _PCD_GET_MODE_BOOL_PcdVerifyNodeInList          _PCD_VALUE_PcdVerifyNodeInList
+
+#define _PCD_TOKEN_PcdDebugPropertyMask                 0U
+#define _PCD_VALUE_PcdDebugPropertyMask                 0x0FU
+#define _PCD_GET_MODE_8_PcdDebugPropertyMask            _PCD_VALUE_PcdDebugPropertyMask
+
+#define _PCD_TOKEN_PcdDebugPrintErrorLevel              0U
+#define _PCD_VALUE_PcdDebugPrintErrorLevel              0x80000002U
+#define _PCD_GET_MODE_32_PcdDebugPrintErrorLevel        _PCD_VALUE_PcdDebugPrintErrorLevel
+
+#define _PCD_TOKEN_PcdDebugClearMemoryValue             0U
+#define _PCD_VALUE_PcdDebugClearMemoryValue             0xAFU
+#define _PCD_GET_MODE_8_PcdDebugClearMemoryValue        _PCD_VALUE_PcdDebugClearMemoryValue
+
+//
+// MsUnitTestPkg
+//
+#define _PCD_TOKEN_PcdUnitTestDeferredLogFormatting     0U
+#define _PCD_VALUE_PcdUnitTestDeferredLogFormatting     ((BOOLEAN)1U)
+#define _PCD_GET_MODE_BOOL_PcdUnitTestDeferredLogFormatting _PCD_VALUE_PcdUnitTestDeferredLogFormatting
+
+#define _PCD_TOKEN_PcdUnitTestCompressSavedState        0U
+#define _PCD_VALUE_PcdUnitTestCompressSavedState        ((BOOLEAN)1U)
+#define _PCD_GET_MODE_BOOL_PcdUnitTestCompressSavedState _PCD_VALUE_PcdUnitTestCompressSavedState
+
+#define _PCD_TOKEN_PcdUnitTestLogLevel                  0U
+#define _PCD_VALUE_PcdUnitTestLogLevel                  0x80400042U
+#define _PCD_GET_MODE_32_PcdUnitTestLogLevel            _PCD_VALUE_PcdUnitTestLogLevel
+
+#define _PCD_TOKEN_PcdUnitTestFingerprintAlgorithm      0U
+#define _PCD_VALUE_PcdUnitTestFingerprintAlgorithm      1U
+#define _PCD_GET_MODE_8_PcdUnitTestFingerprintAlgorithm _PCD_VALUE_PcdUnitTestFingerprintAlgorithm
+
+#define _PCD_TOKEN_PcdUnitTestPerfRegressionThreshold   0U
+#define _PCD_VALUE_PcdUnitTestPerfRegressionThreshold   50U
+#define _PCD_GET_MODE_32_PcdUnitTestPerfRegressionThreshold _PCD_VALUE_PcdUnitTestPerfRegressionThreshold
+
+#define _PCD_TOKEN_PcdUnitTestPerfRegressionMinDuration 0U
+#define _PCD_VALUE_PcdUnitTestPerfRegressionMinDuration 1000000ULL
+#define _PCD_GET_MODE_64_PcdUnitTestPerfRegressionMinDuration _PCD_VALUE_PcdUnitTestPerfRegressionMinDuration
+
+#define _PCD_TOKEN_PcdUnitTestVariablePersistenceMaxChunkSize 0U
+#define _PCD_VALUE_PcdUnitTestVariablePersistenceMaxChunkSize 0U
+#define _PCD_GET_MODE_32_PcdUnitTestVariablePersistenceMaxChunkSize _PCD_VALUE_PcdUnitTestVariablePersistenceMaxChunkSize
+
+extern EFI_GUID gMsUnitTestPkgVariablePersistenceGuid;
+
+#endif // _UNIT_TEST_HOST_AUTOGEN_H_
@@ -0,0 +1,416 @@
+/** @file -- UnitTestHostCompressBenchmark.c
+Host-only benchmark for compressed saves. Checks that the codec round-trips
+and turns away damaged input, then builds saves shaped like MorLockTestApp's
+(the same tests and log lines, at normal and verbose log levels) and reports
+their size and the time to save and load them through the filesystem
+persistence lib, which compresses and expands them along the way. Writing
+alone is timed by saving one that's already compressed, and saves are also
+timed with the cache reopened each time, which is what every save used to cost.
+
+Build and run with "make -C MsUnitTestPkg/Host compress-benchmark SANITIZE=".
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+
+
+Copyright (C) 2016 Microsoft Corporation. All Rights Reserved.
+
+**/
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PrintLib.h>
+#include <Library/TimerLib.h>
+#include <Library/UefiLib.h>
+#include <Library/UnitTestLib.h>
+
+#include "UnitTestHost.h"
+#include "UnitTestPersistenceLib.h"
+#include "Compress.h"
+
+#define BENCHMARK_ITERATIONS          (200)
+#define BENCHMARK_ROUND_TRIP_SIZE     (64 * 1024)
+#define BENCHMARK_LOG_LINE_LENGTH     (160)
+
+//
+// The tests in MorLockTestApp, by the function that runs each of them.
+//
+STATIC CONST CHAR8 *mMorLockTests[] = {
+  "MorControlVariableShouldExist",              "MorControlVariableShouldHaveCorrectSize",
+  "MorControlVariableShouldHaveCorrectAttributes", "MorControlShouldEnforceCorrectAttributes",
+  "MorControlShouldChangeWhenNotLocked",        "MorLockv1ShouldNotSetBadValue",
+  "MorLockv1ShouldNotSetBadBufferSize",         "MorLockShouldNotSetBadAttributes",
+  "MorLockv1ShouldBeLockable",                  "MorLockv1ShouldReportCorrectly",
+  "MorControlShouldNotChange",                  "MorLockv1ShouldNotChangeWhenLocked",
+  "MorLockv1ShouldNotBeDeleteable",             "MorLockShouldClearAfterReboot",
+  "MorControlShouldChangeWhenNotLocked",        "MorLockv2ShouldNotSetSmallBuffer",
+  "MorLockv2ShouldNotSetLargeBuffer",           "MorLockv2ShouldNotSetNoBuffer",
+  "MorLockShouldNotSetBadAttributes",           "MorLockv2ShouldBeLockable",
+  "MorLockv2ShouldReportCorrectly",             "MorLockv2ShouldOnlyReturnOneByte",
+  "MorLockv2ShouldNotReturnKey",                "MorControlShouldNotChange",
+  "MorLockv2ShouldNotChangeWhenLocked",         "MorLockv2ShouldNotChangeTov1",
+  "MorLockv2ShouldNotBeDeleteable",             "MorLockShouldClearAfterReboot",
+  "MorLockv2ShouldClearWithCorrectKey",         "MorLockv2ShouldNotClearWithWrongKey",
+  "MorLockv2ShouldReleaseMorControlAfterClear", "MorLockv2ShouldSetClearSet"
+};
+
+typedef struct {
+  CONST CHAR8   *Label;
+  UINTN         LinesPerTest;           // Beyond the entry line that every test logs.
+} SAVE_SHAPE;
+
+STATIC CONST SAVE_SHAPE mSaveShapes[] = {
+  { "MorLock, default log level",   3 },
+  { "MorLock, verbose",             40 },
+  { "MorLock, verbose, 4 resumes",  160 }
+};
+
+
+STATIC
+VOID
+PrintDuration (
+  IN CONST CHAR8    *Label,
+  IN UINT64         NanoSeconds
+  )
+{
+  AsciiPrint( "  %-36a %8ld us\n", Label, DivU64x32( NanoSeconds, 1000 ) );
+  return;
+} // PrintDuration()
+
+
+/**
+  Compresses and expands a buffer, and makes sure that it comes back the same.
+  Every truncation of the compressed data has to either be turned away or still
+  come back the same (which it can, when all that's cut is an empty last sequence).
+
+**/
+STATIC
+BOOLEAN
+CheckRoundTrip (
+  IN CONST CHAR8    *Label,
+  IN CONST UINT8    *Buffer,
+  IN UINTN          Size
+  )
+{
+  UINT8     *Compressed, *Expanded;
+  UINTN     CompressedSize, Truncated;
+  BOOLEAN   Passed = TRUE;
+
+  // Incompressible data grows by a few bytes per 255.
+  Compressed  = AllocatePool( Size + Size / 255 + 16 );
+  Expanded    = AllocatePool( Size + 1 );
+  if (Compressed == NULL || Expanded == NULL)
+  {
+    return FALSE;
+  }
+
+  CompressedSize = LzCompress( Buffer, Size, Compressed, Size + Size / 255 + 16 );
+  if (CompressedSize == 0 ||
+      EFI_ERROR( LzDecompress( Compressed, CompressedSize, Expanded, Size ) ) ||
+      CompareMem( Buffer, Expanded, Size ) != 0)
+  {
+    Passed = FALSE;
+  }
+  // The size has to match exactly, too.
+  if (!EFI_ERROR( LzDecompress( Compressed, CompressedSize, Expanded, Size + 1 ) ))
+  {
+    Passed = FALSE;
+  }
+  for (Truncated = 0; Passed && Truncated < CompressedSize; Truncated++)
+  {
+    if (!EFI_ERROR( LzDecompress( Compressed, Truncated, Expanded, Size ) ) &&
+        CompareMem( Buffer, Expanded, Size ) != 0)
+    {
+      Passed = FALSE;
+    }
+  }
+
+  AsciiPrint( "Round trip, %-30a %6d -> %6d bytes: %a\n", Label, Size, CompressedSize, Passed ? "PASSED" : "FAILED" );
+  FreePool( Compressed );
+  FreePool( Expanded );
+  return Passed;
+} // CheckRoundTrip()
+
+
+STATIC
+BOOLEAN
+CheckCodec (
+  VOID
+  )
+{
+  UINT8     *Buffer;
+  UINTN     Index;
+  UINT32    Seed = 1;
+  BOOLEAN   Passed = TRUE;
+
+  Buffer = AllocatePool( BENCHMARK_ROUND_TRIP_SIZE );
+  if (Buffer == NULL)
+  {
+    return FALSE;
+  }
+
+  Passed &= CheckRoundTrip( "empty", Buffer, 0 );
+
+  SetMem( Buffer, BENCHMARK_ROUND_TRIP_SIZE, 'A' );
+  Passed &= CheckRoundTrip( "3 bytes", Buffer, 3 );
+  Passed &= CheckRoundTrip( "one long run", Buffer, BENCHMARK_ROUND_TRIP_SIZE );
+
+  for (Index = 0; Index < BENCHMARK_ROUND_TRIP_SIZE; Index++)
+  {
+    Seed = Seed * 1103515245 + 12345;
+    Buffer[Index] = (UINT8)(Seed >> 16);
+  }
+  Passed &= CheckRoundTrip( "noise", Buffer, BENCHMARK_ROUND_TRIP_SIZE );
+
+  // Matches further back than the window can reach.
+  CopyMem( Buffer + BENCHMARK_ROUND_TRIP_SIZE / 2 + 100, Buffer, 1000 );
+  Passed &= CheckRoundTrip( "noise with distant repeats", Buffer, BENCHMARK_ROUND_TRIP_SIZE );
+
+  for (Index = 0; Index < BENCHMARK_ROUND_TRIP_SIZE; Index++)
+  {
+    Buffer[Index] = (UINT8)"0123456789abcdef"[(Index * Index / 7) & 0xF];
+  }
+  Passed &= CheckRoundTrip( "short repeats", Buffer, BENCHMARK_ROUND_TRIP_SIZE );
+
+  FreePool( Buffer );
+  return Passed;
+} // CheckCodec()
+
+
+/**
+  Lays out a save the way SerializeState() would, with logs in the
+  same format and from the same functions as a MorLockTestApp run.
+
+**/
+STATIC
+UNIT_TEST_SAVE_HEADER*
+BuildMorLockSave (
+  IN  UINTN     LinesPerTest
+  )
+{
+  UNIT_TEST_SAVE_HEADER   *Header;
+  UNIT_TEST_SAVE_TEST     *Test;
+  UINTN                   TestIndex, Line, Size, LogLength;
+  CHAR16                  *Log;
+  UINT8                   *FloatingPointer;
+
+  Size    = sizeof( UNIT_TEST_SAVE_HEADER ) +
+            ARRAY_SIZE( mMorLockTests ) * (sizeof( UNIT_TEST_SAVE_TEST ) + (LinesPerTest + 2) * BENCHMARK_LOG_LINE_LENGTH * sizeof( CHAR16 ));
+  Header  = AllocateZeroPool( Size );
+  if (Header == NULL)
+  {
+    return NULL;
+  }
+  Header->Version       = UNIT_TEST_PERSISTENCE_LIB_VERSION;
+  Header->FingerprintAlgorithm = FixedPcdGet8( PcdUnitTestFingerprintAlgorithm );
+  Header->Compression   = UNIT_TEST_SAVE_COMPRESSION_NONE;
+  Header->TestCount     = ARRAY_SIZE( mMorLockTests );
+
+  FloatingPointer = (UINT8*)Header + sizeof( UNIT_TEST_SAVE_HEADER );
+  for (TestIndex = 0; TestIndex < ARRAY_SIZE( mMorLockTests ); TestIndex++)
+  {
+    Test = (UNIT_TEST_SAVE_TEST*)FloatingPointer;
+    // Fingerprints are hashes, so they don't compress at all.
+    for (Line = 0; Line < UNIT_TEST_FINGERPRINT_SIZE; Line++)
+    {
+      Test->Fingerprint[Line] = (UINT8)((TestIndex + 1) * 0x9E3779B1 >> (Line % 4 * 8)) ^ (UINT8)(Line * 73);
+    }
+    Test->Result      = (TestIndex % 5 == 0) ? UNIT_TEST_ERROR_TEST_FAILED : UNIT_TEST_PASSED;
+    Test->RunDuration = 1000 + TestIndex * 7919;
+
+    Log       = (CHAR16*)(FloatingPointer + sizeof( UNIT_TEST_SAVE_TEST ));
+    LogLength = UnicodeSPrintAsciiFormat( Log, BENCHMARK_LOG_LINE_LENGTH * sizeof( CHAR16 ),
+                                          "[VERBOSE]     %a()\n", mMorLockTests[TestIndex] );
+    for (Line = 0; Line < LinesPerTest; Line++)
+    {
+      LogLength += UnicodeSPrintAsciiFormat( &Log[LogLength], BENCHMARK_LOG_LINE_LENGTH * sizeof( CHAR16 ),
+                                             "[VERBOSE]     %a - Attempt %d, Size = 0x%x, Status = %r, MorLock = %d\n",
+                                             mMorLockTests[TestIndex], Line, (Line * 2654435761U) >> 20,
+                                             (Line % 3 == 0) ? EFI_SUCCESS : EFI_ACCESS_DENIED, Line % 3 );
+    }
+    if (Test->Result != UNIT_TEST_PASSED)
+    {
+      LogLength += UnicodeSPrintAsciiFormat( &Log[LogLength], BENCHMARK_LOG_LINE_LENGTH * sizeof( CHAR16 ),
+                                             "[ASSERT FAIL] %a::%d Status 'Status' is EFI_ERROR (%r)!\n",
+                                             mMorLockTests[TestIndex], 300 + TestIndex * 41, EFI_WRITE_PROTECTED );
+    }
+    Test->Size = (UINT32)(sizeof( UNIT_TEST_SAVE_TEST ) + (LogLength + 1) * sizeof( CHAR16 ));
+    FloatingPointer += Test->Size;
+  }
+
+  Header->BlobSize      = (UINT32)(FloatingPointer - (UINT8*)Header);
+  Header->ExpandedSize  = Header->BlobSize;
+  return Header;
+} // BuildMorLockSave()
+
+
+STATIC
+UINT64
+TimeSaves (
+  IN UNIT_TEST_FRAMEWORK_HANDLE   Framework,
+  IN UNIT_TEST_SAVE_HEADER        *SaveData,
+  IN BOOLEAN                      Reopen
+  )
+{
+  UINTN     Index;
+  UINT64    Start;
+
+  Start = GetPerformanceCounter();
+  for (Index = 0; Index < BENCHMARK_ITERATIONS; Index++)
+  {
+    SaveUnitTestCache( Framework, SaveData );
+    // Closing the session makes the next save find and open the cache all over again.
+    if (Reopen)
+    {
+      CloseUnitTestPersistence( Framework );
+    }
+  }
+  return DivU64x32( GetTimeInNanoSecond( GetPerformanceCounter() - Start ), BENCHMARK_ITERATIONS );
+} // TimeSaves()
+
+
+STATIC
+UINT64
+TimeLoads (
+  IN UNIT_TEST_FRAMEWORK_HANDLE   Framework,
+  IN UNIT_TEST_SAVE_HEADER        *Expected,
+  OUT BOOLEAN                     *Matched
+  )
+{
+  UNIT_TEST_SAVE_HEADER   *Loaded;
+  UINTN                   Index;
+  UINT64                  Start;
+
+  *Matched = TRUE;
+  Start = GetPerformanceCounter();
+  for (Index = 0; Index < BENCHMARK_ITERATIONS; Index++)
+  {
+    if (EFI_ERROR( LoadUnitTestCache( Framework, &Loaded ) ))
+    {
+      *Matched = FALSE;
+      break;
+    }
+    // The persistence lib hands back expanded saves, whatever it stored.
+    if (Loaded->Compression != UNIT_TEST_SAVE_COMPRESSION_NONE ||
+        Loaded->BlobSize != Expected->BlobSize ||
+        CompareMem( (UINT8*)Loaded + sizeof( UNIT_TEST_SAVE_HEADER ), (UINT8*)Expected + sizeof( UNIT_TEST_SAVE_HEADER ),
+                    Expected->BlobSize - sizeof( UNIT_TEST_SAVE_HEADER ) ) != 0)
+    {
+      *Matched = FALSE;
+    }
+    FreePool( Loaded );
+  }
+  return DivU64x32( GetTimeInNanoSecond( GetPerformanceCounter() - Start ), BENCHMARK_ITERATIONS );
+} // TimeLoads()
+
+
+STATIC
+BOOLEAN
+BenchmarkSave (
+  IN UNIT_TEST_FRAMEWORK_HANDLE   Framework,
+  IN CONST SAVE_SHAPE             *Shape
+  )
+{
+  UNIT_TEST_SAVE_HEADER   *Raw, *Compressed, *Expanded;
+  UINTN                   Index;
+  UINT64                  Start, CompressTime, ExpandTime;
+  BOOLEAN                 Matched, Passed = TRUE;
+
+  Raw = BuildMorLockSave( Shape->LinesPerTest );
+  if (Raw == NULL)
+  {
+    return FALSE;
+  }
+
+  Start = GetPerformanceCounter();
+  for (Index = 0; Index < BENCHMARK_ITERATIONS; Index++)
+  {
+    Compressed = CompressUnitTestSave( Raw );
+    if (Compressed == NULL)
+    {
+      FreePool( Raw );
+      return FALSE;
+    }
+    if (Index + 1 < BENCHMARK_ITERATIONS)
+    {
+      FreePool( Compressed );
+    }
+  }
+  CompressTime = DivU64x32( GetTimeInNanoSecond( GetPerformanceCounter() - Start ), BENCHMARK_ITERATIONS );
+
+  Start = GetPerformanceCounter();
+  for (Index = 0; Index < BENCHMARK_ITERATIONS; Index++)
+  {
+    if (EFI_ERROR( ExpandUnitTestSave( Compressed, &Expanded ) ))
+    {
+      Passed = FALSE;
+      break;
+    }
+    FreePool( Expanded );
+  }
+  ExpandTime = DivU64x32( GetTimeInNanoSecond( GetPerformanceCounter() - Start ), BENCHMARK_ITERATIONS );
+
+  AsciiPrint( "%a: %d tests, %d bytes -> %d bytes (%d%%)\n", Shape->Label, Raw->TestCount,
+              Raw->BlobSize, Compressed->BlobSize, Compressed->BlobSize * 100 / Raw->BlobSize );
+  PrintDuration( "Compress", CompressTime );
+  PrintDuration( "Expand", ExpandTime );
+  //
+  // A save that's already compressed is written as it is, which times the writing alone.
+  PrintDuration( "Write only", TimeSaves( Framework, Compressed, FALSE ) );
+  PrintDuration( "Save, reopening the cache", TimeSaves( Framework, Raw, TRUE ) );
+  PrintDuration( "Save", TimeSaves( Framework, Raw, FALSE ) );
+  PrintDuration( "Load", TimeLoads( Framework, Raw, &Matched ) );
+  Passed &= Matched;
+
+  FreePool( Compressed );
+  FreePool( Raw );
+  return Passed;
+} // BenchmarkSave()
+
+
+int
+main (
+  int   Argc,
+  char  **Argv
+  )
+{
+  UNIT_TEST_FRAMEWORK   *Framework = NULL;
+  UINTN                 Index;
+  BOOLEAN               Passed;
+
+  HostOsInitialize( Argc, Argv );
+  if (EFI_ERROR( UnitTestHostInitializeServices() ))
+  {
+    return 1;
+  }
+
+  Passed = CheckCodec();
+
+  //
+  // The framework is only here to give the persistence lib a name for the cache file.
+  if (EFI_ERROR( InitUnitTestFramework( &Framework, L"Compress Benchmark", L"CompressBenchmark", L"1.0" ) ))
+  {
+    return 1;
+  }
+  for (Index = 0; Index < ARRAY_SIZE( mSaveShapes ); Index++)
+  {
+    Passed &= BenchmarkSave( Framework, &mSaveShapes[Index] );
+  }
+  FreeUnitTestFramework( Framework );
+
+  AsciiPrint( "Compressed saves: %a\n", Passed ? "PASSED" : "FAILED" );
+  HostOsExit( Passed ? 0 : 1 );
+  return 0;
+} // main()
@@ -0,0 +1,238 @@
+/** @file -- UnitTestHostHashBenchmark.c
+Host-only throughput benchmark for the fingerprint hashes. Checks MD5
+against the RFC 1321 test suite, then reports MB/s for MD5 and for the
+configured fingerprint algorithm over large buffers and over inputs the
+size of a typical test fingerprint.
+
+Build and run with "make -C MsUnitTestPkg/Host hash-benchmark SANITIZE=".
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+
+
+Copyright (C) 2016 Microsoft Corporation. All Rights Reserved.
+
+**/
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PcdLib.h>
+#include <Library/TimerLib.h>
+#include <Library/UefiLib.h>
+#include <Library/UnitTestLib.h>
+
+#include "UnitTestHost.h"
+#include "Fingerprint.h"
+
+#define BENCHMARK_LARGE_BUFFER_SIZE     (1024 * 1024)
+#define BENCHMARK_LARGE_ITERATIONS      (64)
+#define BENCHMARK_SMALL_INPUT_SIZE      (140)   // A suite fingerprint plus a 60-character description.
+#define BENCHMARK_SMALL_ITERATIONS      (200000)
+
+typedef struct {
+  CONST CHAR8   *Message;
+  CONST CHAR8   *Digest;
+} MD5_TEST_VECTOR;
+
+//
+// RFC 1321, appendix A.5.
+//
+STATIC CONST MD5_TEST_VECTOR mMd5TestVectors[] = {
+  { "",                                                                                 "d41d8cd98f00b204e9800998ecf8427e" },
+  { "a",                                                                                "0cc175b9c0f1b6a831c399e269772661" },
+  { "abc",                                                                              "900150983cd24fb0d6963f7d28e17f72" },
+  { "message digest",                                                                   "f96b697d7cb7938d525a2f31aaf161d0" },
+  { "abcdefghijklmnopqrstuvwxyz",                                                       "c3fcd3d76192e4007dfb496cca67e13b" },
+  { "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789",                   "d174ab98d277d9f5a5611c2c9f419d9f" },
+  { "12345678901234567890123456789012345678901234567890123456789012345678901234567890", "57edf4a22be3c955ac49da2e2107b67a" }
+};
+
+
+STATIC
+BOOLEAN
+CheckMd5TestVectors (
+  VOID
+  )
+{
+  MD5_CTX     Ctx;
+  UINT8       Digest[MD5_HASHSIZE];
+  CHAR8       DigestString[MD5_HASHSIZE * 2 + 1];
+  UINTN       Index, Byte, Pass, Length;
+  BOOLEAN     Passed = TRUE;
+
+  //
+  // Every vector is hashed twice: in one update, and then a byte at a time
+  // so that the partial block handling gets exercised too.
+  for (Pass = 0; Pass < 2 * ARRAY_SIZE( mMd5TestVectors ); Pass++)
+  {
+    Index  = Pass % ARRAY_SIZE( mMd5TestVectors );
+    Length = AsciiStrLen( mMd5TestVectors[Index].Message );
+    MD5Init( &Ctx );
+    if (Pass < ARRAY_SIZE( mMd5TestVectors ))
+    {
+      MD5Update( &Ctx, (VOID*)mMd5TestVectors[Index].Message, Length );
+    }
+    else
+    {
+      for (Byte = 0; Byte < Length; Byte++)
+      {
+        MD5Update( &Ctx, (VOID*)&mMd5TestVectors[Index].Message[Byte], 1 );
+      }
+    }
+    MD5Final( &Ctx, &Digest[0] );
+
+    for (Byte = 0; Byte < MD5_HASHSIZE; Byte++)
+    {
+      AsciiSPrint( &DigestString[Byte * 2], 3, "%02x", Digest[Byte] );
+    }
+    if (AsciiStrCmp( DigestString, mMd5TestVectors[Index].Digest ) != 0)
+    {
+      AsciiPrint( "MD5(\"%a\") = %a, expected %a\n", mMd5TestVectors[Index].Message, DigestString, mMd5TestVectors[Index].Digest );
+      Passed = FALSE;
+    }
+  }
+
+  return Passed;
+} // CheckMd5TestVectors()
+
+
+/**
+  Reports throughput in MB/s, to one decimal place.
+
+**/
+STATIC
+VOID
+PrintThroughput (
+  IN CONST CHAR8    *Label,
+  IN UINT64         Bytes,
+  IN UINT64         NanoSeconds
+  )
+{
+  UINT64    TenthsOfMBps;
+  UINT32    Tenths;
+
+  // Bytes per nanosecond is GB/s, so scale up by 10^4 for tenths of a MB/s.
+  TenthsOfMBps = DivU64x64Remainder( MultU64x32( Bytes, 10000 ), MAX( NanoSeconds, 1 ), NULL );
+  TenthsOfMBps = DivU64x32Remainder( TenthsOfMBps, 10, &Tenths );
+  AsciiPrint( "%-40a %6ld.%d MB/s\n", Label, TenthsOfMBps, Tenths );
+  return;
+} // PrintThroughput()
+
+
+STATIC
+VOID
+BenchmarkMd5 (
+  IN CONST UINT8    *Buffer
+  )
+{
+  MD5_CTX     Ctx;
+  UINT8       Digest[MD5_HASHSIZE];
+  UINTN       Index;
+  UINT64      Start;
+
+  Start = GetPerformanceCounter();
+  MD5Init( &Ctx );
+  for (Index = 0; Index < BENCHMARK_LARGE_ITERATIONS; Index++)
+  {
+    MD5Update( &Ctx, (VOID*)Buffer, BENCHMARK_LARGE_BUFFER_SIZE );
+  }
+  MD5Final( &Ctx, &Digest[0] );
+  PrintThroughput( "MD5, 1 MB updates", MultU64x32( BENCHMARK_LARGE_BUFFER_SIZE, BENCHMARK_LARGE_ITERATIONS ),
+                   GetTimeInNanoSecond( GetPerformanceCounter() - Start ) );
+
+  Start = GetPerformanceCounter();
+  for (Index = 0; Index < BENCHMARK_SMALL_ITERATIONS; Index++)
+  {
+    MD5Init( &Ctx );
+    MD5Update( &Ctx, (VOID*)(Buffer + (Index & 0xFF)), BENCHMARK_SMALL_INPUT_SIZE );
+    MD5Final( &Ctx, &Digest[0] );
+  }
+  PrintThroughput( "MD5, 140 byte messages", MultU64x32( BENCHMARK_SMALL_INPUT_SIZE, BENCHMARK_SMALL_ITERATIONS ),
+                   GetTimeInNanoSecond( GetPerformanceCounter() - Start ) );
+  return;
+} // BenchmarkMd5()
+
+
+STATIC
+VOID
+BenchmarkFingerprint (
+  IN CONST UINT8    *Buffer
+  )
+{
+  UNIT_TEST_FINGERPRINT_CTX   Ctx;
+  UINT8                       Fingerprint[UNIT_TEST_FINGERPRINT_SIZE];
+  UINTN                       Index;
+  UINT64                      Start;
+
+  Start = GetPerformanceCounter();
+  FingerprintInit( &Ctx );
+  for (Index = 0; Index < BENCHMARK_LARGE_ITERATIONS; Index++)
+  {
+    FingerprintUpdate( &Ctx, Buffer, BENCHMARK_LARGE_BUFFER_SIZE );
+  }
+  FingerprintFinal( &Ctx, &Fingerprint[0] );
+  PrintThroughput( "Fingerprint, 1 MB updates", MultU64x32( BENCHMARK_LARGE_BUFFER_SIZE, BENCHMARK_LARGE_ITERATIONS ),
+                   GetTimeInNanoSecond( GetPerformanceCounter() - Start ) );
+
+  Start = GetPerformanceCounter();
+  for (Index = 0; Index < BENCHMARK_SMALL_ITERATIONS; Index++)
+  {
+    FingerprintInit( &Ctx );
+    FingerprintUpdate( &Ctx, Buffer + (Index & 0xFF), BENCHMARK_SMALL_INPUT_SIZE );
+    FingerprintFinal( &Ctx, &Fingerprint[0] );
+  }
+  PrintThroughput( "Fingerprint, 140 byte messages", MultU64x32( BENCHMARK_SMALL_INPUT_SIZE, BENCHMARK_SMALL_ITERATIONS ),
+                   GetTimeInNanoSecond( GetPerformanceCounter() - Start ) );
+  return;
+} // BenchmarkFingerprint()
+
+
+int
+main (
+  int   Argc,
+  char  **Argv
+  )
+{
+  UINT8     *Buffer;
+  UINTN     Index;
+  BOOLEAN   Passed;
+
+  HostOsInitialize( Argc, Argv );
+  if (EFI_ERROR( UnitTestHostInitializeServices() ))
+  {
+    return 1;
+  }
+
+  Passed = CheckMd5TestVectors();
+  AsciiPrint( "MD5 RFC 1321 test suite: %a\n", Passed ? "PASSED" : "FAILED" );
+
+  Buffer = AllocatePool( BENCHMARK_LARGE_BUFFER_SIZE );
+  if (Buffer == NULL)
+  {
+    return 1;
+  }
+  for (Index = 0; Index < BENCHMARK_LARGE_BUFFER_SIZE; Index++)
+  {
+    Buffer[Index] = (UINT8)(Index * 7);
+  }
+
+  AsciiPrint( "Fingerprint algorithm: %d\n", FixedPcdGet8( PcdUnitTestFingerprintAlgorithm ) );
+  BenchmarkMd5( Buffer );
+  BenchmarkFingerprint( Buffer );
+
+  FreePool( Buffer );
+  HostOsExit( Passed ? 0 : 1 );
+  return 0;
+} // main()
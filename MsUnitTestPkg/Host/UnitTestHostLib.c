@@ -0,0 +1,660 @@
+/** @file -- UnitTestHostLib.c
+Host instances of the handful of library classes that UnitTestLib, its
+persistence libs and the test applications depend on beyond what is built
+straight out of MdePkg (BaseLib, BaseMemoryLib, BasePrintLib and
+UefiMemoryAllocationLib). Only the functions that are actually consumed
+are provided.
+
+  - DebugLib:       Prints to stderr. ASSERTs abort so that a debugger or
+                    sanitizer gets a useful stack.
+  - TimerLib:       A nanosecond monotonic counter.
+  - UefiLib:        Print()/AsciiPrint() and EfiGetSystemConfigurationTable().
+  - DevicePathLib:  File path nodes only.
+  - ShellLib:       File access over the host filesystem.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+
+
+Copyright (C) 2016 Microsoft Corporation. All Rights Reserved.
+
+**/
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/DevicePathLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PrintLib.h>
+#include <Library/ShellLib.h>
+#include <Library/TimerLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/UefiLib.h>
+
+#include "UnitTestHost.h"
+
+#define HOST_DEBUG_LEVEL_VARIABLE     "UNIT_TEST_HOST_DEBUG_LEVEL"
+#define HOST_PRINT_BUFFER_LENGTH      512
+
+STATIC BOOLEAN  mDebugLevelInitialized = FALSE;
+STATIC UINTN    mDebugLevel;
+
+
+///================================================================================================
+///================================================================================================
+///
+/// DEBUG LIB
+///
+///================================================================================================
+///================================================================================================
+
+
+BOOLEAN
+EFIAPI
+DebugPrintLevelEnabled (
+  IN  CONST UINTN   ErrorLevel
+  )
+{
+  CONST CHAR8   *Value;
+
+  //
+  // The PCD sets the default. The environment can open it up without a rebuild.
+  if (!mDebugLevelInitialized)
+  {
+    Value = HostOsGetEnvironment( HOST_DEBUG_LEVEL_VARIABLE );
+    mDebugLevel = (Value != NULL) ? AsciiStrHexToUintn( Value ) : PcdGet32( PcdDebugPrintErrorLevel );
+    mDebugLevelInitialized = TRUE;
+  }
+
+  return (ErrorLevel & mDebugLevel) != 0;
+} // DebugPrintLevelEnabled()
+
+
+VOID
+EFIAPI
+DebugPrint (
+  IN  UINTN         ErrorLevel,
+  IN  CONST CHAR8   *Format,
+  ...
+  )
+{
+  CHAR8     Buffer[HOST_PRINT_BUFFER_LENGTH];
+  VA_LIST   Marker;
+
+  if (!DebugPrintLevelEnabled( ErrorLevel ))
+  {
+    return;
+  }
+
+  VA_START( Marker, Format );
+  AsciiVSPrint( Buffer, sizeof( Buffer ), Format, Marker );
+  VA_END( Marker );
+
+  HostOsWriteDebug( Buffer );
+} // DebugPrint()
+
+
+VOID
+EFIAPI
+DebugAssert (
+  IN  CONST CHAR8   *FileName,
+  IN  UINTN         LineNumber,
+  IN  CONST CHAR8   *Description
+  )
+{
+  CHAR8     Buffer[HOST_PRINT_BUFFER_LENGTH];
+
+  AsciiSPrint( Buffer, sizeof( Buffer ), "ASSERT [%a(%d)]: %a\n", FileName, LineNumber, Description );
+  HostOsWriteDebug( Buffer );
+  HostOsAbort();
+} // DebugAssert()
+
+
+VOID*
+EFIAPI
+DebugClearMemory (
+  OUT VOID    *Buffer,
+  IN  UINTN   Length
+  )
+{
+  return SetMem( Buffer, Length, PcdGet8( PcdDebugClearMemoryValue ) );
+} // DebugClearMemory()
+
+
+BOOLEAN
+EFIAPI
+DebugAssertEnabled (
+  VOID
+  )
+{
+  return (PcdGet8( PcdDebugPropertyMask ) & DEBUG_PROPERTY_DEBUG_ASSERT_ENABLED) != 0;
+} // DebugAssertEnabled()
+
+
+BOOLEAN
+EFIAPI
+DebugPrintEnabled (
+  VOID
+  )
+{
+  return (PcdGet8( PcdDebugPropertyMask ) & DEBUG_PROPERTY_DEBUG_PRINT_ENABLED) != 0;
+} // DebugPrintEnabled()
+
+
+BOOLEAN
+EFIAPI
+DebugCodeEnabled (
+  VOID
+  )
+{
+  return (PcdGet8( PcdDebugPropertyMask ) & DEBUG_PROPERTY_DEBUG_CODE_ENABLED) != 0;
+} // DebugCodeEnabled()
+
+
+BOOLEAN
+EFIAPI
+DebugClearMemoryEnabled (
+  VOID
+  )
+{
+  return (PcdGet8( PcdDebugPropertyMask ) & DEBUG_PROPERTY_CLEAR_MEMORY_ENABLED) != 0;
+} // DebugClearMemoryEnabled()
+
+
+///================================================================================================
+///================================================================================================
+///
+/// TIMER LIB
+///
+///================================================================================================
+///================================================================================================
+
+
+UINTN
+EFIAPI
+MicroSecondDelay (
+  IN  UINTN   MicroSeconds
+  )
+{
+  HostOsSleepNanoSeconds( MultU64x32( MicroSeconds, 1000 ) );
+  return MicroSeconds;
+} // MicroSecondDelay()
+
+
+UINTN
+EFIAPI
+NanoSecondDelay (
+  IN  UINTN   NanoSeconds
+  )
+{
+  HostOsSleepNanoSeconds( NanoSeconds );
+  return NanoSeconds;
+} // NanoSecondDelay()
+
+
+UINT64
+EFIAPI
+GetPerformanceCounter (
+  VOID
+  )
+{
+  return HostOsGetMonotonicNanoSeconds();
+} // GetPerformanceCounter()
+
+
+UINT64
+EFIAPI
+GetPerformanceCounterProperties (
+  OUT UINT64    *StartValue OPTIONAL,
+  OUT UINT64    *EndValue OPTIONAL
+  )
+{
+  if (StartValue != NULL)
+  {
+    *StartValue = 0;
+  }
+  if (EndValue != NULL)
+  {
+    *EndValue = MAX_UINT64;
+  }
+  // One tick per nanosecond.
+  return 1000000000ULL;
+} // GetPerformanceCounterProperties()
+
+
+UINT64
+EFIAPI
+GetTimeInNanoSecond (
+  IN  UINT64    Ticks
+  )
+{
+  return Ticks;
+} // GetTimeInNanoSecond()
+
+
+///================================================================================================
+///================================================================================================
+///
+/// UEFI LIB
+///
+///================================================================================================
+///================================================================================================
+
+
+UINTN
+EFIAPI
+Print (
+  IN  CONST CHAR16  *Format,
+  ...
+  )
+{
+  CHAR16    Buffer[HOST_PRINT_BUFFER_LENGTH];
+  VA_LIST   Marker;
+  UINTN     Length;
+
+  VA_START( Marker, Format );
+  Length = UnicodeVSPrint( Buffer, sizeof( Buffer ), Format, Marker );
+  VA_END( Marker );
+
+  gST->ConOut->OutputString( gST->ConOut, Buffer );
+  return Length;
+} // Print()
+
+
+UINTN
+EFIAPI
+AsciiPrint (
+  IN  CONST CHAR8   *Format,
+  ...
+  )
+{
+  CHAR16    Buffer[HOST_PRINT_BUFFER_LENGTH];
+  VA_LIST   Marker;
+  UINTN     Length;
+
+  VA_START( Marker, Format );
+  Length = UnicodeVSPrintAsciiFormat( Buffer, sizeof( Buffer ), Format, Marker );
+  VA_END( Marker );
+
+  gST->ConOut->OutputString( gST->ConOut, Buffer );
+  return Length;
+} // AsciiPrint()
+
+
+EFI_STATUS
+EFIAPI
+EfiGetSystemConfigurationTable (
+  IN  EFI_GUID  *TableGuid,
+  OUT VOID      **Table
+  )
+{
+  UINTN     Index;
+
+  *Table = NULL;
+  for (Index = 0; Index < gST->NumberOfTableEntries; Index++)
+  {
+    if (CompareGuid( TableGuid, &gST->ConfigurationTable[Index].VendorGuid ))
+    {
+      *Table = gST->ConfigurationTable[Index].VendorTable;
+      return EFI_SUCCESS;
+    }
+  }
+
+  return EFI_NOT_FOUND;
+} // EfiGetSystemConfigurationTable()
+
+
+///================================================================================================
+///================================================================================================
+///
+/// DEVICE PATH LIB
+///
+///================================================================================================
+///================================================================================================
+
+
+STATIC
+UINTN
+HostDevicePathNodeLength (
+  IN  CONST EFI_DEVICE_PATH_PROTOCOL  *Node
+  )
+{
+  return ReadUnaligned16( (UINT16*)&Node->Length[0] );
+} // HostDevicePathNodeLength()
+
+
+CHAR16*
+EFIAPI
+ConvertDevicePathToText (
+  IN  CONST EFI_DEVICE_PATH_PROTOCOL  *DevicePath,
+  IN  BOOLEAN                         DisplayOnly,
+  IN  BOOLEAN                         AllowShortcuts
+  )
+{
+  CONST EFI_DEVICE_PATH_PROTOCOL  *Node;
+  CHAR16                          *Text;
+  UINTN                           TextLength = 0, NodeLength;
+
+  if (DevicePath == NULL)
+  {
+    return NULL;
+  }
+
+  //
+  // Only file path nodes mean anything on the host. Size the text first...
+  for (Node = DevicePath; Node->Type != END_DEVICE_PATH_TYPE; Node = (CONST EFI_DEVICE_PATH_PROTOCOL*)((UINT8*)Node + NodeLength))
+  {
+    NodeLength = HostDevicePathNodeLength( Node );
+    if (NodeLength < sizeof( EFI_DEVICE_PATH_PROTOCOL ))
+    {
+      return NULL;
+    }
+    if (Node->Type == MEDIA_DEVICE_PATH && Node->SubType == MEDIA_FILEPATH_DP)
+    {
+      TextLength += (NodeLength - SIZE_OF_FILEPATH_DEVICE_PATH) / sizeof( CHAR16 );
+    }
+  }
+
+  Text = AllocateZeroPool( (TextLength + 1) * sizeof( CHAR16 ) );
+  if (Text == NULL)
+  {
+    return NULL;
+  }
+
+  // ...then stitch the path names together.
+  for (Node = DevicePath; Node->Type != END_DEVICE_PATH_TYPE; Node = (CONST EFI_DEVICE_PATH_PROTOCOL*)((UINT8*)Node + NodeLength))
+  {
+    NodeLength = HostDevicePathNodeLength( Node );
+    if (Node->Type == MEDIA_DEVICE_PATH && Node->SubType == MEDIA_FILEPATH_DP)
+    {
+      StrnCatS( Text,
+                TextLength + 1,
+                ((FILEPATH_DEVICE_PATH*)Node)->PathName,
+                (NodeLength - SIZE_OF_FILEPATH_DEVICE_PATH) / sizeof( CHAR16 ) );
+    }
+  }
+
+  return Text;
+} // ConvertDevicePathToText()
+
+
+EFI_DEVICE_PATH_PROTOCOL*
+EFIAPI
+FileDevicePath (
+  IN  EFI_HANDLE      Device OPTIONAL,
+  IN  CONST CHAR16    *FileName
+  )
+{
+  FILEPATH_DEVICE_PATH      *FilePath;
+  EFI_DEVICE_PATH_PROTOCOL  *End;
+  UINTN                     NodeSize;
+
+  //
+  // There's no device path for the host "volume", so the file node is the whole path.
+  NodeSize = SIZE_OF_FILEPATH_DEVICE_PATH + StrSize( FileName );
+  FilePath = AllocatePool( NodeSize + sizeof( EFI_DEVICE_PATH_PROTOCOL ) );
+  if (FilePath == NULL)
+  {
+    return NULL;
+  }
+
+  FilePath->Header.Type    = MEDIA_DEVICE_PATH;
+  FilePath->Header.SubType = MEDIA_FILEPATH_DP;
+  WriteUnaligned16( (UINT16*)&FilePath->Header.Length[0], (UINT16)NodeSize );
+  CopyMem( FilePath->PathName, FileName, StrSize( FileName ) );
+
+  End = (EFI_DEVICE_PATH_PROTOCOL*)((UINT8*)FilePath + NodeSize);
+  End->Type    = END_DEVICE_PATH_TYPE;
+  End->SubType = END_ENTIRE_DEVICE_PATH_SUBTYPE;
+  WriteUnaligned16( (UINT16*)&End->Length[0], (UINT16)sizeof( EFI_DEVICE_PATH_PROTOCOL ) );
+
+  return &FilePath->Header;
+} // FileDevicePath()
+
+
+///================================================================================================
+///================================================================================================
+///
+/// SHELL LIB
+///
+///================================================================================================
+///================================================================================================
+
+
+EFI_STATUS
+EFIAPI
+ShellOpenFileByDevicePath (
+  IN OUT  EFI_DEVICE_PATH_PROTOCOL  **FilePath,
+  OUT     EFI_HANDLE                *DeviceHandle,
+  OUT     SHELL_FILE_HANDLE         *FileHandle,
+  IN      UINT64                    OpenMode,
+  IN      UINT64                    Attributes
+  )
+{
+  CHAR16        *Text;
+  CHAR8         *HostPath;
+  VOID          *File;
+  UINT32        Mode = 0;
+
+  if (FilePath == NULL || *FilePath == NULL || FileHandle == NULL)
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Text = ConvertDevicePathToText( *FilePath, TRUE, TRUE );
+  if (Text == NULL)
+  {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  HostPath = UnitTestHostConvertPath( Text );
+  FreePool( Text );
+  if (HostPath == NULL)
+  {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Mode |= ((OpenMode & EFI_FILE_MODE_READ) != 0)   ? HOST_OS_FILE_READ   : 0;
+  Mode |= ((OpenMode & EFI_FILE_MODE_WRITE) != 0)  ? HOST_OS_FILE_WRITE  : 0;
+  Mode |= ((OpenMode & EFI_FILE_MODE_CREATE) != 0) ? HOST_OS_FILE_CREATE : 0;
+  File = HostOsOpenFile( HostPath, Mode );
+  HostOsFree( HostPath );
+
+  if (DeviceHandle != NULL)
+  {
+    *DeviceHandle = NULL;
+  }
+  *FileHandle = (SHELL_FILE_HANDLE)File;
+
+  return (File != NULL) ? EFI_SUCCESS : EFI_NOT_FOUND;
+} // ShellOpenFileByDevicePath()
+
+
+EFI_STATUS
+EFIAPI
+ShellReadFile (
+  IN      SHELL_FILE_HANDLE   FileHandle,
+  IN OUT  UINTN               *ReadSize,
+  OUT     VOID                *Buffer
+  )
+{
+  long long   Count;
+
+  Count = HostOsReadFile( FileHandle, Buffer, *ReadSize );
+  if (Count < 0)
+  {
+    *ReadSize = 0;
+    return EFI_DEVICE_ERROR;
+  }
+
+  *ReadSize = (UINTN)Count;
+  return EFI_SUCCESS;
+} // ShellReadFile()
+
+
+EFI_STATUS
+EFIAPI
+ShellWriteFile (
+  IN      SHELL_FILE_HANDLE   FileHandle,
+  IN OUT  UINTN               *BufferSize,
+  IN      VOID                *Buffer
+  )
+{
+  long long   Count;
+
+  Count = HostOsWriteFile( FileHandle, Buffer, *BufferSize );
+  if (Count < 0)
+  {
+    *BufferSize = 0;
+    return EFI_DEVICE_ERROR;
+  }
+
+  *BufferSize = (UINTN)Count;
+  return EFI_SUCCESS;
+} // ShellWriteFile()
+
+
+EFI_STATUS
+EFIAPI
+ShellSetFilePosition (
+  IN  SHELL_FILE_HANDLE   FileHandle,
+  IN  UINT64              Position
+  )
+{
+  // 0xFFFFFFFFFFFFFFFF means end-of-file for both sides.
+  return (HostOsSetFilePosition( FileHandle, Position ) == 0) ? EFI_SUCCESS : EFI_DEVICE_ERROR;
+} // ShellSetFilePosition()
+
+
+EFI_STATUS
+EFIAPI
+ShellGetFileSize (
+  IN  SHELL_FILE_HANDLE   FileHandle,
+  OUT UINT64              *Size
+  )
+{
+  long long   FileSize;
+
+  FileSize = HostOsGetFileSize( FileHandle );
+  if (FileSize < 0)
+  {
+    return EFI_DEVICE_ERROR;
+  }
+
+  *Size = (UINT64)FileSize;
+  return EFI_SUCCESS;
+} // ShellGetFileSize()
+
+
+EFI_STATUS
+EFIAPI
+ShellFlushFile (
+  IN  SHELL_FILE_HANDLE   FileHandle
+  )
+{
+  return (HostOsFlushFile( FileHandle ) == 0) ? EFI_SUCCESS : EFI_DEVICE_ERROR;
+} // ShellFlushFile()
+
+
+EFI_FILE_INFO*
+EFIAPI
+ShellGetFileInfo (
+  IN  SHELL_FILE_HANDLE   FileHandle
+  )
+{
+  EFI_FILE_INFO   *FileInfo;
+  long long       FileSize;
+
+  FileSize = HostOsGetFileSize( FileHandle );
+  if (FileSize < 0)
+  {
+    return NULL;
+  }
+
+  // Only the size means anything here. The name is left empty.
+  FileInfo = AllocateZeroPool( SIZE_OF_EFI_FILE_INFO + sizeof( CHAR16 ) );
+  if (FileInfo != NULL)
+  {
+    FileInfo->Size          = SIZE_OF_EFI_FILE_INFO + sizeof( CHAR16 );
+    FileInfo->FileSize      = (UINT64)FileSize;
+    FileInfo->PhysicalSize  = (UINT64)FileSize;
+  }
+
+  return FileInfo;
+} // ShellGetFileInfo()
+
+
+EFI_STATUS
+EFIAPI
+ShellSetFileInfo (
+  IN  SHELL_FILE_HANDLE   FileHandle,
+  IN  EFI_FILE_INFO       *FileInfo
+  )
+{
+  long long   FileSize;
+
+  if (FileInfo == NULL)
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  // Resizing is all that's supported. Everything else is quietly left alone.
+  FileSize = HostOsGetFileSize( FileHandle );
+  if (FileSize < 0)
+  {
+    return EFI_DEVICE_ERROR;
+  }
+  if ((UINT64)FileSize != FileInfo->FileSize &&
+      HostOsSetFileSize( FileHandle, FileInfo->FileSize ) != 0)
+  {
+    return EFI_DEVICE_ERROR;
+  }
+
+  return EFI_SUCCESS;
+} // ShellSetFileInfo()
+
+
+EFI_STATUS
+EFIAPI
+ShellCloseFile (
+  IN  SHELL_FILE_HANDLE   *FileHandle
+  )
+{
+  if (FileHandle == NULL || *FileHandle == NULL)
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  HostOsCloseFile( *FileHandle );
+  *FileHandle = NULL;
+  return EFI_SUCCESS;
+} // ShellCloseFile()
+
+
+EFI_STATUS
+EFIAPI
+ShellDeleteFile (
+  IN  SHELL_FILE_HANDLE   *FileHandle
+  )
+{
+  INTN    Result;
+
+  if (FileHandle == NULL || *FileHandle == NULL)
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Result = HostOsDeleteFile( *FileHandle );
+  *FileHandle = NULL;
+  // Like the real thing, the handle is closed either way.
+  return (Result == 0) ? EFI_SUCCESS : EFI_WARN_DELETE_FAILURE;
+} // ShellDeleteFile()
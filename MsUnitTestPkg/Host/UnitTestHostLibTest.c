@@ -0,0 +1,370 @@
+/** @file -- UnitTestHostLibTest.c
+Host-only tests for UnitTestLib itself. Each case runs as an ordinary test
+under a real framework, and its log is checked afterwards, rendered the
+same way the reports render it. A test app can't do that for its own tests
+without reaching into the library, so those checks live here instead.
+
+Build and run with "make -C MsUnitTestPkg/Host test".
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+
+
+Copyright (C) 2016 Microsoft Corporation. All Rights Reserved.
+
+**/
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PcdLib.h>
+#include <Library/PrintLib.h>
+#include <Library/UefiLib.h>
+#include <Library/UnitTestLib.h>
+
+#include "UnitTestHost.h"
+
+#define EXPECTED_LOG_LENGTH   (8 * 1024)
+
+//
+// What UnitTestLog() puts in front of a DEBUG_INFO line.
+#define INFO_LOG_PREFIX       "[INFO]        "
+
+//
+// Logs through the framework, which defers the formatting, and formats the
+// same call straight away into mExpectedLog. Must be used in a test, since it
+// relies on Framework like the UT_LOG_* macros do.
+#define LOG_BOTH_WAYS(Format, ...)                                                              \
+  do {                                                                                          \
+    UnitTestLog( Framework, DEBUG_INFO, Format "\n", ##__VA_ARGS__ );                           \
+    mExpectedLength += UnicodeSPrintAsciiFormat( &mExpectedLog[mExpectedLength],                \
+                                                 sizeof( mExpectedLog ) - (mExpectedLength * sizeof( CHAR16 )), \
+                                                 INFO_LOG_PREFIX Format "\n", ##__VA_ARGS__ );   \
+  } while (FALSE)
+
+typedef
+BOOLEAN
+(*HOST_LIB_TEST_CHECK) (
+  IN UNIT_TEST        *Test,
+  IN CONST CHAR16     *Log
+  );
+
+typedef struct {
+  CHAR16                *Description;
+  UNIT_TEST_FUNCTION    RunTest;
+  HOST_LIB_TEST_CHECK   CheckLog;     // Judges the test once it has run. Its own result is only an input.
+} HOST_LIB_TEST;
+
+STATIC CHAR16   mExpectedLog[EXPECTED_LOG_LENGTH];
+STATIC UINTN    mExpectedLength = 0;
+
+
+/**
+  Joins the chunks of a test's log into one string, so that a match can't be
+  missed for straddling two of them. The deferred records must already have
+  been rendered.
+
+  @retval   The log, which the caller must free, or NULL if out of resources.
+
+**/
+STATIC
+CHAR16*
+GetRenderedLog (
+  IN UNIT_TEST    *Test
+  )
+{
+  UNIT_TEST_LOG_CHUNK   *Chunk;
+  CHAR16                *Log;
+  UINTN                 Length = 0;
+
+  Log = AllocateZeroPool( (Test->Log.Length + 1) * sizeof( CHAR16 ) );
+  if (Log == NULL)
+  {
+    return NULL;
+  }
+
+  for (Chunk = Test->Log.Head; Chunk != NULL; Chunk = Chunk->Next)
+  {
+    CopyMem( &Log[Length], Chunk->Buffer, Chunk->Length * sizeof( CHAR16 ) );
+    Length += Chunk->Length;
+  }
+
+  return Log;
+} // GetRenderedLog()
+
+
+STATIC
+BOOLEAN
+CheckLogContains (
+  IN CONST CHAR16   *Log,
+  IN CONST CHAR16   *String,
+  IN BOOLEAN        Expected
+  )
+{
+  if ((StrStr( Log, String ) != NULL) != Expected)
+  {
+    Print( L"  %s in the log: \"%s\"\n", Expected ? L"Missing" : L"Unexpected", String );
+    return FALSE;
+  }
+
+  return TRUE;
+} // CheckLogContains()
+
+
+STATIC
+UINTN
+GetLineLength (
+  IN CONST CHAR16   *Line
+  )
+{
+  UINTN   Length = 0;
+
+  while (Line[Length] != L'\0' && Line[Length] != L'\n')
+  {
+    Length++;
+  }
+
+  return Length;
+} // GetLineLength()
+
+
+///================================================================================================
+///================================================================================================
+///
+/// TEST CASES
+///
+///================================================================================================
+///================================================================================================
+
+
+UNIT_TEST_STATUS
+EFIAPI
+MemMismatchShouldLogTheDifference (
+  IN UNIT_TEST_FRAMEWORK_HANDLE  Framework,
+  IN UNIT_TEST_CONTEXT           Context
+  )
+{
+  UINT8     BufferA[0x40];
+  UINT8     BufferB[0x40];
+
+  ZeroMem( &BufferA[0], sizeof( BufferA ) );
+  ZeroMem( &BufferB[0], sizeof( BufferB ) );
+  BufferA[0x25] = 0x5A;
+
+  return UT_ASSERT_MEM_EQUAL( &BufferA[0], &BufferB[0], sizeof( BufferA ) ) ?
+         UNIT_TEST_PASSED :
+         UNIT_TEST_ERROR_TEST_FAILED;
+} // MemMismatchShouldLogTheDifference()
+
+
+/**
+  The log should hold the offset of the difference and a hex dump of the line
+  it's on plus one line either side, with the byte that differs marked in
+  both buffers. Nothing further from the difference should be dumped.
+
+**/
+STATIC
+BOOLEAN
+CheckMemMismatchLog (
+  IN UNIT_TEST        *Test,
+  IN CONST CHAR16     *Log
+  )
+{
+  BOOLEAN   Passed = TRUE;
+
+  if (Test->Result != UNIT_TEST_ERROR_TEST_FAILED)
+  {
+    Print( L"  The mismatch wasn't reported as a failure.\n" );
+    Passed = FALSE;
+  }
+
+  Passed &= CheckLogContains( Log, L"(first difference at offset 0x25 of 0x40)", TRUE );
+  Passed &= CheckLogContains( Log, L"A +0x00000010:", TRUE );
+  Passed &= CheckLogContains( Log, L"A +0x00000020: 00 00 00 00 00*5A 00", TRUE );
+  Passed &= CheckLogContains( Log, L"B +0x00000020: 00 00 00 00 00*00 00", TRUE );
+  Passed &= CheckLogContains( Log, L"B +0x00000030:", TRUE );
+  Passed &= CheckLogContains( Log, L"+0x00000000:", FALSE );
+
+  return Passed;
+} // CheckMemMismatchLog()
+
+
+UNIT_TEST_STATUS
+EFIAPI
+DeferredLogShouldMatchImmediateFormatting (
+  IN UNIT_TEST_FRAMEWORK_HANDLE  Framework,
+  IN UNIT_TEST_CONTEXT           Context
+  )
+{
+  STATIC CONST GUID   Guid = { 0x12345678, 0x9ABC, 0xDEF0, { 0x01, 0x23, 0x45, 0x67, 0x89, 0xAB, 0xCD, 0xEF } };
+  EFI_TIME            Time;
+  CHAR8               AsciiString[] = "Ascii String";
+  CHAR16              UnicodeString[] = L"Unicode String";
+
+  ZeroMem( &Time, sizeof( Time ) );
+  Time.Year   = 2016;
+  Time.Month  = 7;
+  Time.Day    = 4;
+  Time.Hour   = 13;
+  Time.Minute = 5;
+
+  //
+  // Every type PrintLib knows, with each flag and the 'L'/'l' size prefix.
+  LOG_BOTH_WAYS( "%a|%-16a|%16a|%.5a|%.a|%.0a", AsciiString, AsciiString, AsciiString, AsciiString, AsciiString, AsciiString );
+  LOG_BOTH_WAYS( "%s|%-16s|%16s|%.7s|%.s|%S|%.3S", UnicodeString, UnicodeString, UnicodeString, UnicodeString, UnicodeString, UnicodeString, UnicodeString );
+  LOG_BOTH_WAYS( "%a|%s|%g|%t", NULL, NULL, NULL, NULL );
+  LOG_BOTH_WAYS( "%c|%c|%5c|%-5c|", (UINTN)'A', (UINTN)L'\x263A', (UINTN)'B', (UINTN)'C' );
+  LOG_BOTH_WAYS( "%d|%d|%+d|% d|%,d|%5d|%-5d|%05d", 42, -42, 42, 42, 1234567, 42, 42, 42 );
+  LOG_BOTH_WAYS( "%u|%x|%X|%08x|%-8X|%,u", 42u, 0xBEEFu, 0xBEEFu, 0xBEEFu, 0xBEEFu, 1234567u );
+  LOG_BOTH_WAYS( "%ld|%Ld|%lu|%lx|%lX|%016lX|%,ld", -5LL, -5LL, 0xFFFFFFFFFFFFFFFFull, 0x123456789ABCDEF0ull, 0x123456789ABCDEF0ull,
+                 0xABCDull, -1234567890123LL );
+  LOG_BOTH_WAYS( "%p|%lp|%-20p|%20p", (VOID*)&Guid, (VOID*)&Time, (VOID*)&Guid, (VOID*)&Time );
+  LOG_BOTH_WAYS( "%g|%-40g|%t|%r|%r|%r", &Guid, &Guid, &Time, EFI_SUCCESS, EFI_NOT_FOUND, EFI_ACCESS_DENIED );
+
+  //
+  // Widths and precisions taken from the arguments.
+  LOG_BOTH_WAYS( "%*a|%-*a|%.*a|%*.*a|%*.a|%.*s", (UINTN)20, AsciiString, (UINTN)20, AsciiString, (UINTN)3, AsciiString,
+                 (UINTN)10, (UINTN)4, AsciiString, (UINTN)8, AsciiString, (UINTN)2, UnicodeString );
+  LOG_BOTH_WAYS( "%*d|%0*x|%*lx|%-*p|", (UINTN)6, 42, (UINTN)6, 0xABu, (UINTN)18, 0x1234ull, (UINTN)20, (VOID*)&Guid );
+
+  //
+  // Things that take no argument at all.
+  LOG_BOTH_WAYS( "100%%|%d%%|trailing %%", 50 );
+
+  //
+  // None of that should have needed formatting yet.
+  if (FeaturePcdGet( PcdUnitTestDeferredLogFormatting ) &&
+      ((UNIT_TEST_FRAMEWORK*)Framework)->CurrentTest->Log.Length != 0)
+  {
+    UT_LOG_ERROR( "A known specifier wasn't deferred.\n" );
+    return UNIT_TEST_ERROR_TEST_FAILED;
+  }
+
+  //
+  // A specifier the capture code doesn't know is formatted right away,
+  // in order with what was deferred around it.
+  LOG_BOTH_WAYS( "%q|%d|%a", 7, AsciiString );
+  LOG_BOTH_WAYS( "%d|%s", 8, UnicodeString );
+
+  return UNIT_TEST_PASSED;
+} // DeferredLogShouldMatchImmediateFormatting()
+
+
+/**
+  Every deferred line should come out exactly as PrintLib formats it with the
+  original arguments. Points out the first line that doesn't.
+
+**/
+STATIC
+BOOLEAN
+CheckDeferredLog (
+  IN UNIT_TEST        *Test,
+  IN CONST CHAR16     *Log
+  )
+{
+  UINTN     Index;
+  UINTN     LineStart = 0;
+
+  if (Test->Result != UNIT_TEST_PASSED)
+  {
+    Print( L"  The test itself failed.\n" );
+    return FALSE;
+  }
+
+  for (Index = 0; Log[Index] == mExpectedLog[Index]; Index++)
+  {
+    if (Log[Index] == L'\0')
+    {
+      return TRUE;
+    }
+    if (Log[Index] == L'\n')
+    {
+      LineStart = Index + 1;
+    }
+  }
+
+  Print( L"  Deferred:  %.*s\n", GetLineLength( &Log[LineStart] ), &Log[LineStart] );
+  Print( L"  Immediate: %.*s\n", GetLineLength( &mExpectedLog[LineStart] ), &mExpectedLog[LineStart] );
+  return FALSE;
+} // CheckDeferredLog()
+
+
+STATIC CONST HOST_LIB_TEST  mHostLibTests[] = {
+  { L"UT_ASSERT_MEM_EQUAL should log where the buffers differ", MemMismatchShouldLogTheDifference, CheckMemMismatchLog },
+  { L"Deferred log formatting should match PrintLib", DeferredLogShouldMatchImmediateFormatting, CheckDeferredLog }
+};
+
+
+int
+main (
+  int   Argc,
+  char  **Argv
+  )
+{
+  UNIT_TEST_FRAMEWORK   *Framework = NULL;
+  UNIT_TEST_SUITE       *Suite;
+  UNIT_TEST_LIST_ENTRY  *Test;
+  CHAR16                *Log;
+  UINTN                 Index;
+  BOOLEAN               TestPassed;
+  BOOLEAN               Passed = TRUE;
+
+  HostOsInitialize( Argc, Argv );
+  if (EFI_ERROR( UnitTestHostInitializeServices() ))
+  {
+    return 1;
+  }
+
+  if (EFI_ERROR( InitUnitTestFramework( &Framework, L"UnitTestLib Host Tests", L"UnitTestLibHostTests", L"1.0" ) ) ||
+      EFI_ERROR( CreateUnitTestSuite( &Suite, Framework, L"UnitTestLib", NULL, NULL ) ))
+  {
+    return 1;
+  }
+  for (Index = 0; Index < ARRAY_SIZE( mHostLibTests ); Index++)
+  {
+    if (EFI_ERROR( AddTestCase( Suite, mHostLibTests[Index].Description, mHostLibTests[Index].RunTest, NULL, NULL, NULL ) ))
+    {
+      return 1;
+    }
+  }
+
+  RunAllTestSuites( Framework );
+  RenderDeferredUnitTestLogs( Framework );
+
+  //
+  // The cases were added in table order, so walk the two together.
+  for (Index = 0, Test = (UNIT_TEST_LIST_ENTRY*)GetFirstNode( &Suite->TestCaseList );
+       Index < ARRAY_SIZE( mHostLibTests ) && (LIST_ENTRY*)Test != &Suite->TestCaseList;
+       Index++, Test = (UNIT_TEST_LIST_ENTRY*)GetNextNode( &Suite->TestCaseList, (LIST_ENTRY*)Test ))
+  {
+    Log = GetRenderedLog( &Test->UT );
+    TestPassed = (Log != NULL) && mHostLibTests[Index].CheckLog( &Test->UT, Log );
+    if (Log != NULL)
+    {
+      FreePool( Log );
+    }
+
+    AsciiPrint( "%s: %a\n", mHostLibTests[Index].Description, TestPassed ? "PASSED" : "FAILED" );
+    Passed &= TestPassed;
+  }
+  if (Index < ARRAY_SIZE( mHostLibTests ))
+  {
+    Passed = FALSE;
+  }
+  FreeUnitTestFramework( Framework );
+
+  AsciiPrint( "UnitTestLib host tests: %a\n", Passed ? "PASSED" : "FAILED" );
+  HostOsExit( Passed ? 0 : 1 );
+  return 0;
+} // main()
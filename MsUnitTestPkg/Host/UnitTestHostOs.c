@@ -0,0 +1,663 @@
+/** @file -- UnitTestHostOs.c
+This is the thin operating system layer used by the host build of the
+unit test framework. See UnitTestHostOs.h for the rules of this file.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+
+
+Copyright (C) 2016 Microsoft Corporation. All Rights Reserved.
+
+**/
+
+#define _GNU_SOURCE
+#include <limits.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "UnitTestHostOs.h"
+
+//
+// A reboot is simulated by re-executing the runner. The boot count travels
+// in the environment so that a test that reboots forever can't hang the host.
+//
+#define HOST_OS_BOOT_COUNT_VARIABLE     "UNIT_TEST_HOST_BOOT_COUNT"
+#define HOST_OS_MAX_BOOTS_VARIABLE      "UNIT_TEST_HOST_MAX_BOOTS"
+#define HOST_OS_DEFAULT_MAX_BOOTS       16
+#define HOST_OS_PAGE_SIZE               4096
+
+//
+// Each simulated processor is a thread. Processor 0 (the BSP) is the main thread.
+//
+#define HOST_OS_PROCESSORS_VARIABLE     "UNIT_TEST_HOST_PROCESSORS"
+#define HOST_OS_DEFAULT_MAX_PROCESSORS  8
+
+typedef struct
+{
+  FILE    *Stream;
+  char    *Path;
+} HOST_OS_FILE;
+
+static int            mArgc = 0;
+static char           **mArgv = NULL;
+static unsigned int   mBootCount = 0;
+static char           mImagePath[PATH_MAX];
+static unsigned int   mProcessorCount = 1;
+static __thread unsigned int  mProcessorNumber = 0;
+
+typedef struct
+{
+  unsigned int  Number;
+  void          (*Procedure)( void *Argument );
+  void          *Argument;
+  pthread_t     Thread;
+} HOST_OS_PROCESSOR;
+
+
+///================================================================================================
+///================================================================================================
+///
+/// PROCESS FUNCTIONS
+///
+///================================================================================================
+///================================================================================================
+
+
+void
+HostOsInitialize (
+  int     Argc,
+  char    **Argv
+  )
+{
+  const char    *Value;
+  ssize_t       Length;
+
+  mArgc = Argc;
+  mArgv = Argv;
+
+  Value = getenv( HOST_OS_BOOT_COUNT_VARIABLE );
+  mBootCount = (Value != NULL) ? (unsigned int)strtoul( Value, NULL, 10 ) : 0;
+
+  //
+  // Simulate as many processors as the host has, within reason, unless told otherwise.
+  Value = getenv( HOST_OS_PROCESSORS_VARIABLE );
+  if (Value != NULL)
+  {
+    mProcessorCount = (unsigned int)strtoul( Value, NULL, 10 );
+  }
+  else
+  {
+    Length = sysconf( _SC_NPROCESSORS_ONLN );
+    mProcessorCount = (Length > HOST_OS_DEFAULT_MAX_PROCESSORS) ? HOST_OS_DEFAULT_MAX_PROCESSORS : (unsigned int)Length;
+  }
+  if (mProcessorCount < 1)
+  {
+    mProcessorCount = 1;
+  }
+
+  //
+  // The image path is used to build the loaded image device path, so
+  // resolve it once up front. Fall back to argv[0] if /proc isn't around.
+  Length = readlink( "/proc/self/exe", mImagePath, sizeof( mImagePath ) - 1 );
+  if (Length <= 0)
+  {
+    if (realpath( Argv[0], mImagePath ) == NULL)
+    {
+      strncpy( mImagePath, Argv[0], sizeof( mImagePath ) - 1 );
+    }
+  }
+  else
+  {
+    mImagePath[Length] = '\0';
+  }
+
+  return;
+} // HostOsInitialize()
+
+
+const char *
+HostOsGetEnvironment (
+  const char    *Name
+  )
+{
+  return getenv( Name );
+} // HostOsGetEnvironment()
+
+
+unsigned int
+HostOsGetBootCount (
+  void
+  )
+{
+  return mBootCount;
+} // HostOsGetBootCount()
+
+
+int
+HostOsGetArgumentCount (
+  void
+  )
+{
+  return mArgc;
+} // HostOsGetArgumentCount()
+
+
+const char *
+HostOsGetArgument (
+  int     Index
+  )
+{
+  return (Index >= 0 && Index < mArgc) ? mArgv[Index] : NULL;
+} // HostOsGetArgument()
+
+
+const char *
+HostOsGetImagePath (
+  void
+  )
+{
+  return mImagePath;
+} // HostOsGetImagePath()
+
+
+void
+HostOsReboot (
+  void
+  )
+{
+  char            Count[16];
+  const char      *Value;
+  unsigned long   MaxBoots;
+
+  Value = getenv( HOST_OS_MAX_BOOTS_VARIABLE );
+  MaxBoots = (Value != NULL) ? strtoul( Value, NULL, 10 ) : HOST_OS_DEFAULT_MAX_BOOTS;
+  if (mBootCount + 1 >= MaxBoots)
+  {
+    fprintf( stderr, "UnitTestHost: Giving up after %u simulated reboots.\n", mBootCount + 1 );
+    HostOsExit( EXIT_FAILURE );
+  }
+
+  snprintf( Count, sizeof( Count ), "%u", mBootCount + 1 );
+  setenv( HOST_OS_BOOT_COUNT_VARIABLE, Count, 1 );
+
+  fflush( stdout );
+  fflush( stderr );
+  execv( mImagePath, mArgv );
+
+  // If we made it here, the exec failed.
+  perror( "UnitTestHost: execv" );
+  HostOsAbort();
+} // HostOsReboot()
+
+
+void
+HostOsExit (
+  int     Status
+  )
+{
+  fflush( stdout );
+  fflush( stderr );
+  exit( Status );
+} // HostOsExit()
+
+
+void
+HostOsAbort (
+  void
+  )
+{
+  fflush( stdout );
+  fflush( stderr );
+  abort();
+} // HostOsAbort()
+
+
+///================================================================================================
+///================================================================================================
+///
+/// PROCESSOR FUNCTIONS
+///
+///================================================================================================
+///================================================================================================
+
+
+unsigned int
+HostOsGetProcessorCount (
+  void
+  )
+{
+  return mProcessorCount;
+} // HostOsGetProcessorCount()
+
+
+unsigned int
+HostOsGetProcessorNumber (
+  void
+  )
+{
+  return mProcessorNumber;
+} // HostOsGetProcessorNumber()
+
+
+static
+void *
+HostOsProcessorThread (
+  void    *Context
+  )
+{
+  HOST_OS_PROCESSOR   *Processor = (HOST_OS_PROCESSOR*)Context;
+
+  mProcessorNumber = Processor->Number;
+  Processor->Procedure( Processor->Argument );
+  return NULL;
+} // HostOsProcessorThread()
+
+
+int
+HostOsRunOnProcessors (
+  unsigned int    First,
+  unsigned int    Count,
+  void            (*Procedure)( void *Argument ),
+  void            *Argument
+  )
+{
+  HOST_OS_PROCESSOR   *Processors;
+  unsigned int        Index, Started;
+
+  if (First == 0 || Count == 0 || First + Count > mProcessorCount)
+  {
+    return -1;
+  }
+
+  Processors = calloc( Count, sizeof( *Processors ) );
+  if (Processors == NULL)
+  {
+    return -1;
+  }
+
+  for (Started = 0; Started < Count; Started++)
+  {
+    Processors[Started].Number    = First + Started;
+    Processors[Started].Procedure = Procedure;
+    Processors[Started].Argument  = Argument;
+    if (pthread_create( &Processors[Started].Thread, NULL, HostOsProcessorThread, &Processors[Started] ) != 0)
+    {
+      break;
+    }
+  }
+
+  // Wait for everything that did start, regardless.
+  for (Index = 0; Index < Started; Index++)
+  {
+    pthread_join( Processors[Index].Thread, NULL );
+  }
+
+  free( Processors );
+  return (Started == Count) ? 0 : -1;
+} // HostOsRunOnProcessors()
+
+
+///================================================================================================
+///================================================================================================
+///
+/// MEMORY FUNCTIONS
+///
+///================================================================================================
+///================================================================================================
+
+
+void *
+HostOsAllocate (
+  unsigned long long  Size
+  )
+{
+  // Pool allocations are 8-byte aligned in firmware. malloc() is at least that good.
+  return malloc( (size_t)Size );
+} // HostOsAllocate()
+
+
+void *
+HostOsAllocatePages (
+  unsigned long long  Size
+  )
+{
+  void    *Buffer = NULL;
+
+  if (posix_memalign( &Buffer, HOST_OS_PAGE_SIZE, (size_t)Size ) != 0)
+  {
+    return NULL;
+  }
+  return Buffer;
+} // HostOsAllocatePages()
+
+
+void
+HostOsFree (
+  void    *Buffer
+  )
+{
+  free( Buffer );
+} // HostOsFree()
+
+
+///================================================================================================
+///================================================================================================
+///
+/// CONSOLE FUNCTIONS
+///
+///================================================================================================
+///================================================================================================
+
+
+void
+HostOsWriteConsole (
+  int                   ToStdErr,
+  const unsigned short  *String
+  )
+{
+  FILE            *Stream = ToStdErr ? stderr : stdout;
+  unsigned int    Char;
+
+  //
+  // Console output is UCS-2. Encode it as UTF-8 and drop the carriage
+  // returns that firmware console output is so fond of.
+  for (; *String != 0; String++)
+  {
+    Char = *String;
+    if (Char == '\r')
+    {
+      continue;
+    }
+    if (Char < 0x80)
+    {
+      fputc( (int)Char, Stream );
+    }
+    else if (Char < 0x800)
+    {
+      fputc( 0xC0 | (Char >> 6), Stream );
+      fputc( 0x80 | (Char & 0x3F), Stream );
+    }
+    else
+    {
+      fputc( 0xE0 | (Char >> 12), Stream );
+      fputc( 0x80 | ((Char >> 6) & 0x3F), Stream );
+      fputc( 0x80 | (Char & 0x3F), Stream );
+    }
+  }
+
+  return;
+} // HostOsWriteConsole()
+
+
+void
+HostOsWriteDebug (
+  const char    *String
+  )
+{
+  fputs( String, stderr );
+} // HostOsWriteDebug()
+
+
+///================================================================================================
+///================================================================================================
+///
+/// TIME FUNCTIONS
+///
+///================================================================================================
+///================================================================================================
+
+
+unsigned long long
+HostOsGetMonotonicNanoSeconds (
+  void
+  )
+{
+  struct timespec   Now;
+
+  clock_gettime( CLOCK_MONOTONIC, &Now );
+  return (unsigned long long)Now.tv_sec * 1000000000ULL + (unsigned long long)Now.tv_nsec;
+} // HostOsGetMonotonicNanoSeconds()
+
+
+void
+HostOsSleepNanoSeconds (
+  unsigned long long  NanoSeconds
+  )
+{
+  struct timespec   Request;
+
+  Request.tv_sec  = (time_t)(NanoSeconds / 1000000000ULL);
+  Request.tv_nsec = (long)(NanoSeconds % 1000000000ULL);
+  while (nanosleep( &Request, &Request ) != 0)
+  {
+    // Keep going if we were interrupted.
+  }
+
+  return;
+} // HostOsSleepNanoSeconds()
+
+
+void
+HostOsGetLocalTime (
+  HOST_OS_TIME  *Time
+  )
+{
+  struct timespec   Now;
+  struct tm         Local;
+
+  clock_gettime( CLOCK_REALTIME, &Now );
+  localtime_r( &Now.tv_sec, &Local );
+
+  Time->Year       = (unsigned short)(Local.tm_year + 1900);
+  Time->Month      = (unsigned char)(Local.tm_mon + 1);
+  Time->Day        = (unsigned char)Local.tm_mday;
+  Time->Hour       = (unsigned char)Local.tm_hour;
+  Time->Minute     = (unsigned char)Local.tm_min;
+  Time->Second     = (unsigned char)Local.tm_sec;
+  Time->Nanosecond = (unsigned int)Now.tv_nsec;
+  Time->TimeZone   = (short)(Local.tm_gmtoff / 60);
+
+  return;
+} // HostOsGetLocalTime()
+
+
+///================================================================================================
+///================================================================================================
+///
+/// FILE FUNCTIONS
+///
+///================================================================================================
+///================================================================================================
+
+
+void *
+HostOsOpenFile (
+  const char    *Path,
+  unsigned int  Mode
+  )
+{
+  HOST_OS_FILE    *File;
+  FILE            *Stream;
+
+  //
+  // Firmware file semantics: READ|WRITE opens an existing file without
+  // truncating it, and CREATE makes it if it isn't there yet.
+  if ((Mode & HOST_OS_FILE_WRITE) == 0)
+  {
+    Stream = fopen( Path, "rb" );
+  }
+  else
+  {
+    Stream = fopen( Path, "r+b" );
+    if (Stream == NULL && (Mode & HOST_OS_FILE_CREATE) != 0)
+    {
+      Stream = fopen( Path, "w+b" );
+    }
+  }
+  if (Stream == NULL)
+  {
+    return NULL;
+  }
+
+  File = malloc( sizeof( *File ) );
+  if (File != NULL)
+  {
+    File->Path = strdup( Path );
+  }
+  if (File == NULL || File->Path == NULL)
+  {
+    free( File );
+    fclose( Stream );
+    return NULL;
+  }
+  File->Stream = Stream;
+
+  return File;
+} // HostOsOpenFile()
+
+
+long long
+HostOsReadFile (
+  void                *File,
+  void                *Buffer,
+  unsigned long long  Size
+  )
+{
+  HOST_OS_FILE    *HostFile = File;
+  size_t          Count;
+
+  Count = fread( Buffer, 1, (size_t)Size, HostFile->Stream );
+  if (Count < Size && ferror( HostFile->Stream ))
+  {
+    return -1;
+  }
+  return (long long)Count;
+} // HostOsReadFile()
+
+
+long long
+HostOsWriteFile (
+  void                *File,
+  const void          *Buffer,
+  unsigned long long  Size
+  )
+{
+  HOST_OS_FILE    *HostFile = File;
+  size_t          Count;
+
+  Count = fwrite( Buffer, 1, (size_t)Size, HostFile->Stream );
+  if (Count < Size)
+  {
+    return -1;
+  }
+  return (long long)Count;
+} // HostOsWriteFile()
+
+
+int
+HostOsSetFilePosition (
+  void                *File,
+  unsigned long long  Position
+  )
+{
+  HOST_OS_FILE    *HostFile = File;
+
+  if (Position == HOST_OS_SEEK_END)
+  {
+    return fseeko( HostFile->Stream, 0, SEEK_END );
+  }
+  return fseeko( HostFile->Stream, (off_t)Position, SEEK_SET );
+} // HostOsSetFilePosition()
+
+
+long long
+HostOsGetFileSize (
+  void    *File
+  )
+{
+  HOST_OS_FILE    *HostFile = File;
+  off_t           Current, End;
+
+  Current = ftello( HostFile->Stream );
+  if (Current < 0 || fseeko( HostFile->Stream, 0, SEEK_END ) != 0)
+  {
+    return -1;
+  }
+  End = ftello( HostFile->Stream );
+  fseeko( HostFile->Stream, Current, SEEK_SET );
+
+  return (long long)End;
+} // HostOsGetFileSize()
+
+
+int
+HostOsFlushFile (
+  void    *File
+  )
+{
+  HOST_OS_FILE    *HostFile = File;
+
+  return fflush( HostFile->Stream );
+} // HostOsFlushFile()
+
+
+int
+HostOsSetFileSize (
+  void                *File,
+  unsigned long long  Size
+  )
+{
+  HOST_OS_FILE    *HostFile = File;
+
+  // Anything still buffered has to land before the file is cut down to size.
+  if (fflush( HostFile->Stream ) != 0)
+  {
+    return -1;
+  }
+  return ftruncate( fileno( HostFile->Stream ), (off_t)Size );
+} // HostOsSetFileSize()
+
+
+void
+HostOsCloseFile (
+  void    *File
+  )
+{
+  HOST_OS_FILE    *HostFile = File;
+
+  fclose( HostFile->Stream );
+  free( HostFile->Path );
+  free( HostFile );
+
+  return;
+} // HostOsCloseFile()
+
+
+int
+HostOsDeleteFile (
+  void    *File
+  )
+{
+  HOST_OS_FILE    *HostFile = File;
+  int             Result;
+
+  fclose( HostFile->Stream );
+  Result = unlink( HostFile->Path );
+  free( HostFile->Path );
+  free( HostFile );
+
+  return Result;
+} // HostOsDeleteFile()
@@ -0,0 +1,100 @@
+/** @file -- UnitTestHostOs.h
+This is the thin operating system layer used by the host build of the
+unit test framework. It is compiled against the host C library ONLY and
+must never include any EDK2 headers (and vice versa). Everything that
+crosses this boundary uses plain C types.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+
+
+Copyright (C) 2016 Microsoft Corporation. All Rights Reserved.
+
+**/
+
+#ifndef _UNIT_TEST_HOST_OS_H_
+#define _UNIT_TEST_HOST_OS_H_
+
+#define HOST_OS_FILE_READ       0x01
+#define HOST_OS_FILE_WRITE      0x02
+#define HOST_OS_FILE_CREATE     0x04
+
+#define HOST_OS_SEEK_END        (~0ULL)
+
+typedef struct
+{
+  unsigned short      Year;
+  unsigned char       Month;
+  unsigned char       Day;
+  unsigned char       Hour;
+  unsigned char       Minute;
+  unsigned char       Second;
+  unsigned int        Nanosecond;
+  short               TimeZone;       // Minutes from UTC.
+} HOST_OS_TIME;
+
+//
+// Process.
+//
+void                HostOsInitialize( int Argc, char **Argv );
+const char         *HostOsGetEnvironment( const char *Name );
+unsigned int        HostOsGetBootCount( void );
+const char         *HostOsGetImagePath( void );
+int                 HostOsGetArgumentCount( void );
+const char         *HostOsGetArgument( int Index );
+void                HostOsReboot( void ) __attribute__(( noreturn ));
+void                HostOsExit( int Status ) __attribute__(( noreturn ));
+void                HostOsAbort( void ) __attribute__(( noreturn ));
+
+//
+// Processors. Each AP is a thread, and runs Procedure once per call.
+// HostOsRunOnProcessors() returns once all of them have finished.
+//
+unsigned int        HostOsGetProcessorCount( void );
+unsigned int        HostOsGetProcessorNumber( void );     // 0 is the BSP.
+int                 HostOsRunOnProcessors( unsigned int First, unsigned int Count,
+                                           void (*Procedure)( void *Argument ), void *Argument );
+
+//
+// Memory.
+//
+void               *HostOsAllocate( unsigned long long Size );
+void               *HostOsAllocatePages( unsigned long long Size );
+void                HostOsFree( void *Buffer );
+
+//
+// Console and debug output.
+//
+void                HostOsWriteConsole( int ToStdErr, const unsigned short *String );
+void                HostOsWriteDebug( const char *String );
+
+//
+// Time.
+//
+unsigned long long  HostOsGetMonotonicNanoSeconds( void );
+void                HostOsSleepNanoSeconds( unsigned long long NanoSeconds );
+void                HostOsGetLocalTime( HOST_OS_TIME *Time );
+
+//
+// Files. Paths are UTF-8 host paths.
+//
+void               *HostOsOpenFile( const char *Path, unsigned int Mode );
+long long           HostOsReadFile( void *File, void *Buffer, unsigned long long Size );
+long long           HostOsWriteFile( void *File, const void *Buffer, unsigned long long Size );
+int                 HostOsSetFilePosition( void *File, unsigned long long Position );
+long long           HostOsGetFileSize( void *File );
+int                 HostOsFlushFile( void *File );
+int                 HostOsSetFileSize( void *File, unsigned long long Size );
+void                HostOsCloseFile( void *File );
+int                 HostOsDeleteFile( void *File );     // Also closes the file.
+
+#endif // _UNIT_TEST_HOST_OS_H_
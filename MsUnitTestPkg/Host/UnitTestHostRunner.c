@@ -0,0 +1,62 @@
+/** @file -- UnitTestHostRunner.c
+Host runner for the unit test applications. Stands up the services shim
+and then calls the application entry point exactly as the firmware would.
+The entry point is selected at build time with UNIT_TEST_HOST_ENTRY_POINT.
+
+The process exit code is 0 if the entry point returned success and 1
+otherwise. A simulated reboot re-executes the runner with the same arguments.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF **/
+
+#include <Uefi.h>
+#include <Library/DebugLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+
+#include "UnitTestHost.h"
+
+#ifndef UNIT_TEST_HOST_ENTRY_POINT
+#error "UNIT_TEST_HOST_ENTRY_POINT must name the application entry point."
+#endif
+
+EFI_STATUS
+EFIAPI
+UNIT_TEST_HOST_ENTRY_POINT (
+  IN EFI_HANDLE         ImageHandle,
+  IN EFI_SYSTEM_TABLE   *SystemTable
+  );
+
+
+int
+main (
+  int   Argc,
+  char  **Argv
+  )
+{
+  EFI_STATUS    Status;
+
+  HostOsInitialize( Argc, Argv );
+
+  Status = UnitTestHostInitializeServices();
+  if (EFI_ERROR( Status ))
+  {
+    DEBUG(( DEBUG_ERROR, "%a - Failed to initialize host services. %r\n", __FUNCTION__, Status ));
+    return 1;
+  }
+
+  Status = UNIT_TEST_HOST_ENTRY_POINT( gImageHandle, gST );
+  if (EFI_ERROR( Status ))
+  {
+    DEBUG(( DEBUG_ERROR, "%a - Entry point returned %r.\n", __FUNCTION__, Status ));
+  }
+
+  HostOsExit( EFI_ERROR( Status ) ? 1 : 0 );
+} // main()
@@ -0,0 +1,1767 @@
+/** @file -- UnitTestHostServices.c
+This is a minimal boot/runtime services shim that lets UnitTestLib and the
+test applications run as an ordinary host process. It only implements the
+services that the framework and the sample applications actually use.
+Anything else is left NULL so that an unexpected call faults loudly.
+
+  - Pool and page allocations come from the host heap.
+  - Variables live in memory. Non-volatile ones are written through to a
+    file so that they survive a simulated reboot.
+  - GetMemoryMap() returns a small, fixed, but well-formed map.
+  - ResetSystem() re-executes the runner to simulate a reboot.
+  - ConOut and StdErr go to stdout and stderr.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+
+
+Copyright (C) 2016 Microsoft Corporation. All Rights Reserved.
+
+**/
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/UefiRuntimeServicesTableLib.h>
+
+#include <Protocol/LoadedImage.h>
+#include <Protocol/DevicePath.h>
+#include <Protocol/EfiShellParameters.h>
+#include <Protocol/MpService.h>
+
+#include <Guid/MemoryAttributesTable.h>
+
+#include "UnitTestHost.h"
+
+#define HOST_VARIABLE_FILE_VARIABLE     "UNIT_TEST_HOST_VARIABLE_FILE"
+#define HOST_VARIABLE_FILE_SUFFIX       ".vars"
+#define HOST_VARIABLE_FILE_SIGNATURE    SIGNATURE_32( 'U', 'T', 'H', 'V' )
+#define HOST_VARIABLE_STORE_SIZE        SIZE_1MB
+
+#define HOST_VARIABLE_NV_ATTRIBUTES     (EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_BOOTSERVICE_ACCESS | EFI_VARIABLE_RUNTIME_ACCESS)
+
+typedef struct
+{
+  LIST_ENTRY    Link;
+  EFI_GUID      VendorGuid;
+  UINT32        Attributes;
+  CHAR16        *Name;
+  UINTN         DataSize;
+  UINT8         *Data;
+} HOST_VARIABLE;
+
+#pragma pack (1)
+
+typedef struct
+{
+  UINT32        Signature;
+  UINT32        Count;
+} HOST_VARIABLE_FILE_HEADER;
+
+typedef struct
+{
+  EFI_GUID      VendorGuid;
+  UINT32        Attributes;
+  UINT32        NameSize;
+  UINT32        DataSize;
+  // CHAR16     Name[];
+  // UINT8      Data[];
+} HOST_VARIABLE_FILE_RECORD;
+
+#pragma pack ()
+
+EFI_HANDLE            gImageHandle = NULL;
+EFI_SYSTEM_TABLE      *gST = NULL;
+EFI_BOOT_SERVICES     *gBS = NULL;
+EFI_RUNTIME_SERVICES  *gRT = NULL;
+
+STATIC UINT8            mImageHandle;           // Only the addresses of these are used.
+STATIC UINT8            mDeviceHandle;
+STATIC LIST_ENTRY       mVariableList = INITIALIZE_LIST_HEAD_VARIABLE( mVariableList );
+STATIC CHAR8            *mVariableFilePath = NULL;
+STATIC EFI_TPL          mCurrentTpl = TPL_APPLICATION;
+STATIC UINT64           mMonotonicCount = 0;
+STATIC UINTN            mMemoryMapKey = 1;
+STATIC EFI_LOADED_IMAGE_PROTOCOL  mLoadedImage;
+STATIC EFI_SHELL_PARAMETERS_PROTOCOL  mShellParameters;
+
+
+///================================================================================================
+///================================================================================================
+///
+/// HELPER FUNCTIONS
+///
+///================================================================================================
+///================================================================================================
+
+
+CHAR8*
+EFIAPI
+UnitTestHostConvertPath (
+  IN  CONST CHAR16    *Path
+  )
+{
+  CHAR8     *HostPath;
+  UINTN     Index, Length;
+
+  Length = StrLen( Path );
+  HostPath = HostOsAllocate( Length + 1 );
+  if (HostPath == NULL)
+  {
+    return NULL;
+  }
+
+  //
+  // Firmware paths are rooted at the volume, which is the host root.
+  // Only ASCII paths are expected here.
+  for (Index = 0; Index < Length; Index++)
+  {
+    HostPath[Index] = (Path[Index] == L'\\') ? '/' : (CHAR8)Path[Index];
+  }
+  HostPath[Length] = '\0';
+
+  return HostPath;
+} // UnitTestHostConvertPath()
+
+
+/**
+  Builds a single file path node device path from the host path of the runner.
+**/
+STATIC
+EFI_DEVICE_PATH_PROTOCOL*
+CreateImageFilePath (
+  IN  CONST CHAR8   *HostPath
+  )
+{
+  FILEPATH_DEVICE_PATH      *FilePath;
+  EFI_DEVICE_PATH_PROTOCOL  *End;
+  UINTN                     Index, Length, NodeSize;
+
+  Length   = AsciiStrLen( HostPath );
+  NodeSize = SIZE_OF_FILEPATH_DEVICE_PATH + (Length + 1) * sizeof( CHAR16 );
+  FilePath = HostOsAllocate( NodeSize + sizeof( EFI_DEVICE_PATH_PROTOCOL ) );
+  if (FilePath == NULL)
+  {
+    return NULL;
+  }
+
+  FilePath->Header.Type    = MEDIA_DEVICE_PATH;
+  FilePath->Header.SubType = MEDIA_FILEPATH_DP;
+  WriteUnaligned16( (UINT16*)&FilePath->Header.Length[0], (UINT16)NodeSize );
+  for (Index = 0; Index < Length; Index++)
+  {
+    FilePath->PathName[Index] = (HostPath[Index] == '/') ? L'\\' : (CHAR16)HostPath[Index];
+  }
+  FilePath->PathName[Length] = L'\0';
+
+  End = (EFI_DEVICE_PATH_PROTOCOL*)((UINT8*)FilePath + NodeSize);
+  End->Type    = END_DEVICE_PATH_TYPE;
+  End->SubType = END_ENTIRE_DEVICE_PATH_SUBTYPE;
+  WriteUnaligned16( (UINT16*)&End->Length[0], (UINT16)sizeof( EFI_DEVICE_PATH_PROTOCOL ) );
+
+  return &FilePath->Header;
+} // CreateImageFilePath()
+
+
+/**
+  Fills in mShellParameters from the host command line, so that apps
+  (and UnitTestLib's test filters) see the same Argv they would in the shell.
+  Like the image path, arguments are widened a byte at a time.
+
+**/
+STATIC
+EFI_STATUS
+CreateShellParameters (
+  VOID
+  )
+{
+  CONST CHAR8   *Argument;
+  UINTN         Index, Length, CharIndex;
+
+  ZeroMem( &mShellParameters, sizeof( mShellParameters ) );
+  mShellParameters.Argc = (UINTN)HostOsGetArgumentCount();
+  mShellParameters.Argv = HostOsAllocate( (mShellParameters.Argc + 1) * sizeof( CHAR16* ) );
+  if (mShellParameters.Argv == NULL)
+  {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  for (Index = 0; Index < mShellParameters.Argc; Index++)
+  {
+    Argument = HostOsGetArgument( (int)Index );
+    Length   = AsciiStrLen( Argument );
+    mShellParameters.Argv[Index] = HostOsAllocate( (Length + 1) * sizeof( CHAR16 ) );
+    if (mShellParameters.Argv[Index] == NULL)
+    {
+      return EFI_OUT_OF_RESOURCES;
+    }
+    for (CharIndex = 0; CharIndex <= Length; CharIndex++)
+    {
+      mShellParameters.Argv[Index][CharIndex] = (CHAR16)(UINT8)Argument[CharIndex];
+    }
+  }
+  mShellParameters.Argv[mShellParameters.Argc] = NULL;
+
+  return EFI_SUCCESS;
+} // CreateShellParameters()
+
+
+///================================================================================================
+///================================================================================================
+///
+/// VARIABLE STORE
+///
+///================================================================================================
+///================================================================================================
+
+
+STATIC
+HOST_VARIABLE*
+FindVariable (
+  IN  CONST CHAR16      *VariableName,
+  IN  CONST EFI_GUID    *VendorGuid
+  )
+{
+  LIST_ENTRY      *Link;
+  HOST_VARIABLE   *Variable;
+
+  for (Link = GetFirstNode( &mVariableList ); !IsNull( &mVariableList, Link ); Link = GetNextNode( &mVariableList, Link ))
+  {
+    Variable = BASE_CR( Link, HOST_VARIABLE, Link );
+    if (CompareGuid( &Variable->VendorGuid, VendorGuid ) && StrCmp( Variable->Name, VariableName ) == 0)
+    {
+      return Variable;
+    }
+  }
+
+  return NULL;
+} // FindVariable()
+
+
+STATIC
+VOID
+DeleteVariable (
+  IN  HOST_VARIABLE   *Variable
+  )
+{
+  RemoveEntryList( &Variable->Link );
+  HostOsFree( Variable->Data );
+  HostOsFree( Variable->Name );
+  HostOsFree( Variable );
+} // DeleteVariable()
+
+
+/**
+  Creates or replaces a variable in the in-memory store.
+**/
+STATIC
+EFI_STATUS
+StoreVariable (
+  IN  CONST CHAR16      *VariableName,
+  IN  CONST EFI_GUID    *VendorGuid,
+  IN  UINT32            Attributes,
+  IN  UINTN             DataSize,
+  IN  CONST VOID        *Data
+  )
+{
+  HOST_VARIABLE   *Variable;
+  UINT8           *NewData;
+  UINTN           NameSize;
+
+  NewData = HostOsAllocate( DataSize );
+  if (NewData == NULL)
+  {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  CopyMem( NewData, Data, DataSize );
+
+  Variable = FindVariable( VariableName, VendorGuid );
+  if (Variable == NULL)
+  {
+    NameSize = StrSize( VariableName );
+    Variable = HostOsAllocate( sizeof( *Variable ) );
+    if (Variable != NULL)
+    {
+      Variable->Name = HostOsAllocate( NameSize );
+    }
+    if (Variable == NULL || Variable->Name == NULL)
+    {
+      HostOsFree( Variable );
+      HostOsFree( NewData );
+      return EFI_OUT_OF_RESOURCES;
+    }
+    CopyMem( Variable->Name, VariableName, NameSize );
+    CopyGuid( &Variable->VendorGuid, VendorGuid );
+    Variable->Data = NULL;
+    InsertTailList( &mVariableList, &Variable->Link );
+  }
+
+  HostOsFree( Variable->Data );
+  Variable->Attributes = Attributes;
+  Variable->DataSize   = DataSize;
+  Variable->Data       = NewData;
+
+  return EFI_SUCCESS;
+} // StoreVariable()
+
+
+/**
+  Writes all of the non-volatile variables to the backing file.
+  This is done on every NV change so that a crash can't lose anything.
+**/
+STATIC
+EFI_STATUS
+FlushVariableStore (
+  VOID
+  )
+{
+  HOST_VARIABLE_FILE_HEADER   Header;
+  HOST_VARIABLE_FILE_RECORD   Record;
+  LIST_ENTRY                  *Link;
+  HOST_VARIABLE               *Variable;
+  VOID                        *File;
+  BOOLEAN                     Failed = FALSE;
+
+  File = HostOsOpenFile( mVariableFilePath, HOST_OS_FILE_READ | HOST_OS_FILE_WRITE | HOST_OS_FILE_CREATE );
+  if (File == NULL)
+  {
+    DEBUG(( DEBUG_ERROR, "%a - Failed to open %a.\n", __FUNCTION__, mVariableFilePath ));
+    return EFI_DEVICE_ERROR;
+  }
+
+  //
+  // The header carries the record count, so stale data past the end
+  // of a shrinking store is simply never looked at.
+  Header.Signature = HOST_VARIABLE_FILE_SIGNATURE;
+  Header.Count     = 0;
+  for (Link = GetFirstNode( &mVariableList ); !IsNull( &mVariableList, Link ); Link = GetNextNode( &mVariableList, Link ))
+  {
+    Variable = BASE_CR( Link, HOST_VARIABLE, Link );
+    if ((Variable->Attributes & EFI_VARIABLE_NON_VOLATILE) != 0)
+    {
+      Header.Count++;
+    }
+  }
+  Failed |= HostOsWriteFile( File, &Header, sizeof( Header ) ) < 0;
+
+  for (Link = GetFirstNode( &mVariableList ); !IsNull( &mVariableList, Link ); Link = GetNextNode( &mVariableList, Link ))
+  {
+    Variable = BASE_CR( Link, HOST_VARIABLE, Link );
+    if ((Variable->Attributes & EFI_VARIABLE_NON_VOLATILE) == 0)
+    {
+      continue;
+    }
+    CopyGuid( &Record.VendorGuid, &Variable->VendorGuid );
+    Record.Attributes = Variable->Attributes;
+    Record.NameSize   = (UINT32)StrSize( Variable->Name );
+    Record.DataSize   = (UINT32)Variable->DataSize;
+    Failed |= HostOsWriteFile( File, &Record, sizeof( Record ) ) < 0;
+    Failed |= HostOsWriteFile( File, Variable->Name, Record.NameSize ) < 0;
+    Failed |= HostOsWriteFile( File, Variable->Data, Record.DataSize ) < 0;
+  }
+
+  Failed |= HostOsFlushFile( File ) != 0;
+  HostOsCloseFile( File );
+
+  return Failed ? EFI_DEVICE_ERROR : EFI_SUCCESS;
+} // FlushVariableStore()
+
+
+/**
+  Reloads the non-volatile variables written by a previous boot, if any.
+  A damaged file is ignored rather than trusted.
+**/
+STATIC
+VOID
+LoadVariableStore (
+  VOID
+  )
+{
+  HOST_VARIABLE_FILE_HEADER   *Header;
+  HOST_VARIABLE_FILE_RECORD   *Record;
+  VOID                        *File;
+  UINT8                       *Buffer = NULL, *Cursor, *End;
+  CHAR16                      *Name;
+  long long                   FileSize;
+  UINT32                      Index;
+
+  File = HostOsOpenFile( mVariableFilePath, HOST_OS_FILE_READ );
+  if (File == NULL)
+  {
+    return;
+  }
+
+  FileSize = HostOsGetFileSize( File );
+  if (FileSize < (long long)sizeof( *Header ) || FileSize > HOST_VARIABLE_STORE_SIZE)
+  {
+    goto Exit;
+  }
+  Buffer = HostOsAllocate( (UINTN)FileSize );
+  if (Buffer == NULL || HostOsReadFile( File, Buffer, (UINTN)FileSize ) != FileSize)
+  {
+    goto Exit;
+  }
+
+  Header = (HOST_VARIABLE_FILE_HEADER*)Buffer;
+  if (Header->Signature != HOST_VARIABLE_FILE_SIGNATURE)
+  {
+    DEBUG(( DEBUG_WARN, "%a - Ignoring %a. Bad signature.\n", __FUNCTION__, mVariableFilePath ));
+    goto Exit;
+  }
+
+  Cursor = Buffer + sizeof( *Header );
+  End    = Buffer + FileSize;
+  for (Index = 0; Index < Header->Count; Index++)
+  {
+    Record = (HOST_VARIABLE_FILE_RECORD*)Cursor;
+    if ((UINTN)(End - Cursor) < sizeof( *Record ) ||
+        (UINTN)(End - Cursor) - sizeof( *Record ) < (UINTN)Record->NameSize + Record->DataSize ||
+        Record->NameSize < sizeof( CHAR16 ) || (Record->NameSize % sizeof( CHAR16 )) != 0)
+    {
+      DEBUG(( DEBUG_WARN, "%a - Truncated variable store. Dropping the rest.\n", __FUNCTION__ ));
+      break;
+    }
+    Name = (CHAR16*)(Cursor + sizeof( *Record ));
+    if (ReadUnaligned16( (UINT16*)((UINT8*)Name + Record->NameSize - sizeof( CHAR16 )) ) != 0)
+    {
+      break;
+    }
+    StoreVariable( Name,
+                   &Record->VendorGuid,
+                   Record->Attributes,
+                   Record->DataSize,
+                   (UINT8*)Name + Record->NameSize );
+    Cursor += sizeof( *Record ) + Record->NameSize + Record->DataSize;
+  }
+
+Exit:
+  HostOsFree( Buffer );
+  HostOsCloseFile( File );
+  return;
+} // LoadVariableStore()
+
+
+///================================================================================================
+///================================================================================================
+///
+/// RUNTIME SERVICES
+///
+///================================================================================================
+///================================================================================================
+
+
+STATIC
+EFI_STATUS
+EFIAPI
+HostGetTime (
+  OUT EFI_TIME                *Time,
+  OUT EFI_TIME_CAPABILITIES   *Capabilities OPTIONAL
+  )
+{
+  HOST_OS_TIME    HostTime;
+
+  if (Time == NULL)
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  HostOsGetLocalTime( &HostTime );
+  ZeroMem( Time, sizeof( *Time ) );
+  Time->Year       = HostTime.Year;
+  Time->Month      = HostTime.Month;
+  Time->Day        = HostTime.Day;
+  Time->Hour       = HostTime.Hour;
+  Time->Minute     = HostTime.Minute;
+  Time->Second     = HostTime.Second;
+  Time->Nanosecond = HostTime.Nanosecond;
+  Time->TimeZone   = HostTime.TimeZone;
+
+  if (Capabilities != NULL)
+  {
+    Capabilities->Resolution = 1;
+    Capabilities->Accuracy   = 50000000;
+    Capabilities->SetsToZero = FALSE;
+  }
+
+  return EFI_SUCCESS;
+} // HostGetTime()
+
+
+STATIC
+EFI_STATUS
+EFIAPI
+HostGetVariable (
+  IN      CHAR16    *VariableName,
+  IN      EFI_GUID  *VendorGuid,
+  OUT     UINT32    *Attributes OPTIONAL,
+  IN OUT  UINTN     *DataSize,
+  OUT     VOID      *Data OPTIONAL
+  )
+{
+  HOST_VARIABLE   *Variable;
+
+  if (VariableName == NULL || VendorGuid == NULL || DataSize == NULL)
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Variable = FindVariable( VariableName, VendorGuid );
+  if (Variable == NULL)
+  {
+    return EFI_NOT_FOUND;
+  }
+
+  if (*DataSize < Variable->DataSize)
+  {
+    *DataSize = Variable->DataSize;
+    return EFI_BUFFER_TOO_SMALL;
+  }
+  if (Data == NULL)
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  CopyMem( Data, Variable->Data, Variable->DataSize );
+  *DataSize = Variable->DataSize;
+  if (Attributes != NULL)
+  {
+    *Attributes = Variable->Attributes;
+  }
+
+  return EFI_SUCCESS;
+} // HostGetVariable()
+
+
+STATIC
+EFI_STATUS
+EFIAPI
+HostGetNextVariableName (
+  IN OUT  UINTN     *VariableNameSize,
+  IN OUT  CHAR16    *VariableName,
+  IN OUT  EFI_GUID  *VendorGuid
+  )
+{
+  LIST_ENTRY      *Link;
+  HOST_VARIABLE   *Variable;
+  UINTN           NameSize;
+
+  if (VariableNameSize == NULL || VariableName == NULL || VendorGuid == NULL)
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // An empty name starts the walk. Otherwise, pick up after the named variable.
+  if (VariableName[0] == L'\0')
+  {
+    Link = GetFirstNode( &mVariableList );
+  }
+  else
+  {
+    Variable = FindVariable( VariableName, VendorGuid );
+    if (Variable == NULL)
+    {
+      return EFI_INVALID_PARAMETER;
+    }
+    Link = GetNextNode( &mVariableList, &Variable->Link );
+  }
+
+  if (IsNull( &mVariableList, Link ))
+  {
+    return EFI_NOT_FOUND;
+  }
+
+  Variable = BASE_CR( Link, HOST_VARIABLE, Link );
+  NameSize = StrSize( Variable->Name );
+  if (*VariableNameSize < NameSize)
+  {
+    *VariableNameSize = NameSize;
+    return EFI_BUFFER_TOO_SMALL;
+  }
+
+  CopyMem( VariableName, Variable->Name, NameSize );
+  CopyGuid( VendorGuid, &Variable->VendorGuid );
+  *VariableNameSize = NameSize;
+
+  return EFI_SUCCESS;
+} // HostGetNextVariableName()
+
+
+STATIC
+EFI_STATUS
+EFIAPI
+HostSetVariable (
+  IN  CHAR16    *VariableName,
+  IN  EFI_GUID  *VendorGuid,
+  IN  UINT32    Attributes,
+  IN  UINTN     DataSize,
+  IN  VOID      *Data
+  )
+{
+  EFI_STATUS      Status;
+  HOST_VARIABLE   *Variable;
+  BOOLEAN         IsNonVolatile;
+
+  if (VariableName == NULL || VariableName[0] == L'\0' || VendorGuid == NULL ||
+      (DataSize != 0 && Data == NULL))
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+  //
+  // Only the plain attribute combinations are emulated.
+  if ((Attributes & ~HOST_VARIABLE_NV_ATTRIBUTES) != 0)
+  {
+    return EFI_UNSUPPORTED;
+  }
+  if ((Attributes & EFI_VARIABLE_RUNTIME_ACCESS) != 0 && (Attributes & EFI_VARIABLE_BOOTSERVICE_ACCESS) == 0)
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Variable = FindVariable( VariableName, VendorGuid );
+
+  //
+  // A zero size or zero attributes means delete.
+  if (DataSize == 0 || Attributes == 0)
+  {
+    if (Variable == NULL)
+    {
+      return EFI_NOT_FOUND;
+    }
+    IsNonVolatile = (Variable->Attributes & EFI_VARIABLE_NON_VOLATILE) != 0;
+    DeleteVariable( Variable );
+    return IsNonVolatile ? FlushVariableStore() : EFI_SUCCESS;
+  }
+
+  if (Variable != NULL && Variable->Attributes != Attributes)
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Status = StoreVariable( VariableName, VendorGuid, Attributes, DataSize, Data );
+  if (!EFI_ERROR( Status ) && (Attributes & EFI_VARIABLE_NON_VOLATILE) != 0)
+  {
+    Status = FlushVariableStore();
+  }
+
+  return Status;
+} // HostSetVariable()
+
+
+STATIC
+EFI_STATUS
+EFIAPI
+HostQueryVariableInfo (
+  IN  UINT32    Attributes,
+  OUT UINT64    *MaximumVariableStorageSize,
+  OUT UINT64    *RemainingVariableStorageSize,
+  OUT UINT64    *MaximumVariableSize
+  )
+{
+  if (MaximumVariableStorageSize == NULL || RemainingVariableStorageSize == NULL || MaximumVariableSize == NULL)
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // The host store isn't really bounded, but report something sane.
+  *MaximumVariableStorageSize   = HOST_VARIABLE_STORE_SIZE;
+  *RemainingVariableStorageSize = HOST_VARIABLE_STORE_SIZE;
+  *MaximumVariableSize          = SIZE_64KB;
+
+  return EFI_SUCCESS;
+} // HostQueryVariableInfo()
+
+
+STATIC
+EFI_STATUS
+EFIAPI
+HostGetNextHighMonotonicCount (
+  OUT UINT32    *HighCount
+  )
+{
+  if (HighCount == NULL)
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+  mMonotonicCount += BIT32;
+  *HighCount = (UINT32)RShiftU64( mMonotonicCount, 32 );
+  return EFI_SUCCESS;
+} // HostGetNextHighMonotonicCount()
+
+
+STATIC
+VOID
+EFIAPI
+HostResetSystem (
+  IN  EFI_RESET_TYPE  ResetType,
+  IN  EFI_STATUS      ResetStatus,
+  IN  UINTN           DataSize,
+  IN  VOID            *ResetData OPTIONAL
+  )
+{
+  //
+  // A shutdown ends the run. Anything else comes back around as a fresh
+  // process with the same arguments, which is as close to a reboot as we get.
+  if (ResetType == EfiResetShutdown)
+  {
+    HostOsExit( EFI_ERROR( ResetStatus ) ? 1 : 0 );
+  }
+
+  DEBUG(( DEBUG_INFO, "%a - Simulating reset type %d.\n", __FUNCTION__, ResetType ));
+  HostOsReboot();
+} // HostResetSystem()
+
+
+///================================================================================================
+///================================================================================================
+///
+/// MP SERVICES
+///
+///================================================================================================
+///================================================================================================
+
+
+//
+// Carries an EFIAPI AP procedure across to the host OS threads.
+//
+typedef struct
+{
+  EFI_AP_PROCEDURE    Procedure;
+  VOID                *Argument;
+} HOST_AP_PROCEDURE;
+
+
+STATIC
+VOID
+HostApProcedureThunk (
+  VOID    *Context
+  )
+{
+  HOST_AP_PROCEDURE   *ApProcedure = (HOST_AP_PROCEDURE*)Context;
+
+  ApProcedure->Procedure( ApProcedure->Argument );
+  return;
+} // HostApProcedureThunk()
+
+
+STATIC
+EFI_STATUS
+EFIAPI
+HostGetNumberOfProcessors (
+  IN  EFI_MP_SERVICES_PROTOCOL    *This,
+  OUT UINTN                       *NumberOfProcessors,
+  OUT UINTN                       *NumberOfEnabledProcessors
+  )
+{
+  if (NumberOfProcessors == NULL || NumberOfEnabledProcessors == NULL)
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+  if (HostOsGetProcessorNumber() != 0)
+  {
+    return EFI_DEVICE_ERROR;
+  }
+
+  *NumberOfProcessors        = HostOsGetProcessorCount();
+  *NumberOfEnabledProcessors = HostOsGetProcessorCount();
+  return EFI_SUCCESS;
+} // HostGetNumberOfProcessors()
+
+
+STATIC
+EFI_STATUS
+EFIAPI
+HostGetProcessorInfo (
+  IN  EFI_MP_SERVICES_PROTOCOL    *This,
+  IN  UINTN                       ProcessorNumber,
+  OUT EFI_PROCESSOR_INFORMATION   *ProcessorInfoBuffer
+  )
+{
+  if (ProcessorInfoBuffer == NULL)
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+  if (HostOsGetProcessorNumber() != 0)
+  {
+    return EFI_DEVICE_ERROR;
+  }
+  if (ProcessorNumber >= HostOsGetProcessorCount())
+  {
+    return EFI_NOT_FOUND;
+  }
+
+  ZeroMem( ProcessorInfoBuffer, sizeof( *ProcessorInfoBuffer ) );
+  ProcessorInfoBuffer->ProcessorId = ProcessorNumber;
+  ProcessorInfoBuffer->StatusFlag  = PROCESSOR_ENABLED_BIT | PROCESSOR_HEALTH_STATUS_BIT;
+  if (ProcessorNumber == 0)
+  {
+    ProcessorInfoBuffer->StatusFlag |= PROCESSOR_AS_BSP_BIT;
+  }
+  ProcessorInfoBuffer->Location.Core = (UINT32)ProcessorNumber;
+  return EFI_SUCCESS;
+} // HostGetProcessorInfo()
+
+
+/**
+  Only blocking mode is supported, and the timeout is ignored.
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+HostStartupAllAPs (
+  IN  EFI_MP_SERVICES_PROTOCOL    *This,
+  IN  EFI_AP_PROCEDURE            Procedure,
+  IN  BOOLEAN                     SingleThread,
+  IN  EFI_EVENT                   WaitEvent               OPTIONAL,
+  IN  UINTN                       TimeoutInMicroSeconds,
+  IN  VOID                        *ProcedureArgument      OPTIONAL,
+  OUT UINTN                       **FailedCpuList         OPTIONAL
+  )
+{
+  HOST_AP_PROCEDURE   ApProcedure;
+  UINTN               Count, Index;
+
+  if (FailedCpuList != NULL)
+  {
+    *FailedCpuList = NULL;
+  }
+  if (Procedure == NULL)
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+  if (HostOsGetProcessorNumber() != 0)
+  {
+    return EFI_DEVICE_ERROR;
+  }
+  if (WaitEvent != NULL)
+  {
+    return EFI_UNSUPPORTED;
+  }
+
+  Count = HostOsGetProcessorCount();
+  if (Count < 2)
+  {
+    return EFI_NOT_STARTED;
+  }
+
+  ApProcedure.Procedure = Procedure;
+  ApProcedure.Argument  = ProcedureArgument;
+  if (!SingleThread)
+  {
+    return (HostOsRunOnProcessors( 1, (UINT32)(Count - 1), HostApProcedureThunk, &ApProcedure ) == 0) ? EFI_SUCCESS : EFI_DEVICE_ERROR;
+  }
+
+  for (Index = 1; Index < Count; Index++)
+  {
+    if (HostOsRunOnProcessors( (UINT32)Index, 1, HostApProcedureThunk, &ApProcedure ) != 0)
+    {
+      return EFI_DEVICE_ERROR;
+    }
+  }
+  return EFI_SUCCESS;
+} // HostStartupAllAPs()
+
+
+/**
+  Only blocking mode is supported, and the timeout is ignored.
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+HostStartupThisAP (
+  IN  EFI_MP_SERVICES_PROTOCOL    *This,
+  IN  EFI_AP_PROCEDURE            Procedure,
+  IN  UINTN                       ProcessorNumber,
+  IN  EFI_EVENT                   WaitEvent               OPTIONAL,
+  IN  UINTN                       TimeoutInMicroseconds,
+  IN  VOID                        *ProcedureArgument      OPTIONAL,
+  OUT BOOLEAN                     *Finished               OPTIONAL
+  )
+{
+  HOST_AP_PROCEDURE   ApProcedure;
+
+  if (Procedure == NULL || ProcessorNumber == 0)
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+  if (HostOsGetProcessorNumber() != 0)
+  {
+    return EFI_DEVICE_ERROR;
+  }
+  if (WaitEvent != NULL)
+  {
+    return EFI_UNSUPPORTED;
+  }
+  if (ProcessorNumber >= HostOsGetProcessorCount())
+  {
+    return EFI_NOT_FOUND;
+  }
+
+  ApProcedure.Procedure = Procedure;
+  ApProcedure.Argument  = ProcedureArgument;
+  if (HostOsRunOnProcessors( (UINT32)ProcessorNumber, 1, HostApProcedureThunk, &ApProcedure ) != 0)
+  {
+    return EFI_DEVICE_ERROR;
+  }
+  if (Finished != NULL)
+  {
+    *Finished = TRUE;
+  }
+  return EFI_SUCCESS;
+} // HostStartupThisAP()
+
+
+STATIC
+EFI_STATUS
+EFIAPI
+HostSwitchBSP (
+  IN  EFI_MP_SERVICES_PROTOCOL    *This,
+  IN  UINTN                       ProcessorNumber,
+  IN  BOOLEAN                     EnableOldBSP
+  )
+{
+  return EFI_UNSUPPORTED;
+} // HostSwitchBSP()
+
+
+STATIC
+EFI_STATUS
+EFIAPI
+HostEnableDisableAP (
+  IN  EFI_MP_SERVICES_PROTOCOL    *This,
+  IN  UINTN                       ProcessorNumber,
+  IN  BOOLEAN                     EnableAP,
+  IN  UINT32                      *HealthFlag OPTIONAL
+  )
+{
+  return EFI_UNSUPPORTED;
+} // HostEnableDisableAP()
+
+
+STATIC
+EFI_STATUS
+EFIAPI
+HostWhoAmI (
+  IN  EFI_MP_SERVICES_PROTOCOL    *This,
+  OUT UINTN                       *ProcessorNumber
+  )
+{
+  if (ProcessorNumber == NULL)
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  *ProcessorNumber = HostOsGetProcessorNumber();
+  return EFI_SUCCESS;
+} // HostWhoAmI()
+
+
+STATIC EFI_MP_SERVICES_PROTOCOL   mMpServices = {
+  .GetNumberOfProcessors  = HostGetNumberOfProcessors,
+  .GetProcessorInfo       = HostGetProcessorInfo,
+  .StartupAllAPs          = HostStartupAllAPs,
+  .StartupThisAP          = HostStartupThisAP,
+  .SwitchBSP              = HostSwitchBSP,
+  .EnableDisableAP        = HostEnableDisableAP,
+  .WhoAmI                 = HostWhoAmI
+};
+
+
+///================================================================================================
+///================================================================================================
+///
+/// BOOT SERVICES
+///
+///================================================================================================
+///================================================================================================
+
+
+STATIC
+EFI_TPL
+EFIAPI
+HostRaiseTpl (
+  IN  EFI_TPL   NewTpl
+  )
+{
+  EFI_TPL   OldTpl = mCurrentTpl;
+
+  ASSERT( NewTpl >= OldTpl );
+  mCurrentTpl = NewTpl;
+  return OldTpl;
+} // HostRaiseTpl()
+
+
+STATIC
+VOID
+EFIAPI
+HostRestoreTpl (
+  IN  EFI_TPL   OldTpl
+  )
+{
+  ASSERT( OldTpl <= mCurrentTpl );
+  mCurrentTpl = OldTpl;
+} // HostRestoreTpl()
+
+
+STATIC
+EFI_STATUS
+EFIAPI
+HostAllocatePages (
+  IN      EFI_ALLOCATE_TYPE       Type,
+  IN      EFI_MEMORY_TYPE         MemoryType,
+  IN      UINTN                   Pages,
+  IN OUT  EFI_PHYSICAL_ADDRESS    *Memory
+  )
+{
+  VOID    *Buffer;
+
+  if (Memory == NULL)
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+  //
+  // There is no physical memory to hand out, so fixed
+  // addresses and ceilings can't be honored.
+  if (Type != AllocateAnyPages)
+  {
+    return EFI_NOT_FOUND;
+  }
+
+  Buffer = HostOsAllocatePages( EFI_PAGES_TO_SIZE( Pages ) );
+  if (Buffer == NULL)
+  {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  *Memory = (EFI_PHYSICAL_ADDRESS)(UINTN)Buffer;
+  mMemoryMapKey++;
+  return EFI_SUCCESS;
+} // HostAllocatePages()
+
+
+STATIC
+EFI_STATUS
+EFIAPI
+HostFreePages (
+  IN  EFI_PHYSICAL_ADDRESS    Memory,
+  IN  UINTN                   Pages
+  )
+{
+  HostOsFree( (VOID*)(UINTN)Memory );
+  mMemoryMapKey++;
+  return EFI_SUCCESS;
+} // HostFreePages()
+
+
+//
+// A plausible small machine. The descriptors are returned with a stride
+// larger than sizeof( EFI_MEMORY_DESCRIPTOR ), just like real firmware,
+// so that consumers walking the map by sizeof() get caught.
+//
+typedef struct
+{
+  EFI_MEMORY_TYPE   Type;
+  UINT64            PhysicalStart;
+  UINT64            NumberOfPages;
+  UINT64            Attribute;
+} HOST_MEMORY_MAP_ENTRY;
+
+#define HOST_MEMORY_DESCRIPTOR_PADDING    8
+
+STATIC CONST HOST_MEMORY_MAP_ENTRY mHostMemoryMap[] = {
+  { EfiConventionalMemory,      0x00000000, 0x009F,  EFI_MEMORY_WB },
+  { EfiReservedMemoryType,      0x0009F000, 0x0061,  EFI_MEMORY_UC },
+  { EfiLoaderCode,              0x00100000, 0x0100,  EFI_MEMORY_WB },
+  { EfiLoaderData,              0x00200000, 0x0400,  EFI_MEMORY_WB },
+  { EfiBootServicesCode,        0x00600000, 0x0200,  EFI_MEMORY_WB },
+  { EfiBootServicesData,        0x00800000, 0x0800,  EFI_MEMORY_WB },
+  { EfiConventionalMemory,      0x01000000, 0x7000,  EFI_MEMORY_WB },
+  { EfiRuntimeServicesCode,     0x08000000, 0x0040,  EFI_MEMORY_WB | EFI_MEMORY_RUNTIME },
+  { EfiRuntimeServicesData,     0x08040000, 0x0040,  EFI_MEMORY_WB | EFI_MEMORY_RUNTIME },
+  { EfiACPIReclaimMemory,       0x08080000, 0x0010,  EFI_MEMORY_WB },
+  { EfiACPIMemoryNVS,           0x08090000, 0x0010,  EFI_MEMORY_WB },
+  { EfiMemoryMappedIO,          0xFEC00000, 0x0001,  EFI_MEMORY_UC | EFI_MEMORY_RUNTIME },
+};
+
+STATIC
+EFI_STATUS
+EFIAPI
+HostGetMemoryMap (
+  IN OUT  UINTN                   *MemoryMapSize,
+  IN OUT  EFI_MEMORY_DESCRIPTOR   *MemoryMap,
+  OUT     UINTN                   *MapKey,
+  OUT     UINTN                   *DescriptorSize,
+  OUT     UINT32                  *DescriptorVersion
+  )
+{
+  EFI_MEMORY_DESCRIPTOR   *Descriptor;
+  UINTN                   Stride, RequiredSize, Index;
+
+  if (MemoryMapSize == NULL)
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Stride = sizeof( EFI_MEMORY_DESCRIPTOR ) + HOST_MEMORY_DESCRIPTOR_PADDING;
+  RequiredSize = Stride * ARRAY_SIZE( mHostMemoryMap );
+  if (DescriptorSize != NULL)
+  {
+    *DescriptorSize = Stride;
+  }
+  if (DescriptorVersion != NULL)
+  {
+    *DescriptorVersion = EFI_MEMORY_DESCRIPTOR_VERSION;
+  }
+
+  if (*MemoryMapSize < RequiredSize)
+  {
+    *MemoryMapSize = RequiredSize;
+    return EFI_BUFFER_TOO_SMALL;
+  }
+  // Like the DXE core, MapKey and DescriptorVersion are only filled in if asked for.
+  if (MemoryMap == NULL)
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  ZeroMem( MemoryMap, RequiredSize );
+  Descriptor = MemoryMap;
+  for (Index = 0; Index < ARRAY_SIZE( mHostMemoryMap ); Index++)
+  {
+    Descriptor->Type          = mHostMemoryMap[Index].Type;
+    Descriptor->PhysicalStart = mHostMemoryMap[Index].PhysicalStart;
+    Descriptor->VirtualStart  = 0;
+    Descriptor->NumberOfPages = mHostMemoryMap[Index].NumberOfPages;
+    Descriptor->Attribute     = mHostMemoryMap[Index].Attribute;
+    Descriptor = (EFI_MEMORY_DESCRIPTOR*)((UINT8*)Descriptor + Stride);
+  }
+
+  *MemoryMapSize = RequiredSize;
+  if (MapKey != NULL)
+  {
+    *MapKey = mMemoryMapKey;
+  }
+  return EFI_SUCCESS;
+} // HostGetMemoryMap()
+
+
+/**
+  Builds a Memory Attributes Table out of the runtime code and data entries
+  in the memory map, the same way the DXE core would. Code is marked RO and
+  data is marked XP.
+
+**/
+STATIC
+EFI_MEMORY_ATTRIBUTES_TABLE*
+CreateMemoryAttributesTable (
+  VOID
+  )
+{
+  EFI_MEMORY_ATTRIBUTES_TABLE   *Table;
+  EFI_MEMORY_DESCRIPTOR         *Descriptor;
+  UINTN                         Stride, Count, Index;
+
+  Count = 0;
+  for (Index = 0; Index < ARRAY_SIZE( mHostMemoryMap ); Index++)
+  {
+    if (mHostMemoryMap[Index].Type == EfiRuntimeServicesCode || mHostMemoryMap[Index].Type == EfiRuntimeServicesData)
+    {
+      Count++;
+    }
+  }
+
+  Stride = sizeof( EFI_MEMORY_DESCRIPTOR ) + HOST_MEMORY_DESCRIPTOR_PADDING;
+  Table  = HostOsAllocate( sizeof( *Table ) + (Count * Stride) );
+  if (Table == NULL)
+  {
+    return NULL;
+  }
+  ZeroMem( Table, sizeof( *Table ) + (Count * Stride) );
+  Table->Version          = EFI_MEMORY_ATTRIBUTES_TABLE_VERSION;
+  Table->NumberOfEntries  = (UINT32)Count;
+  Table->DescriptorSize   = (UINT32)Stride;
+
+  Descriptor = (EFI_MEMORY_DESCRIPTOR*)(Table + 1);
+  for (Index = 0; Index < ARRAY_SIZE( mHostMemoryMap ); Index++)
+  {
+    if (mHostMemoryMap[Index].Type != EfiRuntimeServicesCode && mHostMemoryMap[Index].Type != EfiRuntimeServicesData)
+    {
+      continue;
+    }
+    Descriptor->Type          = mHostMemoryMap[Index].Type;
+    Descriptor->PhysicalStart = mHostMemoryMap[Index].PhysicalStart;
+    Descriptor->NumberOfPages = mHostMemoryMap[Index].NumberOfPages;
+    Descriptor->Attribute     = EFI_MEMORY_RUNTIME |
+                                ((Descriptor->Type == EfiRuntimeServicesCode) ? EFI_MEMORY_RO : EFI_MEMORY_XP);
+    Descriptor = (EFI_MEMORY_DESCRIPTOR*)((UINT8*)Descriptor + Stride);
+  }
+
+  return Table;
+} // CreateMemoryAttributesTable()
+
+
+STATIC
+EFI_STATUS
+EFIAPI
+HostAllocatePool (
+  IN  EFI_MEMORY_TYPE   PoolType,
+  IN  UINTN             Size,
+  OUT VOID              **Buffer
+  )
+{
+  if (Buffer == NULL)
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  // Zero-byte pools are legal. Make sure we still hand back something unique.
+  *Buffer = HostOsAllocate( (Size == 0) ? 1 : Size );
+  if (*Buffer == NULL)
+  {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  return EFI_SUCCESS;
+} // HostAllocatePool()
+
+
+STATIC
+EFI_STATUS
+EFIAPI
+HostFreePool (
+  IN  VOID    *Buffer
+  )
+{
+  if (Buffer == NULL)
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+  HostOsFree( Buffer );
+  return EFI_SUCCESS;
+} // HostFreePool()
+
+
+STATIC
+EFI_STATUS
+EFIAPI
+HostHandleProtocol (
+  IN  EFI_HANDLE    Handle,
+  IN  EFI_GUID      *Protocol,
+  OUT VOID          **Interface
+  )
+{
+  if (Handle == NULL || Protocol == NULL || Interface == NULL)
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (Handle == gImageHandle && CompareGuid( Protocol, &gEfiLoadedImageProtocolGuid ))
+  {
+    *Interface = &mLoadedImage;
+    return EFI_SUCCESS;
+  }
+
+  if (Handle == gImageHandle && CompareGuid( Protocol, &gEfiShellParametersProtocolGuid ))
+  {
+    *Interface = &mShellParameters;
+    return EFI_SUCCESS;
+  }
+
+  *Interface = NULL;
+  return EFI_UNSUPPORTED;
+} // HostHandleProtocol()
+
+
+STATIC
+EFI_STATUS
+EFIAPI
+HostOpenProtocol (
+  IN  EFI_HANDLE    Handle,
+  IN  EFI_GUID      *Protocol,
+  OUT VOID          **Interface OPTIONAL,
+  IN  EFI_HANDLE    AgentHandle,
+  IN  EFI_HANDLE    ControllerHandle,
+  IN  UINT32        Attributes
+  )
+{
+  VOID    *LocalInterface;
+
+  return HostHandleProtocol( Handle, Protocol, (Interface != NULL) ? Interface : &LocalInterface );
+} // HostOpenProtocol()
+
+
+STATIC
+EFI_STATUS
+EFIAPI
+HostCloseProtocol (
+  IN  EFI_HANDLE    Handle,
+  IN  EFI_GUID      *Protocol,
+  IN  EFI_HANDLE    AgentHandle,
+  IN  EFI_HANDLE    ControllerHandle
+  )
+{
+  return EFI_SUCCESS;
+} // HostCloseProtocol()
+
+
+STATIC
+EFI_STATUS
+EFIAPI
+HostLocateHandleBuffer (
+  IN      EFI_LOCATE_SEARCH_TYPE  SearchType,
+  IN      EFI_GUID                *Protocol OPTIONAL,
+  IN      VOID                    *SearchKey OPTIONAL,
+  IN OUT  UINTN                   *NoHandles,
+  OUT     EFI_HANDLE              **Buffer
+  )
+{
+  if (NoHandles == NULL || Buffer == NULL)
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+  *NoHandles = 0;
+  *Buffer = NULL;
+  return EFI_NOT_FOUND;
+} // HostLocateHandleBuffer()
+
+
+STATIC
+EFI_STATUS
+EFIAPI
+HostLocateProtocol (
+  IN  EFI_GUID  *Protocol,
+  IN  VOID      *Registration OPTIONAL,
+  OUT VOID      **Interface
+  )
+{
+  if (Protocol == NULL || Interface == NULL)
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+  // MP services are the only platform protocol published on the host.
+  if (CompareGuid( Protocol, &gEfiMpServiceProtocolGuid ))
+  {
+    *Interface = &mMpServices;
+    return EFI_SUCCESS;
+  }
+
+  *Interface = NULL;
+  return EFI_NOT_FOUND;
+} // HostLocateProtocol()
+
+
+STATIC
+EFI_STATUS
+EFIAPI
+HostExit (
+  IN  EFI_HANDLE    ImageHandle,
+  IN  EFI_STATUS    ExitStatus,
+  IN  UINTN         ExitDataSize,
+  IN  CHAR16        *ExitData OPTIONAL
+  )
+{
+  HostOsExit( EFI_ERROR( ExitStatus ) ? 1 : 0 );
+} // HostExit()
+
+
+STATIC
+EFI_STATUS
+EFIAPI
+HostGetNextMonotonicCount (
+  OUT UINT64    *Count
+  )
+{
+  if (Count == NULL)
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+  *Count = mMonotonicCount++;
+  return EFI_SUCCESS;
+} // HostGetNextMonotonicCount()
+
+
+STATIC
+EFI_STATUS
+EFIAPI
+HostStall (
+  IN  UINTN   Microseconds
+  )
+{
+  HostOsSleepNanoSeconds( MultU64x32( Microseconds, 1000 ) );
+  return EFI_SUCCESS;
+} // HostStall()
+
+
+STATIC
+EFI_STATUS
+EFIAPI
+HostSetWatchdogTimer (
+  IN  UINTN     Timeout,
+  IN  UINT64    WatchdogCode,
+  IN  UINTN     DataSize,
+  IN  CHAR16    *WatchdogData OPTIONAL
+  )
+{
+  // There's no dog. Nothing will bite.
+  return EFI_SUCCESS;
+} // HostSetWatchdogTimer()
+
+
+STATIC
+EFI_STATUS
+EFIAPI
+HostCalculateCrc32 (
+  IN  VOID      *Data,
+  IN  UINTN     DataSize,
+  OUT UINT32    *Crc32
+  )
+{
+  UINT8     *Bytes = Data;
+  UINT32    Crc = 0xFFFFFFFF;
+  UINTN     Index, Bit;
+
+  if (Data == NULL || DataSize == 0 || Crc32 == NULL)
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  // Nobody will be checksumming much on the host. Bitwise is fine.
+  for (Index = 0; Index < DataSize; Index++)
+  {
+    Crc ^= Bytes[Index];
+    for (Bit = 0; Bit < 8; Bit++)
+    {
+      Crc = (Crc >> 1) ^ (0xEDB88320 & (0 - (Crc & 1)));
+    }
+  }
+
+  *Crc32 = ~Crc;
+  return EFI_SUCCESS;
+} // HostCalculateCrc32()
+
+
+STATIC
+VOID
+EFIAPI
+HostCopyMem (
+  IN  VOID    *Destination,
+  IN  VOID    *Source,
+  IN  UINTN   Length
+  )
+{
+  CopyMem( Destination, Source, Length );
+} // HostCopyMem()
+
+
+STATIC
+VOID
+EFIAPI
+HostSetMem (
+  IN  VOID    *Buffer,
+  IN  UINTN   Size,
+  IN  UINT8   Value
+  )
+{
+  SetMem( Buffer, Size, Value );
+} // HostSetMem()
+
+
+///================================================================================================
+///================================================================================================
+///
+/// CONSOLE
+///
+///================================================================================================
+///================================================================================================
+
+
+STATIC EFI_SIMPLE_TEXT_OUTPUT_PROTOCOL  mConOut;
+STATIC EFI_SIMPLE_TEXT_OUTPUT_PROTOCOL  mStdErr;
+STATIC EFI_SIMPLE_TEXT_OUTPUT_MODE      mConsoleMode = { 1, 0, EFI_TEXT_ATTR( EFI_LIGHTGRAY, EFI_BLACK ), 0, 0, TRUE };
+
+STATIC
+EFI_STATUS
+EFIAPI
+HostConsoleReset (
+  IN  EFI_SIMPLE_TEXT_OUTPUT_PROTOCOL   *This,
+  IN  BOOLEAN                           ExtendedVerification
+  )
+{
+  return EFI_SUCCESS;
+} // HostConsoleReset()
+
+
+STATIC
+EFI_STATUS
+EFIAPI
+HostConsoleOutputString (
+  IN  EFI_SIMPLE_TEXT_OUTPUT_PROTOCOL   *This,
+  IN  CHAR16                            *String
+  )
+{
+  if (String == NULL)
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+  HostOsWriteConsole( This == &mStdErr, String );
+  return EFI_SUCCESS;
+} // HostConsoleOutputString()
+
+
+STATIC
+EFI_STATUS
+EFIAPI
+HostConsoleTestString (
+  IN  EFI_SIMPLE_TEXT_OUTPUT_PROTOCOL   *This,
+  IN  CHAR16                            *String
+  )
+{
+  return EFI_SUCCESS;
+} // HostConsoleTestString()
+
+
+STATIC
+EFI_STATUS
+EFIAPI
+HostConsoleQueryMode (
+  IN  EFI_SIMPLE_TEXT_OUTPUT_PROTOCOL   *This,
+  IN  UINTN                             ModeNumber,
+  OUT UINTN                             *Columns,
+  OUT UINTN                             *Rows
+  )
+{
+  if (ModeNumber != 0)
+  {
+    return EFI_UNSUPPORTED;
+  }
+  *Columns = 80;
+  *Rows    = 25;
+  return EFI_SUCCESS;
+} // HostConsoleQueryMode()
+
+
+STATIC
+EFI_STATUS
+EFIAPI
+HostConsoleSetMode (
+  IN  EFI_SIMPLE_TEXT_OUTPUT_PROTOCOL   *This,
+  IN  UINTN                             ModeNumber
+  )
+{
+  return (ModeNumber == 0) ? EFI_SUCCESS : EFI_UNSUPPORTED;
+} // HostConsoleSetMode()
+
+
+STATIC
+EFI_STATUS
+EFIAPI
+HostConsoleSetAttribute (
+  IN  EFI_SIMPLE_TEXT_OUTPUT_PROTOCOL   *This,
+  IN  UINTN                             Attribute
+  )
+{
+  This->Mode->Attribute = (INT32)Attribute;
+  return EFI_SUCCESS;
+} // HostConsoleSetAttribute()
+
+
+STATIC
+EFI_STATUS
+EFIAPI
+HostConsoleClearScreen (
+  IN  EFI_SIMPLE_TEXT_OUTPUT_PROTOCOL   *This
+  )
+{
+  // Don't wipe the terminal; test output is the whole point.
+  return EFI_SUCCESS;
+} // HostConsoleClearScreen()
+
+
+STATIC
+EFI_STATUS
+EFIAPI
+HostConsoleSetCursorPosition (
+  IN  EFI_SIMPLE_TEXT_OUTPUT_PROTOCOL   *This,
+  IN  UINTN                             Column,
+  IN  UINTN                             Row
+  )
+{
+  return EFI_SUCCESS;
+} // HostConsoleSetCursorPosition()
+
+
+STATIC
+EFI_STATUS
+EFIAPI
+HostConsoleEnableCursor (
+  IN  EFI_SIMPLE_TEXT_OUTPUT_PROTOCOL   *This,
+  IN  BOOLEAN                           Visible
+  )
+{
+  This->Mode->CursorVisible = Visible;
+  return EFI_SUCCESS;
+} // HostConsoleEnableCursor()
+
+
+///================================================================================================
+///================================================================================================
+///
+/// SERVICE TABLES
+///
+///================================================================================================
+///================================================================================================
+
+
+STATIC EFI_BOOT_SERVICES  mBootServices = {
+  .Hdr                  = { EFI_BOOT_SERVICES_SIGNATURE, EFI_BOOT_SERVICES_REVISION, sizeof( EFI_BOOT_SERVICES ), 0, 0 },
+  .RaiseTPL             = HostRaiseTpl,
+  .RestoreTPL           = HostRestoreTpl,
+  .AllocatePages        = HostAllocatePages,
+  .FreePages            = HostFreePages,
+  .GetMemoryMap         = HostGetMemoryMap,
+  .AllocatePool         = HostAllocatePool,
+  .FreePool             = HostFreePool,
+  .HandleProtocol       = HostHandleProtocol,
+  .Exit                 = HostExit,
+  .GetNextMonotonicCount = HostGetNextMonotonicCount,
+  .Stall                = HostStall,
+  .SetWatchdogTimer     = HostSetWatchdogTimer,
+  .OpenProtocol         = HostOpenProtocol,
+  .CloseProtocol        = HostCloseProtocol,
+  .LocateHandleBuffer   = HostLocateHandleBuffer,
+  .LocateProtocol       = HostLocateProtocol,
+  .CalculateCrc32       = HostCalculateCrc32,
+  .CopyMem              = HostCopyMem,
+  .SetMem               = HostSetMem,
+};
+
+STATIC EFI_RUNTIME_SERVICES mRuntimeServices = {
+  .Hdr                  = { EFI_RUNTIME_SERVICES_SIGNATURE, EFI_RUNTIME_SERVICES_REVISION, sizeof( EFI_RUNTIME_SERVICES ), 0, 0 },
+  .GetTime              = HostGetTime,
+  .GetVariable          = HostGetVariable,
+  .GetNextVariableName  = HostGetNextVariableName,
+  .SetVariable          = HostSetVariable,
+  .GetNextHighMonotonicCount = HostGetNextHighMonotonicCount,
+  .ResetSystem          = HostResetSystem,
+  .QueryVariableInfo    = HostQueryVariableInfo,
+};
+
+STATIC EFI_CONFIGURATION_TABLE mConfigurationTable[1];
+
+STATIC EFI_SYSTEM_TABLE mSystemTable = {
+  .Hdr                  = { EFI_SYSTEM_TABLE_SIGNATURE, EFI_SYSTEM_TABLE_REVISION, sizeof( EFI_SYSTEM_TABLE ), 0, 0 },
+  .FirmwareVendor       = L"UnitTestHost",
+  .FirmwareRevision     = 0x00010000,
+  .ConOut               = &mConOut,
+  .StdErr               = &mStdErr,
+  .RuntimeServices      = &mRuntimeServices,
+  .BootServices         = &mBootServices,
+  .NumberOfTableEntries = ARRAY_SIZE( mConfigurationTable ),
+  .ConfigurationTable   = mConfigurationTable,
+};
+
+
+EFI_STATUS
+EFIAPI
+UnitTestHostInitializeServices (
+  VOID
+  )
+{
+  EFI_SIMPLE_TEXT_OUTPUT_PROTOCOL   *Console[] = { &mConOut, &mStdErr };
+  CONST CHAR8                       *VariableFile;
+  CONST CHAR8                       *ImagePath;
+  UINTN                             Index, Size;
+
+  for (Index = 0; Index < ARRAY_SIZE( Console ); Index++)
+  {
+    Console[Index]->Reset             = HostConsoleReset;
+    Console[Index]->OutputString      = HostConsoleOutputString;
+    Console[Index]->TestString        = HostConsoleTestString;
+    Console[Index]->QueryMode         = HostConsoleQueryMode;
+    Console[Index]->SetMode           = HostConsoleSetMode;
+    Console[Index]->SetAttribute      = HostConsoleSetAttribute;
+    Console[Index]->ClearScreen       = HostConsoleClearScreen;
+    Console[Index]->SetCursorPosition = HostConsoleSetCursorPosition;
+    Console[Index]->EnableCursor      = HostConsoleEnableCursor;
+    Console[Index]->Mode              = &mConsoleMode;
+  }
+
+  gImageHandle = (EFI_HANDLE)&mImageHandle;
+  gST = &mSystemTable;
+  gBS = &mBootServices;
+  gRT = &mRuntimeServices;
+
+  //
+  // The loaded image points back at the runner, which is where the
+  // filesystem persistence lib will put its cache.
+  ImagePath = HostOsGetImagePath();
+  ZeroMem( &mLoadedImage, sizeof( mLoadedImage ) );
+  mLoadedImage.Revision      = EFI_LOADED_IMAGE_PROTOCOL_REVISION;
+  mLoadedImage.SystemTable   = gST;
+  mLoadedImage.DeviceHandle  = (EFI_HANDLE)&mDeviceHandle;
+  mLoadedImage.FilePath      = CreateImageFilePath( ImagePath );
+  mLoadedImage.ImageCodeType = EfiLoaderCode;
+  mLoadedImage.ImageDataType = EfiLoaderData;
+  if (mLoadedImage.FilePath == NULL)
+  {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  //
+  // Publish the MAT for anything that wants to compare it against the memory map.
+  CopyGuid( &mConfigurationTable[0].VendorGuid, &gEfiMemoryAttributesTableGuid );
+  mConfigurationTable[0].VendorTable = CreateMemoryAttributesTable();
+  if (mConfigurationTable[0].VendorTable == NULL)
+  {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  //
+  // The runner is "launched from the shell" with its own command line.
+  if (EFI_ERROR( CreateShellParameters() ))
+  {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  //
+  // Non-volatile variables live next to the runner unless told otherwise.
+  VariableFile = HostOsGetEnvironment( HOST_VARIABLE_FILE_VARIABLE );
+  if (VariableFile == NULL)
+  {
+    Size = AsciiStrSize( ImagePath ) + sizeof( HOST_VARIABLE_FILE_SUFFIX );
+    mVariableFilePath = HostOsAllocate( Size );
+    if (mVariableFilePath == NULL)
+    {
+      return EFI_OUT_OF_RESOURCES;
+    }
+    AsciiStrCpyS( mVariableFilePath, Size, ImagePath );
+    AsciiStrCatS( mVariableFilePath, Size, HOST_VARIABLE_FILE_SUFFIX );
+  }
+  else
+  {
+    Size = AsciiStrSize( VariableFile );
+    mVariableFilePath = HostOsAllocate( Size );
+    if (mVariableFilePath == NULL)
+    {
+      return EFI_OUT_OF_RESOURCES;
+    }
+    AsciiStrCpyS( mVariableFilePath, Size, VariableFile );
+  }
+  LoadVariableStore();
+
+  return EFI_SUCCESS;
+} // UnitTestHostInitializeServices()
@@ -0,0 +1,46 @@
+/** @file
+Finds where the files that go with a unit test app should live: next to the
+app itself, on the same filesystem. Used by the filesystem persistence lib
+for its cache and by UnitTestXmlReportLib for the report.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+
+
+Copyright (C) 2016 Microsoft Corporation. All Rights Reserved.
+
+**/
+
+#ifndef __UNIT_TEST_FILE_PATH_LIB_H__
+#define __UNIT_TEST_FILE_PATH_LIB_H__
+
+#include <Library/UnitTestLib.h>
+
+/**
+  Builds the device path of a file that lives next to the test app, named
+  "<ShortTitle><FileSuffix>".
+
+  @param[in]  FrameworkHandle   The framework that the file belongs to.
+  @param[in]  FileSuffix        Appended to the framework's ShortTitle to make the file name.
+
+  @retval     !NULL   A pool-allocated device path. Must be freed by the caller.
+  @retval     NULL    The app's location could not be determined or an error occurred.
+
+**/
+EFI_DEVICE_PATH_PROTOCOL*
+EFIAPI
+GetUnitTestFileDevicePath (
+  IN  UNIT_TEST_FRAMEWORK_HANDLE  FrameworkHandle,
+  IN  CONST CHAR16                *FileSuffix
+  );
+
+#endif // __UNIT_TEST_FILE_PATH_LIB_H__
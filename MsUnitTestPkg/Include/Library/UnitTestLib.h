@@ -1,393 +1,746 @@
-/** @file
-Provides a unit test framework.  This allows tests to focus on testing logic
-and the framework to focus on runnings, reporting, statistics, etc. 
-
-THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
-AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
-IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
-ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
-LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
-CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
-SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
-INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
-CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
-ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
-THE POSSIBILITY OF SUCH DAMAGE.
-
-
-Copyright (C) 2016 Microsoft Corporation. All Rights Reserved.
-
-**/
-
-#ifndef __UNIT_TEST_LIB_H__
-#define __UNIT_TEST_LIB_H__
-
-///================================================================================================
-///================================================================================================
-///
-/// HANDY DEFINITIONS
-///
-///================================================================================================
-///================================================================================================
-
-
-#define UNIT_TEST_MAX_STRING_LENGTH               (120)
-#define UNIT_TEST_MAX_SINGLE_LOG_STRING_LENGTH    (512)
-
-#define UNIT_TEST_FINGERPRINT_SIZE  16    // Hardcoded to MD5_HASHSIZE.
-
-typedef UINT32 UNIT_TEST_STATUS;
-#define UNIT_TEST_PASSED                      (0)
-#define UNIT_TEST_ERROR_PREREQ_NOT_MET        (1)
-#define UNIT_TEST_ERROR_TEST_FAILED           (2)
-#define UNIT_TEST_RUNNING                     (0xFFFFFFFE)
-#define UNIT_TEST_PENDING                     (0xFFFFFFFF)
-
-#define DEBUG_UT_VERBOSE     0x010000000  // Unit Test Verbose
-#define DEBUG_UT_INFO        0x020000000  // Unit Test Info
-#define DEBUG_UT_WARNING     0x040000000  // Unit Test Warning
-#define DEBUG_UT_ERROR       0x080000000  // Unit Test Error
-
-typedef VOID*   UNIT_TEST_FRAMEWORK_HANDLE; // Same as a UNIT_TEST_FRAMEWORK*, but with fewer build errors.
-typedef VOID*   UNIT_TEST_SUITE_HANDLE;     // Same as a UNIT_TEST_SUITE*, but with fewer build errors.
-typedef VOID*   UNIT_TEST_CONTEXT;
-
-
-///================================================================================================
-///================================================================================================
-///
-/// UNIT TEST FUNCTION TYPE DEFINITIONS
-///
-///================================================================================================
-///================================================================================================
-
-
-//
-// Unit-Test Function pointer type.
-//
-typedef
-UNIT_TEST_STATUS
-(EFIAPI *UNIT_TEST_FUNCTION) (
-  UNIT_TEST_FRAMEWORK_HANDLE  Framework,
-  UNIT_TEST_CONTEXT           Context
-  );
-
-//
-// Unit-Test Prerequisite Function pointer type.
-// NOTE: Should be the same as UnitTest.
-//
-typedef
-UNIT_TEST_STATUS
-(EFIAPI *UNIT_TEST_PREREQ) (
-  UNIT_TEST_FRAMEWORK_HANDLE  Framework,
-  UNIT_TEST_CONTEXT           Context
-  );
-
-//
-// Unit-Test Test Cleanup (after) function pointer type.
-//
-typedef
-VOID
-(EFIAPI *UNIT_TEST_CLEANUP) (
-  UNIT_TEST_FRAMEWORK_HANDLE  Framework
-  );
-
-//
-// Unit-Test Test Suite Setup (before) function pointer type.
-//
-typedef
-VOID
-(EFIAPI *UNIT_TEST_SUITE_SETUP) (
-  UNIT_TEST_FRAMEWORK_HANDLE  Framework
-  );
-
-//
-// Unit-Test Test Suite Teardown (after) function pointer type.
-//
-typedef
-VOID
-(EFIAPI *UNIT_TEST_SUITE_TEARDOWN) (
-  UNIT_TEST_FRAMEWORK_HANDLE  Framework
-  );
-
-
-///================================================================================================
-///================================================================================================
-///
-/// UNIT TEST DATA STRUCTURE DEFINITIONS
-///
-///================================================================================================
-///================================================================================================
-
-
-typedef struct {
-  CHAR16                    *Description;
-  CHAR16                    *Log;
-  UINT8                     Fingerprint[UNIT_TEST_FINGERPRINT_SIZE];
-  UNIT_TEST_STATUS          Result;
-  UNIT_TEST_FUNCTION        RunTest;
-  UNIT_TEST_PREREQ          PreReq;
-  UNIT_TEST_CLEANUP         CleanUp;
-  UNIT_TEST_CONTEXT         Context;
-  UNIT_TEST_SUITE_HANDLE    ParentSuite;
-} UNIT_TEST;
-
-typedef struct {
-  LIST_ENTRY    Entry;
-  UNIT_TEST     UT;
-} UNIT_TEST_LIST_ENTRY;
-
-typedef struct {
-  CHAR16                      *Title;
-  UINT8                       Fingerprint[UNIT_TEST_FINGERPRINT_SIZE];
-  UNIT_TEST_SUITE_SETUP       Setup;
-  UNIT_TEST_SUITE_TEARDOWN    Teardown;
-  LIST_ENTRY                  TestCaseList;     // UNIT_TEST_LIST_ENTRY
-  UNIT_TEST_FRAMEWORK_HANDLE  ParentFramework;
-} UNIT_TEST_SUITE;
-
-typedef struct {
-  LIST_ENTRY        Entry;
-  UNIT_TEST_SUITE   UTS;
-} UNIT_TEST_SUITE_LIST_ENTRY;
-
-typedef struct {
-  CHAR16                    *Title;
-  CHAR16                    *ShortTitle;      // This title should contain NO spaces or non-filename charatecters. Is used in reporting and serialization.
-  CHAR16                    *VersionString;
-  CHAR16                    *Log;
-  UINT8                     Fingerprint[UNIT_TEST_FINGERPRINT_SIZE];
-  LIST_ENTRY                TestSuiteList;    // UNIT_TEST_SUITE_LIST_ENTRY
-  EFI_TIME                  StartTime;
-  EFI_TIME                  EndTime;
-  UNIT_TEST                 *CurrentTest;
-  VOID                      *SavedState;      // This is an instance of UNIT_TEST_SAVE_HEADER*, if present.
-} UNIT_TEST_FRAMEWORK;
-
-
-///================================================================================================
-///================================================================================================
-///
-/// UNIT TEST LIBRARY FUNCTION PROTOTYPES
-///
-///================================================================================================
-///================================================================================================
-
-
-/*
-Method to Initialize the Unit Test framework
-
-@retval Success - Unit Test init.
-@retval EFI_ERROR - Unit Tests init failed.  
-*/
-EFI_STATUS
-EFIAPI
-InitUnitTestFramework (
-  OUT UNIT_TEST_FRAMEWORK   **Framework,
-  IN  CHAR16                *Title,
-  IN  CHAR16                *ShortTitle,
-  IN  CHAR16                *VersionString
-  );
-
-
-/*
-Method to print the Unit Test run results
-
-@retval Success
-*/
-EFI_STATUS
-EFIAPI
-PrintUnitTestReport(
-  IN UNIT_TEST_FRAMEWORK  *Framework
-);
-
-EFI_STATUS
-EFIAPI
-CreateUnitTestSuite (
-  OUT UNIT_TEST_SUITE           **Suite,
-  IN UNIT_TEST_FRAMEWORK        *Framework,
-  IN CHAR16                     *Title,
-  IN UNIT_TEST_SUITE_SETUP      Sup    OPTIONAL,
-  IN UNIT_TEST_SUITE_TEARDOWN   Tdn    OPTIONAL
-  );
-
-EFI_STATUS
-EFIAPI
-AddTestCase (
-  IN UNIT_TEST_SUITE      *Suite,
-  IN CHAR16               *Description,
-  IN UNIT_TEST_FUNCTION   Func,
-  IN UNIT_TEST_PREREQ     PreReq    OPTIONAL,
-  IN UNIT_TEST_CLEANUP    CleanUp   OPTIONAL,
-  IN UNIT_TEST_CONTEXT    Context   OPTIONAL
-  );
-
-EFI_STATUS
-EFIAPI
-RunAllTestSuites(
-  IN UNIT_TEST_FRAMEWORK  *Framework
-  );
-
-EFI_STATUS
-EFIAPI
-FreeUnitTestFramework (
-  IN UNIT_TEST_FRAMEWORK  *Framework
-  );
-
-EFI_STATUS
-EFIAPI
-SaveFrameworkState (
-  IN UNIT_TEST_FRAMEWORK_HANDLE FrameworkHandle,
-  IN UNIT_TEST_CONTEXT          ContextToSave     OPTIONAL,
-  IN UINTN                      ContextToSaveSize
-  );
-
-EFI_STATUS
-EFIAPI
-SaveFrameworkStateAndQuit (
-  IN UNIT_TEST_FRAMEWORK_HANDLE Framework,
-  IN UNIT_TEST_CONTEXT          ContextToSave     OPTIONAL,
-  IN UINTN                      ContextToSaveSize
-  );
-
-/**
-  NOTE: Takes in a ResetType, but currently only supports EfiResetCold
-        and EfiResetWarm. All other types will return EFI_INVALID_PARAMETER.
-        If a more specific reset is required, use SaveFrameworkState() and
-        call gRT->ResetSystem() directly.
-
-**/
-EFI_STATUS
-EFIAPI
-SaveFrameworkStateAndReboot (
-  IN UNIT_TEST_FRAMEWORK_HANDLE FrameworkHandle,
-  IN UNIT_TEST_CONTEXT          ContextToSave     OPTIONAL,
-  IN UINTN                      ContextToSaveSize,
-  IN EFI_RESET_TYPE             ResetType
-  );
-
-
-///================================================================================================
-///================================================================================================
-///
-/// UNIT TEST LOGGING DEFINITIONS AND FUNCTIONS
-///
-///================================================================================================
-///================================================================================================
-
-
-// IMPORTANT NOTE: These macros should ONLY be used in a Unit Test.
-//                 They will consume the Framework Handle and update the Framework->CurrentTest.
-
-#define UT_LOG_ERROR(Format, ...)              \
-  UnitTestLog( Framework, DEBUG_ERROR, Format, __VA_ARGS__ );
-#define UT_LOG_WARNING(Format, ...)            \
-  UnitTestLog( Framework, DEBUG_WARN, Format, __VA_ARGS__ );
-#define UT_LOG_INFO(Format, ...)               \
-  UnitTestLog( Framework, DEBUG_INFO, Format, __VA_ARGS__ );
-#define UT_LOG_VERBOSE(Format, ...)            \
-  UnitTestLog( Framework, DEBUG_VERBOSE, Format, __VA_ARGS__ );
-
-VOID
-EFIAPI
-UnitTestLog (
-  IN  UNIT_TEST_FRAMEWORK_HANDLE  Framework,
-  IN  UINTN                       ErrorLevel,
-  IN  CONST CHAR8                 *Format,
-  ...
-  );
-
-// NOTE: Thoughts...
-//        *Could* pass the framework in and actually update the test status if one of these assertions fails.
-//        In this way, a unit test wouldn't have to return a status; it would just make one or more assertions.
-//        If any of these assertions fails, the test will automatically be marked as a failure.
-//
-//        For now, I think we'll just have these return TRUE or FALSE so that we can use if()...
-//        and update the test status based of of the if().
-
-// TODO: UT_CUSTOM_FAILURE
-
-#define UT_ASSERT_TRUE(Expression)                \
-  UnitTestAssertTrue( Framework, (Expression), __FUNCTION__, __LINE__, #Expression )
-
-#define UT_ASSERT_FALSE(Expression)               \
-  UnitTestAssertFalse( Framework, (Expression), __FUNCTION__, __LINE__, #Expression )
-
-#define UT_ASSERT_EQUAL(ValueA, ValueB)           \
-  UnitTestAssertEqual( Framework, ValueA, ValueB, __FUNCTION__, __LINE__, #ValueA, #ValueB )
-
-#define UT_ASSERT_NOT_EQUAL(ValueA, ValueB)       \
-  UnitTestAssertNotEqual( Framework, ValueA, ValueB, __FUNCTION__, __LINE__, #ValueA, #ValueB )
-
-#define UT_ASSERT_NOT_EFI_ERROR(Status)           \
-  UnitTestAssertNotEfiError( Framework, Status, __FUNCTION__, __LINE__, #Status )
-
-#define UT_ASSERT_STATUS_EQUAL(Status, Expected)  \
-  UnitTestAssertStatusEqual( Framework, Status, Expected, __FUNCTION__, __LINE__, #Status )
-
-BOOLEAN
-EFIAPI
-UnitTestAssertTrue (
-  IN UNIT_TEST_FRAMEWORK_HANDLE Framework,
-  IN BOOLEAN                    Expression,
-  IN CONST CHAR8                *FunctionName,
-  IN UINTN                      LineNumber,
-  IN CONST CHAR8                *Description
-  );
-
-BOOLEAN
-EFIAPI
-UnitTestAssertFalse (
-  IN UNIT_TEST_FRAMEWORK_HANDLE Framework,
-  IN BOOLEAN                    Expression,
-  IN CONST CHAR8                *FunctionName,
-  IN UINTN                      LineNumber,
-  IN CONST CHAR8                *Description
-  );
-
-BOOLEAN
-EFIAPI
-UnitTestAssertNotEfiError (
-  IN UNIT_TEST_FRAMEWORK_HANDLE Framework,
-  IN EFI_STATUS                 Status,
-  IN CONST CHAR8                *FunctionName,
-  IN UINTN                      LineNumber,
-  IN CONST CHAR8                *Description
-  );
-
-BOOLEAN
-EFIAPI
-UnitTestAssertEqual (
-  IN UNIT_TEST_FRAMEWORK_HANDLE Framework,
-  IN UINTN                      ValueA,
-  IN UINTN                      ValueB,
-  IN CONST CHAR8                *FunctionName,
-  IN UINTN                      LineNumber,
-  IN CONST CHAR8                *DescriptionA,
-  IN CONST CHAR8                *DescriptionB
-  );
-
-BOOLEAN
-EFIAPI
-UnitTestAssertNotEqual (
-  IN UNIT_TEST_FRAMEWORK_HANDLE Framework,
-  IN UINTN                      ValueA,
-  IN UINTN                      ValueB,
-  IN CONST CHAR8                *FunctionName,
-  IN UINTN                      LineNumber,
-  IN CONST CHAR8                *DescriptionA,
-  IN CONST CHAR8                *DescriptionB
-  );
-
-BOOLEAN
-EFIAPI
-UnitTestAssertStatusEqual (
-  IN UNIT_TEST_FRAMEWORK_HANDLE Framework,
-  IN EFI_STATUS                 Status,
-  IN EFI_STATUS                 Expected,
-  IN CONST CHAR8                *FunctionName,
-  IN UINTN                      LineNumber,
-  IN CONST CHAR8                *Description
-  );
-
+/** @file
+Provides a unit test framework.  This allows tests to focus on testing logic
+and the framework to focus on runnings, reporting, statistics, etc. 
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+
+
+Copyright (C) 2016 Microsoft Corporation. All Rights Reserved.
+
+**/
+
+#ifndef __UNIT_TEST_LIB_H__
+#define __UNIT_TEST_LIB_H__
+
+#include <Library/PcdLib.h>
+#include <Protocol/SimpleFileSystem.h>
+
+///================================================================================================
+///================================================================================================
+///
+/// HANDY DEFINITIONS
+///
+///================================================================================================
+///================================================================================================
+
+
+#define UNIT_TEST_MAX_STRING_LENGTH               (120)
+#define UNIT_TEST_MAX_SINGLE_LOG_STRING_LENGTH    (512)
+
+#define UNIT_TEST_FINGERPRINT_SIZE  16    // Every PcdUnitTestFingerprintAlgorithm produces 128 bits.
+
+typedef UINT32 UNIT_TEST_STATUS;
+#define UNIT_TEST_PASSED                      (0)
+#define UNIT_TEST_ERROR_PREREQ_NOT_MET        (1)
+#define UNIT_TEST_ERROR_TEST_FAILED           (2)
+#define UNIT_TEST_SKIPPED                     (3)   // Not selected by the command-line test filters.
+#define UNIT_TEST_ERROR_PERF_REGRESSION       (4)   // Passed, but ran too far over its baseline. See PcdUnitTestPerfRegressionThreshold.
+#define UNIT_TEST_RUNNING                     (0xFFFFFFFE)
+#define UNIT_TEST_PENDING                     (0xFFFFFFFF)
+
+//
+// Test attributes, for use with AddTestCaseEx().
+//
+#define UNIT_TEST_ATTRIBUTE_AP_SAFE           BIT0  // RunTest only reads shared state, logs through UT_LOG/UT_ASSERT,
+                                                    // and never saves or reboots, so it may run on an AP.
+#define UNIT_TEST_ATTRIBUTE_REQUIRES_CLEAN_BOOT BIT1 // RunTest must start on a boot that no other clean-boot test has run on,
+                                                    // and leaves the boot unfit for any test after it. See AddTestCaseEx().
+
+#define DEBUG_UT_VERBOSE     0x010000000  // Unit Test Verbose
+#define DEBUG_UT_INFO        0x020000000  // Unit Test Info
+#define DEBUG_UT_WARNING     0x040000000  // Unit Test Warning
+#define DEBUG_UT_ERROR       0x080000000  // Unit Test Error
+
+typedef VOID*   UNIT_TEST_FRAMEWORK_HANDLE; // Same as a UNIT_TEST_FRAMEWORK*, but with fewer build errors.
+typedef VOID*   UNIT_TEST_SUITE_HANDLE;     // Same as a UNIT_TEST_SUITE*, but with fewer build errors.
+typedef VOID*   UNIT_TEST_CONTEXT;
+
+
+///================================================================================================
+///================================================================================================
+///
+/// UNIT TEST FUNCTION TYPE DEFINITIONS
+///
+///================================================================================================
+///================================================================================================
+
+
+//
+// Unit-Test Function pointer type.
+//
+typedef
+UNIT_TEST_STATUS
+(EFIAPI *UNIT_TEST_FUNCTION) (
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework,
+  UNIT_TEST_CONTEXT           Context
+  );
+
+//
+// Unit-Test Prerequisite Function pointer type.
+// NOTE: Should be the same as UnitTest.
+//
+typedef
+UNIT_TEST_STATUS
+(EFIAPI *UNIT_TEST_PREREQ) (
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework,
+  UNIT_TEST_CONTEXT           Context
+  );
+
+//
+// Unit-Test Test Cleanup (after) function pointer type.
+//
+typedef
+VOID
+(EFIAPI *UNIT_TEST_CLEANUP) (
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework
+  );
+
+//
+// Unit-Test Test Suite Setup (before) function pointer type.
+//
+typedef
+VOID
+(EFIAPI *UNIT_TEST_SUITE_SETUP) (
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework
+  );
+
+//
+// Unit-Test Test Suite Teardown (after) function pointer type.
+//
+typedef
+VOID
+(EFIAPI *UNIT_TEST_SUITE_TEARDOWN) (
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework
+  );
+
+
+///================================================================================================
+///================================================================================================
+///
+/// UNIT TEST DATA STRUCTURE DEFINITIONS
+///
+///================================================================================================
+///================================================================================================
+
+
+//
+// Per-test log storage.
+// Logs are append-only, so rather than one contiguous string that must be
+// reallocated on every append, they are kept as a chain of chunks. Each new
+// chunk is larger than the last, which keeps appends amortized O(1).
+// Every chunk buffer is NULL-terminated so it can be handed straight to ConOut.
+// With PcdUnitTestDeferredLogFormatting, UnitTestLog() calls are kept as
+// unformatted records until something reads the log.
+// A log restored from the cache is left where it is in the framework's
+// SavedState, as a single full chunk, and is only copied out if the test
+// logs anything more.
+//
+typedef struct _UNIT_TEST_LOG_CHUNK UNIT_TEST_LOG_CHUNK;
+struct _UNIT_TEST_LOG_CHUNK {
+  UNIT_TEST_LOG_CHUNK       *Next;
+  UINTN                     Length;           // Number of CHAR16s in use, not counting the NULL.
+  UINTN                     Size;             // Number of CHAR16s available, not counting the NULL.
+  CHAR16                    *Buffer;
+};
+
+typedef struct {
+  UNIT_TEST_LOG_CHUNK       *Head;
+  UNIT_TEST_LOG_CHUNK       *Tail;
+  UINTN                     Length;           // Total number of CHAR16s across all chunks.
+  VOID                      *DeferredHead;    // UNIT_TEST_LOG_RECORD*s that still need formatting, oldest first.
+  VOID                      *DeferredTail;
+  BOOLEAN                   Borrowed;         // Head is the saved log, still in place in SavedState.
+} UNIT_TEST_LOG;
+
+//
+// Per-operation statistics for a benchmark case. Times are kept in picoseconds
+// so that operations that only take a few nanoseconds still resolve.
+//
+typedef struct {
+  UINT32                    Iterations;       // Timed samples requested by AddBenchmarkCase().
+  UINT32                    Samples;          // Timed samples actually taken. Zero until the benchmark has run.
+  UINT32                    OpsPerSample;     // Calls per sample, so that each sample is well above the counter resolution.
+  UINT64                    MinPicoSeconds;
+  UINT64                    MedianPicoSeconds;
+  UINT64                    P99PicoSeconds;
+  UINT64                    MaxPicoSeconds;
+  UINT64                    MeanPicoSeconds;
+} UNIT_TEST_BENCHMARK;
+
+typedef struct {
+  CHAR16                    *Description;
+  UNIT_TEST_LOG             Log;
+  UINT8                     Fingerprint[UNIT_TEST_FINGERPRINT_SIZE];
+  UNIT_TEST_STATUS          Result;
+  UNIT_TEST_FUNCTION        RunTest;
+  UNIT_TEST_PREREQ          PreReq;
+  UNIT_TEST_CLEANUP         CleanUp;
+  UNIT_TEST_CONTEXT         Context;
+  UINT32                    Attributes;       // UNIT_TEST_ATTRIBUTE_*
+  UNIT_TEST_SUITE_HANDLE    ParentSuite;
+  UINT64                    PreReqDuration;   // In nanoseconds. Test durations accumulate across saves and reboots.
+  UINT64                    RunDuration;
+  UINT64                    CleanUpDuration;
+  UNIT_TEST_BENCHMARK       *Benchmark;       // Only set for cases added with AddBenchmarkCase().
+  UNIT_TEST_STATUS          SavedResult;      // Result and log length as of the last save, so that only
+  UINTN                     SavedLogLength;   // the tests that have changed are appended to the cache.
+} UNIT_TEST;
+
+typedef struct {
+  LIST_ENTRY    Entry;
+  UNIT_TEST     UT;
+} UNIT_TEST_LIST_ENTRY;
+
+typedef struct {
+  CHAR16                      *Title;
+  UINT8                       Fingerprint[UNIT_TEST_FINGERPRINT_SIZE];
+  UNIT_TEST_SUITE_SETUP       Setup;
+  UNIT_TEST_SUITE_TEARDOWN    Teardown;
+  LIST_ENTRY                  TestCaseList;     // UNIT_TEST_LIST_ENTRY
+  UNIT_TEST_FRAMEWORK_HANDLE  ParentFramework;
+  VOID                        *FingerprintCtx;  // Hash state with Fingerprint already absorbed. Each test starts from a copy.
+  UINT64                      SetupDuration;    // In nanoseconds, for this boot only.
+  UINT64                      TeardownDuration;
+  UINT32                      PendingCount;     // Selected tests that still have to run.
+  UNIT_TEST_LIST_ENTRY        *FirstPending;    // Where the run over the suite starts. NULL when nothing is pending.
+} UNIT_TEST_SUITE;
+
+typedef struct {
+  LIST_ENTRY        Entry;
+  UNIT_TEST_SUITE   UTS;
+} UNIT_TEST_SUITE_LIST_ENTRY;
+
+//
+// Bump-pointer arena that owns all of the memory for a framework.
+// Memory is carved out of page-sized blocks and is only ever released
+// all at once by FreeUnitTestFramework().
+//
+typedef struct {
+  VOID                      *Blocks;          // Most recent block. Each block links to the one before it.
+  UINT8                     *Cursor;          // Next free byte in the most recent block.
+  UINTN                     Remaining;        // Bytes left behind the Cursor.
+} UNIT_TEST_ARENA;
+
+typedef struct {
+  CHAR16                    *Title;
+  CHAR16                    *ShortTitle;      // This title should contain NO spaces or non-filename charatecters. Is used in reporting and serialization.
+  CHAR16                    *VersionString;
+  CHAR16                    *Log;
+  UINT8                     Fingerprint[UNIT_TEST_FINGERPRINT_SIZE];
+  VOID                      *FingerprintCtx;  // Hash state with Fingerprint already absorbed. Each suite starts from a copy.
+  LIST_ENTRY                TestSuiteList;    // UNIT_TEST_SUITE_LIST_ENTRY
+  EFI_TIME                  StartTime;
+  EFI_TIME                  EndTime;
+  UNIT_TEST                 *CurrentTest;
+  UINT64                    *ActiveTimer;     // Duration that is currently being timed, if any.
+  UINT64                    ActiveTimerStart; // Performance counter value when ActiveTimer was (re)started.
+  VOID                      *SavedState;      // This is an instance of UNIT_TEST_SAVE_HEADER*, if present.
+  VOID                      **SavedTestIndex; // Open-addressed table of UNIT_TEST_SAVE_TEST* in SavedState, keyed on fingerprint.
+  UINTN                     SavedTestIndexSize; // Number of slots in SavedTestIndex. Always a power of two.
+  VOID                      *SavedContext;    // The UNIT_TEST_SAVE_CONTEXT* in SavedState, if present.
+  UNIT_TEST                 *SavedContextTest; // The test that was handed the saved context, until it has run.
+  UINTN                     SavedStateReferences; // The index, borrowed logs and saved context. SavedState is freed at zero.
+  UNIT_TEST_ARENA           Arena;            // Backs the framework itself and all of its suites, tests and logs.
+  CHAR16                    **IncludeFilters; // Glob patterns from the command line, matched against
+  UINTN                     IncludeFilterCount; // "ShortTitle/Suite Title/Test Description".
+  CHAR16                    **ExcludeFilters;
+  UINTN                     ExcludeFilterCount;
+  VOID                      *ApScheduler;     // UNIT_TEST_AP_SCHEDULER*, if AP-safe tests can be run in parallel.
+  VOID                      *Baseline;        // UNIT_TEST_BASELINE_HEADER* from the persistence lib, if present.
+  VOID                      **BaselineIndex;  // Open-addressed table of UNIT_TEST_BASELINE_ENTRY* in Baseline, keyed on fingerprint.
+  UINTN                     BaselineIndexSize; // Number of slots in BaselineIndex. Always a power of two.
+  VOID                      *NewBaselineEntries; // UNIT_TEST_BASELINE_NODE*s for tests that weren't in Baseline yet.
+  UINT32                    NewBaselineEntryCount;
+  BOOLEAN                   BaselineChanged;  // Something has been folded in since the baseline was last saved.
+  BOOLEAN                   BootIsDirty;      // A clean-boot test has run since the last reboot.
+  BOOLEAN                   CacheIsJournaled; // The cache holds everything up to the last save, so the next one only appends changes.
+  UINT32                    CleanBootTestCount; // Clean-boot tests that have run.
+  UINT32                    CleanBootRebootCount; // Reboots the framework has made to clean up after them.
+  VOID                      *PersistenceSession; // Private to the persistence lib. Released by CloseUnitTestPersistence().
+} UNIT_TEST_FRAMEWORK;
+
+
+///================================================================================================
+///================================================================================================
+///
+/// UNIT TEST LIBRARY FUNCTION PROTOTYPES
+///
+///================================================================================================
+///================================================================================================
+
+
+/*
+Method to Initialize the Unit Test framework
+
+If the app was launched from the shell, its command line is scanned for test filters:
+  -i | -include PATTERN   Only run tests that match PATTERN. May be repeated.
+  -x | -exclude PATTERN   Never run tests that match PATTERN. May be repeated.
+Patterns are case-insensitive globs ('*' and '?') matched against
+"ShortTitle/Suite Title/Test Description". Tests that are filtered out are
+reported as UNIT_TEST_SKIPPED. Other arguments are left for the app.
+
+@retval Success - Unit Test init.
+@retval EFI_ERROR - Unit Tests init failed.  
+*/
+EFI_STATUS
+EFIAPI
+InitUnitTestFramework (
+  OUT UNIT_TEST_FRAMEWORK   **Framework,
+  IN  CHAR16                *Title,
+  IN  CHAR16                *ShortTitle,
+  IN  CHAR16                *VersionString
+  );
+
+
+/*
+Method to print the Unit Test run results
+
+@retval Success
+*/
+EFI_STATUS
+EFIAPI
+PrintUnitTestReport(
+  IN UNIT_TEST_FRAMEWORK  *Framework
+);
+
+/**
+  Writes the same report that PrintUnitTestReport() prints to an open file,
+  as UCS-2 text with a byte order mark. The file is written from its current
+  position and is not flushed or closed.
+
+  @retval     EFI_SUCCESS   The whole report was written.
+  @retval     Others        The first error returned by File->Write().
+
+**/
+EFI_STATUS
+EFIAPI
+WriteUnitTestReport (
+  IN UNIT_TEST_FRAMEWORK  *Framework,
+  IN EFI_FILE_PROTOCOL    *File
+  );
+
+/**
+  Formats the UnitTestLog() calls that PcdUnitTestDeferredLogFormatting held
+  back, so every test's Log is complete. The framework's own reports do this
+  themselves; anything else that reads UNIT_TEST.Log must call this first.
+
+**/
+VOID
+EFIAPI
+RenderDeferredUnitTestLogs (
+  IN UNIT_TEST_FRAMEWORK  *Framework
+  );
+
+/**
+  Returns the name that the reports use for a test result, such as "PASSED".
+
+**/
+CONST CHAR8*
+EFIAPI
+GetUnitTestStatusString (
+  IN UNIT_TEST_STATUS     Status
+  );
+
+EFI_STATUS
+EFIAPI
+CreateUnitTestSuite (
+  OUT UNIT_TEST_SUITE           **Suite,
+  IN UNIT_TEST_FRAMEWORK        *Framework,
+  IN CHAR16                     *Title,
+  IN UNIT_TEST_SUITE_SETUP      Sup    OPTIONAL,
+  IN UNIT_TEST_SUITE_TEARDOWN   Tdn    OPTIONAL
+  );
+
+EFI_STATUS
+EFIAPI
+AddTestCase (
+  IN UNIT_TEST_SUITE      *Suite,
+  IN CHAR16               *Description,
+  IN UNIT_TEST_FUNCTION   Func,
+  IN UNIT_TEST_PREREQ     PreReq    OPTIONAL,
+  IN UNIT_TEST_CLEANUP    CleanUp   OPTIONAL,
+  IN UNIT_TEST_CONTEXT    Context   OPTIONAL
+  );
+
+/**
+  Same as AddTestCase(), but takes UNIT_TEST_ATTRIBUTE_* flags.
+
+  Runs of consecutive UNIT_TEST_ATTRIBUTE_AP_SAFE tests in a suite are
+  spread across the APs with EFI_MP_SERVICES_PROTOCOL. Their PreReqs are
+  all run on the BSP before the run is dispatched, and their CleanUps are
+  all run on the BSP afterwards. Without MP services (or with only one
+  enabled processor) the attribute is ignored and everything runs serially.
+
+  UNIT_TEST_ATTRIBUTE_REQUIRES_CLEAN_BOOT tests run in the order they were
+  added, like any other test, but nothing else runs on a boot that one of them
+  has been through. Before the next test runs, and once more after the last
+  one, the framework saves its state and reboots. If the clean-boot test (or
+  its CleanUp) has already rebooted on its own, the framework doesn't add
+  another. Tests are never moved around to share a reboot. A clean-boot test
+  leaves the boot unfit for everything after it, so the only tests that can
+  share its boot are the ones that ran before it, and those already have.
+  Tests without the attribute must leave the system as they found it, or
+  reboot to put it back. A test can't be both AP-safe and require a clean boot.
+
+**/
+EFI_STATUS
+EFIAPI
+AddTestCaseEx (
+  IN UNIT_TEST_SUITE      *Suite,
+  IN CHAR16               *Description,
+  IN UNIT_TEST_FUNCTION   Func,
+  IN UNIT_TEST_PREREQ     PreReq    OPTIONAL,
+  IN UNIT_TEST_CLEANUP    CleanUp   OPTIONAL,
+  IN UNIT_TEST_CONTEXT    Context   OPTIONAL,
+  IN UINT32               Attributes
+  );
+
+/**
+  Adds a microbenchmark to the suite. Instead of being called once, Func is
+  called repeatedly and timed with the performance counter:
+
+    - Calls are batched so that each sample spans enough counter ticks for
+      the counter resolution not to matter, and the cost of reading the
+      counter is measured and subtracted.
+    - The calibration and a few untimed samples warm up caches and branch
+      predictors before Iterations timed samples are taken.
+    - Min/median/p99/max/mean time per call is recorded in Test->Benchmark,
+      shown by PrintUnitTestReport() and persisted like any other result.
+
+  Func must return UNIT_TEST_PASSED on every call; anything else stops the
+  benchmark and becomes its result. It must not save or reboot.
+
+  @retval     EFI_INVALID_PARAMETER   Iterations is zero.
+
+**/
+EFI_STATUS
+EFIAPI
+AddBenchmarkCase (
+  IN UNIT_TEST_SUITE      *Suite,
+  IN CHAR16               *Description,
+  IN UNIT_TEST_FUNCTION   Func,
+  IN UNIT_TEST_CONTEXT    Context   OPTIONAL,
+  IN UINT32               Iterations
+  );
+
+EFI_STATUS
+EFIAPI
+RunAllTestSuites(
+  IN UNIT_TEST_FRAMEWORK  *Framework
+  );
+
+EFI_STATUS
+EFIAPI
+FreeUnitTestFramework (
+  IN UNIT_TEST_FRAMEWORK  *Framework
+  );
+
+EFI_STATUS
+EFIAPI
+SaveFrameworkState (
+  IN UNIT_TEST_FRAMEWORK_HANDLE FrameworkHandle,
+  IN UNIT_TEST_CONTEXT          ContextToSave     OPTIONAL,
+  IN UINTN                      ContextToSaveSize
+  );
+
+/**
+  NOTE: Nothing runs after a successful gBS->Exit(), so the framework is freed
+        first. Once the state has been saved, the framework is gone, even if
+        this returns EFI_ABORTED because the exit didn't happen. The handle
+        must not be used again. Any other error means that nothing was saved
+        and the framework is still valid.
+
+**/
+EFI_STATUS
+EFIAPI
+SaveFrameworkStateAndQuit (
+  IN UNIT_TEST_FRAMEWORK_HANDLE Framework,
+  IN UNIT_TEST_CONTEXT          ContextToSave     OPTIONAL,
+  IN UINTN                      ContextToSaveSize
+  );
+
+/**
+  NOTE: Takes in a ResetType, but currently only supports EfiResetCold
+        and EfiResetWarm. All other types will return EFI_INVALID_PARAMETER.
+        If a more specific reset is required, use SaveFrameworkState() and
+        call gRT->ResetSystem() directly.
+
+  NOTE: The framework is not freed on the way down. If this returns at all,
+        the framework is still valid. EFI_ABORTED means that the state was
+        saved, but the reset didn't happen.
+
+**/
+EFI_STATUS
+EFIAPI
+SaveFrameworkStateAndReboot (
+  IN UNIT_TEST_FRAMEWORK_HANDLE FrameworkHandle,
+  IN UNIT_TEST_CONTEXT          ContextToSave     OPTIONAL,
+  IN UINTN                      ContextToSaveSize,
+  IN EFI_RESET_TYPE             ResetType
+  );
+
+
+///================================================================================================
+///================================================================================================
+///
+/// UNIT TEST LOGGING DEFINITIONS AND FUNCTIONS
+///
+///================================================================================================
+///================================================================================================
+
+
+// IMPORTANT NOTE: These macros should ONLY be used in a Unit Test.
+//                 They will consume the Framework Handle and update the Framework->CurrentTest.
+//
+// NOTE: With PcdUnitTestDeferredLogFormatting (the default), the Format string is kept
+//       by pointer and only formatted when the log is read, so it must be a string
+//       literal or otherwise outlive the test. Arguments are copied when the call is made.
+//
+// NOTE: Levels that aren't in PcdUnitTestLogLevel are compiled out completely, arguments
+//       and all. Any module that uses these macros must list the PCD under [FixedPcd].
+//       Levels that are compiled in are still filtered by the library at runtime.
+
+#define UT_LOG_LEVEL_ENABLED(Level)            \
+  ((FixedPcdGet32( PcdUnitTestLogLevel ) & (Level)) != 0)
+
+#define UT_LOG_ERROR(Format, ...)              \
+  do { if (UT_LOG_LEVEL_ENABLED( DEBUG_ERROR )) { UnitTestLog( Framework, DEBUG_ERROR, Format, ##__VA_ARGS__ ); } } while (FALSE)
+#define UT_LOG_WARNING(Format, ...)            \
+  do { if (UT_LOG_LEVEL_ENABLED( DEBUG_WARN )) { UnitTestLog( Framework, DEBUG_WARN, Format, ##__VA_ARGS__ ); } } while (FALSE)
+#define UT_LOG_INFO(Format, ...)               \
+  do { if (UT_LOG_LEVEL_ENABLED( DEBUG_INFO )) { UnitTestLog( Framework, DEBUG_INFO, Format, ##__VA_ARGS__ ); } } while (FALSE)
+#define UT_LOG_VERBOSE(Format, ...)            \
+  do { if (UT_LOG_LEVEL_ENABLED( DEBUG_VERBOSE )) { UnitTestLog( Framework, DEBUG_VERBOSE, Format, ##__VA_ARGS__ ); } } while (FALSE)
+
+VOID
+EFIAPI
+UnitTestLog (
+  IN  UNIT_TEST_FRAMEWORK_HANDLE  Framework,
+  IN  UINTN                       ErrorLevel,
+  IN  CONST CHAR8                 *Format,
+  ...
+  );
+
+// NOTE: Thoughts...
+//        *Could* pass the framework in and actually update the test status if one of these assertions fails.
+//        In this way, a unit test wouldn't have to return a status; it would just make one or more assertions.
+//        If any of these assertions fails, the test will automatically be marked as a failure.
+//
+//        For now, I think we'll just have these return TRUE or FALSE so that we can use if()...
+//        and update the test status based of of the if().
+
+// TODO: UT_CUSTOM_FAILURE
+
+//
+// The assertion macros do their comparison inline, at the call site, and only call
+// into the library when an assertion fails. A passing assertion costs no more than
+// the comparison itself. The library functions are the failure paths, so they are
+// marked cold (GCC and Clang move them to .text.unlikely) and never inlined.
+//
+#if defined (__GNUC__) || defined (__clang__)
+#define UNIT_TEST_INLINE    __inline__ __attribute__((always_inline))
+#define UNIT_TEST_COLD      __attribute__((cold, noinline))
+#elif defined (_MSC_EXTENSIONS)
+#define UNIT_TEST_INLINE    __forceinline
+#define UNIT_TEST_COLD      __declspec(noinline)
+#elif defined (__STDC_VERSION__) && (__STDC_VERSION__ >= 199901L)
+#define UNIT_TEST_INLINE    inline
+#define UNIT_TEST_COLD
+#else
+// Pre-C99 compilers still need some inline hint, or every includer gets an
+// unused STATIC function for each helper it doesn't call.
+#define UNIT_TEST_INLINE    __inline
+#define UNIT_TEST_COLD
+#endif
+
+#define UT_ASSERT_TRUE(Expression)                \
+  ((Expression) ? TRUE : UnitTestAssertTrue( Framework, FALSE, __FUNCTION__, __LINE__, #Expression ))
+
+#define UT_ASSERT_FALSE(Expression)               \
+  ((Expression) ? UnitTestAssertFalse( Framework, TRUE, __FUNCTION__, __LINE__, #Expression ) : TRUE)
+
+#define UT_ASSERT_EQUAL(ValueA, ValueB)           \
+  UnitTestAssertEqualInline( Framework, ValueA, ValueB, __FUNCTION__, __LINE__, #ValueA, #ValueB )
+
+#define UT_ASSERT_NOT_EQUAL(ValueA, ValueB)       \
+  UnitTestAssertNotEqualInline( Framework, ValueA, ValueB, __FUNCTION__, __LINE__, #ValueA, #ValueB )
+
+#define UT_ASSERT_NOT_EFI_ERROR(Status)           \
+  UnitTestAssertNotEfiErrorInline( Framework, Status, __FUNCTION__, __LINE__, #Status )
+
+#define UT_ASSERT_STATUS_EQUAL(Status, Expected)  \
+  UnitTestAssertStatusEqualInline( Framework, Status, Expected, __FUNCTION__, __LINE__, #Status )
+
+#define UT_ASSERT_MEM_EQUAL(BufferA, BufferB, Length)  \
+  UnitTestAssertMemEqual( Framework, BufferA, BufferB, Length, __FUNCTION__, __LINE__, #BufferA, #BufferB )
+
+UNIT_TEST_COLD
+BOOLEAN
+EFIAPI
+UnitTestAssertTrue (
+  IN UNIT_TEST_FRAMEWORK_HANDLE Framework,
+  IN BOOLEAN                    Expression,
+  IN CONST CHAR8                *FunctionName,
+  IN UINTN                      LineNumber,
+  IN CONST CHAR8                *Description
+  );
+
+UNIT_TEST_COLD
+BOOLEAN
+EFIAPI
+UnitTestAssertFalse (
+  IN UNIT_TEST_FRAMEWORK_HANDLE Framework,
+  IN BOOLEAN                    Expression,
+  IN CONST CHAR8                *FunctionName,
+  IN UINTN                      LineNumber,
+  IN CONST CHAR8                *Description
+  );
+
+UNIT_TEST_COLD
+BOOLEAN
+EFIAPI
+UnitTestAssertNotEfiError (
+  IN UNIT_TEST_FRAMEWORK_HANDLE Framework,
+  IN EFI_STATUS                 Status,
+  IN CONST CHAR8                *FunctionName,
+  IN UINTN                      LineNumber,
+  IN CONST CHAR8                *Description
+  );
+
+UNIT_TEST_COLD
+BOOLEAN
+EFIAPI
+UnitTestAssertEqual (
+  IN UNIT_TEST_FRAMEWORK_HANDLE Framework,
+  IN UINTN                      ValueA,
+  IN UINTN                      ValueB,
+  IN CONST CHAR8                *FunctionName,
+  IN UINTN                      LineNumber,
+  IN CONST CHAR8                *DescriptionA,
+  IN CONST CHAR8                *DescriptionB
+  );
+
+UNIT_TEST_COLD
+BOOLEAN
+EFIAPI
+UnitTestAssertNotEqual (
+  IN UNIT_TEST_FRAMEWORK_HANDLE Framework,
+  IN UINTN                      ValueA,
+  IN UINTN                      ValueB,
+  IN CONST CHAR8                *FunctionName,
+  IN UINTN                      LineNumber,
+  IN CONST CHAR8                *DescriptionA,
+  IN CONST CHAR8                *DescriptionB
+  );
+
+UNIT_TEST_COLD
+BOOLEAN
+EFIAPI
+UnitTestAssertStatusEqual (
+  IN UNIT_TEST_FRAMEWORK_HANDLE Framework,
+  IN EFI_STATUS                 Status,
+  IN EFI_STATUS                 Expected,
+  IN CONST CHAR8                *FunctionName,
+  IN UINTN                      LineNumber,
+  IN CONST CHAR8                *Description
+  );
+
+/**
+  Compares two buffers with CompareMem(), so it's exactly as fast as the platform's
+  BaseMemoryLib instance. On a mismatch, only the first differing offset and a small
+  hex window around it are logged, so large buffers don't flood the test log.
+
+  Not UNIT_TEST_COLD, since the comparison itself happens in here.
+
+**/
+BOOLEAN
+EFIAPI
+UnitTestAssertMemEqual (
+  IN UNIT_TEST_FRAMEWORK_HANDLE Framework,
+  IN CONST VOID                 *BufferA,
+  IN CONST VOID                 *BufferB,
+  IN UINTN                      Length,
+  IN CONST CHAR8                *FunctionName,
+  IN UINTN                      LineNumber,
+  IN CONST CHAR8                *DescriptionA,
+  IN CONST CHAR8                *DescriptionB
+  );
+
+
+//
+// Inline halves of the assertion macros. These exist so that each macro argument
+// is evaluated exactly once. Once inlined, the name, line and descriptions are
+// only touched on the failure path.
+//
+STATIC UNIT_TEST_INLINE
+BOOLEAN
+UnitTestAssertEqualInline (
+  IN UNIT_TEST_FRAMEWORK_HANDLE Framework,
+  IN UINTN                      ValueA,
+  IN UINTN                      ValueB,
+  IN CONST CHAR8                *FunctionName,
+  IN UINTN                      LineNumber,
+  IN CONST CHAR8                *DescriptionA,
+  IN CONST CHAR8                *DescriptionB
+  )
+{
+  return (ValueA == ValueB) ? TRUE :
+         UnitTestAssertEqual( Framework, ValueA, ValueB, FunctionName, LineNumber, DescriptionA, DescriptionB );
+}
+
+STATIC UNIT_TEST_INLINE
+BOOLEAN
+UnitTestAssertNotEqualInline (
+  IN UNIT_TEST_FRAMEWORK_HANDLE Framework,
+  IN UINTN                      ValueA,
+  IN UINTN                      ValueB,
+  IN CONST CHAR8                *FunctionName,
+  IN UINTN                      LineNumber,
+  IN CONST CHAR8                *DescriptionA,
+  IN CONST CHAR8                *DescriptionB
+  )
+{
+  return (ValueA != ValueB) ? TRUE :
+         UnitTestAssertNotEqual( Framework, ValueA, ValueB, FunctionName, LineNumber, DescriptionA, DescriptionB );
+}
+
+STATIC UNIT_TEST_INLINE
+BOOLEAN
+UnitTestAssertNotEfiErrorInline (
+  IN UNIT_TEST_FRAMEWORK_HANDLE Framework,
+  IN EFI_STATUS                 Status,
+  IN CONST CHAR8                *FunctionName,
+  IN UINTN                      LineNumber,
+  IN CONST CHAR8                *Description
+  )
+{
+  return !EFI_ERROR( Status ) ? TRUE :
+         UnitTestAssertNotEfiError( Framework, Status, FunctionName, LineNumber, Description );
+}
+
+STATIC UNIT_TEST_INLINE
+BOOLEAN
+UnitTestAssertStatusEqualInline (
+  IN UNIT_TEST_FRAMEWORK_HANDLE Framework,
+  IN EFI_STATUS                 Status,
+  IN EFI_STATUS                 Expected,
+  IN CONST CHAR8                *FunctionName,
+  IN UINTN                      LineNumber,
+  IN CONST CHAR8                *Description
+  )
+{
+  return (Status == Expected) ? TRUE :
+         UnitTestAssertStatusEqual( Framework, Status, Expected, FunctionName, LineNumber, Description );
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,42 @@
+/** @file
+Writes the results of a unit test run as JUnit XML, for harnesses that want
+something more reliable than scraping the console. Needs the UEFI shell.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+
+
+Copyright (C) 2016 Microsoft Corporation. All Rights Reserved.
+
+**/
+
+#ifndef __UNIT_TEST_XML_REPORT_LIB_H__
+#define __UNIT_TEST_XML_REPORT_LIB_H__
+
+#include <Library/UnitTestLib.h>
+
+/**
+  Writes the results as JUnit XML to "<ShortTitle>_JUnit.xml", next to the
+  test app. Contains every suite and test with its status, time and log,
+  along with the framework VersionString. Any previous report is replaced.
+
+  @retval     EFI_SUCCESS   The report was written.
+  @retval     Others        The file could not be created or written.
+
+**/
+EFI_STATUS
+EFIAPI
+SaveUnitTestXmlReport (
+  IN UNIT_TEST_FRAMEWORK  *Framework
+  );
+
+#endif // __UNIT_TEST_XML_REPORT_LIB_H__
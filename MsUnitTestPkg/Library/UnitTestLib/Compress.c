@@ -0,0 +1,408 @@
+/** @file -- Compress.c
+LZ77 compression for the saved framework state.
+
+Each sequence is a token byte, a run of literals, and then a back-reference:
+the high nibble of the token is the literal count and the low nibble is the
+match length less LZ_MIN_MATCH. A nibble of 15 means more length bytes follow,
+each adding up to 255. Back-references are a 16-bit little-endian distance.
+The last sequence is literals only and ends with the data.
+
+The saved state is mostly UTF-16 log text, full of repeated prefixes, function
+names and status strings, so even a greedy single-probe match finder like this
+one does well on it.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+
+
+Copyright (C) 2016 Microsoft Corporation. All Rights Reserved.
+
+**/
+
+#include <Uefi.h>
+#include <Library/UnitTestLib.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PcdLib.h>
+
+#include "UnitTestPersistenceLib.h"
+#include "Compress.h"
+
+#define LZ_MIN_MATCH        4
+#define LZ_MAX_OFFSET       0xFFFF
+#define LZ_RUN_MASK         0x0F
+#define LZ_HASH_BITS        12          // 16 KB of match table.
+
+
+STATIC
+UINTN
+LzHash (
+  IN  UINT32    Value
+  )
+{
+  // Knuth's multiplicative hash. The top bits are the well-mixed ones.
+  return (UINTN)((Value * 2654435761U) >> (32 - LZ_HASH_BITS));
+} // LzHash()
+
+
+/**
+  Writes the part of a length that didn't fit in its token nibble.
+
+**/
+STATIC
+BOOLEAN
+LzPutLength (
+  OUT     UINT8     *Destination,
+  IN      UINTN     DestinationSize,
+  IN OUT  UINTN     *Out,
+  IN      UINTN     Length
+  )
+{
+  while (Length >= 0xFF)
+  {
+    if (*Out >= DestinationSize)
+    {
+      return FALSE;
+    }
+    Destination[(*Out)++] = 0xFF;
+    Length -= 0xFF;
+  }
+  if (*Out >= DestinationSize)
+  {
+    return FALSE;
+  }
+  Destination[(*Out)++] = (UINT8)Length;
+
+  return TRUE;
+} // LzPutLength()
+
+
+/**
+  Writes one sequence. A MatchLength of zero writes the final, literal-only sequence.
+
+**/
+STATIC
+BOOLEAN
+LzPutSequence (
+  OUT     UINT8         *Destination,
+  IN      UINTN         DestinationSize,
+  IN OUT  UINTN         *Out,
+  IN      CONST UINT8   *Literals,
+  IN      UINTN         LiteralLength,
+  IN      UINTN         Offset,
+  IN      UINTN         MatchLength
+  )
+{
+  UINT8     *Token;
+
+  if (*Out >= DestinationSize)
+  {
+    return FALSE;
+  }
+  Token  = &Destination[(*Out)++];
+  *Token = (UINT8)(MIN( LiteralLength, LZ_RUN_MASK ) << 4);
+  if (LiteralLength >= LZ_RUN_MASK &&
+      !LzPutLength( Destination, DestinationSize, Out, LiteralLength - LZ_RUN_MASK ))
+  {
+    return FALSE;
+  }
+  if (LiteralLength > DestinationSize - *Out)
+  {
+    return FALSE;
+  }
+  CopyMem( &Destination[*Out], Literals, LiteralLength );
+  *Out += LiteralLength;
+
+  if (MatchLength == 0)
+  {
+    return TRUE;
+  }
+
+  if (DestinationSize - *Out < 2)
+  {
+    return FALSE;
+  }
+  Destination[(*Out)++] = (UINT8)Offset;
+  Destination[(*Out)++] = (UINT8)(Offset >> 8);
+
+  MatchLength -= LZ_MIN_MATCH;
+  *Token |= (UINT8)MIN( MatchLength, LZ_RUN_MASK );
+  if (MatchLength >= LZ_RUN_MASK)
+  {
+    return LzPutLength( Destination, DestinationSize, Out, MatchLength - LZ_RUN_MASK );
+  }
+
+  return TRUE;
+} // LzPutSequence()
+
+
+/**
+  Reads the part of a length that didn't fit in its token nibble.
+
+**/
+STATIC
+BOOLEAN
+LzGetLength (
+  IN      CONST UINT8   *Source,
+  IN      UINTN         SourceSize,
+  IN OUT  UINTN         *In,
+  IN OUT  UINTN         *Length
+  )
+{
+  UINT8     Byte;
+
+  do
+  {
+    // Nothing we save comes close to 4 GB, so anything longer is garbage.
+    if (*In >= SourceSize || *Length > MAX_UINT32)
+    {
+      return FALSE;
+    }
+    Byte     = Source[(*In)++];
+    *Length += Byte;
+  } while (Byte == 0xFF);
+
+  return TRUE;
+} // LzGetLength()
+
+
+UINTN
+LzCompress (
+  IN  CONST UINT8   *Source,
+  IN  UINTN         SourceSize,
+  OUT UINT8         *Destination,
+  IN  UINTN         DestinationSize
+  )
+{
+  UINT32    *Table;
+  UINTN     Position = 0, Anchor = 0, Out = 0;
+  UINTN     Slot, Candidate, MatchLength;
+
+  //
+  // Each slot holds the last position (plus one, so zero is empty) where
+  // four bytes with that hash were seen.
+  Table = AllocateZeroPool( (1 << LZ_HASH_BITS) * sizeof( UINT32 ) );
+  if (Table == NULL)
+  {
+    return 0;
+  }
+
+  while (SourceSize >= LZ_MIN_MATCH && Position <= SourceSize - LZ_MIN_MATCH)
+  {
+    Slot        = LzHash( ReadUnaligned32( (UINT32*)&Source[Position] ) );
+    Candidate   = Table[Slot];
+    Table[Slot] = (UINT32)(Position + 1);
+    if (Candidate == 0 || Position - (Candidate - 1) > LZ_MAX_OFFSET ||
+        ReadUnaligned32( (UINT32*)&Source[Candidate - 1] ) != ReadUnaligned32( (UINT32*)&Source[Position] ))
+    {
+      Position++;
+      continue;
+    }
+    Candidate--;
+
+    MatchLength = LZ_MIN_MATCH;
+    while (Position + MatchLength < SourceSize && Source[Candidate + MatchLength] == Source[Position + MatchLength])
+    {
+      MatchLength++;
+    }
+
+    if (!LzPutSequence( Destination, DestinationSize, &Out, &Source[Anchor], Position - Anchor,
+                        Position - Candidate, MatchLength ))
+    {
+      Out = 0;
+      goto Exit;
+    }
+    Position += MatchLength;
+    Anchor    = Position;
+
+    // Positions inside the match are skipped, but the end of it is a good place to look next time.
+    if (Position <= SourceSize - LZ_MIN_MATCH)
+    {
+      Table[LzHash( ReadUnaligned32( (UINT32*)&Source[Position - 2] ) )] = (UINT32)(Position - 2 + 1);
+    }
+  }
+
+  if (!LzPutSequence( Destination, DestinationSize, &Out, &Source[Anchor], SourceSize - Anchor, 0, 0 ))
+  {
+    Out = 0;
+  }
+
+Exit:
+  FreePool( Table );
+
+  return Out;
+} // LzCompress()
+
+
+EFI_STATUS
+LzDecompress (
+  IN  CONST UINT8   *Source,
+  IN  UINTN         SourceSize,
+  OUT UINT8         *Destination,
+  IN  UINTN         DestinationSize
+  )
+{
+  UINTN     In = 0, Out = 0, Length, Offset, Index, Chunk;
+  UINT8     Token;
+
+  while (In < SourceSize)
+  {
+    Token = Source[In++];
+
+    //
+    // Literals.
+    Length = Token >> 4;
+    if (Length == LZ_RUN_MASK && !LzGetLength( Source, SourceSize, &In, &Length ))
+    {
+      return EFI_VOLUME_CORRUPTED;
+    }
+    if (Length > SourceSize - In || Length > DestinationSize - Out)
+    {
+      return EFI_VOLUME_CORRUPTED;
+    }
+    CopyMem( &Destination[Out], &Source[In], Length );
+    In  += Length;
+    Out += Length;
+
+    // Only the last sequence ends with its literals.
+    if (In == SourceSize)
+    {
+      break;
+    }
+
+    //
+    // Back-reference.
+    if (SourceSize - In < 2)
+    {
+      return EFI_VOLUME_CORRUPTED;
+    }
+    Offset = (UINTN)Source[In] | ((UINTN)Source[In + 1] << 8);
+    In += 2;
+    if (Offset == 0 || Offset > Out)
+    {
+      return EFI_VOLUME_CORRUPTED;
+    }
+    Length = Token & LZ_RUN_MASK;
+    if (Length == LZ_RUN_MASK && !LzGetLength( Source, SourceSize, &In, &Length ))
+    {
+      return EFI_VOLUME_CORRUPTED;
+    }
+    Length += LZ_MIN_MATCH;
+    if (Length > DestinationSize - Out)
+    {
+      return EFI_VOLUME_CORRUPTED;
+    }
+    // A match that overlaps itself repeats the last Offset bytes. Everything from there on
+    // repeats them too, so each copy can take twice as much as the last without overlapping.
+    for (Index = 0; Index < Length; Index += Chunk)
+    {
+      Chunk = MIN( Offset + Index, Length - Index );
+      CopyMem( &Destination[Out + Index], &Destination[Out - Offset], Chunk );
+    }
+    Out += Length;
+  }
+
+  return (Out == DestinationSize) ? EFI_SUCCESS : EFI_VOLUME_CORRUPTED;
+} // LzDecompress()
+
+
+EFI_STATUS
+ExpandUnitTestSave (
+  IN  UNIT_TEST_SAVE_HEADER       *SaveData,
+  OUT UNIT_TEST_SAVE_HEADER       **Expanded
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_SAVE_HEADER       *Buffer;
+
+  *Expanded = SaveData;
+
+  //
+  // Saves from another version don't have the compression fields where we'd look for them.
+  // Pass them through as they are and let whoever indexes them turn them away.
+  if (SaveData->BlobSize < sizeof( UNIT_TEST_SAVE_HEADER ) ||
+      SaveData->Version != UNIT_TEST_PERSISTENCE_LIB_VERSION ||
+      SaveData->Compression == UNIT_TEST_SAVE_COMPRESSION_NONE)
+  {
+    return EFI_SUCCESS;
+  }
+  if (SaveData->Compression != UNIT_TEST_SAVE_COMPRESSION_LZ ||
+      SaveData->ExpandedSize < sizeof( UNIT_TEST_SAVE_HEADER ))
+  {
+    return EFI_VOLUME_CORRUPTED;
+  }
+
+  Buffer = AllocatePool( SaveData->ExpandedSize );
+  if (Buffer == NULL)
+  {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  CopyMem( Buffer, SaveData, sizeof( UNIT_TEST_SAVE_HEADER ) );
+  Status = LzDecompress( (UINT8*)SaveData + sizeof( UNIT_TEST_SAVE_HEADER ),
+                         SaveData->BlobSize - sizeof( UNIT_TEST_SAVE_HEADER ),
+                         (UINT8*)Buffer + sizeof( UNIT_TEST_SAVE_HEADER ),
+                         SaveData->ExpandedSize - sizeof( UNIT_TEST_SAVE_HEADER ) );
+  if (EFI_ERROR( Status ))
+  {
+    DEBUG(( DEBUG_ERROR, "%a - Compressed save is corrupt.\n", __FUNCTION__ ));
+    FreePool( Buffer );
+    return Status;
+  }
+  Buffer->BlobSize    = SaveData->ExpandedSize;
+  Buffer->Compression = UNIT_TEST_SAVE_COMPRESSION_NONE;
+
+  *Expanded = Buffer;
+  return EFI_SUCCESS;
+} // ExpandUnitTestSave()
+
+
+UNIT_TEST_SAVE_HEADER*
+CompressUnitTestSave (
+  IN  UNIT_TEST_SAVE_HEADER       *SaveData
+  )
+{
+  UNIT_TEST_SAVE_HEADER       *Buffer;
+  UINTN                       PayloadSize, CompressedSize;
+
+  if (!FeaturePcdGet( PcdUnitTestCompressSavedState ) ||
+      SaveData->Compression != UNIT_TEST_SAVE_COMPRESSION_NONE ||
+      SaveData->BlobSize <= sizeof( UNIT_TEST_SAVE_HEADER ))
+  {
+    return NULL;
+  }
+
+  //
+  // Only keep the result if it comes out smaller, so there's never a reason
+  // to allocate more than the save already takes.
+  PayloadSize = SaveData->BlobSize - sizeof( UNIT_TEST_SAVE_HEADER );
+  Buffer = AllocatePool( SaveData->BlobSize );
+  if (Buffer == NULL)
+  {
+    return NULL;
+  }
+  CompressedSize = LzCompress( (UINT8*)SaveData + sizeof( UNIT_TEST_SAVE_HEADER ), PayloadSize,
+                               (UINT8*)Buffer + sizeof( UNIT_TEST_SAVE_HEADER ), PayloadSize - 1 );
+  if (CompressedSize == 0)
+  {
+    FreePool( Buffer );
+    return NULL;
+  }
+
+  CopyMem( Buffer, SaveData, sizeof( UNIT_TEST_SAVE_HEADER ) );
+  Buffer->Compression   = UNIT_TEST_SAVE_COMPRESSION_LZ;
+  Buffer->ExpandedSize  = SaveData->BlobSize;
+  Buffer->BlobSize      = (UINT32)(sizeof( UNIT_TEST_SAVE_HEADER ) + CompressedSize);
+
+  return Buffer;
+} // CompressUnitTestSave()
@@ -0,0 +1,104 @@
+/** @file -- Compress.h
+A small LZ77 codec for the saved framework state, laid out like an LZ4 block.
+It trades ratio for speed and a tiny footprint: there's no entropy coding, and
+expanding is little more than a series of copies.
+
+Only the persistence libs build this in. UnitTestLib always hands them, and
+gets back, saves that aren't compressed.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+
+
+Copyright (C) 2016 Microsoft Corporation. All Rights Reserved.
+
+**/
+
+#ifndef _UNIT_TEST_COMPRESS_H_
+#define _UNIT_TEST_COMPRESS_H_
+
+/**
+  Compresses a buffer, as long as the result fits in the space given.
+
+  @param[in]  Source            Data to compress.
+  @param[in]  SourceSize        Size of Source, in bytes.
+  @param[out] Destination       Where to put the compressed data.
+  @param[in]  DestinationSize   Size of Destination, in bytes. Pass less than SourceSize
+                                to only get a result when compression actually helps.
+
+  @retval     0       The data didn't fit, or there wasn't memory for the match table.
+  @retval     Others  Size of the compressed data, in bytes.
+
+**/
+UINTN
+LzCompress (
+  IN  CONST UINT8   *Source,
+  IN  UINTN         SourceSize,
+  OUT UINT8         *Destination,
+  IN  UINTN         DestinationSize
+  );
+
+/**
+  Expands data from LzCompress(). The input is not trusted: every length and
+  offset is checked, and the output has to come out at exactly DestinationSize.
+
+  @param[in]  Source            Compressed data.
+  @param[in]  SourceSize        Size of Source, in bytes.
+  @param[out] Destination       Where to put the expanded data.
+  @param[in]  DestinationSize   Expected size of the expanded data, in bytes.
+
+  @retval     EFI_SUCCESS             Destination holds all DestinationSize bytes.
+  @retval     EFI_VOLUME_CORRUPTED    The data is malformed or the wrong size.
+
+**/
+EFI_STATUS
+LzDecompress (
+  IN  CONST UINT8   *Source,
+  IN  UINTN         SourceSize,
+  OUT UINT8         *Destination,
+  IN  UINTN         DestinationSize
+  );
+
+/**
+  Gets the tests and context of a save back out of a compressed one.
+
+  @param[in]  SaveData    A save, as it was read back from storage.
+  @param[out] Expanded    Updated with the expanded save. This is SaveData itself if it
+                          wasn't compressed. Otherwise it's a new buffer from the pool
+                          that the caller must free.
+
+  @retval     EFI_SUCCESS             Expanded is ready.
+  @retval     EFI_VOLUME_CORRUPTED    The compressed data is damaged.
+  @retval     EFI_OUT_OF_RESOURCES    There's no memory for the expanded save.
+
+**/
+EFI_STATUS
+ExpandUnitTestSave (
+  IN  UNIT_TEST_SAVE_HEADER       *SaveData,
+  OUT UNIT_TEST_SAVE_HEADER       **Expanded
+  );
+
+/**
+  Compresses a save, if PcdUnitTestCompressSavedState is set and it does any good.
+
+  @param[in]  SaveData    A save from UnitTestLib. One that's already compressed is left alone.
+
+  @retval     !NULL   A new buffer from the pool holding the compressed save. Must be freed by the caller.
+  @retval     NULL    SaveData should be written as it is.
+
+**/
+UNIT_TEST_SAVE_HEADER*
+CompressUnitTestSave (
+  IN  UNIT_TEST_SAVE_HEADER       *SaveData
+  );
+
+#endif // _UNIT_TEST_COMPRESS_H_
@@ -0,0 +1,209 @@
+/** @file -- Fingerprint.c
+Fingerprint hashes for the unit test framework.
+
+SipHash-2-4 with the 128-bit output extension is the default. It's several
+times faster than MD5 over the short strings we hash, and it isn't flagged
+as legacy cryptography. The fingerprints only need to tell tests apart
+across a reboot, so the key is a fixed, public constant.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+
+
+Copyright (C) 2016 Microsoft Corporation. All Rights Reserved.
+
+**/
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/PcdLib.h>
+#include <Library/UnitTestLib.h>
+
+#include "Fingerprint.h"
+
+//
+// Fixed SipHash key. Changing it changes every fingerprint, which would
+// also need a new UNIT_TEST_PERSISTENCE_LIB_VERSION.
+//
+#define SIPHASH_KEY_0     0x0706050403020100ULL
+#define SIPHASH_KEY_1     0x0F0E0D0C0B0A0908ULL
+
+#define SIPHASH_ROUND(V)                                                          \
+  do {                                                                            \
+    (V)[0] += (V)[1];   (V)[1] = LRotU64( (V)[1], 13 );   (V)[1] ^= (V)[0];       \
+    (V)[0]  = LRotU64( (V)[0], 32 );                                              \
+    (V)[2] += (V)[3];   (V)[3] = LRotU64( (V)[3], 16 );   (V)[3] ^= (V)[2];       \
+    (V)[0] += (V)[3];   (V)[3] = LRotU64( (V)[3], 21 );   (V)[3] ^= (V)[0];       \
+    (V)[2] += (V)[1];   (V)[1] = LRotU64( (V)[1], 17 );   (V)[1] ^= (V)[2];       \
+    (V)[2]  = LRotU64( (V)[2], 32 );                                              \
+  } while (FALSE)
+
+
+STATIC
+VOID
+SipHashInit (
+  OUT SIPHASH_CTX   *Context
+  )
+{
+  Context->V[0]       = 0x736F6D6570736575ULL ^ SIPHASH_KEY_0;
+  Context->V[1]       = 0x646F72616E646F6DULL ^ SIPHASH_KEY_1 ^ 0xEE;   // 0xEE selects 128-bit output.
+  Context->V[2]       = 0x6C7967656E657261ULL ^ SIPHASH_KEY_0;
+  Context->V[3]       = 0x7465646279746573ULL ^ SIPHASH_KEY_1;
+  Context->Tail       = 0;
+  Context->TailLength = 0;
+  Context->Length     = 0;
+  return;
+} // SipHashInit()
+
+
+STATIC
+VOID
+SipHashCompress (
+  IN OUT SIPHASH_CTX    *Context,
+  IN     UINT64         Word
+  )
+{
+  Context->V[3] ^= Word;
+  SIPHASH_ROUND( Context->V );
+  SIPHASH_ROUND( Context->V );
+  Context->V[0] ^= Word;
+  return;
+} // SipHashCompress()
+
+
+STATIC
+VOID
+SipHashUpdate (
+  IN OUT SIPHASH_CTX    *Context,
+  IN     CONST UINT8    *Data,
+  IN     UINTN          DataLen
+  )
+{
+  Context->Length += DataLen;
+
+  //
+  // Top up any partial word left over from the last call.
+  while (Context->TailLength > 0 && DataLen > 0)
+  {
+    Context->Tail |= LShiftU64( *Data, 8 * Context->TailLength );
+    Data++;
+    DataLen--;
+    if (++Context->TailLength == sizeof( UINT64 ))
+    {
+      SipHashCompress( Context, Context->Tail );
+      Context->Tail       = 0;
+      Context->TailLength = 0;
+    }
+  }
+
+  //
+  // Whole words. SipHash is defined on little-endian words, which is what
+  // every architecture we build for reads natively.
+  for (; DataLen >= sizeof( UINT64 ); Data += sizeof( UINT64 ), DataLen -= sizeof( UINT64 ))
+  {
+    SipHashCompress( Context, ReadUnaligned64( (CONST UINT64*)Data ) );
+  }
+
+  //
+  // Keep whatever's left for next time.
+  for (; DataLen > 0; Data++, DataLen--)
+  {
+    Context->Tail |= LShiftU64( *Data, 8 * Context->TailLength );
+    Context->TailLength++;
+  }
+
+  return;
+} // SipHashUpdate()
+
+
+STATIC
+VOID
+SipHashFinal (
+  IN OUT SIPHASH_CTX    *Context,
+  OUT    UINT8          *Hash
+  )
+{
+  UINTN     Round;
+
+  SipHashCompress( Context, Context->Tail | LShiftU64( Context->Length, 56 ) );
+
+  Context->V[2] ^= 0xEE;
+  for (Round = 0; Round < 4; Round++)
+  {
+    SIPHASH_ROUND( Context->V );
+  }
+  WriteUnaligned64( (UINT64*)&Hash[0], Context->V[0] ^ Context->V[1] ^ Context->V[2] ^ Context->V[3] );
+
+  Context->V[1] ^= 0xDD;
+  for (Round = 0; Round < 4; Round++)
+  {
+    SIPHASH_ROUND( Context->V );
+  }
+  WriteUnaligned64( (UINT64*)&Hash[8], Context->V[0] ^ Context->V[1] ^ Context->V[2] ^ Context->V[3] );
+
+  return;
+} // SipHashFinal()
+
+
+VOID
+FingerprintInit (
+  OUT UNIT_TEST_FINGERPRINT_CTX   *Context
+  )
+{
+  if (UNIT_TEST_FINGERPRINT_ALGORITHM == UNIT_TEST_FINGERPRINT_ALGORITHM_MD5)
+  {
+    MD5Init( &Context->Md5 );
+  }
+  else
+  {
+    SipHashInit( &Context->SipHash );
+  }
+  return;
+} // FingerprintInit()
+
+
+VOID
+FingerprintUpdate (
+  IN OUT UNIT_TEST_FINGERPRINT_CTX  *Context,
+  IN     CONST VOID                 *Data,
+  IN     UINTN                      DataLen
+  )
+{
+  if (UNIT_TEST_FINGERPRINT_ALGORITHM == UNIT_TEST_FINGERPRINT_ALGORITHM_MD5)
+  {
+    MD5Update( &Context->Md5, (VOID*)Data, DataLen );
+  }
+  else
+  {
+    SipHashUpdate( &Context->SipHash, Data, DataLen );
+  }
+  return;
+} // FingerprintUpdate()
+
+
+VOID
+FingerprintFinal (
+  IN OUT UNIT_TEST_FINGERPRINT_CTX  *Context,
+  OUT    UINT8                      *Fingerprint
+  )
+{
+  if (UNIT_TEST_FINGERPRINT_ALGORITHM == UNIT_TEST_FINGERPRINT_ALGORITHM_MD5)
+  {
+    MD5Final( &Context->Md5, Fingerprint );
+  }
+  else
+  {
+    SipHashFinal( &Context->SipHash, Fingerprint );
+  }
+  return;
+} // FingerprintFinal()
@@ -0,0 +1,87 @@
+/** @file -- Fingerprint.h
+Hashes used to fingerprint frameworks, suites and tests. The algorithm is
+picked at build time with PcdUnitTestFingerprintAlgorithm.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+
+
+Copyright (C) 2016 Microsoft Corporation. All Rights Reserved.
+
+**/
+
+#ifndef _UNIT_TEST_FINGERPRINT_H_
+#define _UNIT_TEST_FINGERPRINT_H_
+
+#include "Md5.h"
+
+//
+// Values for PcdUnitTestFingerprintAlgorithm. These are also recorded in
+// UNIT_TEST_SAVE_HEADER, so they must never be renumbered.
+//
+#define UNIT_TEST_FINGERPRINT_ALGORITHM_MD5       0
+#define UNIT_TEST_FINGERPRINT_ALGORITHM_SIPHASH   1
+
+#define UNIT_TEST_FINGERPRINT_ALGORITHM     FixedPcdGet8( PcdUnitTestFingerprintAlgorithm )
+
+typedef struct {
+  UINT64      V[4];
+  UINT64      Tail;             // Bytes that haven't made up a full 64-bit word yet.
+  UINTN       TailLength;
+  UINT64      Length;           // Total bytes absorbed.
+} SIPHASH_CTX;
+
+typedef union {
+  MD5_CTX       Md5;
+  SIPHASH_CTX   SipHash;
+} UNIT_TEST_FINGERPRINT_CTX;
+
+/**
+  Starts a new fingerprint with the configured algorithm.
+
+  @param[out]   Context   Context to initialize.
+
+**/
+VOID
+FingerprintInit (
+  OUT UNIT_TEST_FINGERPRINT_CTX   *Context
+  );
+
+/**
+  Absorbs more data into a fingerprint.
+
+  @param[in,out]  Context   Context from FingerprintInit().
+  @param[in]      Data      Data to hash.
+  @param[in]      DataLen   Length of Data, in bytes.
+
+**/
+VOID
+FingerprintUpdate (
+  IN OUT UNIT_TEST_FINGERPRINT_CTX  *Context,
+  IN     CONST VOID                 *Data,
+  IN     UINTN                      DataLen
+  );
+
+/**
+  Finishes a fingerprint.
+
+  @param[in,out]  Context       Context from FingerprintInit(). Must not be used again without another FingerprintInit().
+  @param[out]     Fingerprint   UNIT_TEST_FINGERPRINT_SIZE bytes of output.
+
+**/
+VOID
+FingerprintFinal (
+  IN OUT UNIT_TEST_FINGERPRINT_CTX  *Context,
+  OUT    UINT8                      *Fingerprint
+  );
+
+#endif // _UNIT_TEST_FINGERPRINT_H_
@@ -0,0 +1,149 @@
+/** @file -- UnitTestFilePathLib.c
+Works out where the files that go with a unit test app should live, from the
+loaded image of the app itself.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+
+Copyright (C) 2016 Microsoft Corporation. All Rights Reserved.
+
+**/
+
+#include <Uefi.h>
+#include <Library/UnitTestLib.h>
+#include <Library/BaseLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/DevicePathLib.h>
+#include <Library/UnitTestFilePathLib.h>
+
+#include <Protocol/LoadedImage.h>
+
+
+/**
+  Builds the device path of a file that lives next to the test app, named
+  "<ShortTitle><FileSuffix>".
+
+  @param[in]  FrameworkHandle   The framework that the file belongs to.
+  @param[in]  FileSuffix        Appended to the framework's ShortTitle to make the file name.
+
+  @retval     !NULL   A pool-allocated device path. Must be freed by the caller.
+  @retval     NULL    The app's location could not be determined or an error occurred.
+
+**/
+EFI_DEVICE_PATH_PROTOCOL*
+EFIAPI
+GetUnitTestFileDevicePath (
+  IN  UNIT_TEST_FRAMEWORK_HANDLE  FrameworkHandle,
+  IN  CONST CHAR16                *FileSuffix
+  )
+{
+  EFI_STATUS                      Status;
+  UNIT_TEST_FRAMEWORK             *Framework = (UNIT_TEST_FRAMEWORK*)FrameworkHandle;
+  EFI_LOADED_IMAGE_PROTOCOL       *LoadedImage;
+  CHAR16                          *AppPath = NULL, *FilePath = NULL;
+  UINTN                           DirectorySlashOffset, FilePathLength;
+  EFI_DEVICE_PATH_PROTOCOL        *FileDevicePathResult = NULL;
+
+  //
+  // First, we need to get some information from the loaded image.
+  // Namely, where the hell are you?
+  //
+  Status = gBS->HandleProtocol( gImageHandle,
+                                &gEfiLoadedImageProtocolGuid,
+                                (VOID**)&LoadedImage );
+  if (EFI_ERROR( Status ))
+  {
+    DEBUG(( DEBUG_WARN, "%a - Failed to locate DevicePath for loaded image. %r\n", __FUNCTION__, Status ));
+    return NULL;
+  }
+
+  //
+  // Now we should have the device path of the root device and a file path for the rest.
+  // In order to target the directory for the test application, we must process
+  // the file path a little.
+  //
+  // NOTE: This may not be necessary... Path processing functions exist...
+  // PathCleanUpDirectories (FileNameCopy);
+  //     if (PathRemoveLastItem (FileNameCopy)) {
+  AppPath = ConvertDevicePathToText( LoadedImage->FilePath, TRUE, TRUE );    // NOTE: This must be freed.
+  if (AppPath == NULL)
+  {
+    goto Exit;
+  }
+  DirectorySlashOffset = StrLen( AppPath );
+  // Make sure we didn't get any weird data.
+  if (DirectorySlashOffset == 0)
+  {
+    DEBUG(( DEBUG_ERROR, "%a - Weird 0-length string when processing app path.\n", __FUNCTION__ ));
+    goto Exit;
+  }
+  // Now that we know we have a decent string, let's take a deeper look.
+  do
+  {
+    if (AppPath[DirectorySlashOffset] == L'\\')
+    {
+      break;
+    }
+    DirectorySlashOffset--;
+  } while (DirectorySlashOffset > 0);
+
+  //
+  // After that little maneuver, DirectorySlashOffset should be pointing at the last '\' in AppString.
+  // That would be the path to the parent directory that the test app is executing from.
+  // Let's check and make sure that's right.
+  //
+  if (AppPath[DirectorySlashOffset] != L'\\')
+  {
+    DEBUG(( DEBUG_ERROR, "%a - Could not find a single directory separator in app path.\n", __FUNCTION__ ));
+    goto Exit;
+  }
+
+  //
+  // Now we know some things, we're ready to produce our output string, I think.
+  //
+  FilePathLength  = DirectorySlashOffset + 1;
+  FilePathLength += StrLen( Framework->ShortTitle );
+  FilePathLength += StrLen( FileSuffix );
+  FilePathLength += 1;   // Don't forget the NULL terminator.
+  FilePath        = AllocateZeroPool( FilePathLength * sizeof( CHAR16 ) );
+  if (FilePath == NULL)
+  {
+    goto Exit;
+  }
+
+  //
+  // Let's produce our final path string, shall we?
+  //
+  StrnCpyS( FilePath, FilePathLength, AppPath, DirectorySlashOffset + 1 );  // Copy the path for the parent directory.
+  StrCatS( FilePath, FilePathLength, Framework->ShortTitle );               // Copy the base name for the file.
+  StrCatS( FilePath, FilePathLength, FileSuffix );                          // Copy the file suffix.
+
+  //
+  // Finally, try to create the device path for the thing thing.
+  //
+  FileDevicePathResult = FileDevicePath( LoadedImage->DeviceHandle, FilePath );
+
+Exit:
+  // Always put away your toys.
+  if (AppPath != NULL)
+  {
+    FreePool( AppPath );
+  }
+  if (FilePath != NULL)
+  {
+    FreePool( FilePath );
+  }
+
+  return FileDevicePathResult;
+} // GetUnitTestFileDevicePath()
@@ -1,392 +1,1045 @@
-/** @file -- UnitTestFilesystemPersistenceLib.c
-This is an instance of the Unit Test Persistence Lib that will utilize
-the filesystem that a test application is running from to save a serialized
-version of the internal test state in case the test needs to quit and restore.
-
-THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
-AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
-IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
-ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
-LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
-CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
-SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
-INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
-CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
-ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
-THE POSSIBILITY OF SUCH DAMAGE.
-
-
-Copyright (C) 2016 Microsoft Corporation. All Rights Reserved.
-
-**/
-
-#include <Library/UnitTestLib.h>
-#include <Library/BaseLib.h>
-#include <Library/DebugLib.h>
-#include <Library/MemoryAllocationLib.h>
-#include <Library/UefiBootServicesTableLib.h>
-#include <Library/DevicePathLib.h>
-#include <Library/ShellLib.h>
-
-#include <Protocol/LoadedImage.h>
-
-#include "UnitTestPersistenceLib.h"
-
-/**
-  TODO: STUFF!!
-
-  @retval     !NULL   A pointer to the EFI_FILE protocol instance for the filesystem.
-  @retval     NULL    Filesystem could not be found or an error occurred.
-
-**/
-STATIC
-EFI_DEVICE_PATH_PROTOCOL*
-GetCacheFileDevicePath (
-  IN  UNIT_TEST_FRAMEWORK_HANDLE  FrameworkHandle
-  )
-{
-  EFI_STATUS                      Status;
-  UNIT_TEST_FRAMEWORK             *Framework = (UNIT_TEST_FRAMEWORK*)FrameworkHandle;
-  EFI_LOADED_IMAGE_PROTOCOL       *LoadedImage;
-  CHAR16                          *AppPath = NULL, *CacheFilePath = NULL;
-  CHAR16                          *FileSuffix = L"_Cache.dat";
-  UINTN                           DirectorySlashOffset, CacheFilePathLength;
-  EFI_DEVICE_PATH_PROTOCOL        *CacheFileDevicePath = NULL;
-
-  //
-  // First, we need to get some information from the loaded image.
-  // Namely, where the hell are you?
-  //
-  Status = gBS->HandleProtocol( gImageHandle,
-                                &gEfiLoadedImageProtocolGuid,
-                                (VOID**)&LoadedImage );
-  if (EFI_ERROR( Status ))
-  {
-    DEBUG(( DEBUG_WARN, __FUNCTION__" - Failed to locate DevicePath for loaded image. %r\n", Status ));
-    return NULL;
-  }
-
-  //
-  // Now we should have the device path of the root device and a file path for the rest.
-  // In order to target the directory for the test application, we must process
-  // the file path a little.
-  //
-  // NOTE: This may not be necessary... Path processing functions exist...
-  // PathCleanUpDirectories (FileNameCopy);
-  //     if (PathRemoveLastItem (FileNameCopy)) {
-  AppPath = ConvertDevicePathToText( LoadedImage->FilePath, TRUE, TRUE );    // NOTE: This must be freed.
-  DirectorySlashOffset = StrLen( AppPath );
-  // Make sure we didn't get any weird data.
-  if (DirectorySlashOffset == 0)
-  {
-    DEBUG(( DEBUG_ERROR, __FUNCTION__" - Weird 0-length string when processing app path.\n" ));
-    goto Exit;
-  }
-  // Now that we know we have a decent string, let's take a deeper look.
-  do
-  {
-    if (AppPath[DirectorySlashOffset] == L'\\')
-    {
-      break;
-    }
-    DirectorySlashOffset--;
-  } while (DirectorySlashOffset > 0);
-
-  //
-  // After that little maneuver, DirectorySlashOffset should be pointing at the last '\' in AppString.
-  // That would be the path to the parent directory that the test app is executing from.
-  // Let's check and make sure that's right.
-  //
-  if (AppPath[DirectorySlashOffset] != L'\\')
-  {
-    DEBUG(( DEBUG_ERROR, __FUNCTION__" - Could not find a single directory separator in app path.\n" ));
-    goto Exit;
-  }
-
-  //
-  // Now we know some things, we're ready to produce our output string, I think.
-  //
-  CacheFilePathLength = DirectorySlashOffset + 1;
-  CacheFilePathLength += StrLen( Framework->ShortTitle );
-  CacheFilePathLength += StrLen( FileSuffix );
-  CacheFilePathLength += 1;   // Don't forget the NULL terminator.
-  CacheFilePath       = AllocateZeroPool( CacheFilePathLength * sizeof( CHAR16 ) );
-
-  //
-  // Let's produce our final path string, shall we?
-  //
-  StrnCpyS( CacheFilePath, CacheFilePathLength, AppPath, DirectorySlashOffset + 1 ); // Copy the path for the parent directory.
-  StrCatS( CacheFilePath, CacheFilePathLength, Framework->ShortTitle );              // Copy the base name for the test cache.
-  StrCatS( CacheFilePath, CacheFilePathLength, FileSuffix );                         // Copy the file suffix.
-
-  //
-  // Finally, try to create the device path for the thing thing.
-  //
-  CacheFileDevicePath = FileDevicePath( LoadedImage->DeviceHandle, CacheFilePath );
-
-Exit:
-  // Always put away your toys.
-  if (AppPath != NULL)
-  {
-    FreePool( AppPath );
-  }
-  if (CacheFilePath != NULL)
-  {
-    FreePool( CacheFilePath);
-  }
-
-  return CacheFileDevicePath;
-} // GetCacheFileDevicePath()
-
-
-/**
-  Determines whether a persistence cache already exists for
-  the given framework.
-
-  @param[in]  FrameworkHandle   A pointer to the framework that is being persisted.
-
-  @retval     TRUE
-  @retval     FALSE   Cache doesn't exist or an error occurred.
-
-**/
-BOOLEAN
-EFIAPI
-DoesCacheExist (
-  IN  UNIT_TEST_FRAMEWORK_HANDLE  FrameworkHandle
-  )
-{
-  EFI_DEVICE_PATH_PROTOCOL      *FileDevicePath;
-  EFI_STATUS                    Status;
-  EFI_HANDLE                    FileDeviceHandle;
-  SHELL_FILE_HANDLE             FileHandle;
-
-  // NOTE: This devpath is allocated and must be freed.
-  FileDevicePath = GetCacheFileDevicePath( FrameworkHandle );
-
-  // Check to see whether the file exists.
-  // If the file can be opened for reading, it exists.
-  // Otherwise, probably not.
-  Status = ShellOpenFileByDevicePath( &FileDevicePath,
-                                      &FileDeviceHandle,
-                                      &FileHandle,
-                                      EFI_FILE_MODE_READ,
-                                      0 );
-  if (!EFI_ERROR( Status ))
-  {
-    ShellCloseFile( &FileHandle );
-  }
-
-  if (FileDevicePath != NULL)
-  {
-    FreePool( FileDevicePath );
-  }
-
-  DEBUG(( DEBUG_VERBOSE, __FUNCTION__" - Returning %d\n", !EFI_ERROR( Status ) ));
-
-  return !EFI_ERROR( Status );
-} // DoesCacheExist()
-
-
-/**
-  Will save the data associated with an internal Unit Test Framework
-  state in a manner that can persist a Unit Test Application quit or
-  even a system reboot.
-
-  @param[in]  FrameworkHandle   A pointer to the framework that is being persisted.
-  @param[in]  SaveData          A pointer to the buffer containing the serialized
-                                framework internal state.
-
-  @retval     EFI_SUCCESS   Data is persisted and the test can be safely quit.
-  @retval     Others        Data is not persisted and test cannot be resumed upon exit.
-
-**/
-EFI_STATUS
-EFIAPI
-SaveUnitTestCache (
-  IN  UNIT_TEST_FRAMEWORK_HANDLE  FrameworkHandle,
-  IN  UNIT_TEST_SAVE_HEADER       *SaveData
-  )
-{
-  EFI_DEVICE_PATH_PROTOCOL      *FileDevicePath;
-  EFI_STATUS                    Status;
-  EFI_HANDLE                    FileDeviceHandle;
-  SHELL_FILE_HANDLE             FileHandle;
-  UINTN                         WriteCount;
-
-  //
-  // Check the inputs for sanity.
-  if (FrameworkHandle == NULL || SaveData == NULL)
-  {
-    return EFI_INVALID_PARAMETER;
-  }
-
-  //
-  // Determine the path for the cache file.
-  // NOTE: This devpath is allocated and must be freed.
-  FileDevicePath = GetCacheFileDevicePath( FrameworkHandle );
-
-  // TODO: Add metadata for the file protocol. Signatures and fingerprint checking.
-
-  //
-  // Now that we know the path to the file... let's open it for writing.
-  //
-  // NOTE: It doesn't *seem* like it would be necessary to specify the EFI_FILE_MODE_READ attribute,
-  //       but without it this call will throw an EFI_INVALID_PARAMETER error.
-  Status = ShellOpenFileByDevicePath( &FileDevicePath,
-                                      &FileDeviceHandle,
-                                      &FileHandle,
-                                      (EFI_FILE_MODE_READ | EFI_FILE_MODE_WRITE | EFI_FILE_MODE_CREATE),
-                                      0 );
-  if (EFI_ERROR( Status ))
-  {
-    DEBUG(( DEBUG_ERROR, __FUNCTION__" - Opening file for writing failed! %r\n", Status ));
-    goto Exit;
-  }
-
-  //
-  // Write the data to the file.
-  //
-  WriteCount = SaveData->BlobSize;
-  DEBUG(( DEBUG_INFO, __FUNCTION__" - Writing %d bytes to file...\n", WriteCount ));
-  Status = ShellWriteFile( FileHandle,
-                           &WriteCount,
-                           SaveData );
-
-  if (EFI_ERROR( Status ) || WriteCount != SaveData->BlobSize)
-  {
-    DEBUG(( DEBUG_ERROR, __FUNCTION__" - Writing to file failed! %r\n", Status ));
-  }
-  else
-  {
-    DEBUG(( DEBUG_INFO, __FUNCTION__" - SUCCESS!\n" ));
-  }
-
-  //
-  // No matter what, we should probably close the file.
-  //
-  ShellCloseFile( &FileHandle );
-
-Exit:
-  if (FileDevicePath != NULL)
-  {
-    FreePool( FileDevicePath );
-  }
-
-  return Status;
-} // SaveUnitTestCache()
-
-
-/**
-  Will retrieve any cached state associated with the given framework.
-  Will allocate a buffer to hold the loaded data.
-
-  @param[in]  FrameworkHandle   A pointer to the framework that is being persisted.
-  @param[in]  SaveData          A pointer pointer that will be updated with the address
-                                of the loaded data buffer.
-
-  @retval     EFI_SUCCESS       Data has been loaded successfully and SaveData is updated
-                                with a pointer to the buffer.
-  @retval     Others            An error has occurred and no data has been loaded. SaveData
-                                is set to NULL.
-
-**/
-EFI_STATUS
-EFIAPI
-LoadUnitTestCache (
-  IN  UNIT_TEST_FRAMEWORK_HANDLE  FrameworkHandle,
-  OUT UNIT_TEST_SAVE_HEADER       **SaveData
-  )
-{
-  EFI_STATUS                    Status;
-  EFI_DEVICE_PATH_PROTOCOL      *FileDevicePath;
-  EFI_HANDLE                    FileDeviceHandle;
-  SHELL_FILE_HANDLE             FileHandle;
-  BOOLEAN                       IsFileOpened = FALSE;
-  UINT64                        LargeFileSize;
-  UINTN                         FileSize;
-  UNIT_TEST_SAVE_HEADER         *Buffer = NULL;
-
-  //
-  // Check the inputs for sanity.
-  if (FrameworkHandle == NULL || SaveData == NULL)
-  {
-    return EFI_INVALID_PARAMETER;
-  }
-
-  //
-  // Determine the path for the cache file.
-  // NOTE: This devpath is allocated and must be freed.
-  FileDevicePath = GetCacheFileDevicePath( FrameworkHandle );
-
-  // TODO: Add metadata for the file protocol. Signatures and fingerprint checking.
-
-  //
-  // Now that we know the path to the file... let's open it for writing.
-  //
-  Status = ShellOpenFileByDevicePath( &FileDevicePath,
-                                      &FileDeviceHandle,
-                                      &FileHandle,
-                                      EFI_FILE_MODE_READ,
-                                      0 );
-  if (EFI_ERROR( Status ))
-  {
-    DEBUG(( DEBUG_ERROR, __FUNCTION__" - Opening file for writing failed! %r\n", Status ));
-    goto Exit;
-  }
-  else
-  {
-    IsFileOpened = TRUE;
-  }
-
-  //
-  // Now that the file is opened, we need to determine how large a buffer we need.
-  Status = ShellGetFileSize( FileHandle, &LargeFileSize );
-  if (EFI_ERROR( Status ))
-  {
-    DEBUG(( DEBUG_ERROR, __FUNCTION__" - Failed to determine file size! %r\n", Status ));
-    goto Exit;
-  }
-
-  //
-  // Now that we know the size, let's allocated a buffer to hold the contents.
-  FileSize = (UINTN)LargeFileSize;    // You know what... if it's too large, this lib don't care.
-  Buffer = AllocatePool( FileSize );
-  if (Buffer == NULL)
-  {
-    DEBUG(( DEBUG_ERROR, __FUNCTION__" - Failed to allocate a pool to hold the file contents! %r\n", Status ));
-    Status = EFI_OUT_OF_RESOURCES;
-    goto Exit;
-  }
-
-  //
-  // Finally, let's read the bloody data.
-  Status = ShellReadFile( FileHandle, &FileSize, Buffer );
-  if (EFI_ERROR( Status ))
-  {
-    DEBUG(( DEBUG_ERROR, __FUNCTION__" - Failed to read the file contents! %r\n", Status ));
-  }
-
-Exit:
-  //
-  // Always put away your toys.
-  if (FileDevicePath != NULL)
-  {
-    FreePool( FileDevicePath );
-  }
-  if (IsFileOpened)
-  {
-    ShellCloseFile( &FileHandle );
-  }
-
-  //
-  // If we're returning an error, make sure
-  // the state is sane.
-  if (EFI_ERROR( Status ) && Buffer != NULL)
-  {
-    FreePool( Buffer );
-    Buffer = NULL;
-  }
-
-  *SaveData = Buffer;
-  return Status;
-} // LoadUnitTestCache()
+/** @file -- UnitTestFilesystemPersistenceLib.c
+This is an instance of the Unit Test Persistence Lib that will utilize
+the filesystem that a test application is running from to save a serialized
+version of the internal test state in case the test needs to quit and restore.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+
+
+Copyright (C) 2016 Microsoft Corporation. All Rights Reserved.
+
+**/
+
+#include <Library/UnitTestLib.h>
+#include <Library/BaseLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/ShellLib.h>
+#include <Library/UnitTestFilePathLib.h>
+
+#include "UnitTestPersistenceLib.h"
+#include "Compress.h"
+
+//
+// Both files live next to the test app, named "<ShortTitle><Suffix>".
+//
+#define UNIT_TEST_CACHE_FILE_SUFFIX       L"_Cache.dat"
+#define UNIT_TEST_BASELINE_FILE_SUFFIX    L"_Baseline.dat"
+
+//
+// What the lib holds on to for each framework between calls, so that a
+// checkpoint is a write and a flush instead of working out the path to the
+// cache and opening it all over again. Hangs off the framework's PersistenceSession.
+//
+typedef struct {
+  EFI_DEVICE_PATH_PROTOCOL    *CacheFilePath;   // Resolved the first time the cache is opened.
+  SHELL_FILE_HANDLE           CacheFile;        // Open for reading and writing, or NULL.
+} UNIT_TEST_FILESYSTEM_SESSION;
+
+
+/**
+  The cache lives next to the test app, in "<ShortTitle>_Cache.dat".
+
+  @retval     !NULL   A pool-allocated device path for the cache file. Must be freed by the caller.
+  @retval     NULL    The app's location could not be determined or an error occurred.
+
+**/
+STATIC
+EFI_DEVICE_PATH_PROTOCOL*
+GetCacheFileDevicePath (
+  IN  UNIT_TEST_FRAMEWORK_HANDLE  FrameworkHandle
+  )
+{
+  return GetUnitTestFileDevicePath( FrameworkHandle, UNIT_TEST_CACHE_FILE_SUFFIX );
+} // GetCacheFileDevicePath()
+
+
+/**
+  Closes the cache file, if it's open, so that the next call opens it afresh.
+  Used after an error, in case the file system has gone away underneath it.
+
+**/
+STATIC
+VOID
+CloseCacheFile (
+  IN  UNIT_TEST_FILESYSTEM_SESSION  *Session
+  )
+{
+  if (Session->CacheFile != NULL)
+  {
+    ShellCloseFile( &Session->CacheFile );
+    Session->CacheFile = NULL;
+  }
+
+  return;
+} // CloseCacheFile()
+
+
+/**
+  Returns the framework's open cache file, opening it first if need be.
+
+  @param[in]  FrameworkHandle   A pointer to the framework that is being persisted.
+  @param[in]  Create            Create the file if it doesn't exist yet.
+  @param[out] Session           The framework's session, with CacheFile open.
+
+  @retval     EFI_SUCCESS   (*Session)->CacheFile is open.
+  @retval     Others        The cache couldn't be opened.
+
+**/
+STATIC
+EFI_STATUS
+OpenCacheFile (
+  IN  UNIT_TEST_FRAMEWORK_HANDLE      FrameworkHandle,
+  IN  BOOLEAN                         Create,
+  OUT UNIT_TEST_FILESYSTEM_SESSION    **Session
+  )
+{
+  UNIT_TEST_FRAMEWORK             *Framework = (UNIT_TEST_FRAMEWORK*)FrameworkHandle;
+  UNIT_TEST_FILESYSTEM_SESSION    *NewSession;
+  EFI_DEVICE_PATH_PROTOCOL        *DevicePath;
+  EFI_HANDLE                      FileDeviceHandle;
+  EFI_STATUS                      Status;
+
+  NewSession = Framework->PersistenceSession;
+  if (NewSession == NULL)
+  {
+    NewSession = AllocateZeroPool( sizeof( UNIT_TEST_FILESYSTEM_SESSION ) );
+    if (NewSession == NULL)
+    {
+      return EFI_OUT_OF_RESOURCES;
+    }
+    Framework->PersistenceSession = NewSession;
+  }
+  *Session = NewSession;
+
+  if (NewSession->CacheFile != NULL)
+  {
+    return EFI_SUCCESS;
+  }
+
+  //
+  // Determine the path for the file. This only has to happen once.
+  if (NewSession->CacheFilePath == NULL)
+  {
+    NewSession->CacheFilePath = GetCacheFileDevicePath( FrameworkHandle );
+    if (NewSession->CacheFilePath == NULL)
+    {
+      return EFI_NOT_FOUND;
+    }
+  }
+
+  //
+  // It's opened for writing even when it's only being read, since it's going to be written eventually.
+  // NOTE: It doesn't *seem* like it would be necessary to specify the EFI_FILE_MODE_READ attribute,
+  //       but without it this call will throw an EFI_INVALID_PARAMETER error.
+  // NOTE: ShellOpenFileByDevicePath() moves the device path pointer along, so hand it a copy.
+  DevicePath = NewSession->CacheFilePath;
+  Status = ShellOpenFileByDevicePath( &DevicePath,
+                                      &FileDeviceHandle,
+                                      &NewSession->CacheFile,
+                                      (EFI_FILE_MODE_READ | EFI_FILE_MODE_WRITE | (Create ? EFI_FILE_MODE_CREATE : 0)),
+                                      0 );
+  if (EFI_ERROR( Status ))
+  {
+    NewSession->CacheFile = NULL;
+  }
+
+  return Status;
+} // OpenCacheFile()
+
+
+/**
+  Determines whether a persistence cache already exists for
+  the given framework.
+
+  @param[in]  FrameworkHandle   A pointer to the framework that is being persisted.
+
+  @retval     TRUE
+  @retval     FALSE   Cache doesn't exist or an error occurred.
+
+**/
+BOOLEAN
+EFIAPI
+DoesCacheExist (
+  IN  UNIT_TEST_FRAMEWORK_HANDLE  FrameworkHandle
+  )
+{
+  UNIT_TEST_FILESYSTEM_SESSION    *Session;
+  EFI_STATUS                      Status;
+
+  // If the file can be opened, it exists. Otherwise, probably not.
+  // Either way, it's left open for the load that usually comes next.
+  Status = OpenCacheFile( FrameworkHandle, FALSE, &Session );
+
+  DEBUG(( DEBUG_VERBOSE, "%a - Returning %d\n", __FUNCTION__, !EFI_ERROR( Status ) ));
+
+  return !EFI_ERROR( Status );
+} // DoesCacheExist()
+
+
+/**
+  Writes Size bytes of Data to the cache, through the framework's session.
+  If Append is set, Data is added to the end of the cache. Otherwise, it replaces
+  whatever was there. Either way, it's flushed before this returns, so it will
+  survive a reset.
+
+**/
+STATIC
+EFI_STATUS
+WriteCacheFile (
+  IN  UNIT_TEST_FRAMEWORK_HANDLE  FrameworkHandle,
+  IN  VOID                        *Data,
+  IN  UINTN                       Size,
+  IN  BOOLEAN                     Append
+  )
+{
+  UNIT_TEST_FILESYSTEM_SESSION    *Session;
+  EFI_FILE_INFO                   *FileInfo;
+  EFI_STATUS                      Status;
+  UINTN                           WriteCount;
+
+  Status = OpenCacheFile( FrameworkHandle, TRUE, &Session );
+  if (EFI_ERROR( Status ))
+  {
+    DEBUG(( DEBUG_ERROR, "%a - Opening file for writing failed! %r\n", __FUNCTION__, Status ));
+    return Status;
+  }
+
+  //
+  // Unless we're adding to it, empty the file first. Like deleting it used to,
+  // that leaves nothing of the old cache behind if the write is cut short.
+  if (!Append)
+  {
+    FileInfo = ShellGetFileInfo( Session->CacheFile );
+    if (FileInfo == NULL)
+    {
+      Status = EFI_DEVICE_ERROR;
+    }
+    else
+    {
+      if (FileInfo->FileSize != 0)
+      {
+        FileInfo->FileSize = 0;
+        Status = ShellSetFileInfo( Session->CacheFile, FileInfo );
+      }
+      FreePool( FileInfo );
+    }
+    if (EFI_ERROR( Status ))
+    {
+      DEBUG(( DEBUG_ERROR, "%a - Emptying the file failed! %r\n", __FUNCTION__, Status ));
+      goto Exit;
+    }
+  }
+
+  //
+  // Position 0xFFFFFFFFFFFFFFFF is the end of the file.
+  Status = ShellSetFilePosition( Session->CacheFile, Append ? MAX_UINT64 : 0 );
+  if (EFI_ERROR( Status ))
+  {
+    DEBUG(( DEBUG_ERROR, "%a - Seeking failed! %r\n", __FUNCTION__, Status ));
+    goto Exit;
+  }
+
+  //
+  // Write the data to the file, and make sure it's all the way out to the disk.
+  WriteCount = Size;
+  DEBUG(( DEBUG_INFO, "%a - Writing %d bytes to file...\n", __FUNCTION__, WriteCount ));
+  Status = ShellWriteFile( Session->CacheFile, &WriteCount, Data );
+  if (!EFI_ERROR( Status ) && WriteCount != Size)
+  {
+    Status = EFI_DEVICE_ERROR;
+  }
+  if (!EFI_ERROR( Status ))
+  {
+    Status = ShellFlushFile( Session->CacheFile );
+  }
+
+  if (EFI_ERROR( Status ))
+  {
+    DEBUG(( DEBUG_ERROR, "%a - Writing to file failed! %r\n", __FUNCTION__, Status ));
+  }
+  else
+  {
+    DEBUG(( DEBUG_INFO, "%a - SUCCESS!\n", __FUNCTION__ ));
+  }
+
+Exit:
+  if (EFI_ERROR( Status ))
+  {
+    CloseCacheFile( Session );
+  }
+
+  return Status;
+} // WriteCacheFile()
+
+
+/**
+  Writes a save to the cache with WriteCacheFile(), compressed if that helps.
+  Logs make up most of a save and shrink a lot, which pays for itself on slow media.
+
+**/
+STATIC
+EFI_STATUS
+WriteCacheSave (
+  IN  UNIT_TEST_FRAMEWORK_HANDLE  FrameworkHandle,
+  IN  UNIT_TEST_SAVE_HEADER       *SaveData,
+  IN  BOOLEAN                     Append
+  )
+{
+  EFI_STATUS                Status;
+  UNIT_TEST_SAVE_HEADER     *Compressed, *Data;
+
+  Compressed  = CompressUnitTestSave( SaveData );
+  Data        = (Compressed != NULL) ? Compressed : SaveData;
+  Status      = WriteCacheFile( FrameworkHandle, Data, Data->BlobSize, Append );
+  if (Compressed != NULL)
+  {
+    FreePool( Compressed );
+  }
+
+  return Status;
+} // WriteCacheSave()
+
+
+/**
+  Writes Size bytes of Data to "<ShortTitle><FileSuffix>", next to the test app,
+  replacing whatever was there. This is for files that are written once a run;
+  the cache goes through WriteCacheFile() instead.
+
+**/
+STATIC
+EFI_STATUS
+WriteUnitTestFile (
+  IN  UNIT_TEST_FRAMEWORK_HANDLE  FrameworkHandle,
+  IN  CONST CHAR16                *FileSuffix,
+  IN  VOID                        *Data,
+  IN  UINTN                       Size
+  )
+{
+  EFI_DEVICE_PATH_PROTOCOL      *FileDevicePath;
+  EFI_DEVICE_PATH_PROTOCOL      *DevicePath;
+  EFI_STATUS                    Status;
+  EFI_HANDLE                    FileDeviceHandle;
+  SHELL_FILE_HANDLE             FileHandle;
+  UINTN                         WriteCount;
+
+  //
+  // Determine the path for the file.
+  // NOTE: This devpath is allocated and must be freed.
+  FileDevicePath = GetUnitTestFileDevicePath( FrameworkHandle, FileSuffix );
+  if (FileDevicePath == NULL)
+  {
+    return EFI_NOT_FOUND;
+  }
+
+  // TODO: Add metadata for the file protocol. Signatures and fingerprint checking.
+
+  //
+  // Opening a file that already exists won't truncate it, so get rid of the old one first.
+  // NOTE: ShellOpenFileByDevicePath() moves the device path pointer along, so hand it a copy.
+  DevicePath = FileDevicePath;
+  Status = ShellOpenFileByDevicePath( &DevicePath,
+                                      &FileDeviceHandle,
+                                      &FileHandle,
+                                      (EFI_FILE_MODE_READ | EFI_FILE_MODE_WRITE),
+                                      0 );
+  if (!EFI_ERROR( Status ))
+  {
+    ShellDeleteFile( &FileHandle );
+  }
+
+  //
+  // Now that we know the path to the file... let's open it for writing.
+  //
+  // NOTE: It doesn't *seem* like it would be necessary to specify the EFI_FILE_MODE_READ attribute,
+  //       but without it this call will throw an EFI_INVALID_PARAMETER error.
+  DevicePath = FileDevicePath;
+  Status = ShellOpenFileByDevicePath( &DevicePath,
+                                      &FileDeviceHandle,
+                                      &FileHandle,
+                                      (EFI_FILE_MODE_READ | EFI_FILE_MODE_WRITE | EFI_FILE_MODE_CREATE),
+                                      0 );
+  if (EFI_ERROR( Status ))
+  {
+    DEBUG(( DEBUG_ERROR, "%a - Opening file for writing failed! %r\n", __FUNCTION__, Status ));
+    goto Exit;
+  }
+
+  //
+  // Write the data to the file.
+  //
+  WriteCount = Size;
+  DEBUG(( DEBUG_INFO, "%a - Writing %d bytes to file...\n", __FUNCTION__, WriteCount ));
+  Status = ShellWriteFile( FileHandle,
+                           &WriteCount,
+                           Data );
+
+  if (EFI_ERROR( Status ) || WriteCount != Size)
+  {
+    DEBUG(( DEBUG_ERROR, "%a - Writing to file failed! %r\n", __FUNCTION__, Status ));
+    if (!EFI_ERROR( Status ))
+    {
+      Status = EFI_DEVICE_ERROR;
+    }
+  }
+  else
+  {
+    DEBUG(( DEBUG_INFO, "%a - SUCCESS!\n", __FUNCTION__ ));
+  }
+
+  //
+  // No matter what, we should probably close the file.
+  //
+  ShellCloseFile( &FileHandle );
+
+Exit:
+  FreePool( FileDevicePath );
+
+  return Status;
+} // WriteUnitTestFile()
+
+
+/**
+  Reads all of an open file, from the start, into a pool buffer.
+
+  @retval     EFI_SUCCESS   *Data points to a buffer of *Size bytes. Must be freed by the caller.
+  @retval     Others        Nothing was read. *Data is set to NULL.
+
+**/
+STATIC
+EFI_STATUS
+ReadWholeFile (
+  IN  SHELL_FILE_HANDLE           FileHandle,
+  OUT VOID                        **Data,
+  OUT UINTN                       *Size
+  )
+{
+  EFI_STATUS                    Status;
+  UINT64                        LargeFileSize;
+  UINTN                         FileSize = 0;
+  VOID                          *Buffer = NULL;
+
+  //
+  // First, we need to determine how large a buffer we need.
+  Status = ShellGetFileSize( FileHandle, &LargeFileSize );
+  if (EFI_ERROR( Status ))
+  {
+    DEBUG(( DEBUG_ERROR, "%a - Failed to determine file size! %r\n", __FUNCTION__, Status ));
+    goto Exit;
+  }
+
+  //
+  // Now that we know the size, let's allocated a buffer to hold the contents.
+  FileSize = (UINTN)LargeFileSize;    // You know what... if it's too large, this lib don't care.
+  Buffer = AllocatePool( FileSize );
+  if (Buffer == NULL)
+  {
+    DEBUG(( DEBUG_ERROR, "%a - Failed to allocate a pool to hold the file contents! %r\n", __FUNCTION__, Status ));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Exit;
+  }
+
+  //
+  // Finally, let's read the bloody data.
+  Status = ShellSetFilePosition( FileHandle, 0 );
+  if (!EFI_ERROR( Status ))
+  {
+    Status = ShellReadFile( FileHandle, &FileSize, Buffer );
+  }
+  if (EFI_ERROR( Status ))
+  {
+    DEBUG(( DEBUG_ERROR, "%a - Failed to read the file contents! %r\n", __FUNCTION__, Status ));
+  }
+
+Exit:
+  //
+  // If we're returning an error, make sure
+  // the state is sane.
+  if (EFI_ERROR( Status ) && Buffer != NULL)
+  {
+    FreePool( Buffer );
+    Buffer = NULL;
+  }
+
+  *Data = Buffer;
+  *Size = FileSize;
+  return Status;
+} // ReadWholeFile()
+
+
+/**
+  Reads all of "<ShortTitle><FileSuffix>", next to the test app, into a pool buffer.
+
+  @retval     EFI_SUCCESS   *Data points to a buffer of *Size bytes. Must be freed by the caller.
+  @retval     Others        Nothing was read. *Data is set to NULL.
+
+**/
+STATIC
+EFI_STATUS
+ReadUnitTestFile (
+  IN  UNIT_TEST_FRAMEWORK_HANDLE  FrameworkHandle,
+  IN  CONST CHAR16                *FileSuffix,
+  OUT VOID                        **Data,
+  OUT UINTN                       *Size
+  )
+{
+  EFI_STATUS                    Status;
+  EFI_DEVICE_PATH_PROTOCOL      *FileDevicePath;
+  EFI_HANDLE                    FileDeviceHandle;
+  SHELL_FILE_HANDLE             FileHandle;
+
+  *Data = NULL;
+  *Size = 0;
+
+  //
+  // Determine the path for the file.
+  // NOTE: This devpath is allocated and must be freed.
+  FileDevicePath = GetUnitTestFileDevicePath( FrameworkHandle, FileSuffix );
+
+  // TODO: Add metadata for the file protocol. Signatures and fingerprint checking.
+
+  //
+  // Now that we know the path to the file... let's open it for reading.
+  //
+  Status = ShellOpenFileByDevicePath( &FileDevicePath,
+                                      &FileDeviceHandle,
+                                      &FileHandle,
+                                      EFI_FILE_MODE_READ,
+                                      0 );
+  if (EFI_ERROR( Status ))
+  {
+    // A missing baseline is normal, so only complain about anything else.
+    DEBUG(( (Status == EFI_NOT_FOUND) ? DEBUG_VERBOSE : DEBUG_ERROR, "%a - Opening file for reading failed! %r\n", __FUNCTION__, Status ));
+  }
+  else
+  {
+    Status = ReadWholeFile( FileHandle, Data, Size );
+    ShellCloseFile( &FileHandle );
+  }
+
+  //
+  // Always put away your toys.
+  if (FileDevicePath != NULL)
+  {
+    FreePool( FileDevicePath );
+  }
+
+  return Status;
+} // ReadUnitTestFile()
+
+
+/**
+  Finds the slot for a fingerprint in an open-addressed table of saved tests.
+  Returns either the slot holding that fingerprint or the empty slot where it belongs.
+
+**/
+STATIC
+UINTN
+GetMergeSlot (
+  IN  UNIT_TEST_SAVE_TEST   **Slots,
+  IN  UINTN                 SlotCount,
+  IN  UINT8                 *Fingerprint
+  )
+{
+  UINTN     Index;
+
+  // Fingerprints are hashes already, so any bits of one will do.
+  Index = (UINTN)ReadUnaligned32( (UINT32*)Fingerprint ) & (SlotCount - 1);
+  while (Slots[Index] != NULL &&
+         CompareMem( &Slots[Index]->Fingerprint[0], Fingerprint, UNIT_TEST_FINGERPRINT_SIZE ) != 0)
+  {
+    Index = (Index + 1) & (SlotCount - 1);
+  }
+
+  return Index;
+} // GetMergeSlot()
+
+
+/**
+  Replays the saves in the cache into a single save. Each test keeps the
+  position where it first appeared, with the contents from its last record.
+  The header and any saved context come from the last save.
+
+  A save that was cut short (by a reset, say) only ever leaves a partial record
+  at the end of the cache, so anything that doesn't parse from there on is dropped.
+
+  Saves are expanded as they're merged, so a merged save is never compressed.
+  A single save is passed back as it is.
+
+  @param[in]  Cache         The contents of the cache file.
+  @param[in]  CacheSize     The size of the cache file.
+  @param[out] SaveData      The merged save. This is Cache itself if it only held one save.
+  @param[out] NeedsRewrite  TRUE if the cache file doesn't match SaveData and should be rewritten.
+
+**/
+STATIC
+EFI_STATUS
+MergeUnitTestCache (
+  IN  UNIT_TEST_SAVE_HEADER   *Cache,
+  IN  UINTN                   CacheSize,
+  OUT UNIT_TEST_SAVE_HEADER   **SaveData,
+  OUT BOOLEAN                 *NeedsRewrite
+  )
+{
+  EFI_STATUS              Status = EFI_SUCCESS;
+  UNIT_TEST_SAVE_HEADER   *Record, *LastRecord = NULL, *Merged, **Expanded = NULL;
+  UNIT_TEST_SAVE_TEST     *Test, **Slots = NULL;
+  UNIT_TEST_SAVE_CONTEXT  *Context = NULL;
+  UINTN                   *Order = NULL;
+  UINTN                   Offset, RecordCount, TotalTests, SlotCount, Slot, OrderCount, MergedSize, ContextSize = 0;
+  UINTN                   Index, RecordIndex;
+  UINT8                   *FloatingPointer, *RecordEnd;
+
+  *SaveData     = NULL;
+  *NeedsRewrite = FALSE;
+
+  //
+  // First, find out how many complete saves there are.
+  Offset      = 0;
+  RecordCount = 0;
+  TotalTests  = 0;
+  while (CacheSize - Offset >= sizeof( UNIT_TEST_SAVE_HEADER ))
+  {
+    Record = (UNIT_TEST_SAVE_HEADER*)((UINT8*)Cache + Offset);
+    if (Record->Version != UNIT_TEST_PERSISTENCE_LIB_VERSION ||
+        Record->BlobSize < sizeof( UNIT_TEST_SAVE_HEADER ) ||
+        Record->BlobSize > CacheSize - Offset ||
+        (RecordCount > 0 && CompareMem( &Record->Fingerprint[0], &Cache->Fingerprint[0], UNIT_TEST_FINGERPRINT_SIZE ) != 0))
+    {
+      break;
+    }
+    LastRecord  = Record;
+    TotalTests += Record->TestCount;
+    RecordCount++;
+    Offset     += Record->BlobSize;
+  }
+  if (LastRecord == NULL)
+  {
+    DEBUG(( DEBUG_ERROR, "%a - Cache doesn't start with a save.\n", __FUNCTION__ ));
+    return EFI_VOLUME_CORRUPTED;
+  }
+  if (Offset != CacheSize)
+  {
+    DEBUG(( DEBUG_WARN, "%a - Dropping %d bytes from the end of the cache.\n", __FUNCTION__, CacheSize - Offset ));
+    *NeedsRewrite = TRUE;
+  }
+
+  //
+  // One save is already what the framework expects.
+  if (RecordCount == 1)
+  {
+    *SaveData = Cache;
+    return EFI_SUCCESS;
+  }
+
+  //
+  // Otherwise, index every test record by fingerprint, letting later ones replace earlier ones.
+  SlotCount = 16;
+  while (SlotCount < TotalTests * 2)
+  {
+    SlotCount *= 2;
+  }
+  Slots     = AllocateZeroPool( SlotCount * sizeof( *Slots ) );
+  Order     = AllocatePool( (TotalTests + 1) * sizeof( *Order ) );
+  Expanded  = AllocateZeroPool( RecordCount * sizeof( *Expanded ) );
+  if (Slots == NULL || Order == NULL || Expanded == NULL)
+  {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Exit;
+  }
+
+  OrderCount  = 0;
+  MergedSize  = sizeof( UNIT_TEST_SAVE_HEADER );
+  Record      = Cache;
+  for (RecordIndex = 0; RecordIndex < RecordCount; RecordIndex++)
+  {
+    // The slots point into the expanded saves, so they're all kept until the end.
+    Status = ExpandUnitTestSave( Record, &Expanded[RecordIndex] );
+    if (EFI_ERROR( Status ))
+    {
+      DEBUG(( DEBUG_ERROR, "%a - Save %d can't be expanded. %r\n", __FUNCTION__, RecordIndex, Status ));
+      Expanded[RecordIndex] = NULL;
+      goto Exit;
+    }
+    FloatingPointer = (UINT8*)Expanded[RecordIndex] + sizeof( UNIT_TEST_SAVE_HEADER );
+    RecordEnd       = (UINT8*)Expanded[RecordIndex] + Expanded[RecordIndex]->BlobSize;
+    for (Index = 0; Index < Record->TestCount; Index++)
+    {
+      Test = (UNIT_TEST_SAVE_TEST*)FloatingPointer;
+      if ((UINTN)(RecordEnd - FloatingPointer) < sizeof( UNIT_TEST_SAVE_TEST ) ||
+          Test->Size < sizeof( UNIT_TEST_SAVE_TEST ) ||
+          Test->Size > (UINTN)(RecordEnd - FloatingPointer))
+      {
+        DEBUG(( DEBUG_ERROR, "%a - Save %d is corrupt.\n", __FUNCTION__, RecordIndex ));
+        Status = EFI_VOLUME_CORRUPTED;
+        goto Exit;
+      }
+
+      Slot = GetMergeSlot( Slots, SlotCount, &Test->Fingerprint[0] );
+      if (Slots[Slot] == NULL)
+      {
+        Order[OrderCount++] = Slot;
+      }
+      else
+      {
+        MergedSize -= Slots[Slot]->Size;
+      }
+      MergedSize  += Test->Size;
+      Slots[Slot]  = Test;
+      FloatingPointer += Test->Size;
+    }
+
+    //
+    // Only the context from the last save still matters.
+    if (Record == LastRecord && Record->HasSavedContext)
+    {
+      Context = (UNIT_TEST_SAVE_CONTEXT*)FloatingPointer;
+      if ((UINTN)(RecordEnd - FloatingPointer) < sizeof( UNIT_TEST_SAVE_CONTEXT ) ||
+          Context->Size > (UINTN)(RecordEnd - FloatingPointer) - sizeof( UNIT_TEST_SAVE_CONTEXT ))
+      {
+        DEBUG(( DEBUG_ERROR, "%a - Saved context is corrupt.\n", __FUNCTION__ ));
+        Status = EFI_VOLUME_CORRUPTED;
+        goto Exit;
+      }
+      ContextSize = sizeof( UNIT_TEST_SAVE_CONTEXT ) + Context->Size;
+      MergedSize += ContextSize;
+    }
+
+    Record = (UNIT_TEST_SAVE_HEADER*)((UINT8*)Record + Record->BlobSize);
+  }
+
+  //
+  // Now lay the merged save out the same way SerializeState() would have.
+  Merged = AllocatePool( MergedSize );
+  if (Merged == NULL)
+  {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Exit;
+  }
+  CopyMem( Merged, Expanded[RecordCount - 1], sizeof( UNIT_TEST_SAVE_HEADER ) );
+  Merged->BlobSize      = (UINT32)MergedSize;
+  Merged->ExpandedSize  = (UINT32)MergedSize;
+  Merged->TestCount = (UINT32)OrderCount;
+  FloatingPointer = (UINT8*)Merged + sizeof( UNIT_TEST_SAVE_HEADER );
+  for (Index = 0; Index < OrderCount; Index++)
+  {
+    Test = Slots[Order[Index]];
+    CopyMem( FloatingPointer, Test, Test->Size );
+    FloatingPointer += Test->Size;
+  }
+  if (Context != NULL)
+  {
+    CopyMem( FloatingPointer, Context, ContextSize );
+  }
+
+  DEBUG(( DEBUG_INFO, "%a - Merged %d saves into %d bytes.\n", __FUNCTION__, RecordCount, MergedSize ));
+  *SaveData     = Merged;
+  *NeedsRewrite = TRUE;
+
+Exit:
+  if (Slots != NULL)
+  {
+    FreePool( Slots );
+  }
+  if (Order != NULL)
+  {
+    FreePool( Order );
+  }
+  if (Expanded != NULL)
+  {
+    // Only the saves that were compressed got buffers of their own.
+    Record = Cache;
+    for (RecordIndex = 0; RecordIndex < RecordCount; RecordIndex++)
+    {
+      if (Expanded[RecordIndex] != NULL && Expanded[RecordIndex] != Record)
+      {
+        FreePool( Expanded[RecordIndex] );
+      }
+      Record = (UNIT_TEST_SAVE_HEADER*)((UINT8*)Record + Record->BlobSize);
+    }
+    FreePool( Expanded );
+  }
+
+  return Status;
+} // MergeUnitTestCache()
+
+
+/**
+  Will save the data associated with an internal Unit Test Framework
+  state in a manner that can persist a Unit Test Application quit or
+  even a system reboot.
+
+  @param[in]  FrameworkHandle   A pointer to the framework that is being persisted.
+  @param[in]  SaveData          A pointer to the buffer containing the serialized
+                                framework internal state.
+
+  @retval     EFI_SUCCESS   Data is persisted and the test can be safely quit.
+  @retval     Others        Data is not persisted and test cannot be resumed upon exit.
+
+**/
+EFI_STATUS
+EFIAPI
+SaveUnitTestCache (
+  IN  UNIT_TEST_FRAMEWORK_HANDLE  FrameworkHandle,
+  IN  UNIT_TEST_SAVE_HEADER       *SaveData
+  )
+{
+  //
+  // Check the inputs for sanity.
+  if (FrameworkHandle == NULL || SaveData == NULL)
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  return WriteCacheSave( FrameworkHandle, SaveData, FALSE );
+} // SaveUnitTestCache()
+
+
+/**
+  Will add a save to the end of the existing cache. SaveData only carries the
+  tests that have changed since the last save. Only used once the cache holds
+  a complete save from SaveUnitTestCache() or LoadUnitTestCache().
+
+  @param[in]  FrameworkHandle   A pointer to the framework that is being persisted.
+  @param[in]  SaveData          A pointer to the buffer containing the changes.
+
+  @retval     EFI_SUCCESS       Data is persisted and the test can be safely quit.
+  @retval     EFI_UNSUPPORTED   The cache can only be saved whole. Use SaveUnitTestCache().
+  @retval     Others            Data is not persisted and test cannot be resumed upon exit.
+
+**/
+EFI_STATUS
+EFIAPI
+AppendUnitTestCache (
+  IN  UNIT_TEST_FRAMEWORK_HANDLE  FrameworkHandle,
+  IN  UNIT_TEST_SAVE_HEADER       *SaveData
+  )
+{
+  //
+  // Check the inputs for sanity.
+  if (FrameworkHandle == NULL || SaveData == NULL)
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  return WriteCacheSave( FrameworkHandle, SaveData, TRUE );
+} // AppendUnitTestCache()
+
+
+/**
+  Will retrieve any cached state associated with the given framework.
+  Will allocate a buffer to hold the loaded data.
+
+  @param[in]  FrameworkHandle   A pointer to the framework that is being persisted.
+  @param[in]  SaveData          A pointer pointer that will be updated with the address
+                                of the loaded data buffer.
+
+  @retval     EFI_SUCCESS             Data has been loaded successfully and SaveData is updated
+                                      with a pointer to the buffer.
+  @retval     EFI_WARN_WRITE_FAILURE  Data has been loaded, but the cache could not be compacted.
+  @retval     Others                  An error has occurred and no data has been loaded. SaveData
+                                      is set to NULL.
+
+**/
+EFI_STATUS
+EFIAPI
+LoadUnitTestCache (
+  IN  UNIT_TEST_FRAMEWORK_HANDLE  FrameworkHandle,
+  OUT UNIT_TEST_SAVE_HEADER       **SaveData
+  )
+{
+  EFI_STATUS                    Status;
+  UNIT_TEST_FILESYSTEM_SESSION  *Session;
+  UNIT_TEST_SAVE_HEADER         *Cache, *Expanded;
+  UINTN                         FileSize;
+  BOOLEAN                       NeedsRewrite;
+
+  //
+  // Check the inputs for sanity.
+  if (FrameworkHandle == NULL || SaveData == NULL)
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+  *SaveData = NULL;
+
+  Status = OpenCacheFile( FrameworkHandle, FALSE, &Session );
+  if (EFI_ERROR( Status ))
+  {
+    DEBUG(( (Status == EFI_NOT_FOUND) ? DEBUG_VERBOSE : DEBUG_ERROR, "%a - Opening the cache failed! %r\n", __FUNCTION__, Status ));
+    return Status;
+  }
+  Status = ReadWholeFile( Session->CacheFile, (VOID**)&Cache, &FileSize );
+  if (EFI_ERROR( Status ))
+  {
+    CloseCacheFile( Session );
+    return Status;
+  }
+
+  //
+  // Replay all of the saves into one.
+  Status = MergeUnitTestCache( Cache, FileSize, SaveData, &NeedsRewrite );
+  if (*SaveData != Cache)
+  {
+    FreePool( Cache );
+  }
+  if (EFI_ERROR( Status ))
+  {
+    return Status;
+  }
+
+  //
+  // A merged save has already been expanded, but a lone one may not have been.
+  Status = ExpandUnitTestSave( *SaveData, &Expanded );
+  if (EFI_ERROR( Status ))
+  {
+    FreePool( *SaveData );
+    *SaveData = NULL;
+    return Status;
+  }
+  if (Expanded != *SaveData)
+  {
+    FreePool( *SaveData );
+    *SaveData = Expanded;
+  }
+  if (!NeedsRewrite)
+  {
+    return EFI_SUCCESS;
+  }
+
+  //
+  // Compact the cache so that it doesn't keep growing from one boot to the next,
+  // and so that anything left over from a save that was cut short is gone before
+  // the next save is appended. If that fails, what was loaded is still good;
+  // the next save just has to be a whole one.
+  Status = WriteCacheSave( FrameworkHandle, *SaveData, FALSE );
+  if (EFI_ERROR( Status ))
+  {
+    DEBUG(( DEBUG_ERROR, "%a - Failed to compact the cache! %r\n", __FUNCTION__, Status ));
+    return EFI_WARN_WRITE_FAILURE;
+  }
+
+  return EFI_SUCCESS;
+} // LoadUnitTestCache()
+
+
+/**
+  Will save the performance baseline for the given framework. Unlike the
+  cache, the baseline is meant to stay around from one run to the next.
+
+  @param[in]  FrameworkHandle   A pointer to the framework that the baseline belongs to.
+  @param[in]  Baseline          A pointer to the serialized baseline.
+
+  @retval     EFI_SUCCESS   The baseline is persisted.
+  @retval     Others        The baseline is not persisted.
+
+**/
+EFI_STATUS
+EFIAPI
+SaveUnitTestBaseline (
+  IN  UNIT_TEST_FRAMEWORK_HANDLE  FrameworkHandle,
+  IN  UNIT_TEST_BASELINE_HEADER   *Baseline
+  )
+{
+  if (FrameworkHandle == NULL || Baseline == NULL)
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  return WriteUnitTestFile( FrameworkHandle, UNIT_TEST_BASELINE_FILE_SUFFIX, Baseline, Baseline->BlobSize );
+} // SaveUnitTestBaseline()
+
+
+/**
+  Will retrieve the performance baseline for the given framework, if there is one.
+  Will allocate a buffer to hold the loaded data.
+
+  @param[in]  FrameworkHandle   A pointer to the framework that the baseline belongs to.
+  @param[in]  Baseline          A pointer pointer that will be updated with the address
+                                of the loaded data buffer.
+
+  @retval     EFI_SUCCESS       The baseline has been loaded and Baseline is updated with
+                                a pointer to the buffer. At least BlobSize bytes were read.
+  @retval     Others            There is no baseline or it couldn't be loaded. Baseline is
+                                set to NULL.
+
+**/
+EFI_STATUS
+EFIAPI
+LoadUnitTestBaseline (
+  IN  UNIT_TEST_FRAMEWORK_HANDLE  FrameworkHandle,
+  OUT UNIT_TEST_BASELINE_HEADER   **Baseline
+  )
+{
+  EFI_STATUS    Status;
+  UINTN         FileSize;
+
+  if (FrameworkHandle == NULL || Baseline == NULL)
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Status = ReadUnitTestFile( FrameworkHandle, UNIT_TEST_BASELINE_FILE_SUFFIX, (VOID**)Baseline, &FileSize );
+  if (EFI_ERROR( Status ))
+  {
+    return Status;
+  }
+
+  //
+  // Older builds rewrote the file in place, so it may be longer than the
+  // baseline in it, but never shorter.
+  if (FileSize < sizeof( UNIT_TEST_BASELINE_HEADER ) || FileSize < (*Baseline)->BlobSize)
+  {
+    DEBUG(( DEBUG_ERROR, "%a - Baseline file is truncated.\n", __FUNCTION__ ));
+    FreePool( *Baseline );
+    *Baseline = NULL;
+    return EFI_VOLUME_CORRUPTED;
+  }
+
+  return EFI_SUCCESS;
+} // LoadUnitTestBaseline()
+
+
+/**
+  Closes the cache file, which is otherwise kept open from one save to the
+  next, and forgets its path. Called when the framework is freed.
+
+  @param[in]  FrameworkHandle   A pointer to the framework that is being persisted.
+
+**/
+VOID
+EFIAPI
+CloseUnitTestPersistence (
+  IN  UNIT_TEST_FRAMEWORK_HANDLE  FrameworkHandle
+  )
+{
+  UNIT_TEST_FRAMEWORK             *Framework = (UNIT_TEST_FRAMEWORK*)FrameworkHandle;
+  UNIT_TEST_FILESYSTEM_SESSION    *Session;
+
+  if (Framework == NULL || Framework->PersistenceSession == NULL)
+  {
+    return;
+  }
+
+  Session = Framework->PersistenceSession;
+  CloseCacheFile( Session );
+  if (Session->CacheFilePath != NULL)
+  {
+    FreePool( Session->CacheFilePath );
+  }
+  FreePool( Session );
+  Framework->PersistenceSession = NULL;
+
+  return;
+} // CloseUnitTestPersistence()
@@ -1,1500 +1,4555 @@
-/**
-
-Implement UnitTestLib 
-
-
-THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
-AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
-IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
-ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
-LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
-CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
-SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
-INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
-CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
-ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
-THE POSSIBILITY OF SUCH DAMAGE.
-
-
-Copyright (C) 2016 Microsoft Corporation. All Rights Reserved.
-**/
-
-#include <PiDxe.h>
-#include <Library/BaseLib.h>
-#include <Library/BaseMemoryLib.h>
-#include <Library/MemoryAllocationLib.h>
-#include <Library/UefiLib.h>
-#include <Library/DebugLib.h>
-#include <Library/PrintLib.h>
-#include <Library/UnitTestLib.h>
-#include <Library/UefiBootServicesTableLib.h>
-#include <Library/UefiRuntimeServicesTableLib.h>
-
-#include "UnitTestPersistenceLib.h"
-#include "Md5.h"
-
-MD5_CTX     mFingerprintCtx;
-
-BOOLEAN     mUnitTestAssertionLogging   = TRUE;
-UINTN       mUnitTestLoggingLevel       = (DEBUG_INFO | DEBUG_ERROR);
-BOOLEAN     mFlowLogging                = FALSE;    // NOTE: Doesn't do anything right now.
-
-struct _UNIT_TEST_STATUS_STRING
-{
-  UNIT_TEST_STATUS    Status;
-  CHAR8               *String;
-};
-
-struct _UNIT_TEST_STATUS_STRING   mStatusStrings[] =
-{
-  { UNIT_TEST_PASSED,               "PASSED" },
-  { UNIT_TEST_ERROR_PREREQ_NOT_MET, "NOT RUN - PREREQ FAILED" },
-  { UNIT_TEST_ERROR_TEST_FAILED,    "FAILED" },
-  { UNIT_TEST_RUNNING,              "RUNNING" },
-  { UNIT_TEST_PENDING,              "PENDING" }
-};
-UINTN                             mStatusStringsCount = sizeof( mStatusStrings ) / sizeof( mStatusStrings[0] );
-
-struct _UNIT_TEST_LOG_PREFIX_STRING
-{
-  UNIT_TEST_STATUS    LogLevel;
-  CHAR8               *String;
-};
-
-struct _UNIT_TEST_LOG_PREFIX_STRING   mLogPrefixStrings[] =
-{
-  { DEBUG_ERROR,    "[ERROR]       " },
-  { DEBUG_WARN,     "[WARNING]     " },
-  { DEBUG_INFO,     "[INFO]        " },
-  { DEBUG_VERBOSE,  "[VERBOSE]     " }
-};
-UINTN                                 mLogPrefixStringsCount = sizeof( mLogPrefixStrings ) / sizeof( mLogPrefixStrings[0] );
-
-
-// Prototyped here so that it can be included near the functions that
-// it logically goes with.
-STATIC
-VOID
-UpdateTestFromSave (
-  IN OUT UNIT_TEST              *Test,
-  IN     UNIT_TEST_SAVE_HEADER  *SavedState
-  );
-
-
-//=============================================================================
-//
-// ----------------  TEST HELPER FUNCTIONS ------------------------------------
-//
-//=============================================================================
-
-
-/**
-  This function will determine whether the short name violates any rules that would
-  prevent it from being used as a reporting name or as a serialization name.
-
-  Example: If the name cannot be serialized to a filesystem file name.
-
-  @param[in]  ShortTitleString  A pointer to the short title string to be evaluated.
-
-  @retval     TRUE    The string is acceptable.
-  @retval     FALSE   The string should not be used.
-
-**/
-STATIC
-BOOLEAN
-IsFrameworkShortNameValid (
-  IN  CHAR16    *ShortTitleString
-  )
-{
-  // TODO: Finish this function.
-  return TRUE;
-} // IsFrameworkShortNameValid()
-
-
-STATIC
-CHAR16*
-AllocateAndCopyString (
-  IN  CHAR16    *StringToCopy
-  )
-{
-  CHAR16    *NewString = NULL;
-  UINTN     NewStringLength;
-
-  NewStringLength = StrnLenS( StringToCopy, UNIT_TEST_MAX_STRING_LENGTH ) + 1;
-  NewString = AllocatePool( NewStringLength * sizeof( CHAR16 ) );
-  if (NewString != NULL)
-  {
-    StrCpyS( NewString, UNIT_TEST_MAX_STRING_LENGTH, StringToCopy );
-    NewString[NewStringLength] = 0x00;    // NULL terminate, regardless.
-  }
-
-  return NewString;
-} // AllocateAndCopyString ()
-
-
-STATIC
-VOID
-SetFrameworkFingerprint (
-  OUT UINT8                 *Fingerprint,
-  IN  UNIT_TEST_FRAMEWORK   *Framework
-  )
-{
-  MD5Init( &mFingerprintCtx );
-
-  // For this one we'll just use the title and version as the unique fingerprint.
-  MD5Update( &mFingerprintCtx, Framework->Title, (StrLen( Framework->Title ) * sizeof( CHAR16 )) );
-  MD5Update( &mFingerprintCtx, Framework->VersionString, (StrLen( Framework->VersionString ) * sizeof( CHAR16 )) );
-
-  MD5Final( &mFingerprintCtx, &Framework->Fingerprint[0] );
-  return;
-} // SetFrameworkFingerprint()
-
-
-STATIC
-VOID
-SetSuiteFingerprint (
-  OUT UINT8                 *Fingerprint,
-  IN  UNIT_TEST_FRAMEWORK   *Framework,
-  IN  UNIT_TEST_SUITE       *Suite
-  )
-{
-  MD5Init( &mFingerprintCtx );
-
-  // For this one, we'll use the fingerprint from the framework, and the title of the suite.
-  MD5Update( &mFingerprintCtx, &Framework->Fingerprint[0], UNIT_TEST_FINGERPRINT_SIZE );
-  MD5Update( &mFingerprintCtx, Suite->Title, (StrLen( Suite->Title ) * sizeof( CHAR16 )) );
-
-  MD5Final( &mFingerprintCtx, &Suite->Fingerprint[0] );
-  return;
-} // SetSuiteFingerprint()
-
-
-STATIC
-VOID
-SetTestFingerprint (
-  OUT UINT8                 *Fingerprint,
-  IN  UNIT_TEST_SUITE       *Suite,
-  IN  UNIT_TEST             *Test
-  )
-{
-  MD5Init( &mFingerprintCtx );
-
-  // For this one, we'll use the fingerprint from the suite, and the description of the test.
-  MD5Update( &mFingerprintCtx, &Suite->Fingerprint[0], UNIT_TEST_FINGERPRINT_SIZE );
-  MD5Update( &mFingerprintCtx, Test->Description, (StrLen( Test->Description ) * sizeof( CHAR16 )) );
-
-  MD5Final( &mFingerprintCtx, &Test->Fingerprint[0] );
-  return;
-} // SetTestFingerprint()
-
-
-STATIC
-BOOLEAN
-CompareFingerprints (
-  IN  UINT8       *FingerprintA,
-  IN  UINT8       *FingerprintB
-  )
-{
-  return (CompareMem( FingerprintA, FingerprintB, UNIT_TEST_FINGERPRINT_SIZE ) == 0);
-} // SetTestFingerprint()
-
-
-EFI_STATUS
-EFIAPI
-FreeUnitTestFramework (
-  IN UNIT_TEST_FRAMEWORK  *Framework
-  )
-{
-  // TODO: Finish this function.
-  return EFI_SUCCESS;
-} // FreeUnitTestFramework()
-
-
-STATIC
-EFI_STATUS
-FreeUnitTestSuiteEntry (
-  IN UNIT_TEST_SUITE_LIST_ENTRY *SuiteEntry
-  )
-{
-  // TODO: Finish this function.
-  return EFI_SUCCESS;
-} // FreeUnitTestSuiteEntry()
-
-
-STATIC
-EFI_STATUS
-FreeUnitTestTestEntry (
-  IN UNIT_TEST_LIST_ENTRY *TestEntry
-  )
-{
-  // TODO: Finish this function.
-  return EFI_SUCCESS;
-} // FreeUnitTestTestEntry()
-
-
-//=============================================================================
-//
-// ----------------  TEST SETUP FUNCTIONS -------------------------------------
-//
-//=============================================================================
-
-
-/*
-Method to Initialize the Unit Test framework
-
-@retval Success - Unit Test init.
-@retval EFI_ERROR - Unit Tests init failed.
-*/
-EFI_STATUS
-EFIAPI
-InitUnitTestFramework (
-  OUT UNIT_TEST_FRAMEWORK   **Framework,
-  IN  CHAR16                *Title,
-  IN  CHAR16                *ShortTitle,
-  IN  CHAR16                *VersionString
-  )
-{
-  EFI_STATUS                Status = EFI_SUCCESS;
-  UNIT_TEST_FRAMEWORK       *NewFramework = NULL;
-
-  //
-  // First, check all pointers and make sure nothing's broked.
-  if (Framework == NULL || Title == NULL ||
-      ShortTitle == NULL || VersionString == NULL)
-  {
-    return EFI_INVALID_PARAMETER;
-  }
-
-  //
-  // Next, determine whether all of the strings are good to use.
-  if (!IsFrameworkShortNameValid( ShortTitle ))
-  {
-    return EFI_INVALID_PARAMETER;
-  }
-
-  //
-  // Next, set aside some space to start messing with the framework.
-  NewFramework = AllocateZeroPool( sizeof( UNIT_TEST_FRAMEWORK ) );
-  if (NewFramework == NULL)
-  {
-    return EFI_OUT_OF_RESOURCES;
-  }
-
-  //
-  // Next, set up all the test data.
-  NewFramework->Title         = AllocateAndCopyString( Title );
-  NewFramework->ShortTitle    = AllocateAndCopyString( ShortTitle );
-  NewFramework->VersionString = AllocateAndCopyString( VersionString );
-  NewFramework->Log           = NULL;
-  NewFramework->CurrentTest   = NULL;
-  NewFramework->SavedState    = NULL;
-  if (NewFramework->Title == NULL || NewFramework->ShortTitle == NULL ||
-      NewFramework->VersionString == NULL)
-  {
-    Status = EFI_OUT_OF_RESOURCES;
-    goto Exit;
-  }
-  InitializeListHead( &(NewFramework->TestSuiteList) );
-
-  //
-  // Create the framework fingerprint.
-  SetFrameworkFingerprint( &NewFramework->Fingerprint[0], NewFramework );
-
-  //
-  // If there is a persisted context, load it now.
-  if (DoesCacheExist( NewFramework ))
-  {
-    Status = LoadUnitTestCache( NewFramework, &(UNIT_TEST_SAVE_HEADER*)(NewFramework->SavedState) );
-    if (EFI_ERROR( Status ))
-    {
-      // Don't actually report it as an error, but emit a warning.
-      DEBUG(( DEBUG_ERROR, __FUNCTION__" - Cache was detected, but failed to load.\n" ));
-      Status = EFI_SUCCESS;
-    }
-  }
-
-Exit:
-  //
-  // If we're good, then let's copy the framework.
-  if (!EFI_ERROR( Status ))
-  {
-    *Framework = NewFramework;
-  }
-  // Otherwise, we need to undo this horrible thing that we've done.
-  else
-  {
-    FreeUnitTestFramework( NewFramework );
-  }
-
-  return Status;
-}
-
-
-EFI_STATUS
-EFIAPI
-CreateUnitTestSuite (
-  OUT UNIT_TEST_SUITE           **Suite,
-  IN UNIT_TEST_FRAMEWORK        *Framework,
-  IN CHAR16                     *Title,
-  IN UNIT_TEST_SUITE_SETUP      Sup    OPTIONAL,
-  IN UNIT_TEST_SUITE_TEARDOWN   Tdn    OPTIONAL
-  )
-{
-  EFI_STATUS                    Status = EFI_SUCCESS;
-  UNIT_TEST_SUITE_LIST_ENTRY    *NewSuiteEntry;
-
-  //
-  // First, let's check to make sure that our parameters look good.
-  if ((Framework == NULL) || (Title == NULL))
-  {
-    return EFI_INVALID_PARAMETER;
-  }
-
-  //
-  // Create the new entry.
-  NewSuiteEntry = AllocateZeroPool( sizeof( UNIT_TEST_SUITE_LIST_ENTRY ) );
-  if (NewSuiteEntry == NULL)
-  {
-    return EFI_OUT_OF_RESOURCES;
-  }
-
-  //
-  // Copy the fields we think we need.
-  NewSuiteEntry->UTS.Title            = AllocateAndCopyString( Title );
-  NewSuiteEntry->UTS.Setup            = Sup;
-  NewSuiteEntry->UTS.Teardown         = Tdn;
-  NewSuiteEntry->UTS.ParentFramework  = Framework;
-  InitializeListHead( &(NewSuiteEntry->Entry) );             // List entry for sibling suites.
-  InitializeListHead( &(NewSuiteEntry->UTS.TestCaseList) );  // List entry for child tests.
-  if (NewSuiteEntry->UTS.Title == NULL)
-  {
-    Status = EFI_OUT_OF_RESOURCES;
-    goto Exit;
-  }
-
-  //
-  // Create the suite fingerprint.
-  SetSuiteFingerprint( &NewSuiteEntry->UTS.Fingerprint[0], Framework, &NewSuiteEntry->UTS );
-
-Exit:
-  //
-  // If everything is going well, add the new suite to the tail list for the framework.
-  if (!EFI_ERROR( Status ))
-  {
-    InsertTailList( &(Framework->TestSuiteList), (LIST_ENTRY*)NewSuiteEntry );
-    *Suite = &NewSuiteEntry->UTS;
-  }
-  // Otherwise, make with the destruction.
-  else
-  {
-    FreeUnitTestSuiteEntry( NewSuiteEntry );
-  }
-
-  return Status;
-}
-
-
-EFI_STATUS
-EFIAPI
-AddTestCase (
-  IN UNIT_TEST_SUITE      *Suite,
-  IN CHAR16               *Description,
-  IN UNIT_TEST_FUNCTION   Func,
-  IN UNIT_TEST_PREREQ     PreReq    OPTIONAL,
-  IN UNIT_TEST_CLEANUP    CleanUp   OPTIONAL,
-  IN UNIT_TEST_CONTEXT    Context   OPTIONAL
-  )
-{
-  EFI_STATUS            Status = EFI_SUCCESS;
-  UNIT_TEST_LIST_ENTRY  *NewTestEntry;
-  UNIT_TEST_FRAMEWORK   *ParentFramework = (UNIT_TEST_FRAMEWORK*)Suite->ParentFramework;
-
-  //
-  // First, let's check to make sure that our parameters look good.
-  if ((Suite == NULL) || (Description == NULL))
-  {
-    return EFI_INVALID_PARAMETER;
-  }
-
-  //
-  // Create the new entry.
-  NewTestEntry = AllocateZeroPool( sizeof( UNIT_TEST_LIST_ENTRY ) );
-  if (NewTestEntry == NULL)
-  {
-    return EFI_OUT_OF_RESOURCES;
-  }
-
-  //
-  // Copy the fields we think we need.
-  NewTestEntry->UT.Description  = AllocateAndCopyString( Description );
-  NewTestEntry->UT.Log          = NULL;
-  NewTestEntry->UT.PreReq       = PreReq;
-  NewTestEntry->UT.CleanUp      = CleanUp;
-  NewTestEntry->UT.RunTest      = Func;
-  NewTestEntry->UT.Context      = Context;
-  NewTestEntry->UT.Result       = UNIT_TEST_PENDING;
-  NewTestEntry->UT.ParentSuite  = Suite;
-  InitializeListHead( &(NewTestEntry->Entry) );      // List entry for sibling tests.
-  if (NewTestEntry->UT.Description == NULL)
-  {
-    Status = EFI_OUT_OF_RESOURCES;
-    goto Exit;
-  }
-
-  //
-  // Create the test fingerprint.
-  SetTestFingerprint( &NewTestEntry->UT.Fingerprint[0], Suite, &NewTestEntry->UT );
-
-  // TODO: Make sure that duplicate fingerprints cannot be created.
-
-  //
-  // If there is saved test data, update this record.
-  if (ParentFramework->SavedState != NULL)
-  {
-    UpdateTestFromSave( &NewTestEntry->UT, ParentFramework->SavedState );
-  }
-
-Exit:
-  //
-  // If everything is going well, add the new suite to the tail list for the framework.
-  if (!EFI_ERROR( Status ))
-  {
-    InsertTailList( &(Suite->TestCaseList), (LIST_ENTRY*)NewTestEntry );
-  }
-  // Otherwise, make with the destruction.
-  else
-  {
-    FreeUnitTestTestEntry( NewTestEntry );
-  }
-
-  return Status;
-}
-
-
-//=============================================================================
-//
-// ----------------  TEST EXECUTION FUNCTIONS ---------------------------------
-//
-//=============================================================================
-
-STATIC
-EFI_STATUS
-RunTestSuite (
-  IN UNIT_TEST_SUITE      *Suite
-  )
-{
-  UNIT_TEST_LIST_ENTRY  *TestEntry = NULL;
-  UNIT_TEST             *Test;
-  UNIT_TEST_FRAMEWORK   *ParentFramework = (UNIT_TEST_FRAMEWORK*)Suite->ParentFramework;
-
-  if (Suite == NULL)
-  {
-    return EFI_INVALID_PARAMETER;
-  }
-
-  DEBUG((DEBUG_UT_VERBOSE, "---------------------------------------------------------\n"));
-  DEBUG((DEBUG_UT_VERBOSE, "RUNNING TEST SUITE: %s\n", Suite->Title));
-  DEBUG((DEBUG_UT_VERBOSE, "---------------------------------------------------------\n"));
-
-  if (Suite->Setup != NULL)
-  {
-    Suite->Setup( Suite->ParentFramework );
-  }
-
-  //
-  // Iterate all tests within the suite
-  //
-  for (TestEntry = (UNIT_TEST_LIST_ENTRY*)GetFirstNode( &(Suite->TestCaseList) );                         // Start at the beginning.
-       (LIST_ENTRY*)TestEntry != &(Suite->TestCaseList);                                                  // Go until you loop back to the head.
-       TestEntry = (UNIT_TEST_LIST_ENTRY*)GetNextNode( &(Suite->TestCaseList), (LIST_ENTRY*)TestEntry) )  // Always get the next test.
-  {
-    Test                          = &TestEntry->UT;
-    ParentFramework->CurrentTest  = Test;
-
-    DEBUG((DEBUG_UT_VERBOSE, "*********************************************************\n"));
-    DEBUG((DEBUG_UT_VERBOSE, " RUNNING TEST: %s:\n", Test->Description));
-    DEBUG((DEBUG_UT_VERBOSE, "**********************************************************\n"));
-
-    //
-    // First, check to see whether the test has already been run.
-    // NOTE: This would generally only be the case if a saved state was detected and loaded.
-    if (Test->Result != UNIT_TEST_PENDING && Test->Result != UNIT_TEST_RUNNING)
-    {
-      DEBUG(( DEBUG_UT_VERBOSE, "Test was run on a previous pass. Skipping.\n" ));
-      ParentFramework->CurrentTest  = NULL;
-      continue;
-    }
-
-    //
-    // Next, if we're still running, make sure that our test prerequisites are in place.
-    if (Test->Result == UNIT_TEST_PENDING && Test->PreReq != NULL)
-    {
-      DEBUG(( DEBUG_UT_VERBOSE, "PREREQ\n" ));
-      if (Test->PreReq( Suite->ParentFramework, Test->Context ) != UNIT_TEST_PASSED)
-      {
-        DEBUG(( DEBUG_ERROR, "PreReq Not Met\n" ));
-        Test->Result = UNIT_TEST_ERROR_PREREQ_NOT_MET;
-        ParentFramework->CurrentTest  = NULL;
-        continue;
-      }
-    }
-
-    //
-    // Now we should be ready to call the actual test.
-    // We set the status to UNIT_TEST_RUNNING in case the test needs to reboot
-    // or quit. The UNIT_TEST_RUNNING state will allow the test to resume
-    // but will prevent the PreReq from being dispatched a second time.
-    Test->Result = UNIT_TEST_RUNNING;
-    Test->Result = Test->RunTest( Suite->ParentFramework, Test->Context );
-
-    //
-    // Finally, clean everything up, if need be.
-    if (Test->CleanUp != NULL)
-    {
-      DEBUG(( DEBUG_UT_VERBOSE, "CLEANUP\n" ));
-      Test->CleanUp( Suite->ParentFramework );
-    }
-
-    //
-    // End the test.
-    ParentFramework->CurrentTest  = NULL;
-  } // End Test iteration
-
-
-  if (Suite->Teardown != NULL)
-  {
-    Suite->Teardown( Suite->ParentFramework );
-  }
-
-  return EFI_SUCCESS;
-}
-
-EFI_STATUS
-EFIAPI
-RunAllTestSuites(
-  IN UNIT_TEST_FRAMEWORK  *Framework
-  )
-{
-  UNIT_TEST_SUITE_LIST_ENTRY *Suite = NULL;
-  EFI_STATUS Status; 
-
-  if (Framework == NULL)
-  {
-    return EFI_INVALID_PARAMETER;
-  }
-
-  DEBUG((DEBUG_UT_VERBOSE, "---------------------------------------------------------\n"));
-  DEBUG((DEBUG_UT_VERBOSE, "------------     RUNNING ALL TEST SUITES   --------------\n"));
-  DEBUG((DEBUG_UT_VERBOSE, "---------------------------------------------------------\n"));
-
-  // TODO: Set the StartTime.
-
-  //
-  // Iterate all suites
-  //
-  for (Suite = (UNIT_TEST_SUITE_LIST_ENTRY*)GetFirstNode(&Framework->TestSuiteList);
-    (LIST_ENTRY*)Suite != &Framework->TestSuiteList;
-    Suite = (UNIT_TEST_SUITE_LIST_ENTRY*)GetNextNode(&Framework->TestSuiteList, (LIST_ENTRY*)Suite))
-  {
-    Status = RunTestSuite(&(Suite->UTS));
-    if (EFI_ERROR(Status))
-    {
-      DEBUG((DEBUG_ERROR, "Test Suite Failed with Error.  %r\n", Status));
-    }
-  } // End Suite iteration
-
-  // TODO: Set the StopTime.
-
-  return EFI_SUCCESS;
-}
-
-
-//=============================================================================
-//
-// ----------------  TEST REPORTING FUNCTIONS ---------------------------------
-//
-//=============================================================================
-
-STATIC
-CONST CHAR8*
-GetStringForUnitTestStatus (
-  IN UNIT_TEST_STATUS   Status
-  )
-{
-  UINTN   Index;
-  CHAR8   *Result, *NoResult = "**UNKNOWN**";     // NOTE: This might be bad. Is it on the stack?
-
-  Result = NoResult;
-  for (Index = 0; Index < mStatusStringsCount; Index++)
-  {
-    if (mStatusStrings[Index].Status == Status)
-    {
-      Result = mStatusStrings[Index].String;
-      break;
-    }
-  }
-
-  return Result;
-}
-
-
-STATIC
-CONST CHAR8*
-GetStringForStatusLogPrefix (
-  IN UINTN      LogLevel
-  )
-{
-  UINTN   Index;
-  CHAR8   *Result = NULL;
-
-  for (Index = 0; Index < mLogPrefixStringsCount; Index++)
-  {
-    if (mLogPrefixStrings[Index].LogLevel == LogLevel)
-    {
-      Result = mLogPrefixStrings[Index].String;
-      break;
-    }
-  }
-
-  return Result;
-}
-
-
-/*
-Method to print the Unit Test run results
-
-IMPORTANT NOTE: This function currently expects the shell to exist.
-                Ultimately, this functionality should be wrapped up into an
-                "environment lib" that is similar to the persistence lib.
-                In fact, it could just be an expansion of the persistence lib.
-
-@retval Success
-*/
-EFI_STATUS
-EFIAPI
-PrintUnitTestReport(
-  IN UNIT_TEST_FRAMEWORK  *Framework
-  )
-{
-  INTN Passed = 0;
-  INTN Failed = 0;
-  INTN NotRun = 0;
-  UNIT_TEST_SUITE_LIST_ENTRY *Suite = NULL;
-
-  if (Framework == NULL)
-  {
-    return EFI_INVALID_PARAMETER;
-  }
-
-  Print( L"---------------------------------------------------------\n" );
-  Print( L"------------- UNIT TEST FRAMEWORK RESULTS ---------------\n" );
-  Print( L"---------------------------------------------------------\n" );
-
-  //print the version and time
-
-  //
-  // Iterate all suites
-  //
-  for (Suite = (UNIT_TEST_SUITE_LIST_ENTRY*)GetFirstNode(&Framework->TestSuiteList);
-    (LIST_ENTRY*)Suite != &Framework->TestSuiteList; 
-    Suite = (UNIT_TEST_SUITE_LIST_ENTRY*)GetNextNode(&Framework->TestSuiteList, (LIST_ENTRY*)Suite))
-  {
-    UNIT_TEST_LIST_ENTRY *Test = NULL;
-    INTN SPassed = 0;
-    INTN SFailed = 0;
-    INTN SNotRun = 0;
-
-    Print( L"/////////////////////////////////////////////////////////\n" );
-    Print( L"  SUITE: %s\n", Suite->UTS.Title );
-    Print( L"/////////////////////////////////////////////////////////\n" );
-
-    //
-    // Iterate all tests within the suite
-    //
-    for (Test = (UNIT_TEST_LIST_ENTRY*)GetFirstNode(&(Suite->UTS.TestCaseList));
-      (LIST_ENTRY*)Test != &(Suite->UTS.TestCaseList);
-      Test = (UNIT_TEST_LIST_ENTRY*)GetNextNode(&(Suite->UTS.TestCaseList), (LIST_ENTRY*)Test))
-    {
-
-      Print( L"*********************************************************\n" );
-      Print( L"  TEST:   %s\n", Test->UT.Description );
-      Print( L"  STATUS: %a\n", GetStringForUnitTestStatus( Test->UT.Result ) );
-      if (Test->UT.Log != NULL)
-      {
-        Print( L"  LOG:\n" );
-        // NOTE: This has to be done directly because all of the other
-        //       "formatted" print statements have caps on the string size.
-        gST->ConOut->OutputString( gST->ConOut, Test->UT.Log );
-      }
-
-      switch (Test->UT.Result)
-      {
-        case UNIT_TEST_PASSED:                SPassed++; break;
-        case UNIT_TEST_ERROR_TEST_FAILED:     SFailed++; break;
-        case UNIT_TEST_PENDING:               // Fall through...
-        case UNIT_TEST_RUNNING:               // Fall through...
-        case UNIT_TEST_ERROR_PREREQ_NOT_MET:  SNotRun++; break;
-        default: break;
-      }
-      Print( L"**********************************************************\n" );
-    } //End Test iteration
-
-    Print( L"+++++++++++++++++++++++++++++++++++++++++++++++++++++++++\n" );
-    Print( L"Suite Stats\n" );
-    Print( L" Passed:  %d  (%d%%)\n", SPassed, (SPassed * 100)/(SPassed+SFailed+SNotRun) );
-    Print( L" Failed:  %d  (%d%%)\n", SFailed, (SFailed * 100) / (SPassed + SFailed + SNotRun) );
-    Print( L" Not Run: %d  (%d%%)\n", SNotRun, (SNotRun * 100) / (SPassed + SFailed + SNotRun) );
-    Print( L"+++++++++++++++++++++++++++++++++++++++++++++++++++++++++\n" );
-
-    Passed += SPassed;  //add to global counters
-    Failed += SFailed;  //add to global counters
-    NotRun += SNotRun;  //add to global coutners
-  }//End Suite iteration
-
-  Print( L"=========================================================\n" );
-  Print( L"Total Stats\n" );
-  Print( L" Passed:  %d  (%d%%)\n", Passed, (Passed * 100) / (Passed + Failed + NotRun) );
-  Print( L" Failed:  %d  (%d%%)\n", Failed, (Failed * 100) / (Passed + Failed + NotRun) );
-  Print( L" Not Run: %d  (%d%%)\n", NotRun, (NotRun * 100) / (Passed + Failed + NotRun) );
-  Print( L"=========================================================\n" );
-
-  return EFI_SUCCESS;
-}
-
-
-STATIC
-EFI_STATUS
-AddStringToUnitTestLog (
-  IN OUT UNIT_TEST    *UnitTest,
-  IN CONST CHAR16     *String
-  )
-{
-  CHAR16      *NewLog;
-  UINTN       NewLogLength;
-
-  //
-  // Make sure that you're cooking with gas.
-  //
-  if (UnitTest == NULL || String == NULL)
-  {
-    return EFI_INVALID_PARAMETER;
-  }
-
-  //
-  // Determine new log length.
-  //
-  NewLogLength = StrnLenS( String, UNIT_TEST_MAX_SINGLE_LOG_STRING_LENGTH );
-  // If there was an existing log, add it.
-  if (UnitTest->Log != NULL) 
-  {
-    NewLogLength += StrLen( UnitTest->Log );
-  }
-  // Add the NULL char.
-  NewLogLength += 1;
-
-  //
-  // Allocate new log.
-  //
-  NewLog = AllocatePool( NewLogLength * sizeof( CHAR16 ) );
-  if (NewLog == NULL)
-  {
-    return EFI_OUT_OF_RESOURCES;
-  }
-
-  //
-  // Create new log.
-  //
-  if (UnitTest->Log != NULL)
-  {
-    StrCpyS( NewLog, NewLogLength, UnitTest->Log );
-    StrCatS( NewLog, NewLogLength, String );
-  }
-  else
-  {
-    StrCpyS( NewLog, NewLogLength, String );
-  }
-
-  //
-  // Set up the new log.
-  //
-  if (UnitTest->Log != NULL)
-  {
-    FreePool( UnitTest->Log );
-  }
-  UnitTest->Log = NewLog;
-
-  return EFI_SUCCESS;
-}
-
-
-VOID
-EFIAPI
-UnitTestLog (
-  IN  UNIT_TEST_FRAMEWORK_HANDLE  Framework,
-  IN  UINTN                       ErrorLevel,
-  IN  CONST CHAR8                 *Format,
-  ...
-  )
-{
-  CHAR8         NewFormatString[UNIT_TEST_MAX_SINGLE_LOG_STRING_LENGTH];
-  CHAR16        LogString[UNIT_TEST_MAX_SINGLE_LOG_STRING_LENGTH];
-  CONST CHAR8   *LogTypePrefix = NULL;
-  VA_LIST       Marker;
-
-  //
-  // Make sure that this debug mode is enabled.
-  //
-  if ((ErrorLevel & mUnitTestLoggingLevel) == 0) {
-      return;
-  }
-
-  //
-  // If we need to define a new format string...
-  // well... get to it.
-  //
-  LogTypePrefix = GetStringForStatusLogPrefix( ErrorLevel );
-  if (LogTypePrefix != NULL)
-  {
-    AsciiSPrint( NewFormatString, sizeof( NewFormatString ), "%a%a", LogTypePrefix, Format );
-  }
-  else
-  {
-    AsciiStrCpyS( NewFormatString, sizeof( NewFormatString ), Format );
-  }
-
-  //
-  // Convert the message to an ASCII String
-  //
-  VA_START (Marker, Format);
-  UnicodeVSPrintAsciiFormat( LogString, sizeof( LogString ), NewFormatString, Marker );
-  VA_END (Marker);
-
-  //
-  // Finally, add the string to the log.
-  //
-  AddStringToUnitTestLog( ((UNIT_TEST_FRAMEWORK*)Framework)->CurrentTest, LogString );
-
-  return;
-}
-
-
-BOOLEAN
-EFIAPI
-UnitTestAssertTrue (
-  IN UNIT_TEST_FRAMEWORK_HANDLE Framework,
-  IN BOOLEAN                    Expression,
-  IN CONST CHAR8                *FunctionName,
-  IN UINTN                      LineNumber,
-  IN CONST CHAR8                *Description
-  )
-{
-  CHAR16    AssertString[UNIT_TEST_MAX_SINGLE_LOG_STRING_LENGTH];
-  if (!Expression && mUnitTestAssertionLogging)
-  {
-    UnicodeSPrintAsciiFormat( AssertString, sizeof( AssertString ),
-                   "[ASSERT FAIL] %a::%d Expression (%a) is not TRUE!\n", FunctionName, LineNumber, Description );
-    AddStringToUnitTestLog( ((UNIT_TEST_FRAMEWORK*)Framework)->CurrentTest, AssertString );
-  }
-  return Expression;
-}
-
-
-BOOLEAN
-EFIAPI
-UnitTestAssertFalse (
-  IN UNIT_TEST_FRAMEWORK_HANDLE Framework,
-  IN BOOLEAN                    Expression,
-  IN CONST CHAR8                *FunctionName,
-  IN UINTN                      LineNumber,
-  IN CONST CHAR8                *Description
-  )
-{
-  CHAR16    AssertString[UNIT_TEST_MAX_SINGLE_LOG_STRING_LENGTH];
-  if (Expression && mUnitTestAssertionLogging)
-  {
-    UnicodeSPrintAsciiFormat( AssertString, sizeof( AssertString ),
-                   "[ASSERT FAIL] %a::%d Expression (%a) is not FALSE!\n", FunctionName, LineNumber, Description );
-    AddStringToUnitTestLog( ((UNIT_TEST_FRAMEWORK*)Framework)->CurrentTest, AssertString );
-  }
-  return !Expression;
-}
-
-
-BOOLEAN
-EFIAPI
-UnitTestAssertNotEfiError (
-  IN UNIT_TEST_FRAMEWORK_HANDLE Framework,
-  IN EFI_STATUS                 Status,
-  IN CONST CHAR8                *FunctionName,
-  IN UINTN                      LineNumber,
-  IN CONST CHAR8                *Description
-  )
-{
-  CHAR16    AssertString[UNIT_TEST_MAX_SINGLE_LOG_STRING_LENGTH];
-  if (EFI_ERROR( Status ) && mUnitTestAssertionLogging)
-  {
-    UnicodeSPrintAsciiFormat( AssertString, sizeof( AssertString ),
-                   "[ASSERT FAIL] %a::%d Status '%a' is EFI_ERROR (%r)!\n", FunctionName, LineNumber, Description, Status );
-    AddStringToUnitTestLog( ((UNIT_TEST_FRAMEWORK*)Framework)->CurrentTest, AssertString );
-  }
-  return !EFI_ERROR( Status );
-}
-
-
-BOOLEAN
-EFIAPI
-UnitTestAssertEqual (
-  IN UNIT_TEST_FRAMEWORK_HANDLE Framework,
-  IN UINTN                      ValueA,
-  IN UINTN                      ValueB,
-  IN CONST CHAR8                *FunctionName,
-  IN UINTN                      LineNumber,
-  IN CONST CHAR8                *DescriptionA,
-  IN CONST CHAR8                *DescriptionB
-  )
-{
-  CHAR16    AssertString[UNIT_TEST_MAX_SINGLE_LOG_STRING_LENGTH];
-  if ((ValueA != ValueB) && mUnitTestAssertionLogging)
-  {
-    UnicodeSPrintAsciiFormat( AssertString, sizeof( AssertString ),
-                   "[ASSERT FAIL] %a::%d Value %a != %a (%d != %d)!\n", FunctionName, LineNumber,
-                   DescriptionA, DescriptionB, ValueA, ValueB );
-    AddStringToUnitTestLog( ((UNIT_TEST_FRAMEWORK*)Framework)->CurrentTest, AssertString );
-  }
-  return (ValueA == ValueB);
-}
-
-
-BOOLEAN
-EFIAPI
-UnitTestAssertNotEqual (
-  IN UNIT_TEST_FRAMEWORK_HANDLE Framework,
-  IN UINTN                      ValueA,
-  IN UINTN                      ValueB,
-  IN CONST CHAR8                *FunctionName,
-  IN UINTN                      LineNumber,
-  IN CONST CHAR8                *DescriptionA,
-  IN CONST CHAR8                *DescriptionB
-  )
-{
-  CHAR16    AssertString[UNIT_TEST_MAX_SINGLE_LOG_STRING_LENGTH];
-  if ((ValueA == ValueB) && mUnitTestAssertionLogging)
-  {
-    UnicodeSPrintAsciiFormat( AssertString, sizeof( AssertString ),
-                   "[ASSERT FAIL] %a::%d Value %a == %a (%d == %d)!\n", FunctionName, LineNumber,
-                   DescriptionA, DescriptionB, ValueA, ValueB );
-    AddStringToUnitTestLog( ((UNIT_TEST_FRAMEWORK*)Framework)->CurrentTest, AssertString );
-  }
-  return (ValueA != ValueB);
-}
-
-
-BOOLEAN
-EFIAPI
-UnitTestAssertStatusEqual (
-  IN UNIT_TEST_FRAMEWORK_HANDLE Framework,
-  IN EFI_STATUS                 Status,
-  IN EFI_STATUS                 Expected,
-  IN CONST CHAR8                *FunctionName,
-  IN UINTN                      LineNumber,
-  IN CONST CHAR8                *Description
-  )
-{
-  CHAR16    AssertString[UNIT_TEST_MAX_SINGLE_LOG_STRING_LENGTH];
-  if ((Status != Expected) && mUnitTestAssertionLogging)
-  {
-    UnicodeSPrintAsciiFormat( AssertString, sizeof( AssertString ),
-                   "[ASSERT FAIL] %a::%d Status '%a' is %r, should be %r!\n", FunctionName, LineNumber, Description, Status, Expected );
-    AddStringToUnitTestLog( ((UNIT_TEST_FRAMEWORK*)Framework)->CurrentTest, AssertString );
-  }
-  return (Status == Expected);
-}
-
-
-//=============================================================================
-//
-// ----------------  TEST UTILITY FUNCTIONS -----------------------------------
-//
-//=============================================================================
-
-
-STATIC
-VOID
-UpdateTestFromSave (
-  IN OUT UNIT_TEST              *Test,
-  IN     UNIT_TEST_SAVE_HEADER  *SavedState
-  )
-{
-  UNIT_TEST_SAVE_TEST     *CurrentTest, *MatchingTest;
-  UINT8                   *FloatingPointer;
-  UNIT_TEST_SAVE_CONTEXT  *SavedContext;
-  UINTN                   Index;
-
-  //
-  // First, evaluate the inputs.
-  if (Test == NULL || SavedState == NULL)
-  {
-    return;
-  }
-  if (SavedState->TestCount == 0)
-  {
-    return;
-  }
-
-  //
-  // Next, determine whether a matching test can be found.
-  // Start at the beginning.
-  MatchingTest    = NULL;
-  FloatingPointer = (UINT8*)SavedState + sizeof( *SavedState );
-  for (Index = 0; Index < SavedState->TestCount; Index++)
-  {
-    CurrentTest = (UNIT_TEST_SAVE_TEST*)FloatingPointer;
-    if (CompareFingerprints( &Test->Fingerprint[0], &CurrentTest->Fingerprint[0] ))
-    {
-      MatchingTest = CurrentTest;
-      // If there's a saved context, it's important that we iterate through the entire list.
-      if (!SavedState->HasSavedContext)
-      {
-        break;
-      }
-    }
-
-    // If we didn't find it, we have to increment to the next test.
-    FloatingPointer = (UINT8*)CurrentTest + CurrentTest->Size;
-  }
-
-  //
-  // If a matching test was found, copy the status.
-  if (MatchingTest)
-  {
-    // Override the test status with the saved status.
-    Test->Result = MatchingTest->Result;
-
-    // If there is a log string associated, grab that.
-    // We can tell that there's a log string because the "size" will be larger than
-    // the structure size.
-    // IMPORTANT NOTE: There are security implications here.
-    //                 This data is user-supplied and we're about to play kinda
-    //                 fast and loose with data buffers.
-    if (MatchingTest->Size > sizeof( UNIT_TEST_SAVE_TEST ))
-    {
-      Test->Log = AllocatePool( MatchingTest->Size - sizeof( UNIT_TEST_SAVE_TEST ) );
-      if (Test->Log != NULL)
-      {
-        CopyMem( Test->Log, ((UINT8*)MatchingTest + sizeof( UNIT_TEST_SAVE_TEST )),
-                 MatchingTest->Size - sizeof( UNIT_TEST_SAVE_TEST ) );
-      }
-    }
-  }
-
-  //
-  // If the saved context exists and matches this test, grab it, too.
-  if (SavedState->HasSavedContext)
-  {
-    // TODO: Reconcile the difference between the way "size" works for Test Saves
-    //        and the way it works for Context Saves. Too confusing to use it different ways.
-
-    // If there was a saved context, the "matching test" loop will have placed the FloatingPointer
-    // at the beginning of the context structure.
-    SavedContext = (UNIT_TEST_SAVE_CONTEXT*)FloatingPointer;
-    if (SavedContext->Size > 0 &&
-        CompareFingerprints( &Test->Fingerprint[0], &SavedContext->Fingerprint[0] ))
-    {
-      // Override the test context with the saved context.
-      Test->Context = (VOID*)((UINT8*)SavedContext + sizeof( *SavedContext ));
-    }
-  }
-
-  return;
-} // UpdateTestFromSave()
-
-
-STATIC
-UNIT_TEST_SAVE_HEADER*
-SerializeState (
-  IN UNIT_TEST_FRAMEWORK_HANDLE FrameworkHandle,
-  IN UNIT_TEST_CONTEXT          ContextToSave     OPTIONAL,
-  IN UINTN                      ContextToSaveSize
-  )
-{
-  UNIT_TEST_FRAMEWORK         *Framework  = FrameworkHandle;
-  UNIT_TEST_SAVE_HEADER       *Header = NULL;
-  LIST_ENTRY                  *SuiteListHead, *Suite, *TestListHead, *Test;
-  UINT32                      TestCount, TotalSize;
-  UINTN                       LogSize;
-  UNIT_TEST_SAVE_TEST         *TestSaveData;
-  UNIT_TEST_SAVE_CONTEXT      *TestSaveContext;
-  UNIT_TEST                   *UnitTest;
-  UINT8                       *FloatingPointer;
-
-  //
-  // First, let's not make assumptions about the parameters.
-  // You gotta call shenanigans in a hurry, son.
-  if (Framework == NULL || (ContextToSave != NULL && ContextToSaveSize == 0) ||
-      ContextToSaveSize > MAX_UINT32)
-  {
-    return NULL;
-  }
-
-  //
-  // Next, we've gotta figure out the resources that will be required to serialize the
-  // the framework state so that we can persist it.
-  // To start with, we're gonna need a header.
-  TotalSize = sizeof( UNIT_TEST_SAVE_HEADER );
-  // Now we need to figure out how many tests there are.
-  TestCount = 0;
-  // Iterate all suites.
-  SuiteListHead = &Framework->TestSuiteList;
-  for (Suite = GetFirstNode( SuiteListHead ); Suite != SuiteListHead; Suite = GetNextNode( SuiteListHead, Suite ))
-  {
-    // Iterate all tests within the suite.
-    TestListHead = &((UNIT_TEST_SUITE_LIST_ENTRY*)Suite)->UTS.TestCaseList;
-    for (Test = GetFirstNode( TestListHead ); Test != TestListHead; Test = GetNextNode( TestListHead, Test ))
-    {
-      UnitTest = &((UNIT_TEST_LIST_ENTRY*)Test)->UT;
-      // Account for the size of a test structure.
-      TotalSize += sizeof( UNIT_TEST_SAVE_TEST );
-      // If there's a log, make sure to account for the log size.
-      if (UnitTest->Log != NULL)
-      {
-        // The +1 is for the NULL character. Can't forget the NULL character.
-        LogSize = (StrLen( UnitTest->Log ) + 1) * sizeof( CHAR16 );
-        ASSERT( LogSize < MAX_UINT32 );
-        TotalSize += (UINT32)LogSize;
-      }
-      // Increment the test count.
-      TestCount++;
-    }
-  }
-  // If there are no tests, we're done here.
-  if (TestCount == 0)
-  {
-    return NULL;
-  }
-  // Add room for the context, if there is one.
-  if (ContextToSave != NULL)
-  {
-    TotalSize += sizeof( UNIT_TEST_SAVE_CONTEXT ) + (UINT32)ContextToSaveSize;
-  }
-
-  //
-  // Phew! That was a pain.
-  // Now that we know the size, we need to allocate space for the serialized output.
-  Header = AllocateZeroPool( TotalSize );
-  if (Header == NULL)
-  {
-    return NULL;
-  }
-
-  //
-  // Alright, let's start setting up some data.
-  Header->Version         = UNIT_TEST_PERSISTENCE_LIB_VERSION;
-  Header->BlobSize        = TotalSize;
-  CopyMem( &Header->Fingerprint[0], &Framework->Fingerprint[0], UNIT_TEST_FINGERPRINT_SIZE );
-  CopyMem( &Header->StartTime, &Framework->StartTime, sizeof( EFI_TIME ) );
-  Header->TestCount       = TestCount;
-  Header->HasSavedContext = FALSE;
-
-  //
-  // Start adding all of the test cases.
-  // Set the floating pointer to the start of the current test save buffer.
-  FloatingPointer = (UINT8*)Header + sizeof( UNIT_TEST_SAVE_HEADER );
-  // Iterate all suites.
-  SuiteListHead = &Framework->TestSuiteList;
-  for (Suite = GetFirstNode( SuiteListHead ); Suite != SuiteListHead; Suite = GetNextNode( SuiteListHead, Suite ))
-  {
-    // Iterate all tests within the suite.
-    TestListHead = &((UNIT_TEST_SUITE_LIST_ENTRY*)Suite)->UTS.TestCaseList;
-    for (Test = GetFirstNode( TestListHead ); Test != TestListHead; Test = GetNextNode( TestListHead, Test ))
-    {
-      TestSaveData  = (UNIT_TEST_SAVE_TEST*)FloatingPointer;
-      UnitTest      = &((UNIT_TEST_LIST_ENTRY*)Test)->UT;
-      
-      // Save the fingerprint.
-      CopyMem( &TestSaveData->Fingerprint[0], &UnitTest->Fingerprint[0], UNIT_TEST_FINGERPRINT_SIZE );
-      
-      // Save the result.
-      TestSaveData->Result = UnitTest->Result;
-      
-      // If there is a log, save the log.
-      FloatingPointer += sizeof( UNIT_TEST_SAVE_TEST );
-      if (UnitTest->Log != NULL)
-      {
-        // The +1 is for the NULL character. Can't forget the NULL character.
-        LogSize = (StrLen( UnitTest->Log ) + 1) * sizeof( CHAR16 );
-        CopyMem( FloatingPointer, UnitTest->Log, LogSize );
-        FloatingPointer += LogSize;
-      }
-
-      // Update the size once the structure is complete.
-      // NOTE: Should thise be a straight cast without validation?
-      //       Maybe.
-      //       Am I tired of writing code?
-      //       Yes.
-      TestSaveData->Size = (UINT32)(FloatingPointer - (UINT8*)TestSaveData);
-    }
-  }
-
-  //
-  // If there is a context to save, let's do that now.
-  if (ContextToSave != NULL && Framework->CurrentTest != NULL)
-  {
-    TestSaveContext         = (UNIT_TEST_SAVE_CONTEXT*)FloatingPointer;
-    TestSaveContext->Size   = (UINT32)ContextToSaveSize;
-    CopyMem( &TestSaveContext->Fingerprint[0], &Framework->CurrentTest->Fingerprint[0], UNIT_TEST_FINGERPRINT_SIZE );
-    CopyMem( ((UINT8*)TestSaveContext + sizeof( UNIT_TEST_SAVE_CONTEXT )), ContextToSave, ContextToSaveSize );
-    Header->HasSavedContext = TRUE;
-  }
-
-  return Header;
-}
-
-
-STATIC
-EFI_STATUS
-SetUsbBootNext (
-  VOID
-  )
-{
-  EFI_STATUS  Status;
-  UINT16      BootOptionIndex;
-  CHAR16      *BootOptionName = L"Boot0000";
-  UINT8       *OptionBuffer = NULL;
-  UINTN       OptionBufferSize = 0, VariableSize = 0;
-  BOOLEAN     IsUsbOptionFound = FALSE;
-
-  //
-  // Walk through each of the first 10 boot options looking for the
-  // generic USB boot option.
-  for (BootOptionIndex = 0; BootOptionIndex < 10; BootOptionIndex++)
-  {
-    // Construct the BootOption name for this boot option.
-    // Do this by altering the last character of the name.
-    BootOptionName[7] = L'0' + BootOptionIndex;
-
-    // Attempt to retrieve the option.
-    DEBUG(( DEBUG_VERBOSE, __FUNCTION__" - Checking for %s...\n", BootOptionName ));
-    VariableSize = OptionBufferSize;
-    Status = gRT->GetVariable( BootOptionName,
-                               &gEfiGlobalVariableGuid,
-                               NULL,
-                               &VariableSize,
-                               OptionBuffer );
-    // If we need a larger buffer, let's do that now.
-    if (Status == EFI_BUFFER_TOO_SMALL)
-    {
-      // Free the existing buffer.
-      if (OptionBuffer != NULL)
-      {
-        FreePool( OptionBuffer );
-      }
-      // Allocate a larger buffer.
-      OptionBuffer = AllocatePool( VariableSize );
-      // If you fail to... we've gotta get out of here.
-      if (OptionBuffer == NULL)
-      {
-        return EFI_OUT_OF_RESOURCES;
-      }
-      OptionBufferSize = VariableSize;
-
-      // Now that we've got a larger buffer, try that again.
-      Status = gRT->GetVariable( BootOptionName,
-                                 &gEfiGlobalVariableGuid,
-                                 NULL,
-                                 &VariableSize,
-                                 OptionBuffer );
-    }
-
-    // If we failed to retrieve this option... move on with your life.
-    if (EFI_ERROR( Status ))
-    {
-      DEBUG(( DEBUG_VERBOSE, __FUNCTION__" - Failed to locate option. Moving on.\n" ));
-      continue;
-    }
-
-    // If we found the option, check to see whether this is the generic USB option.
-    // For now... we're lazy... just check the last four bytes (which should be the
-    // optional data) and see whether it's "USB".
-    if (VariableSize > 4 &&
-        OptionBuffer[VariableSize - 4] == 'U' && OptionBuffer[VariableSize - 3] == 'S' &&
-        OptionBuffer[VariableSize - 2] == 'B' && OptionBuffer[VariableSize - 1] == 0x00 )
-    {
-      IsUsbOptionFound = TRUE;
-      break;
-    }
-  }
-
-  //
-  // If the correct boot option was found,
-  // set it to the BootNext variable.
-  if (IsUsbOptionFound)
-  {
-    Status = gRT->SetVariable( L"BootNext",
-                               &gEfiGlobalVariableGuid,
-                               (EFI_VARIABLE_BOOTSERVICE_ACCESS | EFI_VARIABLE_RUNTIME_ACCESS | EFI_VARIABLE_NON_VOLATILE),
-                               sizeof( BootOptionIndex ),
-                               &BootOptionIndex );
-  }
-  else
-  {
-    DEBUG(( DEBUG_WARN, __FUNCTION__" - Could not find generic USB boot option.\n" ));
-    Status = EFI_NOT_FOUND;
-  }
-
-  // Always put away your toys.
-  if (OptionBuffer != NULL)
-  {
-    FreePool( OptionBuffer );
-  }
-
-  return Status;  
-} // SetUsbBootNext()
-
-
-EFI_STATUS
-EFIAPI
-SaveFrameworkState (
-  IN UNIT_TEST_FRAMEWORK_HANDLE FrameworkHandle,
-  IN UNIT_TEST_CONTEXT          ContextToSave     OPTIONAL,
-  IN UINTN                      ContextToSaveSize
-  )
-{
-  EFI_STATUS                  Status;
-  UNIT_TEST_SAVE_HEADER       *Header = NULL;
-
-  //
-  // First, let's not make assumptions about the parameters.
-  // You gotta call shenanigans in a hurry, son.
-  if (FrameworkHandle == NULL || (ContextToSave != NULL && ContextToSaveSize == 0) ||
-      ContextToSaveSize > MAX_UINT32)
-  {
-    return EFI_INVALID_PARAMETER;
-  }
-
-  //
-  // Now, let's package up all the data for saving.
-  Header = SerializeState( FrameworkHandle, ContextToSave, ContextToSaveSize );
-  if (Header == NULL)
-  {
-    return EFI_OUT_OF_RESOURCES;
-  }
-
-  //
-  // All that should be left to do is save it using the associated persistence lib.
-  Status = SaveUnitTestCache( FrameworkHandle, Header );
-  if (EFI_ERROR( Status ))
-  {
-    DEBUG(( DEBUG_ERROR, __FUNCTION__" - Could not save state! %r\n", Status ));
-    Status = EFI_DEVICE_ERROR;
-  }
-
-  //
-  // Free data that was used.
-  FreePool( Header );
-
-  return Status;
-} // SaveFrameworkState()
-
-
-EFI_STATUS
-EFIAPI
-SaveFrameworkStateAndQuit (
-  IN UNIT_TEST_FRAMEWORK_HANDLE FrameworkHandle,
-  IN UNIT_TEST_CONTEXT          ContextToSave     OPTIONAL,
-  IN UINTN                      ContextToSaveSize
-  )
-{
-  EFI_STATUS                  Status;
-
-  //
-  // First, let's not make assumptions about the parameters.
-  // You gotta call shenanigans in a hurry, son.
-  if (FrameworkHandle == NULL)
-  {
-    return EFI_INVALID_PARAMETER;
-  }
-
-  //
-  // Now, save all the data associated with this framework.
-  Status = SaveFrameworkState( FrameworkHandle, ContextToSave, ContextToSaveSize );
-
-  //
-  // If we're all good, let's book...
-  if (!EFI_ERROR( Status ))
-  {
-    //
-    // Free data that was used.
-    FreeUnitTestFramework( (UNIT_TEST_FRAMEWORK*)FrameworkHandle );
-
-    //
-    // Quit like a champ!
-    gBS->Exit( gImageHandle, EFI_SUCCESS, 0, NULL );
-    DEBUG(( DEBUG_ERROR, __FUNCTION__" - Unit test failed to quit! Framework can no longer be used!\n" ));
-
-    //
-    // We REALLY shouldn't be here.
-    Status = EFI_ABORTED;
-  }
-
-  return Status;
-} // SaveFrameworkStateAndQuit()
-
-
-/**
-  NOTE: Takes in a ResetType, but currently only supports EfiResetCold
-        and EfiResetWarm. All other types will return EFI_INVALID_PARAMETER.
-        If a more specific reset is required, use SaveFrameworkState() and
-        call gRT->ResetSystem() directly.
-
-**/
-EFI_STATUS
-EFIAPI
-SaveFrameworkStateAndReboot (
-  IN UNIT_TEST_FRAMEWORK_HANDLE FrameworkHandle,
-  IN UNIT_TEST_CONTEXT          ContextToSave     OPTIONAL,
-  IN UINTN                      ContextToSaveSize,
-  IN EFI_RESET_TYPE             ResetType
-  )
-{
-  EFI_STATUS                  Status;
-
-  //
-  // First, let's not make assumptions about the parameters.
-  // You gotta call shenanigans in a hurry, son.
-  if (FrameworkHandle == NULL ||
-      (ResetType != EfiResetCold && ResetType != EfiResetWarm))
-  {
-    return EFI_INVALID_PARAMETER;
-  }
-
-  //
-  // Now, save all the data associated with this framework.
-  Status = SaveFrameworkState( FrameworkHandle, ContextToSave, ContextToSaveSize );
-
-  //
-  // If we're all good, let's book...
-  if (!EFI_ERROR( Status ))
-  {
-    //
-    // Next, we want to update the BootNext variable to USB
-    // so that we have a fighting chance of coming back here.
-    // NOTE: TODO: This is *very* shell-specific and should be refactored
-    //             before any integration into driver unit tests.
-    SetUsbBootNext();
-
-    //
-    // Free data that was used.
-    FreeUnitTestFramework( (UNIT_TEST_FRAMEWORK*)FrameworkHandle );
-
-    //
-    // Reset like a champ!
-    gRT->ResetSystem( ResetType, EFI_SUCCESS, 0, NULL );
-    DEBUG(( DEBUG_ERROR, __FUNCTION__" - Unit test failed to quit! Framework can no longer be used!\n" ));
-
-    //
-    // We REALLY shouldn't be here.
-    Status = EFI_ABORTED;
-  }
-
-  return Status;
-} // SaveFrameworkStateAndReboot()
+/**
+
+Implement UnitTestLib 
+
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+
+
+Copyright (C) 2016 Microsoft Corporation. All Rights Reserved.
+**/
+
+#include <PiDxe.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UefiLib.h>
+#include <Library/DebugLib.h>
+#include <Library/PrintLib.h>
+#include <Library/UnitTestLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/UefiRuntimeServicesTableLib.h>
+#include <Library/TimerLib.h>
+#include <Library/SynchronizationLib.h>
+#include <Library/PcdLib.h>
+#include <Protocol/MpService.h>
+#include <Protocol/SimpleFileSystem.h>
+#include <Protocol/EfiShellParameters.h>
+
+#include "UnitTestPersistenceLib.h"
+#include "Fingerprint.h"
+
+//
+// Log chunks start small, since most tests log little or nothing,
+// and double in size up to a cap.
+//
+#define UNIT_TEST_LOG_MIN_CHUNK_LENGTH    (256)
+#define UNIT_TEST_LOG_MAX_CHUNK_LENGTH    (16 * 1024)
+
+//
+// A UnitTestLog() call that hasn't been formatted yet. See CaptureLogArguments().
+//
+typedef struct _UNIT_TEST_LOG_RECORD UNIT_TEST_LOG_RECORD;
+struct _UNIT_TEST_LOG_RECORD
+{
+  UNIT_TEST_LOG_RECORD    *Next;
+  CONST CHAR8             *Format;          // Must outlive the test. In practice, a string literal.
+  UINTN                   ErrorLevel;
+  // UINTN                Arguments[];      // BASE_LIST, followed by copies of the strings, GUIDs
+                                            // and times that it points to.
+};
+
+//
+// Baseline statistics for a test that wasn't in the loaded baseline.
+// These are carved out of the arena and added to the baseline when it's saved.
+//
+typedef struct _UNIT_TEST_BASELINE_NODE UNIT_TEST_BASELINE_NODE;
+struct _UNIT_TEST_BASELINE_NODE
+{
+  UNIT_TEST_BASELINE_NODE   *Next;
+  UNIT_TEST_BASELINE_ENTRY  Entry;
+};
+
+//
+// Framework arenas grow in blocks of this many pages.
+//
+#define UNIT_TEST_ARENA_BLOCK_PAGES       (16)
+
+//
+// Test filters are matched against "ShortTitle/Suite Title/Test Description".
+//
+#define UNIT_TEST_FILTER_NAME_LENGTH      (3 * (UNIT_TEST_MAX_STRING_LENGTH + 1))
+
+typedef struct _UNIT_TEST_ARENA_BLOCK UNIT_TEST_ARENA_BLOCK;
+struct _UNIT_TEST_ARENA_BLOCK
+{
+  UNIT_TEST_ARENA_BLOCK   *Previous;
+  UINTN                   Pages;
+};
+
+//
+// Each AP-safe test gets a fixed log buffer while it runs on an AP,
+// since the arena can only be grown from the BSP.
+//
+#define UNIT_TEST_AP_LOG_LENGTH           (4 * UNIT_TEST_MAX_SINGLE_LOG_STRING_LENGTH)
+
+//
+// One AP-safe test in a batch. Filled in by whichever AP claims it.
+// Result stays UNIT_TEST_PENDING until then.
+//
+typedef struct
+{
+  UNIT_TEST               *Test;
+  UNIT_TEST_STATUS        Result;
+  UINT64                  Duration;
+  CHAR16                  *Log;               // UNIT_TEST_AP_LOG_LENGTH characters. Not NULL-terminated.
+  UINTN                   LogLength;
+  BOOLEAN                 LogTruncated;
+} UNIT_TEST_AP_WORK_ITEM;
+
+typedef struct
+{
+  UNIT_TEST_AP_WORK_ITEM  *Item;              // The work item this processor is running, if any.
+} UNIT_TEST_AP_SLOT;
+
+typedef struct
+{
+  EFI_MP_SERVICES_PROTOCOL  *MpServices;
+  UNIT_TEST_FRAMEWORK       *Framework;
+  UINTN                     ProcessorCount;
+  UNIT_TEST_AP_SLOT         *Slots;           // One per processor, indexed by WhoAmI().
+  UNIT_TEST_AP_WORK_ITEM    *Items;           // The batch that is running, if any.
+  UINT32                    ItemCount;
+  volatile UINT32           NextItem;         // Head of the lock-free queue. APs claim Items with InterlockedIncrement().
+} UNIT_TEST_AP_SCHEDULER;
+
+//
+// The report is rendered into one large buffer that only goes out to the
+// console (or a file) when it fills up. On a serial console every
+// OutputString() is a round trip, so this saves a lot of time.
+//
+#define UNIT_TEST_REPORT_BUFFER_LENGTH    (32 * 1024)
+
+typedef struct _UNIT_TEST_REPORT UNIT_TEST_REPORT;
+
+typedef
+EFI_STATUS
+(*UNIT_TEST_REPORT_FLUSH) (
+  IN UNIT_TEST_REPORT   *Report
+  );
+
+struct _UNIT_TEST_REPORT
+{
+  CHAR16                  *Buffer;
+  UINTN                   Length;           // Number of CHAR16s in use.
+  UINTN                   Size;             // Number of CHAR16s available, not counting room for a NULL.
+  UNIT_TEST_REPORT_FLUSH  Flush;            // Sends Buffer (NULL-terminated) wherever it's going.
+  VOID                    *Context;         // For the Flush function. EFI_FILE_PROTOCOL* for file reports.
+  EFI_STATUS              Status;           // First error from Flush, if any.
+};
+
+//
+// A failed UT_ASSERT_MEM_EQUAL logs the line holding the first difference plus this many
+// lines either side of it, so a mismatch in a multi-megabyte buffer costs at most a few log lines.
+// The line length must be a power of two.
+//
+#define UNIT_TEST_MEM_DIFF_LINE_LENGTH    16
+#define UNIT_TEST_MEM_DIFF_CONTEXT_LINES  1
+
+//
+// Benchmark calls are batched until one sample spans at least this many counter ticks,
+// which keeps the counter resolution under 0.1% of a sample. Very slow counters may
+// hit the batch cap first. See RunBenchmark().
+//
+#define UNIT_TEST_BENCHMARK_MIN_SAMPLE_TICKS      (1000)
+#define UNIT_TEST_BENCHMARK_MAX_OPS_PER_SAMPLE    (1 << 20)
+#define UNIT_TEST_BENCHMARK_WARMUP_SAMPLES        (8)
+#define UNIT_TEST_BENCHMARK_OVERHEAD_READS        (16)
+
+//
+// A test can only be marked as a performance regression once its baseline has this many
+// passing runs in it. The baseline mean is a plain average of the first WINDOW runs and
+// an exponential moving average with the same weight after that.
+//
+#define UNIT_TEST_BASELINE_MIN_RUNS       (3)
+#define UNIT_TEST_BASELINE_WINDOW         (8)
+
+BOOLEAN     mUnitTestAssertionLogging   = TRUE;
+UINTN       mUnitTestLoggingLevel       = (DEBUG_INFO | DEBUG_ERROR);
+BOOLEAN     mFlowLogging                = FALSE;    // NOTE: Doesn't do anything right now.
+
+struct _UNIT_TEST_STATUS_STRING
+{
+  UNIT_TEST_STATUS    Status;
+  CHAR8               *String;
+};
+
+struct _UNIT_TEST_STATUS_STRING   mStatusStrings[] =
+{
+  { UNIT_TEST_PASSED,               "PASSED" },
+  { UNIT_TEST_ERROR_PREREQ_NOT_MET, "NOT RUN - PREREQ FAILED" },
+  { UNIT_TEST_ERROR_TEST_FAILED,    "FAILED" },
+  { UNIT_TEST_SKIPPED,              "SKIPPED - NOT SELECTED" },
+  { UNIT_TEST_ERROR_PERF_REGRESSION, "FAILED - PERFORMANCE REGRESSION" },
+  { UNIT_TEST_RUNNING,              "RUNNING" },
+  { UNIT_TEST_PENDING,              "PENDING" }
+};
+UINTN                             mStatusStringsCount = sizeof( mStatusStrings ) / sizeof( mStatusStrings[0] );
+
+struct _UNIT_TEST_LOG_PREFIX_STRING
+{
+  UNIT_TEST_STATUS    LogLevel;
+  CHAR8               *String;
+};
+
+struct _UNIT_TEST_LOG_PREFIX_STRING   mLogPrefixStrings[] =
+{
+  { DEBUG_ERROR,    "[ERROR]       " },
+  { DEBUG_WARN,     "[WARNING]     " },
+  { DEBUG_INFO,     "[INFO]        " },
+  { DEBUG_VERBOSE,  "[VERBOSE]     " }
+};
+UINTN                                 mLogPrefixStringsCount = sizeof( mLogPrefixStrings ) / sizeof( mLogPrefixStrings[0] );
+
+
+// Prototyped here so that it can be included near the functions that
+// it logically goes with.
+STATIC
+EFI_STATUS
+IndexSavedState (
+  IN OUT UNIT_TEST_FRAMEWORK    *Framework
+  );
+
+STATIC
+VOID
+UpdateTestFromSave (
+  IN OUT UNIT_TEST              *Test,
+  IN     UNIT_TEST_FRAMEWORK    *Framework
+  );
+
+STATIC
+VOID
+ReleaseSavedStateReference (
+  IN OUT UNIT_TEST_FRAMEWORK    *Framework
+  );
+
+STATIC
+EFI_STATUS
+AppendToUnitTestLog (
+  IN OUT UNIT_TEST    *UnitTest,
+  IN CONST CHAR16     *String,
+  IN UINTN            Length
+  );
+
+STATIC
+VOID
+RenderDeferredLog (
+  IN OUT UNIT_TEST    *UnitTest
+  );
+
+STATIC
+EFI_STATUS
+AddStringToUnitTestLog (
+  IN OUT UNIT_TEST    *UnitTest,
+  IN CONST CHAR16     *String
+  );
+
+STATIC
+VOID
+LoadPerformanceBaseline (
+  IN OUT UNIT_TEST_FRAMEWORK    *Framework
+  );
+
+STATIC
+VOID
+UpdatePerformanceBaseline (
+  IN OUT UNIT_TEST_FRAMEWORK    *Framework,
+  IN OUT UNIT_TEST              *Test
+  );
+
+STATIC
+VOID
+SavePerformanceBaseline (
+  IN OUT UNIT_TEST_FRAMEWORK    *Framework
+  );
+
+
+//=============================================================================
+//
+// ----------------  TEST HELPER FUNCTIONS ------------------------------------
+//
+//=============================================================================
+
+
+/**
+  This function will determine whether the short name violates any rules that would
+  prevent it from being used as a reporting name or as a serialization name.
+
+  Example: If the name cannot be serialized to a filesystem file name.
+
+  @param[in]  ShortTitleString  A pointer to the short title string to be evaluated.
+
+  @retval     TRUE    The string is acceptable.
+  @retval     FALSE   The string should not be used.
+
+**/
+STATIC
+BOOLEAN
+IsFrameworkShortNameValid (
+  IN  CHAR16    *ShortTitleString
+  )
+{
+  // TODO: Finish this function.
+  return TRUE;
+} // IsFrameworkShortNameValid()
+
+
+/**
+  Grows the arena by at least MinimumSize bytes.
+
+  Normal blocks become the new allocation block. Requests that are too big
+  for a normal block get a dedicated block of their own, which is linked in
+  behind the current block so that the free space there isn't abandoned.
+
+  @param[in,out]  Arena         The arena to grow.
+  @param[in]      MinimumSize   The size of the allocation that didn't fit.
+
+  @retval     Pointer to MinimumSize bytes of fresh memory, or NULL.
+
+**/
+STATIC
+VOID*
+GrowArena (
+  IN OUT UNIT_TEST_ARENA  *Arena,
+  IN     UINTN            MinimumSize
+  )
+{
+  UNIT_TEST_ARENA_BLOCK   *Block, *CurrentBlock;
+  UINTN                   Pages;
+  BOOLEAN                 IsDedicated;
+
+  IsDedicated = (MinimumSize > EFI_PAGES_TO_SIZE( UNIT_TEST_ARENA_BLOCK_PAGES ) - sizeof( UNIT_TEST_ARENA_BLOCK ));
+  Pages       = IsDedicated ? EFI_SIZE_TO_PAGES( MinimumSize + sizeof( UNIT_TEST_ARENA_BLOCK ) ) : UNIT_TEST_ARENA_BLOCK_PAGES;
+
+  Block = AllocatePages( Pages );
+  if (Block == NULL)
+  {
+    return NULL;
+  }
+  Block->Pages = Pages;
+
+  CurrentBlock = Arena->Blocks;
+  if (IsDedicated && CurrentBlock != NULL)
+  {
+    Block->Previous         = CurrentBlock->Previous;
+    CurrentBlock->Previous  = Block;
+  }
+  else
+  {
+    Block->Previous   = CurrentBlock;
+    Arena->Blocks     = Block;
+    Arena->Cursor     = (UINT8*)(Block + 1) + MinimumSize;
+    Arena->Remaining  = EFI_PAGES_TO_SIZE( Pages ) - sizeof( UNIT_TEST_ARENA_BLOCK ) - MinimumSize;
+  }
+
+  return (VOID*)(Block + 1);
+} // GrowArena()
+
+
+/**
+  Carves Size bytes out of the arena. The memory is NOT zeroed.
+  There is no way to free a single allocation; everything goes
+  when the arena is released.
+
+**/
+STATIC
+VOID*
+AllocateFromArena (
+  IN OUT UNIT_TEST_ARENA  *Arena,
+  IN     UINTN            Size
+  )
+{
+  VOID    *Buffer;
+
+  // Keep everything naturally aligned for the largest type we store.
+  Size = ALIGN_VALUE( Size, sizeof( UINT64 ) );
+  if (Size > Arena->Remaining)
+  {
+    return GrowArena( Arena, Size );
+  }
+
+  Buffer            = Arena->Cursor;
+  Arena->Cursor    += Size;
+  Arena->Remaining -= Size;
+  return Buffer;
+} // AllocateFromArena()
+
+
+STATIC
+VOID*
+AllocateZeroFromArena (
+  IN OUT UNIT_TEST_ARENA  *Arena,
+  IN     UINTN            Size
+  )
+{
+  VOID    *Buffer;
+
+  Buffer = AllocateFromArena( Arena, Size );
+  if (Buffer != NULL)
+  {
+    ZeroMem( Buffer, Size );
+  }
+
+  return Buffer;
+} // AllocateZeroFromArena()
+
+
+/**
+  Returns every block owned by the arena to the system.
+  NOTE: The arena structure itself may live inside one of the blocks,
+        so it must not be touched after this returns.
+
+**/
+STATIC
+VOID
+ReleaseArena (
+  IN UNIT_TEST_ARENA  *Arena
+  )
+{
+  UNIT_TEST_ARENA_BLOCK   *Block, *PreviousBlock;
+
+  for (Block = Arena->Blocks; Block != NULL; Block = PreviousBlock)
+  {
+    PreviousBlock = Block->Previous;
+    FreePages( Block, Block->Pages );
+  }
+
+  return;
+} // ReleaseArena()
+
+
+STATIC
+CHAR16*
+AllocateAndCopyString (
+  IN OUT UNIT_TEST_ARENA  *Arena,
+  IN     CHAR16           *StringToCopy
+  )
+{
+  CHAR16    *NewString = NULL;
+  UINTN     NewStringLength;
+
+  NewStringLength = StrnLenS( StringToCopy, UNIT_TEST_MAX_STRING_LENGTH );
+  NewString = AllocateFromArena( Arena, (NewStringLength + 1) * sizeof( CHAR16 ) );
+  if (NewString != NULL)
+  {
+    CopyMem( NewString, StringToCopy, NewStringLength * sizeof( CHAR16 ) );
+    NewString[NewStringLength] = 0x00;    // NULL terminate, regardless.
+  }
+
+  return NewString;
+} // AllocateAndCopyString ()
+
+
+/**
+  Creates the hash state that children of a framework or suite start from:
+  a fresh context that has already absorbed the parent's fingerprint.
+  Each child only has to copy it and hash its own name.
+
+  @param[in,out]  Arena         Arena to allocate the context from.
+  @param[in]      Fingerprint   The parent's finished fingerprint.
+
+  @retval     !NULL   The context.
+  @retval     NULL    Out of resources.
+
+**/
+STATIC
+UNIT_TEST_FINGERPRINT_CTX*
+CreateChildFingerprintCtx (
+  IN OUT UNIT_TEST_ARENA    *Arena,
+  IN     UINT8              *Fingerprint
+  )
+{
+  UNIT_TEST_FINGERPRINT_CTX   *Ctx;
+
+  Ctx = AllocateFromArena( Arena, sizeof( UNIT_TEST_FINGERPRINT_CTX ) );
+  if (Ctx != NULL)
+  {
+    FingerprintInit( Ctx );
+    FingerprintUpdate( Ctx, Fingerprint, UNIT_TEST_FINGERPRINT_SIZE );
+  }
+
+  return Ctx;
+} // CreateChildFingerprintCtx()
+
+
+STATIC
+EFI_STATUS
+SetFrameworkFingerprint (
+  OUT UINT8                 *Fingerprint,
+  IN  UNIT_TEST_FRAMEWORK   *Framework
+  )
+{
+  UNIT_TEST_FINGERPRINT_CTX   Ctx;
+
+  FingerprintInit( &Ctx );
+
+  // For this one we'll just use the title and version as the unique fingerprint.
+  FingerprintUpdate( &Ctx, Framework->Title, (StrLen( Framework->Title ) * sizeof( CHAR16 )) );
+  FingerprintUpdate( &Ctx, Framework->VersionString, (StrLen( Framework->VersionString ) * sizeof( CHAR16 )) );
+
+  FingerprintFinal( &Ctx, Fingerprint );
+
+  Framework->FingerprintCtx = CreateChildFingerprintCtx( &Framework->Arena, Fingerprint );
+  return (Framework->FingerprintCtx != NULL) ? EFI_SUCCESS : EFI_OUT_OF_RESOURCES;
+} // SetFrameworkFingerprint()
+
+
+STATIC
+EFI_STATUS
+SetSuiteFingerprint (
+  OUT UINT8                 *Fingerprint,
+  IN  UNIT_TEST_FRAMEWORK   *Framework,
+  IN  UNIT_TEST_SUITE       *Suite
+  )
+{
+  UNIT_TEST_FINGERPRINT_CTX   Ctx;
+
+  // For this one, we'll use the fingerprint from the framework (already absorbed), and the title of the suite.
+  CopyMem( &Ctx, Framework->FingerprintCtx, sizeof( Ctx ) );
+  FingerprintUpdate( &Ctx, Suite->Title, (StrLen( Suite->Title ) * sizeof( CHAR16 )) );
+
+  FingerprintFinal( &Ctx, Fingerprint );
+
+  Suite->FingerprintCtx = CreateChildFingerprintCtx( &Framework->Arena, Fingerprint );
+  return (Suite->FingerprintCtx != NULL) ? EFI_SUCCESS : EFI_OUT_OF_RESOURCES;
+} // SetSuiteFingerprint()
+
+
+STATIC
+VOID
+SetTestFingerprint (
+  OUT UINT8                 *Fingerprint,
+  IN  UNIT_TEST_SUITE       *Suite,
+  IN  UNIT_TEST             *Test
+  )
+{
+  UNIT_TEST_FINGERPRINT_CTX   Ctx;
+
+  // For this one, we'll use the fingerprint from the suite (already absorbed), and the description of the test.
+  CopyMem( &Ctx, Suite->FingerprintCtx, sizeof( Ctx ) );
+  FingerprintUpdate( &Ctx, Test->Description, (StrLen( Test->Description ) * sizeof( CHAR16 )) );
+
+  FingerprintFinal( &Ctx, Fingerprint );
+  return;
+} // SetTestFingerprint()
+
+
+STATIC
+BOOLEAN
+CompareFingerprints (
+  IN  UINT8       *FingerprintA,
+  IN  UINT8       *FingerprintB
+  )
+{
+  return (CompareMem( FingerprintA, FingerprintB, UNIT_TEST_FINGERPRINT_SIZE ) == 0);
+} // SetTestFingerprint()
+
+
+/**
+  Case-insensitive glob match. '*' matches any run of characters (including none)
+  and '?' matches any single character. Only ASCII letters are folded.
+
+  Backtracks to the most recent '*' only, so this is never worse
+  than O(Pattern * String).
+
+**/
+STATIC
+BOOLEAN
+MatchFilterPattern (
+  IN CONST CHAR16   *Pattern,
+  IN CONST CHAR16   *String
+  )
+{
+  CONST CHAR16    *StarPattern = NULL;
+  CONST CHAR16    *StarString = NULL;
+  CHAR16          PatternChar, StringChar;
+
+  while (*String != L'\0')
+  {
+    if (*Pattern == L'*')
+    {
+      // Remember where we were so that a later mismatch can let the '*' eat one more character.
+      StarPattern = ++Pattern;
+      StarString  = String;
+      continue;
+    }
+
+    PatternChar = (*Pattern >= L'a' && *Pattern <= L'z') ? (*Pattern - (L'a' - L'A')) : *Pattern;
+    StringChar  = (*String >= L'a' && *String <= L'z') ? (*String - (L'a' - L'A')) : *String;
+    if (*Pattern != L'\0' && (PatternChar == L'?' || PatternChar == StringChar))
+    {
+      Pattern++;
+      String++;
+      continue;
+    }
+
+    if (StarPattern == NULL)
+    {
+      return FALSE;
+    }
+    Pattern = StarPattern;
+    String  = ++StarString;
+  }
+
+  // Any trailing '*'s can match nothing.
+  while (*Pattern == L'*')
+  {
+    Pattern++;
+  }
+
+  return (*Pattern == L'\0');
+} // MatchFilterPattern()
+
+
+/**
+  Picks the -i/-include and -x/-exclude patterns out of the app's shell command line.
+  Apps that weren't launched from the shell just run everything.
+
+**/
+STATIC
+EFI_STATUS
+ParseTestFilters (
+  IN OUT UNIT_TEST_FRAMEWORK    *Framework
+  )
+{
+  EFI_STATUS                      Status;
+  EFI_SHELL_PARAMETERS_PROTOCOL   *ShellParameters;
+  UINTN                           Index;
+  BOOLEAN                         IsInclude;
+  CHAR16                          **Filters;
+  UINTN                           *FilterCount;
+
+  Status = gBS->HandleProtocol( gImageHandle,
+                                &gEfiShellParametersProtocolGuid,
+                                (VOID**)&ShellParameters );
+  if (EFI_ERROR( Status ) || ShellParameters->Argc < 2)
+  {
+    return EFI_SUCCESS;
+  }
+
+  //
+  // Count first, so that each list can be carved out of the arena in one go.
+  for (Index = 1; Index + 1 < ShellParameters->Argc; Index++)
+  {
+    if (StrCmp( ShellParameters->Argv[Index], L"-i" ) == 0 || StrCmp( ShellParameters->Argv[Index], L"-include" ) == 0)
+    {
+      Framework->IncludeFilterCount++;
+      Index++;
+    }
+    else if (StrCmp( ShellParameters->Argv[Index], L"-x" ) == 0 || StrCmp( ShellParameters->Argv[Index], L"-exclude" ) == 0)
+    {
+      Framework->ExcludeFilterCount++;
+      Index++;
+    }
+  }
+
+  if (Framework->IncludeFilterCount > 0)
+  {
+    Framework->IncludeFilters = AllocateFromArena( &Framework->Arena, Framework->IncludeFilterCount * sizeof( CHAR16* ) );
+  }
+  if (Framework->ExcludeFilterCount > 0)
+  {
+    Framework->ExcludeFilters = AllocateFromArena( &Framework->Arena, Framework->ExcludeFilterCount * sizeof( CHAR16* ) );
+  }
+  if ((Framework->IncludeFilterCount > 0 && Framework->IncludeFilters == NULL) ||
+      (Framework->ExcludeFilterCount > 0 && Framework->ExcludeFilters == NULL))
+  {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  //
+  // Now go back and copy the patterns.
+  Framework->IncludeFilterCount = 0;
+  Framework->ExcludeFilterCount = 0;
+  for (Index = 1; Index < ShellParameters->Argc; Index++)
+  {
+    if (StrCmp( ShellParameters->Argv[Index], L"-i" ) == 0 || StrCmp( ShellParameters->Argv[Index], L"-include" ) == 0)
+    {
+      IsInclude = TRUE;
+    }
+    else if (StrCmp( ShellParameters->Argv[Index], L"-x" ) == 0 || StrCmp( ShellParameters->Argv[Index], L"-exclude" ) == 0)
+    {
+      IsInclude = FALSE;
+    }
+    else
+    {
+      // Not ours. Leave it for the app.
+      continue;
+    }
+
+    if (Index + 1 >= ShellParameters->Argc)
+    {
+      DEBUG(( DEBUG_WARN, "%a - '%s' is missing its pattern. Ignoring.\n", __FUNCTION__, ShellParameters->Argv[Index] ));
+      break;
+    }
+
+    Index++;
+    Filters     = IsInclude ? Framework->IncludeFilters : Framework->ExcludeFilters;
+    FilterCount = IsInclude ? &Framework->IncludeFilterCount : &Framework->ExcludeFilterCount;
+    Filters[*FilterCount] = AllocateAndCopyString( &Framework->Arena, ShellParameters->Argv[Index] );
+    if (Filters[*FilterCount] == NULL)
+    {
+      return EFI_OUT_OF_RESOURCES;
+    }
+    DEBUG(( DEBUG_INFO, "%a - %a '%s'\n", __FUNCTION__, IsInclude ? "Including" : "Excluding", Filters[*FilterCount] ));
+    (*FilterCount)++;
+  }
+
+  return EFI_SUCCESS;
+} // ParseTestFilters()
+
+
+/**
+  Decides whether the command-line filters select a given test.
+  A test is selected if it matches any include filter (or there are none)
+  and doesn't match any exclude filter.
+
+**/
+STATIC
+BOOLEAN
+IsTestSelected (
+  IN UNIT_TEST_FRAMEWORK    *Framework,
+  IN UNIT_TEST_SUITE        *Suite,
+  IN UNIT_TEST              *Test
+  )
+{
+  CHAR16      FullName[UNIT_TEST_FILTER_NAME_LENGTH];
+  UINTN       Index;
+  BOOLEAN     Selected;
+
+  UnicodeSPrint( &FullName[0], sizeof( FullName ), L"%s/%s/%s",
+                 Framework->ShortTitle, Suite->Title, Test->Description );
+
+  Selected = (Framework->IncludeFilterCount == 0);
+  for (Index = 0; !Selected && Index < Framework->IncludeFilterCount; Index++)
+  {
+    Selected = MatchFilterPattern( Framework->IncludeFilters[Index], &FullName[0] );
+  }
+  for (Index = 0; Selected && Index < Framework->ExcludeFilterCount; Index++)
+  {
+    Selected = !MatchFilterPattern( Framework->ExcludeFilters[Index], &FullName[0] );
+  }
+
+  return Selected;
+} // IsTestSelected()
+
+
+/**
+  Counts a newly added test against its suite if it still has to run, and
+  remembers it if it's the first one. Done as each test is added (after any
+  saved result and the filters have been applied) so that a resumed run never
+  has to walk the tests to find out where it left off.
+
+**/
+STATIC
+VOID
+TrackPendingTest (
+  IN OUT UNIT_TEST_SUITE        *Suite,
+  IN     UNIT_TEST_LIST_ENTRY   *TestEntry
+  )
+{
+  if (TestEntry->UT.Result != UNIT_TEST_PENDING && TestEntry->UT.Result != UNIT_TEST_RUNNING)
+  {
+    return;
+  }
+
+  Suite->PendingCount++;
+  if (Suite->FirstPending == NULL)
+  {
+    Suite->FirstPending = TestEntry;
+  }
+
+  return;
+} // TrackPendingTest()
+
+
+/**
+  Returns the number of ticks between two performance counter values,
+  taking into account counters that count down and counters that wrap.
+
+**/
+STATIC
+UINT64
+GetElapsedTicks (
+  IN  UINT64    StartTicks,
+  IN  UINT64    EndTicks
+  )
+{
+  UINT64    CounterStart, CounterEnd;
+
+  GetPerformanceCounterProperties( &CounterStart, &CounterEnd );
+  if (CounterStart < CounterEnd)
+  {
+    // Counting up.
+    return (EndTicks >= StartTicks) ? (EndTicks - StartTicks) :
+                                      ((CounterEnd - StartTicks) + (EndTicks - CounterStart));
+  }
+
+  // Counting down.
+  return (StartTicks >= EndTicks) ? (StartTicks - EndTicks) :
+                                    ((StartTicks - CounterEnd) + (CounterStart - EndTicks));
+} // GetElapsedTicks()
+
+
+/**
+  Converts the distance between two performance counter values to nanoseconds.
+
+**/
+STATIC
+UINT64
+GetElapsedNanoSeconds (
+  IN  UINT64    StartTicks,
+  IN  UINT64    EndTicks
+  )
+{
+  return GetTimeInNanoSecond( GetElapsedTicks( StartTicks, EndTicks ) );
+} // GetElapsedNanoSeconds()
+
+
+/**
+  Starts accumulating time into Duration. Only one duration is timed at once;
+  the framework tracks it so that SerializeState() can account for time that
+  was spent right up until a save.
+
+**/
+STATIC
+VOID
+StartDurationTimer (
+  IN OUT UNIT_TEST_FRAMEWORK    *Framework,
+  IN     UINT64                 *Duration
+  )
+{
+  Framework->ActiveTimer      = Duration;
+  Framework->ActiveTimerStart = GetPerformanceCounter();
+  return;
+} // StartDurationTimer()
+
+
+/**
+  Folds the time elapsed so far into the active duration. If Restart is TRUE,
+  the timer keeps running from this point; otherwise it is stopped.
+
+**/
+STATIC
+VOID
+UpdateDurationTimer (
+  IN OUT UNIT_TEST_FRAMEWORK    *Framework,
+  IN     BOOLEAN                Restart
+  )
+{
+  UINT64    Now;
+
+  if (Framework->ActiveTimer == NULL)
+  {
+    return;
+  }
+
+  Now = GetPerformanceCounter();
+  *Framework->ActiveTimer += GetElapsedNanoSeconds( Framework->ActiveTimerStart, Now );
+  Framework->ActiveTimerStart = Now;
+  if (!Restart)
+  {
+    Framework->ActiveTimer = NULL;
+  }
+
+  return;
+} // UpdateDurationTimer()
+
+
+EFI_STATUS
+EFIAPI
+FreeUnitTestFramework (
+  IN UNIT_TEST_FRAMEWORK  *Framework
+  )
+{
+  UNIT_TEST_ARENA   Arena;
+
+  if (Framework == NULL)
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // Close out anything the persistence lib has kept open, like the cache file.
+  CloseUnitTestPersistence( Framework );
+
+  //
+  // The saved state came from the persistence lib, not the arena.
+  if (Framework->SavedState != NULL)
+  {
+    FreePool( Framework->SavedState );
+    Framework->SavedState = NULL;
+  }
+  if (Framework->Baseline != NULL)
+  {
+    FreePool( Framework->Baseline );
+    Framework->Baseline = NULL;
+  }
+
+  //
+  // Everything else -- including the framework itself -- lives in the arena.
+  // Grab a copy of the arena first, since it's about to free itself out from under us.
+  CopyMem( &Arena, &Framework->Arena, sizeof( Arena ) );
+  ReleaseArena( &Arena );
+
+  return EFI_SUCCESS;
+} // FreeUnitTestFramework()
+
+
+//=============================================================================
+//
+// ----------------  TEST SETUP FUNCTIONS -------------------------------------
+//
+//=============================================================================
+
+
+/*
+Method to Initialize the Unit Test framework
+
+@retval Success - Unit Test init.
+@retval EFI_ERROR - Unit Tests init failed.
+*/
+EFI_STATUS
+EFIAPI
+InitUnitTestFramework (
+  OUT UNIT_TEST_FRAMEWORK   **Framework,
+  IN  CHAR16                *Title,
+  IN  CHAR16                *ShortTitle,
+  IN  CHAR16                *VersionString
+  )
+{
+  EFI_STATUS                Status = EFI_SUCCESS;
+  UNIT_TEST_FRAMEWORK       *NewFramework = NULL;
+  UNIT_TEST_ARENA           Arena;
+  UNIT_TEST_SAVE_HEADER     *SavedState;
+
+  //
+  // First, check all pointers and make sure nothing's broked.
+  if (Framework == NULL || Title == NULL ||
+      ShortTitle == NULL || VersionString == NULL)
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // Next, determine whether all of the strings are good to use.
+  if (!IsFrameworkShortNameValid( ShortTitle ))
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // Next, set aside some space to start messing with the framework.
+  // The framework is the first thing carved out of its own arena.
+  ZeroMem( &Arena, sizeof( Arena ) );
+  NewFramework = AllocateZeroFromArena( &Arena, sizeof( UNIT_TEST_FRAMEWORK ) );
+  if (NewFramework == NULL)
+  {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  CopyMem( &NewFramework->Arena, &Arena, sizeof( Arena ) );
+
+  //
+  // Next, set up all the test data.
+  NewFramework->Title         = AllocateAndCopyString( &NewFramework->Arena, Title );
+  NewFramework->ShortTitle    = AllocateAndCopyString( &NewFramework->Arena, ShortTitle );
+  NewFramework->VersionString = AllocateAndCopyString( &NewFramework->Arena, VersionString );
+  NewFramework->Log           = NULL;
+  NewFramework->CurrentTest   = NULL;
+  NewFramework->SavedState    = NULL;
+  if (NewFramework->Title == NULL || NewFramework->ShortTitle == NULL ||
+      NewFramework->VersionString == NULL)
+  {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Exit;
+  }
+  InitializeListHead( &(NewFramework->TestSuiteList) );
+
+  //
+  // Pick up any test filters from the command line.
+  Status = ParseTestFilters( NewFramework );
+  if (EFI_ERROR( Status ))
+  {
+    goto Exit;
+  }
+
+  //
+  // Create the framework fingerprint.
+  Status = SetFrameworkFingerprint( &NewFramework->Fingerprint[0], NewFramework );
+  if (EFI_ERROR( Status ))
+  {
+    goto Exit;
+  }
+
+  //
+  // If there is a persisted context, load it now.
+  if (DoesCacheExist( NewFramework ))
+  {
+    Status = LoadUnitTestCache( NewFramework, &SavedState );
+    if (EFI_ERROR( Status ))
+    {
+      // Don't actually report it as an error, but emit a warning.
+      DEBUG(( DEBUG_ERROR, "%a - Cache was detected, but failed to load.\n", __FUNCTION__ ));
+      Status = EFI_SUCCESS;
+    }
+    else
+    {
+      //
+      // Index the saved tests once, up front, so that every AddTestCase()
+      // can find its saved record without walking the blob.
+      NewFramework->SavedState = SavedState;
+      if (EFI_ERROR( IndexSavedState( NewFramework ) ))
+      {
+        // A cache we can't use is no worse than no cache at all.
+        DEBUG(( DEBUG_ERROR, "%a - Cache was loaded, but could not be used.\n", __FUNCTION__ ));
+        FreePool( NewFramework->SavedState );
+        NewFramework->SavedState = NULL;
+      }
+      else
+      {
+        // The run started back before the first save.
+        CopyMem( &NewFramework->StartTime, &SavedState->StartTime, sizeof( EFI_TIME ) );
+        NewFramework->BootIsDirty           = SavedState->BootIsDirty;
+        NewFramework->CleanBootTestCount    = SavedState->CleanBootTestCount;
+        NewFramework->CleanBootRebootCount  = SavedState->CleanBootRebootCount;
+        // From here on, saves only have to add what has changed. Unless the
+        // cache couldn't be compacted, in which case the next one starts it over.
+        NewFramework->CacheIsJournaled      = (Status != EFI_WARN_WRITE_FAILURE);
+      }
+      Status = EFI_SUCCESS;
+    }
+  }
+
+  //
+  // Pick up the performance baseline from previous runs, if there is one.
+  LoadPerformanceBaseline( NewFramework );
+
+Exit:
+  //
+  // If we're good, then let's copy the framework.
+  if (!EFI_ERROR( Status ))
+  {
+    *Framework = NewFramework;
+  }
+  // Otherwise, we need to undo this horrible thing that we've done.
+  else
+  {
+    FreeUnitTestFramework( NewFramework );
+  }
+
+  return Status;
+}
+
+
+EFI_STATUS
+EFIAPI
+CreateUnitTestSuite (
+  OUT UNIT_TEST_SUITE           **Suite,
+  IN UNIT_TEST_FRAMEWORK        *Framework,
+  IN CHAR16                     *Title,
+  IN UNIT_TEST_SUITE_SETUP      Sup    OPTIONAL,
+  IN UNIT_TEST_SUITE_TEARDOWN   Tdn    OPTIONAL
+  )
+{
+  EFI_STATUS                    Status = EFI_SUCCESS;
+  UNIT_TEST_SUITE_LIST_ENTRY    *NewSuiteEntry;
+
+  //
+  // First, let's check to make sure that our parameters look good.
+  if ((Framework == NULL) || (Title == NULL))
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // Create the new entry.
+  NewSuiteEntry = AllocateZeroFromArena( &Framework->Arena, sizeof( UNIT_TEST_SUITE_LIST_ENTRY ) );
+  if (NewSuiteEntry == NULL)
+  {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  //
+  // Copy the fields we think we need.
+  NewSuiteEntry->UTS.Title            = AllocateAndCopyString( &Framework->Arena, Title );
+  NewSuiteEntry->UTS.Setup            = Sup;
+  NewSuiteEntry->UTS.Teardown         = Tdn;
+  NewSuiteEntry->UTS.ParentFramework  = Framework;
+  InitializeListHead( &(NewSuiteEntry->Entry) );             // List entry for sibling suites.
+  InitializeListHead( &(NewSuiteEntry->UTS.TestCaseList) );  // List entry for child tests.
+  if (NewSuiteEntry->UTS.Title == NULL)
+  {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Exit;
+  }
+
+  //
+  // Create the suite fingerprint.
+  Status = SetSuiteFingerprint( &NewSuiteEntry->UTS.Fingerprint[0], Framework, &NewSuiteEntry->UTS );
+
+Exit:
+  //
+  // If everything is going well, add the new suite to the tail list for the framework.
+  // Otherwise, the partial entry just stays in the arena until the framework is freed.
+  if (!EFI_ERROR( Status ))
+  {
+    InsertTailList( &(Framework->TestSuiteList), (LIST_ENTRY*)NewSuiteEntry );
+    *Suite = &NewSuiteEntry->UTS;
+  }
+
+  return Status;
+}
+
+
+/**
+  Creates a test and adds it to the suite. If BenchmarkIterations is non-zero,
+  the test is a benchmark and gets somewhere to keep its statistics. That has to
+  be in place before any saved results are restored into it.
+
+**/
+STATIC
+EFI_STATUS
+AddTestCaseInternal (
+  IN UNIT_TEST_SUITE      *Suite,
+  IN CHAR16               *Description,
+  IN UNIT_TEST_FUNCTION   Func,
+  IN UNIT_TEST_PREREQ     PreReq    OPTIONAL,
+  IN UNIT_TEST_CLEANUP    CleanUp   OPTIONAL,
+  IN UNIT_TEST_CONTEXT    Context   OPTIONAL,
+  IN UINT32               Attributes,
+  IN UINT32               BenchmarkIterations
+  )
+{
+  EFI_STATUS            Status = EFI_SUCCESS;
+  UNIT_TEST_LIST_ENTRY  *NewTestEntry;
+  UNIT_TEST_FRAMEWORK   *ParentFramework = (UNIT_TEST_FRAMEWORK*)Suite->ParentFramework;
+
+  //
+  // First, let's check to make sure that our parameters look good.
+  if ((Suite == NULL) || (Description == NULL))
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+  // A test that shares the boot with the APs can't have one to itself.
+  if ((Attributes & UNIT_TEST_ATTRIBUTE_AP_SAFE) != 0 &&
+      (Attributes & UNIT_TEST_ATTRIBUTE_REQUIRES_CLEAN_BOOT) != 0)
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // Create the new entry.
+  NewTestEntry = AllocateZeroFromArena( &ParentFramework->Arena, sizeof( UNIT_TEST_LIST_ENTRY ) );
+  if (NewTestEntry == NULL)
+  {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  //
+  // Copy the fields we think we need.
+  NewTestEntry->UT.Description  = AllocateAndCopyString( &ParentFramework->Arena, Description );
+  NewTestEntry->UT.Log.Head     = NULL;
+  NewTestEntry->UT.Log.Tail     = NULL;
+  NewTestEntry->UT.Log.Length   = 0;
+  NewTestEntry->UT.Log.DeferredHead = NULL;
+  NewTestEntry->UT.Log.DeferredTail = NULL;
+  NewTestEntry->UT.Log.Borrowed = FALSE;
+  NewTestEntry->UT.PreReq       = PreReq;
+  NewTestEntry->UT.CleanUp      = CleanUp;
+  NewTestEntry->UT.RunTest      = Func;
+  NewTestEntry->UT.Context      = Context;
+  NewTestEntry->UT.Attributes   = Attributes;
+  NewTestEntry->UT.Result       = UNIT_TEST_PENDING;
+  NewTestEntry->UT.SavedResult  = UNIT_TEST_PENDING;
+  NewTestEntry->UT.ParentSuite  = Suite;
+  InitializeListHead( &(NewTestEntry->Entry) );      // List entry for sibling tests.
+  if (NewTestEntry->UT.Description == NULL)
+  {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Exit;
+  }
+  if (BenchmarkIterations > 0)
+  {
+    NewTestEntry->UT.Benchmark = AllocateZeroFromArena( &ParentFramework->Arena, sizeof( UNIT_TEST_BENCHMARK ) );
+    if (NewTestEntry->UT.Benchmark == NULL)
+    {
+      Status = EFI_OUT_OF_RESOURCES;
+      goto Exit;
+    }
+    NewTestEntry->UT.Benchmark->Iterations = BenchmarkIterations;
+  }
+
+  //
+  // Create the test fingerprint.
+  SetTestFingerprint( &NewTestEntry->UT.Fingerprint[0], Suite, &NewTestEntry->UT );
+
+  // TODO: Make sure that duplicate fingerprints cannot be created.
+
+  //
+  // If there is saved test data, update this record.
+  if (ParentFramework->SavedState != NULL)
+  {
+    UpdateTestFromSave( &NewTestEntry->UT, ParentFramework );
+  }
+
+  //
+  // Apply the command-line filters, if there were any.
+  // Without any filters, a saved selection is left alone so that a run that was
+  // filtered before a reboot stays filtered when it's resumed.
+  if (ParentFramework->IncludeFilterCount > 0 || ParentFramework->ExcludeFilterCount > 0)
+  {
+    if (!IsTestSelected( ParentFramework, Suite, &NewTestEntry->UT ))
+    {
+      if (NewTestEntry->UT.Result == UNIT_TEST_PENDING)
+      {
+        NewTestEntry->UT.Result = UNIT_TEST_SKIPPED;
+      }
+    }
+    else if (NewTestEntry->UT.Result == UNIT_TEST_SKIPPED)
+    {
+      NewTestEntry->UT.Result = UNIT_TEST_PENDING;
+    }
+  }
+
+Exit:
+  //
+  // If everything is going well, add the new test to the tail list for the suite.
+  // Otherwise, the partial entry just stays in the arena until the framework is freed.
+  if (!EFI_ERROR( Status ))
+  {
+    InsertTailList( &(Suite->TestCaseList), (LIST_ENTRY*)NewTestEntry );
+    TrackPendingTest( Suite, NewTestEntry );
+  }
+
+  return Status;
+}
+
+
+EFI_STATUS
+EFIAPI
+AddTestCase (
+  IN UNIT_TEST_SUITE      *Suite,
+  IN CHAR16               *Description,
+  IN UNIT_TEST_FUNCTION   Func,
+  IN UNIT_TEST_PREREQ     PreReq    OPTIONAL,
+  IN UNIT_TEST_CLEANUP    CleanUp   OPTIONAL,
+  IN UNIT_TEST_CONTEXT    Context   OPTIONAL
+  )
+{
+  return AddTestCaseEx( Suite, Description, Func, PreReq, CleanUp, Context, 0 );
+}
+
+
+EFI_STATUS
+EFIAPI
+AddTestCaseEx (
+  IN UNIT_TEST_SUITE      *Suite,
+  IN CHAR16               *Description,
+  IN UNIT_TEST_FUNCTION   Func,
+  IN UNIT_TEST_PREREQ     PreReq    OPTIONAL,
+  IN UNIT_TEST_CLEANUP    CleanUp   OPTIONAL,
+  IN UNIT_TEST_CONTEXT    Context   OPTIONAL,
+  IN UINT32               Attributes
+  )
+{
+  return AddTestCaseInternal( Suite, Description, Func, PreReq, CleanUp, Context, Attributes, 0 );
+}
+
+
+EFI_STATUS
+EFIAPI
+AddBenchmarkCase (
+  IN UNIT_TEST_SUITE      *Suite,
+  IN CHAR16               *Description,
+  IN UNIT_TEST_FUNCTION   Func,
+  IN UNIT_TEST_CONTEXT    Context   OPTIONAL,
+  IN UINT32               Iterations
+  )
+{
+  if (Iterations == 0)
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  return AddTestCaseInternal( Suite, Description, Func, NULL, NULL, Context, 0, Iterations );
+}
+
+
+//=============================================================================
+//
+// ----------------  TEST EXECUTION FUNCTIONS ---------------------------------
+//
+//=============================================================================
+
+/**
+  Sets up Framework->ApScheduler if there are any AP-safe tests and
+  more than one enabled processor to run them on. Otherwise, leaves it
+  NULL and everything runs serially on the BSP.
+
+**/
+STATIC
+VOID
+InitApScheduler (
+  IN OUT UNIT_TEST_FRAMEWORK    *Framework
+  )
+{
+  EFI_STATUS                    Status;
+  EFI_MP_SERVICES_PROTOCOL      *MpServices;
+  UNIT_TEST_AP_SCHEDULER        *Scheduler;
+  UNIT_TEST_SUITE_LIST_ENTRY    *Suite;
+  UNIT_TEST_LIST_ENTRY          *Test;
+  BOOLEAN                       HasApSafeTests = FALSE;
+  UINTN                         ProcessorCount, EnabledCount, Index;
+
+  if (Framework->ApScheduler != NULL)
+  {
+    return;
+  }
+
+  for (Suite = (UNIT_TEST_SUITE_LIST_ENTRY*)GetFirstNode( &Framework->TestSuiteList );
+       (LIST_ENTRY*)Suite != &Framework->TestSuiteList && !HasApSafeTests;
+       Suite = (UNIT_TEST_SUITE_LIST_ENTRY*)GetNextNode( &Framework->TestSuiteList, (LIST_ENTRY*)Suite ))
+  {
+    for (Test = (UNIT_TEST_LIST_ENTRY*)GetFirstNode( &Suite->UTS.TestCaseList );
+         (LIST_ENTRY*)Test != &Suite->UTS.TestCaseList && !HasApSafeTests;
+         Test = (UNIT_TEST_LIST_ENTRY*)GetNextNode( &Suite->UTS.TestCaseList, (LIST_ENTRY*)Test ))
+    {
+      HasApSafeTests = ((Test->UT.Attributes & UNIT_TEST_ATTRIBUTE_AP_SAFE) != 0);
+    }
+  }
+  if (!HasApSafeTests)
+  {
+    return;
+  }
+
+  Status = gBS->LocateProtocol( &gEfiMpServiceProtocolGuid, NULL, (VOID**)&MpServices );
+  if (!EFI_ERROR( Status ))
+  {
+    Status = MpServices->GetNumberOfProcessors( MpServices, &ProcessorCount, &EnabledCount );
+  }
+  if (EFI_ERROR( Status ) || EnabledCount < 2)
+  {
+    DEBUG(( DEBUG_INFO, "%a - No APs available. AP-safe tests will run on the BSP.\n", __FUNCTION__ ));
+    return;
+  }
+
+  //
+  // Processor numbers from WhoAmI() go up to the total count, not just the enabled count.
+  Scheduler = AllocateZeroFromArena( &Framework->Arena, sizeof( UNIT_TEST_AP_SCHEDULER ) );
+  if (Scheduler == NULL)
+  {
+    return;
+  }
+  Scheduler->Slots = AllocateZeroFromArena( &Framework->Arena, ProcessorCount * sizeof( UNIT_TEST_AP_SLOT ) );
+  if (Scheduler->Slots == NULL)
+  {
+    return;
+  }
+  Scheduler->MpServices     = MpServices;
+  Scheduler->Framework      = Framework;
+  Scheduler->ProcessorCount = ProcessorCount;
+
+  DEBUG(( DEBUG_INFO, "%a - AP-safe tests will run on %d processors.\n", __FUNCTION__, EnabledCount - 1 ));
+  Framework->ApScheduler = Scheduler;
+  return;
+} // InitApScheduler()
+
+
+/**
+  Runs on each AP. Keeps claiming work items off the front of the queue
+  until there are none left. Nothing in here touches the arena or any
+  other shared framework state; the test's log goes to its work item.
+
+  The duration is timed on the AP itself. Both counter reads happen on the
+  same processor, so the APs' counters don't have to agree with the BSP's,
+  only tick at the rate GetPerformanceCounterProperties() gave on the BSP.
+  That holds for the invariant TSC and the ARM generic timer, and the
+  platform TimerLib is assumed to be built on one of those.
+
+**/
+STATIC
+VOID
+EFIAPI
+ApSafeTestWorker (
+  IN VOID   *Buffer
+  )
+{
+  UNIT_TEST_AP_SCHEDULER  *Scheduler = (UNIT_TEST_AP_SCHEDULER*)Buffer;
+  UNIT_TEST_AP_WORK_ITEM  *Item;
+  UNIT_TEST_AP_SLOT       *Slot;
+  UINTN                   Processor;
+  UINT32                  Index;
+  UINT64                  StartTicks;
+
+  if (EFI_ERROR( Scheduler->MpServices->WhoAmI( Scheduler->MpServices, &Processor ) ) ||
+      Processor >= Scheduler->ProcessorCount)
+  {
+    return;
+  }
+  Slot = &Scheduler->Slots[Processor];
+
+  for (;;)
+  {
+    Index = InterlockedIncrement( &Scheduler->NextItem ) - 1;
+    if (Index >= Scheduler->ItemCount)
+    {
+      break;
+    }
+
+    Item            = &Scheduler->Items[Index];
+    Slot->Item      = Item;
+
+    StartTicks      = GetPerformanceCounter();
+    Item->Result    = Item->Test->RunTest( Scheduler->Framework, Item->Test->Context );
+    Item->Duration  = GetElapsedNanoSeconds( StartTicks, GetPerformanceCounter() );
+
+    Slot->Item      = NULL;
+  }
+
+  return;
+} // ApSafeTestWorker()
+
+
+/**
+  Runs a batch of consecutive AP-safe tests, starting at FirstEntry.
+  PreReqs run on the BSP first, then the tests whose PreReqs passed are
+  spread across the APs, then the CleanUps run on the BSP in order. Any
+  test that no AP claimed runs on the BSP as its results are collected.
+
+  @param[in]  Suite       The suite the tests belong to.
+  @param[in]  FirstEntry  The first test in the batch. Must be AP-safe and PENDING.
+
+  @retval     The last test entry that was part of the batch.
+
+**/
+STATIC
+UNIT_TEST_LIST_ENTRY*
+RunApSafeTests (
+  IN UNIT_TEST_SUITE        *Suite,
+  IN UNIT_TEST_LIST_ENTRY   *FirstEntry
+  )
+{
+  UNIT_TEST_FRAMEWORK     *Framework = (UNIT_TEST_FRAMEWORK*)Suite->ParentFramework;
+  UNIT_TEST_AP_SCHEDULER  *Scheduler = (UNIT_TEST_AP_SCHEDULER*)Framework->ApScheduler;
+  UNIT_TEST_LIST_ENTRY    *TestEntry, *LastEntry;
+  UNIT_TEST_AP_WORK_ITEM  *Item;
+  UNIT_TEST               *Test;
+  UNIT_TEST_STATUS        PreReqResult;
+  CHAR16                  *Logs;
+  UINT32                  Count, Index;
+  EFI_STATUS              Status;
+
+  //
+  // Find the end of the batch.
+  Count = 0;
+  LastEntry = FirstEntry;
+  for (TestEntry = FirstEntry;
+       (LIST_ENTRY*)TestEntry != &(Suite->TestCaseList) &&
+        (TestEntry->UT.Attributes & UNIT_TEST_ATTRIBUTE_AP_SAFE) != 0 &&
+        TestEntry->UT.Result == UNIT_TEST_PENDING;
+       TestEntry = (UNIT_TEST_LIST_ENTRY*)GetNextNode( &(Suite->TestCaseList), (LIST_ENTRY*)TestEntry ))
+  {
+    LastEntry = TestEntry;
+    Count++;
+  }
+
+  //
+  // Every test gets a log buffer of its own, so a chatty test can't use up the room
+  // of the tests after it on the same AP. The work items and logs are only needed
+  // until the batch is collected, so they come from the pool rather than the arena.
+  Logs = AllocatePool( Count * UNIT_TEST_AP_LOG_LENGTH * sizeof( CHAR16 ) );
+  Scheduler->Items = AllocateZeroPool( Count * sizeof( UNIT_TEST_AP_WORK_ITEM ) );
+  if (Logs == NULL || Scheduler->Items == NULL)
+  {
+    // Leave the tests PENDING. RunTestSuite() will run them one at a time.
+    if (Logs != NULL)
+    {
+      FreePool( Logs );
+    }
+    if (Scheduler->Items != NULL)
+    {
+      FreePool( Scheduler->Items );
+      Scheduler->Items = NULL;
+    }
+    return NULL;
+  }
+
+  //
+  // PreReqs may set up shared state, so they all run here on the BSP.
+  Scheduler->ItemCount = 0;
+  for (TestEntry = FirstEntry;; TestEntry = (UNIT_TEST_LIST_ENTRY*)GetNextNode( &(Suite->TestCaseList), (LIST_ENTRY*)TestEntry ))
+  {
+    Test = &TestEntry->UT;
+    DEBUG(( DEBUG_UT_VERBOSE, " QUEUEING TEST: %s\n", Test->Description ));
+    if (Test->PreReq != NULL)
+    {
+      Framework->CurrentTest = Test;
+      StartDurationTimer( Framework, &Test->PreReqDuration );
+      PreReqResult = Test->PreReq( Framework, Test->Context );
+      UpdateDurationTimer( Framework, FALSE );
+      Framework->CurrentTest = NULL;
+      if (PreReqResult != UNIT_TEST_PASSED)
+      {
+        DEBUG(( DEBUG_ERROR, "PreReq Not Met\n" ));
+        Test->Result = UNIT_TEST_ERROR_PREREQ_NOT_MET;
+      }
+    }
+    if (Test->Result == UNIT_TEST_PENDING)
+    {
+      Test->Result = UNIT_TEST_RUNNING;
+      Scheduler->Items[Scheduler->ItemCount].Test   = Test;
+      Scheduler->Items[Scheduler->ItemCount].Result = UNIT_TEST_PENDING;
+      Scheduler->Items[Scheduler->ItemCount].Log    = &Logs[Scheduler->ItemCount * UNIT_TEST_AP_LOG_LENGTH];
+      Scheduler->ItemCount++;
+    }
+    if (TestEntry == LastEntry)
+    {
+      break;
+    }
+  }
+
+  //
+  // Let the APs at it. The BSP waits here until the queue is drained.
+  for (Index = 0; Index < Scheduler->ProcessorCount; Index++)
+  {
+    Scheduler->Slots[Index].Item = NULL;
+  }
+  Scheduler->NextItem = 0;
+  if (Scheduler->ItemCount > 0)
+  {
+    DEBUG(( DEBUG_UT_VERBOSE, "Dispatching %d AP-safe tests.\n", Scheduler->ItemCount ));
+    Status = Scheduler->MpServices->StartupAllAPs( Scheduler->MpServices,
+                                                   ApSafeTestWorker,
+                                                   FALSE,     // SingleThread
+                                                   NULL,      // Blocking
+                                                   0,         // No timeout
+                                                   Scheduler,
+                                                   NULL );
+    if (EFI_ERROR( Status ))
+    {
+      DEBUG(( DEBUG_ERROR, "%a - StartupAllAPs failed. %r\n", __FUNCTION__, Status ));
+    }
+  }
+
+  //
+  // Collect the results and logs in order, then clean up on the BSP.
+  // StartupAllAPs() blocks, so no AP is touching the queue any more.
+  for (Index = 0; Index < Scheduler->ItemCount; Index++)
+  {
+    Item = &Scheduler->Items[Index];
+    Test = Item->Test;
+    Framework->CurrentTest = Test;
+
+    //
+    // Whatever no AP got to (StartupAllAPs() failed, or the APs couldn't tell
+    // which processor they were) runs right here, in its place in the batch.
+    if (Item->Result == UNIT_TEST_PENDING)
+    {
+      StartDurationTimer( Framework, &Test->RunDuration );
+      Test->Result = Test->RunTest( Framework, Test->Context );
+      UpdateDurationTimer( Framework, FALSE );
+    }
+    else
+    {
+      Test->Result       = Item->Result;
+      Test->RunDuration += Item->Duration;
+      if (Item->LogLength > 0)
+      {
+        AppendToUnitTestLog( Test, Item->Log, Item->LogLength );
+      }
+      if (Item->LogTruncated)
+      {
+        AddStringToUnitTestLog( Test, L"[LOG TRUNCATED]\n" );
+      }
+    }
+
+    if (Test->CleanUp != NULL)
+    {
+      DEBUG(( DEBUG_UT_VERBOSE, "CLEANUP\n" ));
+      StartDurationTimer( Framework, &Test->CleanUpDuration );
+      Test->CleanUp( Framework );
+      UpdateDurationTimer( Framework, FALSE );
+    }
+    UpdatePerformanceBaseline( Framework, Test );
+    Framework->CurrentTest = NULL;
+  }
+
+  FreePool( Logs );
+  FreePool( Scheduler->Items );
+  Scheduler->Items     = NULL;
+  Scheduler->ItemCount = 0;
+  return LastEntry;
+} // RunApSafeTests()
+
+
+/**
+  Sorts benchmark samples into ascending order. Heapsort, so that it needs no
+  extra memory and has no bad cases no matter how the samples came out.
+
+**/
+STATIC
+VOID
+SortBenchmarkSamples (
+  IN OUT UINT64   *Samples,
+  IN     UINTN    Count
+  )
+{
+  UINTN     Start, End, Root, Child;
+  UINT64    Swap;
+
+  if (Count < 2)
+  {
+    return;
+  }
+
+  //
+  // Build a max-heap, then repeatedly move the largest sample to the end.
+  Start = Count / 2;
+  End   = Count;
+  while (End > 1)
+  {
+    if (Start > 0)
+    {
+      Start--;
+    }
+    else
+    {
+      End--;
+      Swap = Samples[End]; Samples[End] = Samples[0]; Samples[0] = Swap;
+    }
+
+    // Sift the root of the (sub)heap down into place.
+    for (Root = Start; (Child = 2 * Root + 1) < End; Root = Child)
+    {
+      if (Child + 1 < End && Samples[Child + 1] > Samples[Child])
+      {
+        Child++;
+      }
+      if (Samples[Root] >= Samples[Child])
+      {
+        break;
+      }
+      Swap = Samples[Root]; Samples[Root] = Samples[Child]; Samples[Child] = Swap;
+    }
+  }
+
+  return;
+} // SortBenchmarkSamples()
+
+
+/**
+  Converts a number of counter ticks spent on OpsPerSample calls into picoseconds per call.
+
+**/
+STATIC
+UINT64
+GetPicoSecondsPerOp (
+  IN  UINT64    Ticks,
+  IN  UINT64    Ops
+  )
+{
+  return DivU64x64Remainder( GetTimeInNanoSecond( MultU64x32( Ticks, 1000 ) ), Ops, NULL );
+} // GetPicoSecondsPerOp()
+
+
+/**
+  Calls the benchmark function Ops times and returns the number of counter ticks that took,
+  less the cost of reading the counter. Stops early if a call doesn't pass.
+
+**/
+STATIC
+UINT64
+TimeBenchmarkSample (
+  IN     UNIT_TEST_FRAMEWORK    *Framework,
+  IN     UNIT_TEST              *Test,
+  IN     UINT32                 Ops,
+  IN     UINT64                 OverheadTicks,
+  OUT    UNIT_TEST_STATUS       *Result
+  )
+{
+  UINT64    StartTicks, Ticks;
+  UINT32    Index;
+
+  *Result    = UNIT_TEST_PASSED;
+  StartTicks = GetPerformanceCounter();
+  for (Index = 0; Index < Ops && *Result == UNIT_TEST_PASSED; Index++)
+  {
+    *Result = Test->RunTest( Framework, Test->Context );
+  }
+  Ticks = GetElapsedTicks( StartTicks, GetPerformanceCounter() );
+
+  return (Ticks > OverheadTicks) ? (Ticks - OverheadTicks) : 0;
+} // TimeBenchmarkSample()
+
+
+/**
+  Runs a benchmark case. See AddBenchmarkCase() for what happens.
+  The statistics are only filled in if every call passes.
+
+**/
+STATIC
+UNIT_TEST_STATUS
+RunBenchmark (
+  IN     UNIT_TEST_FRAMEWORK  *Framework,
+  IN OUT UNIT_TEST            *Test
+  )
+{
+  UNIT_TEST_BENCHMARK   *Benchmark = Test->Benchmark;
+  UNIT_TEST_STATUS      Result;
+  UINT64                *Samples;
+  UINT64                OverheadTicks, StartTicks, Ticks, TotalTicks, Frequency;
+  UINT32                Ops, Index;
+
+  Benchmark->Samples = 0;
+
+  //
+  // First, calibrate. The counter frequency is what turns ticks into time,
+  // and the cheapest back-to-back read is what every sample pays just for being timed.
+  Frequency     = GetPerformanceCounterProperties( NULL, NULL );
+  OverheadTicks = MAX_UINT64;
+  for (Index = 0; Index < UNIT_TEST_BENCHMARK_OVERHEAD_READS; Index++)
+  {
+    StartTicks    = GetPerformanceCounter();
+    Ticks         = GetElapsedTicks( StartTicks, GetPerformanceCounter() );
+    OverheadTicks = MIN( OverheadTicks, Ticks );
+  }
+  DEBUG(( DEBUG_UT_VERBOSE, "BENCHMARK: Counter runs at %ld Hz, reading it costs %ld ticks.\n", Frequency, OverheadTicks ));
+
+  //
+  // Next, find out how many calls it takes to fill a sample. This doubles as the
+  // start of the warmup. Each batch size is timed twice and the faster one counts,
+  // so that a cold first call doesn't leave every sample at a single call.
+  for (Ops = 1; ; Ops *= 2)
+  {
+    Ticks = TimeBenchmarkSample( Framework, Test, Ops, OverheadTicks, &Result );
+    if (Result == UNIT_TEST_PASSED)
+    {
+      Ticks = MIN( Ticks, TimeBenchmarkSample( Framework, Test, Ops, OverheadTicks, &Result ) );
+    }
+    if (Result != UNIT_TEST_PASSED)
+    {
+      return Result;
+    }
+    if (Ticks >= UNIT_TEST_BENCHMARK_MIN_SAMPLE_TICKS || Ops >= UNIT_TEST_BENCHMARK_MAX_OPS_PER_SAMPLE)
+    {
+      break;
+    }
+  }
+
+  //
+  // Finish warming up at the calibrated batch size.
+  for (Index = 0; Index < UNIT_TEST_BENCHMARK_WARMUP_SAMPLES; Index++)
+  {
+    TimeBenchmarkSample( Framework, Test, Ops, OverheadTicks, &Result );
+    if (Result != UNIT_TEST_PASSED)
+    {
+      return Result;
+    }
+  }
+
+  //
+  // Now take the real samples.
+  Samples = AllocatePool( Benchmark->Iterations * sizeof( UINT64 ) );
+  if (Samples == NULL)
+  {
+    DEBUG(( DEBUG_ERROR, "BENCHMARK: Could not allocate %d samples.\n", Benchmark->Iterations ));
+    return UNIT_TEST_ERROR_TEST_FAILED;
+  }
+  TotalTicks = 0;
+  for (Index = 0; Index < Benchmark->Iterations; Index++)
+  {
+    Samples[Index] = TimeBenchmarkSample( Framework, Test, Ops, OverheadTicks, &Result );
+    if (Result != UNIT_TEST_PASSED)
+    {
+      FreePool( Samples );
+      return Result;
+    }
+    TotalTicks += Samples[Index];
+  }
+
+  //
+  // Finally, work out the statistics. The p99 is the smallest sample
+  // that at least 99% of the samples are no slower than.
+  SortBenchmarkSamples( Samples, Benchmark->Iterations );
+  Benchmark->Samples            = Benchmark->Iterations;
+  Benchmark->OpsPerSample       = Ops;
+  Benchmark->MinPicoSeconds     = GetPicoSecondsPerOp( Samples[0], Ops );
+  Benchmark->MaxPicoSeconds     = GetPicoSecondsPerOp( Samples[Benchmark->Samples - 1], Ops );
+  Benchmark->P99PicoSeconds     = GetPicoSecondsPerOp( Samples[((UINT64)Benchmark->Samples * 99 + 99) / 100 - 1], Ops );
+  if ((Benchmark->Samples & 1) != 0)
+  {
+    Benchmark->MedianPicoSeconds = GetPicoSecondsPerOp( Samples[Benchmark->Samples / 2], Ops );
+  }
+  else
+  {
+    Benchmark->MedianPicoSeconds = GetPicoSecondsPerOp( Samples[Benchmark->Samples / 2 - 1] + Samples[Benchmark->Samples / 2], 2 * (UINT64)Ops );
+  }
+  Benchmark->MeanPicoSeconds    = GetPicoSecondsPerOp( TotalTicks, MultU64x32( Benchmark->Samples, Ops ) );
+
+  FreePool( Samples );
+  return UNIT_TEST_PASSED;
+} // RunBenchmark()
+
+
+/**
+  Runs the suite's tests in the order they were added. Nothing runs on a boot
+  that a clean-boot test has been through, so a test that would gets a reboot first.
+
+  @retval EFI_ABORTED   The state was saved for a reboot, but the reset didn't happen.
+                        Nothing more should be run on this launch.
+
+**/
+STATIC
+EFI_STATUS
+RunTestSuite (
+  IN UNIT_TEST_SUITE      *Suite
+  )
+{
+  EFI_STATUS            Status;
+  UNIT_TEST_LIST_ENTRY  *TestEntry = NULL;
+  UNIT_TEST_LIST_ENTRY  *LastEntry;
+  UNIT_TEST             *Test;
+  UNIT_TEST_FRAMEWORK   *ParentFramework = (UNIT_TEST_FRAMEWORK*)Suite->ParentFramework;
+  UNIT_TEST_STATUS      PreReqResult;
+
+  if (Suite == NULL)
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  DEBUG((DEBUG_UT_VERBOSE, "---------------------------------------------------------\n"));
+  DEBUG((DEBUG_UT_VERBOSE, "RUNNING TEST SUITE: %s\n", Suite->Title));
+  DEBUG((DEBUG_UT_VERBOSE, "---------------------------------------------------------\n"));
+
+  //
+  // If the filters didn't pick anything in this suite (or it was all run before
+  // a reboot), don't bother setting it up.
+  if (Suite->PendingCount == 0)
+  {
+    DEBUG(( DEBUG_UT_VERBOSE, "No tests to run. Skipping suite.\n" ));
+    return EFI_SUCCESS;
+  }
+
+  if (Suite->Setup != NULL)
+  {
+    StartDurationTimer( ParentFramework, &Suite->SetupDuration );
+    Suite->Setup( Suite->ParentFramework );
+    UpdateDurationTimer( ParentFramework, FALSE );
+  }
+
+  //
+  // Iterate all tests within the suite
+  //
+  for (TestEntry = Suite->FirstPending;                                                                   // Start where we left off.
+       (LIST_ENTRY*)TestEntry != &(Suite->TestCaseList);                                                  // Go until you loop back to the head.
+       TestEntry = (UNIT_TEST_LIST_ENTRY*)GetNextNode( &(Suite->TestCaseList), (LIST_ENTRY*)TestEntry) )  // Always get the next test.
+  {
+    Test                          = &TestEntry->UT;
+    ParentFramework->CurrentTest  = Test;
+
+    DEBUG((DEBUG_UT_VERBOSE, "*********************************************************\n"));
+    DEBUG((DEBUG_UT_VERBOSE, " RUNNING TEST: %s:\n", Test->Description));
+    DEBUG((DEBUG_UT_VERBOSE, "**********************************************************\n"));
+
+    //
+    // First, check to see whether the test was filtered out.
+    if (Test->Result == UNIT_TEST_SKIPPED)
+    {
+      DEBUG(( DEBUG_UT_VERBOSE, "Test was not selected. Skipping.\n" ));
+      ParentFramework->CurrentTest  = NULL;
+      continue;
+    }
+
+    //
+    // Next, check to see whether the test has already been run.
+    // NOTE: This would generally only be the case if a saved state was detected and loaded.
+    if (Test->Result != UNIT_TEST_PENDING && Test->Result != UNIT_TEST_RUNNING)
+    {
+      DEBUG(( DEBUG_UT_VERBOSE, "Test was run on a previous pass. Skipping.\n" ));
+      ParentFramework->CurrentTest  = NULL;
+      continue;
+    }
+
+    //
+    // If a clean-boot test has already been through this boot, get a fresh one.
+    // The test is still pending when the state is saved, so it starts over from the PreReq.
+    // If anything else has rebooted since (the clean-boot test itself, or its CleanUp),
+    // the boot is already clean and this one comes for free.
+    if (Test->Result == UNIT_TEST_PENDING && ParentFramework->BootIsDirty)
+    {
+      DEBUG(( DEBUG_UT_INFO, "Rebooting for a clean boot.\n" ));
+      ParentFramework->CleanBootRebootCount++;
+      Status = SaveFrameworkStateAndReboot( ParentFramework, NULL, 0, EfiResetCold );
+      ParentFramework->CleanBootRebootCount--;
+      if (Status == EFI_ABORTED)
+      {
+        //
+        // The state is saved, but the reset didn't happen. Stop here and
+        // let the next launch pick up from the saved state.
+        DEBUG(( DEBUG_ERROR, "%a - Reset for a clean boot returned! Stopping the run.\n", __FUNCTION__ ));
+        ParentFramework->CurrentTest  = NULL;
+        return Status;
+      }
+      // Nothing was saved, so there is nothing to come back to. Better to run on this boot than not at all.
+      DEBUG(( DEBUG_ERROR, "%a - Could not save for a clean boot! %r\n", __FUNCTION__, Status ));
+    }
+
+    //
+    // Runs of AP-safe tests are handed to the APs all at once.
+    if (ParentFramework->ApScheduler != NULL && Test->Result == UNIT_TEST_PENDING &&
+        (Test->Attributes & UNIT_TEST_ATTRIBUTE_AP_SAFE) != 0)
+    {
+      ParentFramework->CurrentTest  = NULL;
+      LastEntry = RunApSafeTests( Suite, TestEntry );
+      if (LastEntry != NULL)
+      {
+        TestEntry = LastEntry;
+        continue;
+      }
+      // Couldn't set up the batch, so just run this one here.
+      ParentFramework->CurrentTest  = Test;
+    }
+
+    //
+    // Next, if we're still running, make sure that our test prerequisites are in place.
+    if (Test->Result == UNIT_TEST_PENDING && Test->PreReq != NULL)
+    {
+      DEBUG(( DEBUG_UT_VERBOSE, "PREREQ\n" ));
+      StartDurationTimer( ParentFramework, &Test->PreReqDuration );
+      PreReqResult = Test->PreReq( Suite->ParentFramework, Test->Context );
+      UpdateDurationTimer( ParentFramework, FALSE );
+      if (PreReqResult != UNIT_TEST_PASSED)
+      {
+        DEBUG(( DEBUG_ERROR, "PreReq Not Met\n" ));
+        Test->Result = UNIT_TEST_ERROR_PREREQ_NOT_MET;
+        ParentFramework->CurrentTest  = NULL;
+        continue;
+      }
+    }
+
+    //
+    // Now we should be ready to call the actual test.
+    // We set the status to UNIT_TEST_RUNNING in case the test needs to reboot
+    // or quit. The UNIT_TEST_RUNNING state will allow the test to resume
+    // but will prevent the PreReq from being dispatched a second time.
+    if ((Test->Attributes & UNIT_TEST_ATTRIBUTE_REQUIRES_CLEAN_BOOT) != 0 && Test->Result == UNIT_TEST_PENDING)
+    {
+      ParentFramework->CleanBootTestCount++;
+    }
+    Test->Result = UNIT_TEST_RUNNING;
+    StartDurationTimer( ParentFramework, &Test->RunDuration );
+    if (Test->Benchmark != NULL)
+    {
+      Test->Result = RunBenchmark( ParentFramework, Test );
+    }
+    else
+    {
+      Test->Result = Test->RunTest( Suite->ParentFramework, Test->Context );
+    }
+    UpdateDurationTimer( ParentFramework, FALSE );
+
+    //
+    // Nothing else gets this boot now. If the test (or its CleanUp) reboots on
+    // its own, the saved state says otherwise and the next test doesn't need another.
+    if ((Test->Attributes & UNIT_TEST_ATTRIBUTE_REQUIRES_CLEAN_BOOT) != 0)
+    {
+      ParentFramework->BootIsDirty = TRUE;
+    }
+
+    //
+    // Finally, clean everything up, if need be.
+    if (Test->CleanUp != NULL)
+    {
+      DEBUG(( DEBUG_UT_VERBOSE, "CLEANUP\n" ));
+      StartDurationTimer( ParentFramework, &Test->CleanUpDuration );
+      Test->CleanUp( Suite->ParentFramework );
+      UpdateDurationTimer( ParentFramework, FALSE );
+    }
+
+    //
+    // A resumed test is done with its saved context now. It doesn't get the
+    // original one back, but it won't be run again on this boot anyway.
+    if (Test == ParentFramework->SavedContextTest)
+    {
+      Test->Context = NULL;
+      ParentFramework->SavedContextTest = NULL;
+      ReleaseSavedStateReference( ParentFramework );
+    }
+
+    //
+    // Compare the run against the baseline, and fold it in.
+    UpdatePerformanceBaseline( ParentFramework, Test );
+
+    //
+    // End the test.
+    ParentFramework->CurrentTest  = NULL;
+  } // End Test iteration
+
+  //
+  // Everything has a result now.
+  Suite->PendingCount = 0;
+  Suite->FirstPending = NULL;
+
+  if (Suite->Teardown != NULL)
+  {
+    StartDurationTimer( ParentFramework, &Suite->TeardownDuration );
+    Suite->Teardown( Suite->ParentFramework );
+    UpdateDurationTimer( ParentFramework, FALSE );
+  }
+
+  return EFI_SUCCESS;
+}
+
+EFI_STATUS
+EFIAPI
+RunAllTestSuites(
+  IN UNIT_TEST_FRAMEWORK  *Framework
+  )
+{
+  UNIT_TEST_SUITE_LIST_ENTRY *Suite = NULL;
+  EFI_STATUS Status; 
+
+  if (Framework == NULL)
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  DEBUG((DEBUG_UT_VERBOSE, "---------------------------------------------------------\n"));
+  DEBUG((DEBUG_UT_VERBOSE, "------------     RUNNING ALL TEST SUITES   --------------\n"));
+  DEBUG((DEBUG_UT_VERBOSE, "---------------------------------------------------------\n"));
+
+  //
+  // If we're resuming, the StartTime was restored along with the rest of the saved state.
+  if (Framework->StartTime.Year == 0)
+  {
+    gRT->GetTime( &Framework->StartTime, NULL );
+  }
+
+  //
+  // Every test has been added, so the index into the saved state is done with.
+  // Whatever is left of the saved state is only kept for the logs and context that point into it.
+  if (Framework->SavedTestIndex != NULL)
+  {
+    Framework->SavedTestIndex = NULL;
+    Framework->SavedContext   = NULL;
+    ReleaseSavedStateReference( Framework );
+  }
+
+  //
+  // See whether there are any APs to spread the AP-safe tests across.
+  InitApScheduler( Framework );
+
+  //
+  // Iterate all suites
+  //
+  for (Suite = (UNIT_TEST_SUITE_LIST_ENTRY*)GetFirstNode(&Framework->TestSuiteList);
+    (LIST_ENTRY*)Suite != &Framework->TestSuiteList;
+    Suite = (UNIT_TEST_SUITE_LIST_ENTRY*)GetNextNode(&Framework->TestSuiteList, (LIST_ENTRY*)Suite))
+  {
+    Status = RunTestSuite(&(Suite->UTS));
+    if (Status == EFI_ABORTED)
+    {
+      return Status;
+    }
+    if (EFI_ERROR(Status))
+    {
+      DEBUG((DEBUG_ERROR, "Test Suite Failed with Error.  %r\n", Status));
+    }
+  } // End Suite iteration
+
+  //
+  // If the last test to run needed a clean boot, it gets a reboot after it, too,
+  // so that nothing that runs once the app is gone finds the boot the way that
+  // test left it. The framework comes back with nothing left to run and finishes up.
+  if (Framework->BootIsDirty)
+  {
+    DEBUG(( DEBUG_UT_INFO, "Rebooting to leave a clean boot behind.\n" ));
+    Framework->CleanBootRebootCount++;
+    Status = SaveFrameworkStateAndReboot( Framework, NULL, 0, EfiResetCold );
+    Framework->CleanBootRebootCount--;
+    if (Status == EFI_ABORTED)
+    {
+      DEBUG(( DEBUG_ERROR, "%a - Reset for a clean boot returned! Stopping the run.\n", __FUNCTION__ ));
+      return Status;
+    }
+    DEBUG(( DEBUG_ERROR, "%a - Could not save for a clean boot! %r\n", __FUNCTION__, Status ));
+  }
+
+  gRT->GetTime( &Framework->EndTime, NULL );
+
+  //
+  // Keep the baseline up to date for the next run.
+  SavePerformanceBaseline( Framework );
+
+  return EFI_SUCCESS;
+}
+
+
+//=============================================================================
+//
+// ----------------  TEST REPORTING FUNCTIONS ---------------------------------
+//
+//=============================================================================
+
+CONST CHAR8*
+EFIAPI
+GetUnitTestStatusString (
+  IN UNIT_TEST_STATUS   Status
+  )
+{
+  UINTN   Index;
+  CHAR8   *Result, *NoResult = "**UNKNOWN**";     // NOTE: This might be bad. Is it on the stack?
+
+  Result = NoResult;
+  for (Index = 0; Index < mStatusStringsCount; Index++)
+  {
+    if (mStatusStrings[Index].Status == Status)
+    {
+      Result = mStatusStrings[Index].String;
+      break;
+    }
+  }
+
+  return Result;
+}
+
+
+STATIC
+CONST CHAR8*
+GetStringForStatusLogPrefix (
+  IN UINTN      LogLevel
+  )
+{
+  UINTN   Index;
+  CHAR8   *Result = NULL;
+
+  for (Index = 0; Index < mLogPrefixStringsCount; Index++)
+  {
+    if (mLogPrefixStrings[Index].LogLevel == LogLevel)
+    {
+      Result = mLogPrefixStrings[Index].String;
+      break;
+    }
+  }
+
+  return Result;
+}
+
+
+/**
+  Sends everything in the report buffer to its sink and empties it.
+  Once a flush fails, the report stops trying and remembers the error.
+
+**/
+STATIC
+EFI_STATUS
+FlushReport (
+  IN OUT UNIT_TEST_REPORT   *Report
+  )
+{
+  if (Report->Length > 0 && !EFI_ERROR( Report->Status ))
+  {
+    Report->Buffer[Report->Length] = L'\0';
+    Report->Status = Report->Flush( Report );
+  }
+  Report->Length = 0;
+
+  return Report->Status;
+} // FlushReport()
+
+
+/**
+  Appends Length characters to the report, flushing as the buffer fills.
+
+**/
+STATIC
+VOID
+ReportWrite (
+  IN OUT UNIT_TEST_REPORT   *Report,
+  IN CONST CHAR16           *String,
+  IN UINTN                  Length
+  )
+{
+  UINTN     CopyLength;
+
+  while (Length > 0)
+  {
+    if (Report->Length == Report->Size)
+    {
+      FlushReport( Report );
+    }
+
+    CopyLength = MIN( Length, Report->Size - Report->Length );
+    CopyMem( &Report->Buffer[Report->Length], String, CopyLength * sizeof( CHAR16 ) );
+    Report->Length += CopyLength;
+    String         += CopyLength;
+    Length         -= CopyLength;
+  }
+
+  return;
+} // ReportWrite()
+
+
+/**
+  Formats straight into the tail of the report buffer. A single line is never
+  longer than UNIT_TEST_MAX_SINGLE_LOG_STRING_LENGTH, so that's all the room
+  that has to be left before formatting.
+
+**/
+STATIC
+VOID
+ReportPrint (
+  IN OUT UNIT_TEST_REPORT   *Report,
+  IN CONST CHAR16           *Format,
+  ...
+  )
+{
+  VA_LIST   Marker;
+
+  if (Report->Size - Report->Length < UNIT_TEST_MAX_SINGLE_LOG_STRING_LENGTH)
+  {
+    FlushReport( Report );
+  }
+
+  VA_START( Marker, Format );
+  Report->Length += UnicodeVSPrint( &Report->Buffer[Report->Length],
+                                    (Report->Size - Report->Length + 1) * sizeof( CHAR16 ),
+                                    Format,
+                                    Marker );
+  VA_END( Marker );
+
+  return;
+} // ReportPrint()
+
+
+STATIC
+EFI_STATUS
+FlushReportToConsole (
+  IN UNIT_TEST_REPORT   *Report
+  )
+{
+  return gST->ConOut->OutputString( gST->ConOut, Report->Buffer );
+} // FlushReportToConsole()
+
+
+STATIC
+EFI_STATUS
+FlushReportToFile (
+  IN UNIT_TEST_REPORT   *Report
+  )
+{
+  EFI_FILE_PROTOCOL   *File = (EFI_FILE_PROTOCOL*)Report->Context;
+  UINTN               WriteSize;
+  EFI_STATUS          Status;
+
+  WriteSize = Report->Length * sizeof( CHAR16 );
+  Status = File->Write( File, &WriteSize, Report->Buffer );
+  if (!EFI_ERROR( Status ) && WriteSize != Report->Length * sizeof( CHAR16 ))
+  {
+    Status = EFI_VOLUME_FULL;
+  }
+
+  return Status;
+} // FlushReportToFile()
+
+
+/**
+  Sets up a report with a pool buffer of UNIT_TEST_REPORT_BUFFER_LENGTH characters.
+  If that can't be had, FallbackBuffer is used instead; it just means more flushes.
+
+**/
+STATIC
+VOID
+InitReport (
+  OUT UNIT_TEST_REPORT        *Report,
+  IN  UNIT_TEST_REPORT_FLUSH  Flush,
+  IN  VOID                    *Context,
+  IN  CHAR16                  *FallbackBuffer,
+  IN  UINTN                   FallbackSize
+  )
+{
+  ZeroMem( Report, sizeof( *Report ) );
+  Report->Flush   = Flush;
+  Report->Context = Context;
+  Report->Status  = EFI_SUCCESS;
+  Report->Buffer  = AllocatePool( (UNIT_TEST_REPORT_BUFFER_LENGTH + 1) * sizeof( CHAR16 ) );
+  Report->Size    = UNIT_TEST_REPORT_BUFFER_LENGTH;
+  if (Report->Buffer == NULL)
+  {
+    Report->Buffer = FallbackBuffer;
+    Report->Size   = FallbackSize - 1;
+  }
+
+  return;
+} // InitReport()
+
+
+STATIC
+VOID
+FreeReport (
+  IN UNIT_TEST_REPORT       *Report,
+  IN CHAR16                 *FallbackBuffer
+  )
+{
+  if (Report->Buffer != FallbackBuffer)
+  {
+    FreePool( Report->Buffer );
+  }
+  return;
+} // FreeReport()
+
+
+/**
+  Prints a duration as milliseconds with microsecond precision.
+  Done with BaseLib math so there are no 64-bit division intrinsics on IA32.
+
+**/
+STATIC
+VOID
+PrintDuration (
+  IN OUT UNIT_TEST_REPORT   *Report,
+  IN CONST CHAR16           *Label,
+  IN UINT64                 NanoSeconds
+  )
+{
+  UINT64    MilliSeconds;
+  UINT32    MicroSeconds;
+
+  MilliSeconds = DivU64x32Remainder( DivU64x32( NanoSeconds, 1000 ), 1000, &MicroSeconds );
+  ReportPrint( Report, L"%s%ld.%03d ms\n", Label, MilliSeconds, MicroSeconds );
+  return;
+} // PrintDuration()
+
+
+STATIC
+VOID
+PrintTimePerOp (
+  IN OUT UNIT_TEST_REPORT   *Report,
+  IN CONST CHAR16           *Label,
+  IN UINT64                 PicoSeconds
+  )
+{
+  UINT64    NanoSeconds;
+  UINT32    Fraction;
+
+  NanoSeconds = DivU64x32Remainder( PicoSeconds, 1000, &Fraction );
+  ReportPrint( Report, L"%s%ld.%03d ns/op\n", Label, NanoSeconds, Fraction );
+  return;
+} // PrintTimePerOp()
+
+
+STATIC
+VOID
+PrintTime (
+  IN OUT UNIT_TEST_REPORT   *Report,
+  IN CONST CHAR16           *Label,
+  IN EFI_TIME               *Time
+  )
+{
+  ReportPrint( Report, L"%s%04d-%02d-%02d %02d:%02d:%02d\n", Label,
+               Time->Year, Time->Month, Time->Day, Time->Hour, Time->Minute, Time->Second );
+  return;
+} // PrintTime()
+
+
+/**
+  Returns Count as a percentage of Total, or zero when nothing counted toward Total
+  (such as a suite where every test was filtered out).
+
+**/
+STATIC
+INTN
+GetPercentage (
+  IN INTN   Count,
+  IN INTN   Total
+  )
+{
+  return (Total == 0) ? 0 : (Count * 100) / Total;
+} // GetPercentage()
+
+
+/**
+  Renders the whole report into Report. Report->Flush is only called when
+  the buffer fills up, so a typical report goes out in a handful of writes.
+
+**/
+STATIC
+EFI_STATUS
+RenderUnitTestReport (
+  IN     UNIT_TEST_FRAMEWORK  *Framework,
+  IN OUT UNIT_TEST_REPORT     *Report
+  )
+{
+  INTN Passed = 0;
+  INTN Failed = 0;
+  INTN NotRun = 0;
+  INTN Skipped = 0;
+  UINT64 Duration = 0;
+  UNIT_TEST_SUITE_LIST_ENTRY *Suite = NULL;
+
+  RenderDeferredUnitTestLogs( Framework );
+
+  ReportPrint( Report, L"---------------------------------------------------------\n" );
+  ReportPrint( Report, L"------------- UNIT TEST FRAMEWORK RESULTS ---------------\n" );
+  ReportPrint( Report, L"---------------------------------------------------------\n" );
+
+  //print the version and time
+  ReportPrint( Report, L"%s (%s)\n", Framework->Title, Framework->VersionString );
+  PrintTime( Report, L"Started: ", &Framework->StartTime );
+  PrintTime( Report, L"Ended:   ", &Framework->EndTime );
+
+  //
+  // Iterate all suites
+  //
+  for (Suite = (UNIT_TEST_SUITE_LIST_ENTRY*)GetFirstNode(&Framework->TestSuiteList);
+    (LIST_ENTRY*)Suite != &Framework->TestSuiteList; 
+    Suite = (UNIT_TEST_SUITE_LIST_ENTRY*)GetNextNode(&Framework->TestSuiteList, (LIST_ENTRY*)Suite))
+  {
+    UNIT_TEST_LIST_ENTRY *Test = NULL;
+    UNIT_TEST_LOG_CHUNK *LogChunk;
+    INTN SPassed = 0;
+    INTN SFailed = 0;
+    INTN SNotRun = 0;
+    INTN SSkipped = 0;
+    UINT64 SDuration = 0;
+
+    ReportPrint( Report, L"/////////////////////////////////////////////////////////\n" );
+    ReportPrint( Report, L"  SUITE: %s\n", Suite->UTS.Title );
+    ReportPrint( Report, L"/////////////////////////////////////////////////////////\n" );
+
+    //
+    // Iterate all tests within the suite
+    //
+    for (Test = (UNIT_TEST_LIST_ENTRY*)GetFirstNode(&(Suite->UTS.TestCaseList));
+      (LIST_ENTRY*)Test != &(Suite->UTS.TestCaseList);
+      Test = (UNIT_TEST_LIST_ENTRY*)GetNextNode(&(Suite->UTS.TestCaseList), (LIST_ENTRY*)Test))
+    {
+
+      ReportPrint( Report, L"*********************************************************\n" );
+      ReportPrint( Report, L"  TEST:   %s\n", Test->UT.Description );
+      ReportPrint( Report, L"  STATUS: %a\n", GetUnitTestStatusString( Test->UT.Result ) );
+      PrintDuration( Report, L"  TIME:   ", Test->UT.PreReqDuration + Test->UT.RunDuration + Test->UT.CleanUpDuration );
+      if (Test->UT.PreReq != NULL)
+      {
+        PrintDuration( Report, L"    PREREQ:  ", Test->UT.PreReqDuration );
+      }
+      if (Test->UT.CleanUp != NULL)
+      {
+        PrintDuration( Report, L"    CLEANUP: ", Test->UT.CleanUpDuration );
+      }
+      if (Test->UT.Benchmark != NULL && Test->UT.Benchmark->Samples > 0)
+      {
+        ReportPrint( Report, L"  BENCHMARK: %d samples of %d ops\n", Test->UT.Benchmark->Samples, Test->UT.Benchmark->OpsPerSample );
+        PrintTimePerOp( Report, L"    MIN:    ", Test->UT.Benchmark->MinPicoSeconds );
+        PrintTimePerOp( Report, L"    MEDIAN: ", Test->UT.Benchmark->MedianPicoSeconds );
+        PrintTimePerOp( Report, L"    P99:    ", Test->UT.Benchmark->P99PicoSeconds );
+        PrintTimePerOp( Report, L"    MAX:    ", Test->UT.Benchmark->MaxPicoSeconds );
+        PrintTimePerOp( Report, L"    MEAN:   ", Test->UT.Benchmark->MeanPicoSeconds );
+      }
+      if (Test->UT.Log.Head != NULL)
+      {
+        ReportPrint( Report, L"  LOG:\n" );
+        // NOTE: This has to be done directly because all of the other
+        //       "formatted" print statements have caps on the string size.
+        for (LogChunk = Test->UT.Log.Head; LogChunk != NULL; LogChunk = LogChunk->Next)
+        {
+          ReportWrite( Report, LogChunk->Buffer, LogChunk->Length );
+        }
+      }
+
+      switch (Test->UT.Result)
+      {
+        case UNIT_TEST_PASSED:                SPassed++; break;
+        case UNIT_TEST_ERROR_TEST_FAILED:     // Fall through...
+        case UNIT_TEST_ERROR_PERF_REGRESSION: SFailed++; break;
+        case UNIT_TEST_PENDING:               // Fall through...
+        case UNIT_TEST_RUNNING:               // Fall through...
+        case UNIT_TEST_ERROR_PREREQ_NOT_MET:  SNotRun++; break;
+        case UNIT_TEST_SKIPPED:               SSkipped++; break;
+        default: break;
+      }
+      SDuration += Test->UT.PreReqDuration + Test->UT.RunDuration + Test->UT.CleanUpDuration;
+      ReportPrint( Report, L"**********************************************************\n" );
+    } //End Test iteration
+
+    ReportPrint( Report, L"+++++++++++++++++++++++++++++++++++++++++++++++++++++++++\n" );
+    ReportPrint( Report, L"Suite Stats\n" );
+    ReportPrint( Report, L" Passed:  %d  (%d%%)\n", SPassed, GetPercentage( SPassed, SPassed + SFailed + SNotRun ) );
+    ReportPrint( Report, L" Failed:  %d  (%d%%)\n", SFailed, GetPercentage( SFailed, SPassed + SFailed + SNotRun ) );
+    ReportPrint( Report, L" Not Run: %d  (%d%%)\n", SNotRun, GetPercentage( SNotRun, SPassed + SFailed + SNotRun ) );
+    ReportPrint( Report, L" Skipped: %d\n", SSkipped );
+    PrintDuration( Report, L" Setup:    ", Suite->UTS.SetupDuration );
+    PrintDuration( Report, L" Teardown: ", Suite->UTS.TeardownDuration );
+    SDuration += Suite->UTS.SetupDuration + Suite->UTS.TeardownDuration;
+    PrintDuration( Report, L" Time:     ", SDuration );
+    ReportPrint( Report, L"+++++++++++++++++++++++++++++++++++++++++++++++++++++++++\n" );
+
+    Passed += SPassed;  //add to global counters
+    Failed += SFailed;  //add to global counters
+    NotRun += SNotRun;  //add to global coutners
+    Skipped += SSkipped;
+    Duration += SDuration;
+  }//End Suite iteration
+
+  ReportPrint( Report, L"=========================================================\n" );
+  ReportPrint( Report, L"Total Stats\n" );
+  ReportPrint( Report, L" Passed:  %d  (%d%%)\n", Passed, GetPercentage( Passed, Passed + Failed + NotRun ) );
+  ReportPrint( Report, L" Failed:  %d  (%d%%)\n", Failed, GetPercentage( Failed, Passed + Failed + NotRun ) );
+  ReportPrint( Report, L" Not Run: %d  (%d%%)\n", NotRun, GetPercentage( NotRun, Passed + Failed + NotRun ) );
+  ReportPrint( Report, L" Skipped: %d\n", Skipped );
+  if (Framework->CleanBootTestCount > 0)
+  {
+    ReportPrint( Report, L" Reboots: %d for %d clean-boot tests\n",
+                 Framework->CleanBootRebootCount,
+                 Framework->CleanBootTestCount );
+  }
+  PrintDuration( Report, L" Time:    ", Duration );
+  ReportPrint( Report, L"=========================================================\n" );
+
+  return FlushReport( Report );
+} // RenderUnitTestReport()
+
+
+
+/*
+Method to print the Unit Test run results
+
+IMPORTANT NOTE: This function currently expects the shell to exist.
+                Ultimately, this functionality should be wrapped up into an
+                "environment lib" that is similar to the persistence lib.
+                In fact, it could just be an expansion of the persistence lib.
+
+@retval Success
+*/
+EFI_STATUS
+EFIAPI
+PrintUnitTestReport(
+  IN UNIT_TEST_FRAMEWORK  *Framework
+  )
+{
+  UNIT_TEST_REPORT    Report;
+  CHAR16              FallbackBuffer[2 * UNIT_TEST_MAX_SINGLE_LOG_STRING_LENGTH];
+  EFI_STATUS          Status;
+
+  if (Framework == NULL)
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  InitReport( &Report, FlushReportToConsole, NULL, FallbackBuffer, ARRAY_SIZE( FallbackBuffer ) );
+  Status = RenderUnitTestReport( Framework, &Report );
+  FreeReport( &Report, FallbackBuffer );
+
+  return Status;
+}
+
+
+EFI_STATUS
+EFIAPI
+WriteUnitTestReport (
+  IN UNIT_TEST_FRAMEWORK  *Framework,
+  IN EFI_FILE_PROTOCOL    *File
+  )
+{
+  UNIT_TEST_REPORT    Report;
+  CHAR16              FallbackBuffer[2 * UNIT_TEST_MAX_SINGLE_LOG_STRING_LENGTH];
+  EFI_STATUS          Status;
+
+  if (Framework == NULL || File == NULL)
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // Start with a byte order mark, the same as the shell does for redirected output.
+  InitReport( &Report, FlushReportToFile, File, FallbackBuffer, ARRAY_SIZE( FallbackBuffer ) );
+  Report.Buffer[Report.Length++] = 0xFEFF;
+  Status = RenderUnitTestReport( Framework, &Report );
+  FreeReport( &Report, FallbackBuffer );
+
+  return Status;
+}
+
+
+/**
+  Allocates a new, empty log chunk with room for Size characters
+  (plus the NULL terminator).
+
+**/
+STATIC
+UNIT_TEST_LOG_CHUNK*
+AllocateLogChunk (
+  IN UNIT_TEST_ARENA  *Arena,
+  IN UINTN            Size
+  )
+{
+  UNIT_TEST_LOG_CHUNK   *Chunk;
+
+  // The character buffer lives directly behind the chunk header.
+  Chunk = AllocateFromArena( Arena, sizeof( UNIT_TEST_LOG_CHUNK ) + ((Size + 1) * sizeof( CHAR16 )) );
+  if (Chunk != NULL)
+  {
+    Chunk->Next       = NULL;
+    Chunk->Length     = 0;
+    Chunk->Size       = Size;
+    Chunk->Buffer     = (CHAR16*)(Chunk + 1);
+    Chunk->Buffer[0]  = L'\0';
+  }
+
+  return Chunk;
+} // AllocateLogChunk()
+
+
+/**
+  Appends Length characters of String to the end of the test log.
+  Whatever fits is copied into the free space of the last chunk and
+  the remainder goes into a new chunk that is larger than the last one,
+  so the existing log is never copied.
+
+**/
+STATIC
+EFI_STATUS
+AppendToUnitTestLog (
+  IN OUT UNIT_TEST    *UnitTest,
+  IN CONST CHAR16     *String,
+  IN UINTN            Length
+  )
+{
+  UNIT_TEST_FRAMEWORK   *Framework;
+  UNIT_TEST_LOG         *Log;
+  UNIT_TEST_LOG_CHUNK   *Chunk;
+  UINTN                 CopyLength;
+  UINTN                 NewSize;
+
+  Framework = ((UNIT_TEST_SUITE*)UnitTest->ParentSuite)->ParentFramework;
+  Log       = &UnitTest->Log;
+
+  //
+  // Anything that was logged before this has to be formatted first to keep the log in order.
+  if (Log->DeferredHead != NULL)
+  {
+    RenderDeferredLog( UnitTest );
+  }
+
+  //
+  // A log that still lives in the saved state is copied out before it grows,
+  // so that the saved state can be let go of once every such log has been.
+  if (Log->Borrowed && Length > 0)
+  {
+    NewSize = MAX( MIN( Log->Head->Length * 2, UNIT_TEST_LOG_MAX_CHUNK_LENGTH ), UNIT_TEST_LOG_MIN_CHUNK_LENGTH );
+    NewSize = MAX( NewSize, Log->Head->Length + Length );
+    Chunk   = AllocateLogChunk( &Framework->Arena, NewSize );
+    if (Chunk == NULL)
+    {
+      return EFI_OUT_OF_RESOURCES;
+    }
+    CopyMem( Chunk->Buffer, Log->Head->Buffer, (Log->Head->Length + 1) * sizeof( CHAR16 ) );
+    Chunk->Length = Log->Head->Length;
+    Log->Head     = Chunk;
+    Log->Tail     = Chunk;
+    Log->Borrowed = FALSE;
+    ReleaseSavedStateReference( Framework );
+  }
+
+  while (Length > 0)
+  {
+    //
+    // If there's no room left at the tail, grow the chain.
+    //
+    Chunk = Log->Tail;
+    if (Chunk == NULL || Chunk->Length == Chunk->Size)
+    {
+      NewSize = (Chunk == NULL) ? UNIT_TEST_LOG_MIN_CHUNK_LENGTH : MIN( Chunk->Size * 2, UNIT_TEST_LOG_MAX_CHUNK_LENGTH );
+      NewSize = MAX( NewSize, Length );
+      Chunk   = AllocateLogChunk( &Framework->Arena, NewSize );
+      if (Chunk == NULL)
+      {
+        return EFI_OUT_OF_RESOURCES;
+      }
+
+      if (Log->Tail == NULL)
+      {
+        Log->Head = Chunk;
+      }
+      else
+      {
+        Log->Tail->Next = Chunk;
+      }
+      Log->Tail = Chunk;
+    }
+
+    //
+    // Copy as much as will fit and keep the chunk NULL-terminated.
+    //
+    CopyLength = MIN( Length, Chunk->Size - Chunk->Length );
+    CopyMem( &Chunk->Buffer[Chunk->Length], String, CopyLength * sizeof( CHAR16 ) );
+    Chunk->Length                += CopyLength;
+    Chunk->Buffer[Chunk->Length]  = L'\0';
+    Log->Length                  += CopyLength;
+
+    String += CopyLength;
+    Length -= CopyLength;
+  }
+
+  return EFI_SUCCESS;
+} // AppendToUnitTestLog()
+
+
+STATIC
+EFI_STATUS
+AddStringToUnitTestLog (
+  IN OUT UNIT_TEST    *UnitTest,
+  IN CONST CHAR16     *String
+  )
+{
+  //
+  // Make sure that you're cooking with gas.
+  //
+  if (UnitTest == NULL || String == NULL)
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  return AppendToUnitTestLog( UnitTest, String, StrnLenS( String, UNIT_TEST_MAX_SINGLE_LOG_STRING_LENGTH ) );
+}
+
+
+/**
+  Adds a string to the log of whatever test is running on this processor.
+  While AP-safe tests are being run, each AP writes into the log buffer of
+  the work item it claimed, so nothing shared is touched. RunApSafeTests()
+  moves those into the real test logs once the APs are done.
+
+**/
+STATIC
+UNIT_TEST_AP_SLOT*
+GetCurrentApSlot (
+  IN UNIT_TEST_FRAMEWORK    *Framework
+  )
+{
+  UNIT_TEST_AP_SCHEDULER  *Scheduler = (UNIT_TEST_AP_SCHEDULER*)Framework->ApScheduler;
+  UINTN                   Processor;
+
+  if (Scheduler != NULL && Scheduler->Items != NULL &&
+      !EFI_ERROR( Scheduler->MpServices->WhoAmI( Scheduler->MpServices, &Processor ) ) &&
+      Processor < Scheduler->ProcessorCount && Scheduler->Slots[Processor].Item != NULL)
+  {
+    return &Scheduler->Slots[Processor];
+  }
+
+  return NULL;
+} // GetCurrentApSlot()
+
+
+STATIC
+EFI_STATUS
+AddStringToCurrentTestLog (
+  IN UNIT_TEST_FRAMEWORK    *Framework,
+  IN CONST CHAR16           *String
+  )
+{
+  UNIT_TEST_AP_SLOT       *Slot;
+  UNIT_TEST_AP_WORK_ITEM  *Item;
+  UINTN                   Length, CopyLength;
+
+  Slot = GetCurrentApSlot( Framework );
+  if (Slot != NULL)
+  {
+    Item       = Slot->Item;
+    Length     = StrnLenS( String, UNIT_TEST_MAX_SINGLE_LOG_STRING_LENGTH );
+    CopyLength = MIN( Length, UNIT_TEST_AP_LOG_LENGTH - Item->LogLength );
+    CopyMem( &Item->Log[Item->LogLength], String, CopyLength * sizeof( CHAR16 ) );
+    Item->LogLength += CopyLength;
+    if (CopyLength < Length)
+    {
+      Item->LogTruncated = TRUE;
+    }
+    return EFI_SUCCESS;
+  }
+
+  return AddStringToUnitTestLog( Framework->CurrentTest, String );
+} // AddStringToCurrentTestLog()
+
+
+/**
+  Copies the arguments for Format out of Marker and into a BASE_LIST at
+  Arguments, so they can be formatted later with UnicodeBSPrintAsciiFormat().
+  The argument types are worked out the same way PrintLib reads them.
+
+  Anything that is passed by pointer (strings, GUIDs and times) may well be
+  gone by the time the log is formatted, so the data itself is copied to
+  Data and the BASE_LIST points at the copy.
+
+  If Arguments is NULL, nothing is copied and only the sizes are returned.
+
+  @param[out] ArgumentsSize   Set to the size of the BASE_LIST itself.
+
+  @retval   MAX_UINTN   Format has a specifier that isn't known here. Format it now instead.
+  @retval   Others      The number of bytes needed for the BASE_LIST and the copied data.
+
+**/
+STATIC
+UINTN
+CaptureLogArguments (
+  IN  CONST CHAR8   *Format,
+  IN  VA_LIST       Marker,
+  OUT UINTN         *ArgumentsSize,
+  OUT UINTN         *Arguments    OPTIONAL,
+  OUT UINT8         *Data         OPTIONAL
+  )
+{
+  BASE_LIST     BaseListMarker;
+  UINTN         DataSize;
+  UINTN         CopySize;
+  UINTN         CharSize;
+  UINTN         Precision;
+  UINTN         Count;
+  BOOLEAN       Long;
+  BOOLEAN       HasPrecision;
+  VOID          *Pointer;
+  UINTN         Value;
+
+  BaseListMarker = (BASE_LIST)Arguments;
+  *ArgumentsSize = 0;
+  DataSize       = 0;
+
+  for (; *Format != '\0'; Format++)
+  {
+    if (*Format != '%')
+    {
+      continue;
+    }
+
+    //
+    // Flags, width and precision. As in PrintLib, the precision starts out
+    // at 1 and a run of digits or a '*' only sets it if it follows the '.'.
+    Long          = FALSE;
+    HasPrecision  = FALSE;
+    Precision     = 1;
+    for (Format++; TRUE; Format++)
+    {
+      if (*Format == '.')
+      {
+        HasPrecision = TRUE;
+        continue;
+      }
+      if (*Format == '-' || *Format == '+' || *Format == ' ' || *Format == ',')
+      {
+        continue;
+      }
+      if (*Format >= '0' && *Format <= '9')
+      {
+        for (Count = 0; *Format >= '0' && *Format <= '9'; Format++)
+        {
+          Count = (Count * 10) + (*Format - '0');
+        }
+        Format--;
+        Precision = HasPrecision ? Count : Precision;
+        continue;
+      }
+      if (*Format == '*')
+      {
+        Value = VA_ARG( Marker, UINTN );
+        Precision = HasPrecision ? Value : Precision;
+        if (BaseListMarker != NULL)
+        {
+          BASE_ARG( BaseListMarker, UINTN ) = Value;
+        }
+        *ArgumentsSize += _BASE_INT_SIZE_OF( UINTN ) * sizeof( UINTN );
+        continue;
+      }
+      if (*Format == 'L' || *Format == 'l')
+      {
+        Long = TRUE;
+        continue;
+      }
+      break;
+    }
+
+    if (*Format == 'p')
+    {
+      // PrintLib drops any 'l' on a %p and reads a pointer-sized value.
+      Long = (sizeof( VOID* ) > 4);
+    }
+
+    switch (*Format)
+    {
+      case 'p':
+      case 'X':
+      case 'x':
+      case 'd':
+      case 'u':
+        if (Long)
+        {
+          if (BaseListMarker != NULL)
+          {
+            BASE_ARG( BaseListMarker, INT64 ) = VA_ARG( Marker, INT64 );
+          }
+          else
+          {
+            VA_ARG( Marker, INT64 );
+          }
+          *ArgumentsSize += _BASE_INT_SIZE_OF( INT64 ) * sizeof( UINTN );
+        }
+        else
+        {
+          if (BaseListMarker != NULL)
+          {
+            BASE_ARG( BaseListMarker, int ) = VA_ARG( Marker, int );
+          }
+          else
+          {
+            VA_ARG( Marker, int );
+          }
+          *ArgumentsSize += _BASE_INT_SIZE_OF( int ) * sizeof( UINTN );
+        }
+        break;
+
+      case 'c':
+        Value = VA_ARG( Marker, UINTN );
+        if (BaseListMarker != NULL)
+        {
+          BASE_ARG( BaseListMarker, UINTN ) = Value;
+        }
+        *ArgumentsSize += _BASE_INT_SIZE_OF( UINTN ) * sizeof( UINTN );
+        break;
+
+      case 'r':
+        Value = VA_ARG( Marker, RETURN_STATUS );
+        if (BaseListMarker != NULL)
+        {
+          BASE_ARG( BaseListMarker, RETURN_STATUS ) = Value;
+        }
+        *ArgumentsSize += _BASE_INT_SIZE_OF( RETURN_STATUS ) * sizeof( UINTN );
+        break;
+
+      case 'a':
+      case 's':
+      case 'S':
+      case 'g':
+      case 't':
+        Pointer  = VA_ARG( Marker, VOID* );
+        CopySize = 0;
+        CharSize = 0;
+        if (Pointer != NULL)
+        {
+          switch (*Format)
+          {
+            case 'a':
+              CharSize = sizeof( CHAR8 );
+              CopySize = HasPrecision ? AsciiStrnLenS( Pointer, Precision ) : AsciiStrLen( Pointer );
+              break;
+            case 'g':
+              CopySize = sizeof( GUID );
+              break;
+            case 't':
+              CopySize = sizeof( EFI_TIME );
+              break;
+            default:
+              // %s and %S are CHAR16 strings, even when the format is ASCII.
+              CharSize = sizeof( CHAR16 );
+              CopySize = HasPrecision ? StrnLenS( Pointer, Precision ) : StrLen( Pointer );
+              break;
+          }
+          CopySize *= (CharSize != 0) ? CharSize : 1;
+        }
+
+        if (BaseListMarker != NULL && Pointer != NULL)
+        {
+          //
+          // Strings are terminated here rather than copied with their NULL,
+          // since a precision may have cut them off before it.
+          CopyMem( &Data[DataSize], Pointer, CopySize );
+          ZeroMem( &Data[DataSize + CopySize], CharSize );
+          Pointer = &Data[DataSize];
+        }
+        if (BaseListMarker != NULL)
+        {
+          BASE_ARG( BaseListMarker, VOID* ) = Pointer;
+        }
+        *ArgumentsSize += _BASE_INT_SIZE_OF( VOID* ) * sizeof( UINTN );
+        // Keep every copy aligned for the GUID and TIME fields.
+        DataSize += ALIGN_VALUE( CopySize + CharSize, sizeof( UINTN ) );
+        break;
+
+      case '\0':
+        // A '%' at the very end of the format. Don't walk off of it.
+        Format--;
+        break;
+
+      case '%':
+      case '\r':
+      case '\n':
+        // Printed as-is. No argument.
+        break;
+
+      default:
+        //
+        // PrintLib prints anything else as-is too, but rather than guess that
+        // it takes no argument, leave this call to be formatted right away.
+        return MAX_UINTN;
+    }
+  }
+
+  return *ArgumentsSize + DataSize;
+} // CaptureLogArguments()
+
+
+/**
+  Records a UnitTestLog() call for the current test without formatting it.
+  Formatting only happens if something actually reads the log.
+
+  @retval   TRUE    The call was recorded.
+  @retval   FALSE   The call couldn't be recorded and should be formatted now instead.
+
+**/
+STATIC
+BOOLEAN
+DeferUnitTestLog (
+  IN  UNIT_TEST_FRAMEWORK   *Framework,
+  IN  UINTN                 ErrorLevel,
+  IN  CONST CHAR8           *Format,
+  IN  VA_LIST               Marker
+  )
+{
+  UNIT_TEST               *UnitTest;
+  UNIT_TEST_LOG_RECORD    *Record;
+  VA_LIST                 SizeMarker;
+  UINTN                   ArgumentsSize;
+  UINTN                   RecordSize;
+
+  UnitTest = Framework->CurrentTest;
+  if (UnitTest == NULL)
+  {
+    return FALSE;
+  }
+
+  //
+  // Take one pass to size the record and another to fill it in.
+  // The copied data goes right behind the BASE_LIST.
+  VA_COPY( SizeMarker, Marker );
+  RecordSize = CaptureLogArguments( Format, SizeMarker, &ArgumentsSize, NULL, NULL );
+  VA_END( SizeMarker );
+  if (RecordSize == MAX_UINTN)
+  {
+    return FALSE;
+  }
+
+  Record = AllocateFromArena( &Framework->Arena, sizeof( UNIT_TEST_LOG_RECORD ) + RecordSize );
+  if (Record == NULL)
+  {
+    return FALSE;
+  }
+  Record->Next        = NULL;
+  Record->Format      = Format;
+  Record->ErrorLevel  = ErrorLevel;
+  CaptureLogArguments( Format, Marker, &ArgumentsSize, (UINTN*)(Record + 1), (UINT8*)(Record + 1) + ArgumentsSize );
+
+  if (UnitTest->Log.DeferredTail == NULL)
+  {
+    UnitTest->Log.DeferredHead = Record;
+  }
+  else
+  {
+    ((UNIT_TEST_LOG_RECORD*)UnitTest->Log.DeferredTail)->Next = Record;
+  }
+  UnitTest->Log.DeferredTail = Record;
+
+  return TRUE;
+} // DeferUnitTestLog()
+
+
+/**
+  Formats any deferred UnitTestLog() calls for this test and appends
+  them to its log, in the order they were made.
+
+**/
+STATIC
+VOID
+RenderDeferredLog (
+  IN OUT UNIT_TEST    *UnitTest
+  )
+{
+  UNIT_TEST_LOG_RECORD  *Record;
+  CHAR16                LogString[UNIT_TEST_MAX_SINGLE_LOG_STRING_LENGTH];
+  CONST CHAR8           *LogTypePrefix;
+  UINTN                 Length;
+
+  //
+  // Detach the list before appending, since AppendToUnitTestLog() comes back here
+  // whenever there are records waiting.
+  Record = UnitTest->Log.DeferredHead;
+  UnitTest->Log.DeferredHead = NULL;
+  UnitTest->Log.DeferredTail = NULL;
+
+  for (; Record != NULL; Record = Record->Next)
+  {
+    Length = 0;
+    LogTypePrefix = GetStringForStatusLogPrefix( Record->ErrorLevel );
+    if (LogTypePrefix != NULL)
+    {
+      Length = UnicodeSPrintAsciiFormat( LogString, sizeof( LogString ), "%a", LogTypePrefix );
+    }
+    Length += UnicodeBSPrintAsciiFormat( &LogString[Length],
+                                         sizeof( LogString ) - (Length * sizeof( CHAR16 )),
+                                         Record->Format,
+                                         (BASE_LIST)(Record + 1) );
+    AppendToUnitTestLog( UnitTest, LogString, Length );
+  }
+
+  return;
+} // RenderDeferredLog()
+
+
+/**
+  Formats every deferred log record in the framework. Must be called
+  before anything reads the test logs directly.
+
+**/
+VOID
+EFIAPI
+RenderDeferredUnitTestLogs (
+  IN UNIT_TEST_FRAMEWORK    *Framework
+  )
+{
+  UNIT_TEST_SUITE_LIST_ENTRY  *Suite;
+  UNIT_TEST_LIST_ENTRY        *Test;
+
+  for (Suite = (UNIT_TEST_SUITE_LIST_ENTRY*)GetFirstNode( &Framework->TestSuiteList );
+       (LIST_ENTRY*)Suite != &Framework->TestSuiteList;
+       Suite = (UNIT_TEST_SUITE_LIST_ENTRY*)GetNextNode( &Framework->TestSuiteList, (LIST_ENTRY*)Suite ))
+  {
+    for (Test = (UNIT_TEST_LIST_ENTRY*)GetFirstNode( &Suite->UTS.TestCaseList );
+         (LIST_ENTRY*)Test != &Suite->UTS.TestCaseList;
+         Test = (UNIT_TEST_LIST_ENTRY*)GetNextNode( &Suite->UTS.TestCaseList, (LIST_ENTRY*)Test ))
+    {
+      if (Test->UT.Log.DeferredHead != NULL)
+      {
+        RenderDeferredLog( &Test->UT );
+      }
+    }
+  }
+
+  return;
+} // RenderDeferredUnitTestLogs()
+
+
+VOID
+EFIAPI
+UnitTestLog (
+  IN  UNIT_TEST_FRAMEWORK_HANDLE  Framework,
+  IN  UINTN                       ErrorLevel,
+  IN  CONST CHAR8                 *Format,
+  ...
+  )
+{
+  CHAR8         NewFormatString[UNIT_TEST_MAX_SINGLE_LOG_STRING_LENGTH];
+  CHAR16        LogString[UNIT_TEST_MAX_SINGLE_LOG_STRING_LENGTH];
+  CONST CHAR8   *LogTypePrefix = NULL;
+  VA_LIST       Marker;
+  BOOLEAN       Deferred;
+
+  //
+  // Make sure that this debug mode is enabled.
+  //
+  if ((ErrorLevel & mUnitTestLoggingLevel & FixedPcdGet32( PcdUnitTestLogLevel )) == 0) {
+      return;
+  }
+
+  //
+  // Unless the log is going to an AP slot, just write down what was asked for.
+  // The string only gets built if somebody reads the log.
+  //
+  if (FeaturePcdGet( PcdUnitTestDeferredLogFormatting ) &&
+      GetCurrentApSlot( (UNIT_TEST_FRAMEWORK*)Framework ) == NULL)
+  {
+    VA_START (Marker, Format);
+    Deferred = DeferUnitTestLog( (UNIT_TEST_FRAMEWORK*)Framework, ErrorLevel, Format, Marker );
+    VA_END (Marker);
+    if (Deferred)
+    {
+      return;
+    }
+  }
+
+  //
+  // If we need to define a new format string...
+  // well... get to it.
+  //
+  LogTypePrefix = GetStringForStatusLogPrefix( ErrorLevel );
+  if (LogTypePrefix != NULL)
+  {
+    AsciiSPrint( NewFormatString, sizeof( NewFormatString ), "%a%a", LogTypePrefix, Format );
+  }
+  else
+  {
+    AsciiStrCpyS( NewFormatString, sizeof( NewFormatString ), Format );
+  }
+
+  //
+  // Convert the message to an ASCII String
+  //
+  VA_START (Marker, Format);
+  UnicodeVSPrintAsciiFormat( LogString, sizeof( LogString ), NewFormatString, Marker );
+  VA_END (Marker);
+
+  //
+  // Finally, add the string to the log.
+  //
+  AddStringToCurrentTestLog( (UNIT_TEST_FRAMEWORK*)Framework, LogString );
+
+  return;
+}
+
+
+BOOLEAN
+EFIAPI
+UnitTestAssertTrue (
+  IN UNIT_TEST_FRAMEWORK_HANDLE Framework,
+  IN BOOLEAN                    Expression,
+  IN CONST CHAR8                *FunctionName,
+  IN UINTN                      LineNumber,
+  IN CONST CHAR8                *Description
+  )
+{
+  CHAR16    AssertString[UNIT_TEST_MAX_SINGLE_LOG_STRING_LENGTH];
+  if (!Expression && mUnitTestAssertionLogging)
+  {
+    UnicodeSPrintAsciiFormat( AssertString, sizeof( AssertString ),
+                   "[ASSERT FAIL] %a::%d Expression (%a) is not TRUE!\n", FunctionName, LineNumber, Description );
+    AddStringToCurrentTestLog( (UNIT_TEST_FRAMEWORK*)Framework, AssertString );
+  }
+  return Expression;
+}
+
+
+BOOLEAN
+EFIAPI
+UnitTestAssertFalse (
+  IN UNIT_TEST_FRAMEWORK_HANDLE Framework,
+  IN BOOLEAN                    Expression,
+  IN CONST CHAR8                *FunctionName,
+  IN UINTN                      LineNumber,
+  IN CONST CHAR8                *Description
+  )
+{
+  CHAR16    AssertString[UNIT_TEST_MAX_SINGLE_LOG_STRING_LENGTH];
+  if (Expression && mUnitTestAssertionLogging)
+  {
+    UnicodeSPrintAsciiFormat( AssertString, sizeof( AssertString ),
+                   "[ASSERT FAIL] %a::%d Expression (%a) is not FALSE!\n", FunctionName, LineNumber, Description );
+    AddStringToCurrentTestLog( (UNIT_TEST_FRAMEWORK*)Framework, AssertString );
+  }
+  return !Expression;
+}
+
+
+BOOLEAN
+EFIAPI
+UnitTestAssertNotEfiError (
+  IN UNIT_TEST_FRAMEWORK_HANDLE Framework,
+  IN EFI_STATUS                 Status,
+  IN CONST CHAR8                *FunctionName,
+  IN UINTN                      LineNumber,
+  IN CONST CHAR8                *Description
+  )
+{
+  CHAR16    AssertString[UNIT_TEST_MAX_SINGLE_LOG_STRING_LENGTH];
+  if (EFI_ERROR( Status ) && mUnitTestAssertionLogging)
+  {
+    UnicodeSPrintAsciiFormat( AssertString, sizeof( AssertString ),
+                   "[ASSERT FAIL] %a::%d Status '%a' is EFI_ERROR (%r)!\n", FunctionName, LineNumber, Description, Status );
+    AddStringToCurrentTestLog( (UNIT_TEST_FRAMEWORK*)Framework, AssertString );
+  }
+  return !EFI_ERROR( Status );
+}
+
+
+BOOLEAN
+EFIAPI
+UnitTestAssertEqual (
+  IN UNIT_TEST_FRAMEWORK_HANDLE Framework,
+  IN UINTN                      ValueA,
+  IN UINTN                      ValueB,
+  IN CONST CHAR8                *FunctionName,
+  IN UINTN                      LineNumber,
+  IN CONST CHAR8                *DescriptionA,
+  IN CONST CHAR8                *DescriptionB
+  )
+{
+  CHAR16    AssertString[UNIT_TEST_MAX_SINGLE_LOG_STRING_LENGTH];
+  if ((ValueA != ValueB) && mUnitTestAssertionLogging)
+  {
+    UnicodeSPrintAsciiFormat( AssertString, sizeof( AssertString ),
+                   "[ASSERT FAIL] %a::%d Value %a != %a (%d != %d)!\n", FunctionName, LineNumber,
+                   DescriptionA, DescriptionB, ValueA, ValueB );
+    AddStringToCurrentTestLog( (UNIT_TEST_FRAMEWORK*)Framework, AssertString );
+  }
+  return (ValueA == ValueB);
+}
+
+
+BOOLEAN
+EFIAPI
+UnitTestAssertNotEqual (
+  IN UNIT_TEST_FRAMEWORK_HANDLE Framework,
+  IN UINTN                      ValueA,
+  IN UINTN                      ValueB,
+  IN CONST CHAR8                *FunctionName,
+  IN UINTN                      LineNumber,
+  IN CONST CHAR8                *DescriptionA,
+  IN CONST CHAR8                *DescriptionB
+  )
+{
+  CHAR16    AssertString[UNIT_TEST_MAX_SINGLE_LOG_STRING_LENGTH];
+  if ((ValueA == ValueB) && mUnitTestAssertionLogging)
+  {
+    UnicodeSPrintAsciiFormat( AssertString, sizeof( AssertString ),
+                   "[ASSERT FAIL] %a::%d Value %a == %a (%d == %d)!\n", FunctionName, LineNumber,
+                   DescriptionA, DescriptionB, ValueA, ValueB );
+    AddStringToCurrentTestLog( (UNIT_TEST_FRAMEWORK*)Framework, AssertString );
+  }
+  return (ValueA != ValueB);
+}
+
+
+BOOLEAN
+EFIAPI
+UnitTestAssertStatusEqual (
+  IN UNIT_TEST_FRAMEWORK_HANDLE Framework,
+  IN EFI_STATUS                 Status,
+  IN EFI_STATUS                 Expected,
+  IN CONST CHAR8                *FunctionName,
+  IN UINTN                      LineNumber,
+  IN CONST CHAR8                *Description
+  )
+{
+  CHAR16    AssertString[UNIT_TEST_MAX_SINGLE_LOG_STRING_LENGTH];
+  if ((Status != Expected) && mUnitTestAssertionLogging)
+  {
+    UnicodeSPrintAsciiFormat( AssertString, sizeof( AssertString ),
+                   "[ASSERT FAIL] %a::%d Status '%a' is %r, should be %r!\n", FunctionName, LineNumber, Description, Status, Expected );
+    AddStringToCurrentTestLog( (UNIT_TEST_FRAMEWORK*)Framework, AssertString );
+  }
+  return (Status == Expected);
+}
+
+
+/**
+  Finds the first offset at which two buffers differ. Most of the buffer
+  is walked in 64-bit strides and only the final stride is walked a byte
+  at a time.
+
+  @retval   The offset of the first differing byte, or Length if the buffers match.
+
+**/
+STATIC
+UINTN
+FindFirstDifference (
+  IN CONST UINT8    *BufferA,
+  IN CONST UINT8    *BufferB,
+  IN UINTN          Length
+  )
+{
+  UINTN     Offset;
+
+  for (Offset = 0;
+       Offset + sizeof( UINT64 ) <= Length &&
+       ReadUnaligned64( (CONST UINT64*)(BufferA + Offset) ) == ReadUnaligned64( (CONST UINT64*)(BufferB + Offset) );
+       Offset += sizeof( UINT64 ))
+  {
+  }
+
+  while (Offset < Length && BufferA[Offset] == BufferB[Offset])
+  {
+    Offset++;
+  }
+
+  return Offset;
+} // FindFirstDifference()
+
+
+/**
+  Logs one line of the hex window for UnitTestAssertMemEqual(). Any byte that
+  differs from the other buffer is preceded by a '*'.
+
+**/
+STATIC
+VOID
+LogMemDiffLine (
+  IN UNIT_TEST_FRAMEWORK    *Framework,
+  IN CHAR8                  Label,
+  IN CONST UINT8            *Buffer,
+  IN CONST UINT8            *Other,
+  IN UINTN                  Offset,
+  IN UINTN                  Count
+  )
+{
+  CONST CHAR8   HexDigits[] = "0123456789ABCDEF";
+  CHAR8         Bytes[UNIT_TEST_MEM_DIFF_LINE_LENGTH * 3 + 1];
+  CHAR16        LogString[UNIT_TEST_MAX_SINGLE_LOG_STRING_LENGTH];
+  UINTN         Index;
+
+  for (Index = 0; Index < Count; Index++)
+  {
+    Bytes[Index * 3]     = (Buffer[Offset + Index] != Other[Offset + Index]) ? '*' : ' ';
+    Bytes[Index * 3 + 1] = HexDigits[Buffer[Offset + Index] >> 4];
+    Bytes[Index * 3 + 2] = HexDigits[Buffer[Offset + Index] & 0xF];
+  }
+  Bytes[Count * 3] = '\0';
+
+  UnicodeSPrintAsciiFormat( LogString, sizeof( LogString ), "    %c +0x%08lx:%a\n", Label, (UINT64)Offset, Bytes );
+  AddStringToCurrentTestLog( Framework, LogString );
+  return;
+} // LogMemDiffLine()
+
+
+BOOLEAN
+EFIAPI
+UnitTestAssertMemEqual (
+  IN UNIT_TEST_FRAMEWORK_HANDLE Framework,
+  IN CONST VOID                 *BufferA,
+  IN CONST VOID                 *BufferB,
+  IN UINTN                      Length,
+  IN CONST CHAR8                *FunctionName,
+  IN UINTN                      LineNumber,
+  IN CONST CHAR8                *DescriptionA,
+  IN CONST CHAR8                *DescriptionB
+  )
+{
+  CHAR16    AssertString[UNIT_TEST_MAX_SINGLE_LOG_STRING_LENGTH];
+  UINTN     Offset, WindowStart, WindowEnd, Count;
+
+  if (Length == 0 || BufferA == BufferB || CompareMem( BufferA, BufferB, Length ) == 0)
+  {
+    return TRUE;
+  }
+
+  if (mUnitTestAssertionLogging)
+  {
+    Offset = FindFirstDifference( BufferA, BufferB, Length );
+    UnicodeSPrintAsciiFormat( AssertString, sizeof( AssertString ),
+                   "[ASSERT FAIL] %a::%d Memory %a != %a (first difference at offset 0x%lx of 0x%lx)!\n",
+                   FunctionName, LineNumber, DescriptionA, DescriptionB, (UINT64)Offset, (UINT64)Length );
+    AddStringToCurrentTestLog( (UNIT_TEST_FRAMEWORK*)Framework, AssertString );
+
+    //
+    // Dump a few lines either side of the line that holds the first difference.
+    WindowStart = Offset & ~(UINTN)(UNIT_TEST_MEM_DIFF_LINE_LENGTH - 1);
+    WindowStart = (WindowStart > UNIT_TEST_MEM_DIFF_CONTEXT_LINES * UNIT_TEST_MEM_DIFF_LINE_LENGTH) ?
+                  WindowStart - UNIT_TEST_MEM_DIFF_CONTEXT_LINES * UNIT_TEST_MEM_DIFF_LINE_LENGTH : 0;
+    WindowEnd   = WindowStart + (UNIT_TEST_MEM_DIFF_CONTEXT_LINES * 2 + 1) * UNIT_TEST_MEM_DIFF_LINE_LENGTH;
+    WindowEnd   = MIN( WindowEnd, Length );
+    for (; WindowStart < WindowEnd; WindowStart += Count)
+    {
+      Count = MIN( UNIT_TEST_MEM_DIFF_LINE_LENGTH, WindowEnd - WindowStart );
+      LogMemDiffLine( (UNIT_TEST_FRAMEWORK*)Framework, 'A', BufferA, BufferB, WindowStart, Count );
+      LogMemDiffLine( (UNIT_TEST_FRAMEWORK*)Framework, 'B', BufferB, BufferA, WindowStart, Count );
+    }
+  }
+
+  return FALSE;
+} // UnitTestAssertMemEqual()
+
+
+//=============================================================================
+//
+// ----------------  TEST UTILITY FUNCTIONS -----------------------------------
+//
+//=============================================================================
+
+
+/**
+  Picks the starting slot in the saved test index for a fingerprint.
+  Fingerprints are already uniformly distributed hashes, so their leading
+  bytes can be used directly.
+
+**/
+STATIC
+UINTN
+GetSavedTestIndexSlot (
+  IN  UINT8       *Fingerprint,
+  IN  UINTN       IndexSize
+  )
+{
+  return (UINTN)ReadUnaligned32( (UINT32*)Fingerprint ) & (IndexSize - 1);
+} // GetSavedTestIndexSlot()
+
+
+/**
+  Walks the SavedState blob exactly once, validating every record against
+  the blob size, and builds an open-addressed (linear probing) hash table
+  of the saved tests keyed on their fingerprints. The saved context, if
+  any, is located at the same time.
+
+  The table is kept at most half full so probe sequences stay short.
+
+  @param[in,out]  Framework   Framework whose SavedState should be indexed.
+
+  @retval     EFI_SUCCESS             The index is ready.
+  @retval     EFI_INCOMPATIBLE_VERSION  The blob was written by a different version or framework.
+  @retval     EFI_VOLUME_CORRUPTED    The blob is inconsistent with its own sizes.
+  @retval     EFI_OUT_OF_RESOURCES    The table could not be allocated.
+
+**/
+STATIC
+EFI_STATUS
+IndexSavedState (
+  IN OUT UNIT_TEST_FRAMEWORK    *Framework
+  )
+{
+  UNIT_TEST_SAVE_HEADER   *SavedState = Framework->SavedState;
+  UNIT_TEST_SAVE_TEST     *CurrentTest;
+  UNIT_TEST_SAVE_CONTEXT  *SavedContext;
+  UINT8                   *FloatingPointer, *BlobEnd;
+  UINTN                   Index, Slot, IndexSize;
+  UNIT_TEST_SAVE_TEST     **SavedTestIndex;
+
+  //
+  // First, make sure this blob is even meant for us.
+  // IMPORTANT NOTE: There are security implications here.
+  //                 This data is user-supplied, so nothing in it is trusted
+  //                 until it has been checked against the blob size.
+  if (SavedState->BlobSize < sizeof( UNIT_TEST_SAVE_HEADER ))
+  {
+    return EFI_VOLUME_CORRUPTED;
+  }
+  if (SavedState->Version != UNIT_TEST_PERSISTENCE_LIB_VERSION ||
+      SavedState->FingerprintAlgorithm != UNIT_TEST_FINGERPRINT_ALGORITHM ||
+      !CompareFingerprints( &SavedState->Fingerprint[0], &Framework->Fingerprint[0] ))
+  {
+    return EFI_INCOMPATIBLE_VERSION;
+  }
+  // Every test needs at least a full record, which bounds the count (and the table).
+  if (SavedState->TestCount > (SavedState->BlobSize - sizeof( UNIT_TEST_SAVE_HEADER )) / sizeof( UNIT_TEST_SAVE_TEST ))
+  {
+    return EFI_VOLUME_CORRUPTED;
+  }
+
+  //
+  // Size the table to the next power of two that's at least twice the test count.
+  IndexSize = 1;
+  while (IndexSize < (UINTN)SavedState->TestCount * 2)
+  {
+    IndexSize <<= 1;
+  }
+  SavedTestIndex = AllocateZeroFromArena( &Framework->Arena, IndexSize * sizeof( UNIT_TEST_SAVE_TEST* ) );
+  if (SavedTestIndex == NULL)
+  {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  //
+  // Walk the tests once.
+  FloatingPointer = (UINT8*)SavedState + sizeof( UNIT_TEST_SAVE_HEADER );
+  BlobEnd         = (UINT8*)SavedState + SavedState->BlobSize;
+  for (Index = 0; Index < SavedState->TestCount; Index++)
+  {
+    CurrentTest = (UNIT_TEST_SAVE_TEST*)FloatingPointer;
+    if ((UINTN)(BlobEnd - FloatingPointer) < sizeof( UNIT_TEST_SAVE_TEST ) ||
+        CurrentTest->Size < sizeof( UNIT_TEST_SAVE_TEST ) ||
+        CurrentTest->Size > (UINTN)(BlobEnd - FloatingPointer))
+    {
+      return EFI_VOLUME_CORRUPTED;
+    }
+
+    // Probe for a free slot. If the fingerprint is already present, the first record wins.
+    for (Slot = GetSavedTestIndexSlot( &CurrentTest->Fingerprint[0], IndexSize );
+         SavedTestIndex[Slot] != NULL;
+         Slot = (Slot + 1) & (IndexSize - 1))
+    {
+      if (CompareFingerprints( &SavedTestIndex[Slot]->Fingerprint[0], &CurrentTest->Fingerprint[0] ))
+      {
+        break;
+      }
+    }
+    if (SavedTestIndex[Slot] == NULL)
+    {
+      SavedTestIndex[Slot] = CurrentTest;
+    }
+
+    FloatingPointer += CurrentTest->Size;
+  }
+
+  //
+  // If there was a saved context, the loop will have left the FloatingPointer
+  // at the beginning of the context structure.
+  SavedContext = NULL;
+  if (SavedState->HasSavedContext)
+  {
+    // TODO: Reconcile the difference between the way "size" works for Test Saves
+    //        and the way it works for Context Saves. Too confusing to use it different ways.
+    SavedContext = (UNIT_TEST_SAVE_CONTEXT*)FloatingPointer;
+    if ((UINTN)(BlobEnd - FloatingPointer) < sizeof( UNIT_TEST_SAVE_CONTEXT ) ||
+        SavedContext->Size > (UINTN)(BlobEnd - FloatingPointer) - sizeof( UNIT_TEST_SAVE_CONTEXT ))
+    {
+      return EFI_VOLUME_CORRUPTED;
+    }
+  }
+
+  Framework->SavedTestIndex     = (VOID**)SavedTestIndex;
+  Framework->SavedTestIndexSize = IndexSize;
+  Framework->SavedContext       = SavedContext;
+  // The index points into the saved state until every test has been added.
+  Framework->SavedStateReferences = 1;
+
+  return EFI_SUCCESS;
+} // IndexSavedState()
+
+
+STATIC
+UNIT_TEST_SAVE_TEST*
+FindSavedTest (
+  IN  UNIT_TEST_FRAMEWORK   *Framework,
+  IN  UINT8                 *Fingerprint
+  )
+{
+  UNIT_TEST_SAVE_TEST   **SavedTestIndex = (UNIT_TEST_SAVE_TEST**)Framework->SavedTestIndex;
+  UINTN                 Slot;
+
+  if (SavedTestIndex == NULL)
+  {
+    return NULL;
+  }
+
+  for (Slot = GetSavedTestIndexSlot( Fingerprint, Framework->SavedTestIndexSize );
+       SavedTestIndex[Slot] != NULL;
+       Slot = (Slot + 1) & (Framework->SavedTestIndexSize - 1))
+  {
+    if (CompareFingerprints( &SavedTestIndex[Slot]->Fingerprint[0], Fingerprint ))
+    {
+      return SavedTestIndex[Slot];
+    }
+  }
+
+  return NULL;
+} // FindSavedTest()
+
+
+STATIC
+VOID
+UpdateTestFromSave (
+  IN OUT UNIT_TEST              *Test,
+  IN     UNIT_TEST_FRAMEWORK    *Framework
+  )
+{
+  UNIT_TEST_SAVE_TEST     *MatchingTest;
+  UNIT_TEST_SAVE_CONTEXT  *SavedContext;
+  UNIT_TEST_LOG_CHUNK     *Chunk;
+  CHAR16                  *SavedLog;
+  UINTN                   SavedLogSize, SavedLogLength;
+
+  //
+  // First, evaluate the inputs.
+  if (Test == NULL || Framework == NULL || Framework->SavedState == NULL)
+  {
+    return;
+  }
+
+  //
+  // Next, look up the matching test in the index.
+  MatchingTest = FindSavedTest( Framework, &Test->Fingerprint[0] );
+
+  //
+  // If a matching test was found, copy the status.
+  if (MatchingTest)
+  {
+    // Override the test status with the saved status.
+    Test->Result = MatchingTest->Result;
+
+    // Pick up the time spent on previous passes.
+    Test->PreReqDuration  = MatchingTest->PreReqDuration;
+    Test->RunDuration     = MatchingTest->RunDuration;
+    Test->CleanUpDuration = MatchingTest->CleanUpDuration;
+
+    // Benchmarks pick up their statistics, if they got as far as taking any.
+    if (Test->Benchmark != NULL && MatchingTest->BenchmarkSamples > 0)
+    {
+      Test->Benchmark->Samples            = MatchingTest->BenchmarkSamples;
+      Test->Benchmark->OpsPerSample       = MatchingTest->BenchmarkOpsPerSample;
+      Test->Benchmark->MinPicoSeconds     = MatchingTest->BenchmarkMinPicoSeconds;
+      Test->Benchmark->MedianPicoSeconds  = MatchingTest->BenchmarkMedianPicoSeconds;
+      Test->Benchmark->P99PicoSeconds     = MatchingTest->BenchmarkP99PicoSeconds;
+      Test->Benchmark->MaxPicoSeconds     = MatchingTest->BenchmarkMaxPicoSeconds;
+      Test->Benchmark->MeanPicoSeconds    = MatchingTest->BenchmarkMeanPicoSeconds;
+    }
+
+    // If there is a log string associated, grab that.
+    // We can tell that there's a log string because the "size" will be larger than
+    // the structure size. The size itself was validated when the index was built.
+    if (MatchingTest->Size > sizeof( UNIT_TEST_SAVE_TEST ))
+    {
+      SavedLog        = (CHAR16*)((UINT8*)MatchingTest + sizeof( UNIT_TEST_SAVE_TEST ));
+      SavedLogSize    = (MatchingTest->Size - sizeof( UNIT_TEST_SAVE_TEST )) / sizeof( CHAR16 );
+      SavedLogLength  = StrnLenS( SavedLog, SavedLogSize );
+
+      //
+      // The saved state stays loaded anyway, so rather than copy the log out of it,
+      // point a chunk at it. That only works if it's NULL-terminated in place;
+      // anything else is copied, which terminates it.
+      Chunk = NULL;
+      if (SavedLogLength > 0 && SavedLogLength < SavedLogSize)
+      {
+        Chunk = AllocateFromArena( &Framework->Arena, sizeof( UNIT_TEST_LOG_CHUNK ) );
+      }
+      if (Chunk != NULL)
+      {
+        Chunk->Next         = NULL;
+        Chunk->Length       = SavedLogLength;
+        Chunk->Size         = SavedLogLength;
+        Chunk->Buffer       = SavedLog;
+        Test->Log.Head      = Chunk;
+        Test->Log.Tail      = Chunk;
+        Test->Log.Length    = SavedLogLength;
+        Test->Log.Borrowed  = TRUE;
+        Framework->SavedStateReferences++;
+      }
+      else
+      {
+        AppendToUnitTestLog( Test, SavedLog, SavedLogLength );
+      }
+    }
+
+    // This is what the cache already has, so there's no need to save it again.
+    Test->SavedResult     = Test->Result;
+    Test->SavedLogLength  = Test->Log.Length;
+  }
+
+  //
+  // If the saved context exists and matches this test, grab it, too.
+  SavedContext = Framework->SavedContext;
+  if (SavedContext != NULL && SavedContext->Size > 0 &&
+      CompareFingerprints( &Test->Fingerprint[0], &SavedContext->Fingerprint[0] ))
+  {
+    // Override the test context with the saved context.
+    Test->Context = (VOID*)((UINT8*)SavedContext + sizeof( *SavedContext ));
+    Framework->SavedContextTest = Test;
+    Framework->SavedStateReferences++;
+  }
+
+  return;
+} // UpdateTestFromSave()
+
+
+/**
+  Drops one of the references into the saved state, and frees it once
+  nothing points into it any more.
+
+**/
+STATIC
+VOID
+ReleaseSavedStateReference (
+  IN OUT UNIT_TEST_FRAMEWORK    *Framework
+  )
+{
+  if (Framework->SavedStateReferences == 0)
+  {
+    return;
+  }
+
+  Framework->SavedStateReferences--;
+  if (Framework->SavedStateReferences == 0 && Framework->SavedState != NULL)
+  {
+    DEBUG(( DEBUG_UT_VERBOSE, "%a - Nothing refers to the saved state any more. Freeing it.\n", __FUNCTION__ ));
+    FreePool( Framework->SavedState );
+    Framework->SavedState = NULL;
+  }
+
+  return;
+} // ReleaseSavedStateReference()
+
+
+/**
+  Loads the performance baseline, if baselines are turned on and there is one,
+  and indexes it by fingerprint. A baseline that can't be used is dropped, and
+  will be replaced the next time the baseline is saved.
+
+**/
+STATIC
+VOID
+LoadPerformanceBaseline (
+  IN OUT UNIT_TEST_FRAMEWORK    *Framework
+  )
+{
+  UNIT_TEST_BASELINE_HEADER   *Baseline;
+  UNIT_TEST_BASELINE_ENTRY    *Entries;
+  UNIT_TEST_BASELINE_ENTRY    **BaselineIndex;
+  UINTN                       Index, Slot, IndexSize;
+
+  if (FixedPcdGet32( PcdUnitTestPerfRegressionThreshold ) == 0 ||
+      EFI_ERROR( LoadUnitTestBaseline( Framework, &Baseline ) ))
+  {
+    return;
+  }
+
+  //
+  // Like the saved state, the baseline is user-supplied, so check it over first.
+  if (Baseline->BlobSize < sizeof( UNIT_TEST_BASELINE_HEADER ) ||
+      Baseline->Version != UNIT_TEST_BASELINE_VERSION ||
+      Baseline->FingerprintAlgorithm != UNIT_TEST_FINGERPRINT_ALGORITHM ||
+      Baseline->EntryCount != (Baseline->BlobSize - sizeof( UNIT_TEST_BASELINE_HEADER )) / sizeof( UNIT_TEST_BASELINE_ENTRY ))
+  {
+    DEBUG(( DEBUG_ERROR, "%a - Baseline was loaded, but could not be used.\n", __FUNCTION__ ));
+    FreePool( Baseline );
+    return;
+  }
+
+  //
+  // Size the table to the next power of two that's at least twice the entry count.
+  IndexSize = 1;
+  while (IndexSize < (UINTN)Baseline->EntryCount * 2)
+  {
+    IndexSize <<= 1;
+  }
+  BaselineIndex = AllocateZeroFromArena( &Framework->Arena, IndexSize * sizeof( UNIT_TEST_BASELINE_ENTRY* ) );
+  if (BaselineIndex == NULL)
+  {
+    FreePool( Baseline );
+    return;
+  }
+
+  // If a fingerprint shows up more than once, the first entry wins.
+  Entries = (UNIT_TEST_BASELINE_ENTRY*)((UINT8*)Baseline + sizeof( UNIT_TEST_BASELINE_HEADER ));
+  for (Index = 0; Index < Baseline->EntryCount; Index++)
+  {
+    for (Slot = GetSavedTestIndexSlot( &Entries[Index].Fingerprint[0], IndexSize );
+         BaselineIndex[Slot] != NULL;
+         Slot = (Slot + 1) & (IndexSize - 1))
+    {
+      if (CompareFingerprints( &BaselineIndex[Slot]->Fingerprint[0], &Entries[Index].Fingerprint[0] ))
+      {
+        break;
+      }
+    }
+    if (BaselineIndex[Slot] == NULL)
+    {
+      BaselineIndex[Slot] = &Entries[Index];
+    }
+  }
+
+  Framework->Baseline           = Baseline;
+  Framework->BaselineIndex      = (VOID**)BaselineIndex;
+  Framework->BaselineIndexSize  = IndexSize;
+  return;
+} // LoadPerformanceBaseline()
+
+
+STATIC
+UNIT_TEST_BASELINE_ENTRY*
+FindBaselineEntry (
+  IN  UNIT_TEST_FRAMEWORK   *Framework,
+  IN  UINT8                 *Fingerprint
+  )
+{
+  UNIT_TEST_BASELINE_ENTRY  **BaselineIndex = (UNIT_TEST_BASELINE_ENTRY**)Framework->BaselineIndex;
+  UINTN                     Slot;
+
+  if (BaselineIndex == NULL)
+  {
+    return NULL;
+  }
+
+  for (Slot = GetSavedTestIndexSlot( Fingerprint, Framework->BaselineIndexSize );
+       BaselineIndex[Slot] != NULL;
+       Slot = (Slot + 1) & (Framework->BaselineIndexSize - 1))
+  {
+    if (CompareFingerprints( &BaselineIndex[Slot]->Fingerprint[0], Fingerprint ))
+    {
+      return BaselineIndex[Slot];
+    }
+  }
+
+  return NULL;
+} // FindBaselineEntry()
+
+
+/**
+  Checks a test that has just finished against its baseline. A passing test
+  that ran more than PcdUnitTestPerfRegressionThreshold percent over the
+  baseline mean is marked UNIT_TEST_ERROR_PERF_REGRESSION. Otherwise the
+  run is folded into the baseline.
+
+  Regressions are deliberately left out of the baseline, so that it doesn't
+  creep up to meet them. To accept a slower test, delete the baseline file.
+
+**/
+STATIC
+VOID
+UpdatePerformanceBaseline (
+  IN OUT UNIT_TEST_FRAMEWORK    *Framework,
+  IN OUT UNIT_TEST              *Test
+  )
+{
+  UNIT_TEST_BASELINE_ENTRY  *Entry;
+  UNIT_TEST_BASELINE_NODE   *Node;
+  UINT64                    Value, Limit;
+  CONST CHAR16              *Units;
+  CHAR16                    Message[UNIT_TEST_MAX_SINGLE_LOG_STRING_LENGTH];
+
+  if (FixedPcdGet32( PcdUnitTestPerfRegressionThreshold ) == 0 || Test->Result != UNIT_TEST_PASSED)
+  {
+    return;
+  }
+
+  //
+  // Benchmarks are judged on their median, everything else on how long RunTest took.
+  if (Test->Benchmark != NULL)
+  {
+    Value = Test->Benchmark->MedianPicoSeconds;
+    Units = L"ps/op";
+  }
+  else
+  {
+    Value = Test->RunDuration;
+    Units = L"ns";
+  }
+
+  //
+  // If there's enough of a baseline to go on, see whether this run is out of line.
+  Entry = FindBaselineEntry( Framework, &Test->Fingerprint[0] );
+  if (Entry != NULL && Entry->Runs >= UNIT_TEST_BASELINE_MIN_RUNS &&
+      (Test->Benchmark != NULL || Value >= FixedPcdGet64( PcdUnitTestPerfRegressionMinDuration )))
+  {
+    Limit = Entry->Mean + DivU64x64Remainder( MultU64x32( Entry->Mean, FixedPcdGet32( PcdUnitTestPerfRegressionThreshold ) ), 100, NULL );
+    if (Value > Limit)
+    {
+      UnicodeSPrint( Message, sizeof( Message ),
+                     L"[PERF REGRESSION] %ld %s is more than %d%% over the baseline mean of %ld %s (%d runs, min %ld, max %ld).\n",
+                     Value, Units, FixedPcdGet32( PcdUnitTestPerfRegressionThreshold ), Entry->Mean, Units,
+                     Entry->Runs, Entry->Min, Entry->Max );
+      AddStringToUnitTestLog( Test, Message );
+      Test->Result = UNIT_TEST_ERROR_PERF_REGRESSION;
+      return;
+    }
+  }
+
+  //
+  // Fold the run in. Tests that weren't in the baseline get a new entry.
+  if (Entry == NULL)
+  {
+    Node = AllocateZeroFromArena( &Framework->Arena, sizeof( UNIT_TEST_BASELINE_NODE ) );
+    if (Node == NULL)
+    {
+      return;
+    }
+    CopyMem( &Node->Entry.Fingerprint[0], &Test->Fingerprint[0], UNIT_TEST_FINGERPRINT_SIZE );
+    Node->Next                    = Framework->NewBaselineEntries;
+    Framework->NewBaselineEntries = Node;
+    Framework->NewBaselineEntryCount++;
+    Entry = &Node->Entry;
+  }
+
+  if (Entry->Runs == 0 || Value < Entry->Min)
+  {
+    Entry->Min = Value;
+  }
+  if (Value > Entry->Max)
+  {
+    Entry->Max = Value;
+  }
+  if (Entry->Runs < UNIT_TEST_BASELINE_WINDOW)
+  {
+    Entry->Mean = DivU64x32( MultU64x32( Entry->Mean, Entry->Runs ) + Value, Entry->Runs + 1 );
+  }
+  else
+  {
+    Entry->Mean = Entry->Mean - DivU64x32( Entry->Mean, UNIT_TEST_BASELINE_WINDOW ) + DivU64x32( Value, UNIT_TEST_BASELINE_WINDOW );
+  }
+  if (Entry->Runs < MAX_UINT32)
+  {
+    Entry->Runs++;
+  }
+  Framework->BaselineChanged = TRUE;
+
+  return;
+} // UpdatePerformanceBaseline()
+
+
+/**
+  Writes the loaded baseline, with everything folded into it so far, back out
+  through the persistence lib. Entries for tests that aren't registered any
+  more (or were filtered out) are carried over untouched.
+
+**/
+STATIC
+VOID
+SavePerformanceBaseline (
+  IN OUT UNIT_TEST_FRAMEWORK    *Framework
+  )
+{
+  UNIT_TEST_BASELINE_HEADER   *OldBaseline = Framework->Baseline;
+  UNIT_TEST_BASELINE_HEADER   *NewBaseline;
+  UNIT_TEST_BASELINE_ENTRY    *Entries;
+  UNIT_TEST_BASELINE_NODE     *Node;
+  UINT32                      OldCount, Index;
+  EFI_STATUS                  Status;
+
+  if (!Framework->BaselineChanged)
+  {
+    return;
+  }
+
+  OldCount    = (OldBaseline != NULL) ? OldBaseline->EntryCount : 0;
+  NewBaseline = AllocatePool( sizeof( UNIT_TEST_BASELINE_HEADER ) +
+                              ((UINTN)OldCount + Framework->NewBaselineEntryCount) * sizeof( UNIT_TEST_BASELINE_ENTRY ) );
+  if (NewBaseline == NULL)
+  {
+    return;
+  }
+
+  NewBaseline->Version              = UNIT_TEST_BASELINE_VERSION;
+  NewBaseline->FingerprintAlgorithm = UNIT_TEST_FINGERPRINT_ALGORITHM;
+  NewBaseline->EntryCount           = OldCount + Framework->NewBaselineEntryCount;
+  NewBaseline->BlobSize             = sizeof( UNIT_TEST_BASELINE_HEADER ) + NewBaseline->EntryCount * sizeof( UNIT_TEST_BASELINE_ENTRY );
+
+  Entries = (UNIT_TEST_BASELINE_ENTRY*)((UINT8*)NewBaseline + sizeof( UNIT_TEST_BASELINE_HEADER ));
+  if (OldCount > 0)
+  {
+    CopyMem( Entries, (UINT8*)OldBaseline + sizeof( UNIT_TEST_BASELINE_HEADER ), OldCount * sizeof( UNIT_TEST_BASELINE_ENTRY ) );
+  }
+  Index = OldCount;
+  for (Node = Framework->NewBaselineEntries; Node != NULL; Node = Node->Next)
+  {
+    CopyMem( &Entries[Index++], &Node->Entry, sizeof( UNIT_TEST_BASELINE_ENTRY ) );
+  }
+
+  Status = SaveUnitTestBaseline( Framework, NewBaseline );
+  if (!EFI_ERROR( Status ))
+  {
+    Framework->BaselineChanged = FALSE;
+  }
+  else if (Status != EFI_UNSUPPORTED)
+  {
+    DEBUG(( DEBUG_ERROR, "%a - Could not save the baseline! %r\n", __FUNCTION__, Status ));
+  }
+
+  FreePool( NewBaseline );
+  return;
+} // SavePerformanceBaseline()
+
+
+/**
+  Returns TRUE if the test has to go into the next save. Anything that changes
+  a test's record also changes its result or adds to its log, except for the
+  durations of the test that's running now, so that one always goes in.
+
+**/
+STATIC
+BOOLEAN
+HasTestChangedSinceSave (
+  IN UNIT_TEST_FRAMEWORK    *Framework,
+  IN UNIT_TEST              *UnitTest
+  )
+{
+  return (UnitTest == Framework->CurrentTest ||
+          UnitTest->Result != UnitTest->SavedResult ||
+          UnitTest->Log.Length != UnitTest->SavedLogLength);
+} // HasTestChangedSinceSave()
+
+
+/**
+  Packages up the framework state for the persistence lib. If ChangedOnly is
+  set, only the tests that have changed since the last save are included,
+  to be appended to what's already in the cache.
+
+**/
+STATIC
+UNIT_TEST_SAVE_HEADER*
+SerializeState (
+  IN UNIT_TEST_FRAMEWORK_HANDLE FrameworkHandle,
+  IN UNIT_TEST_CONTEXT          ContextToSave     OPTIONAL,
+  IN UINTN                      ContextToSaveSize,
+  IN BOOLEAN                    ChangedOnly
+  )
+{
+  UNIT_TEST_FRAMEWORK         *Framework  = FrameworkHandle;
+  UNIT_TEST_SAVE_HEADER       *Header = NULL;
+  LIST_ENTRY                  *SuiteListHead, *Suite, *TestListHead, *Test;
+  UINT32                      TestCount, TotalSize;
+  UINTN                       LogSize;
+  UNIT_TEST_SAVE_TEST         *TestSaveData;
+  UNIT_TEST_SAVE_CONTEXT      *TestSaveContext;
+  UNIT_TEST                   *UnitTest;
+  UNIT_TEST_LOG_CHUNK         *LogChunk;
+  UINT8                       *FloatingPointer;
+
+  //
+  // First, let's not make assumptions about the parameters.
+  // You gotta call shenanigans in a hurry, son.
+  if (Framework == NULL || (ContextToSave != NULL && ContextToSaveSize == 0) ||
+      ContextToSaveSize > MAX_UINT32)
+  {
+    return NULL;
+  }
+
+  //
+  // If we're saving from inside a test, make sure the time it has spent so far
+  // is accounted for. The timer keeps running in case the caller carries on.
+  UpdateDurationTimer( Framework, TRUE );
+
+  //
+  // Logs are saved as text, so anything that's still deferred has to be formatted now.
+  RenderDeferredUnitTestLogs( Framework );
+
+  //
+  // Next, we've gotta figure out the resources that will be required to serialize the
+  // the framework state so that we can persist it.
+  // To start with, we're gonna need a header.
+  TotalSize = sizeof( UNIT_TEST_SAVE_HEADER );
+  // Now we need to figure out how many tests there are.
+  TestCount = 0;
+  // Iterate all suites.
+  SuiteListHead = &Framework->TestSuiteList;
+  for (Suite = GetFirstNode( SuiteListHead ); Suite != SuiteListHead; Suite = GetNextNode( SuiteListHead, Suite ))
+  {
+    // Iterate all tests within the suite.
+    TestListHead = &((UNIT_TEST_SUITE_LIST_ENTRY*)Suite)->UTS.TestCaseList;
+    for (Test = GetFirstNode( TestListHead ); Test != TestListHead; Test = GetNextNode( TestListHead, Test ))
+    {
+      UnitTest = &((UNIT_TEST_LIST_ENTRY*)Test)->UT;
+      if (ChangedOnly && !HasTestChangedSinceSave( Framework, UnitTest ))
+      {
+        continue;
+      }
+      // Account for the size of a test structure.
+      TotalSize += sizeof( UNIT_TEST_SAVE_TEST );
+      // If there's a log, make sure to account for the log size.
+      if (UnitTest->Log.Head != NULL)
+      {
+        // The +1 is for the NULL character. Can't forget the NULL character.
+        LogSize = (UnitTest->Log.Length + 1) * sizeof( CHAR16 );
+        ASSERT( LogSize < MAX_UINT32 );
+        TotalSize += (UINT32)LogSize;
+      }
+      // Increment the test count.
+      TestCount++;
+    }
+  }
+  // If there are no tests, we're done here.
+  // (Unless nothing has changed, in which case the header is still worth saving.)
+  if (TestCount == 0 && !ChangedOnly)
+  {
+    return NULL;
+  }
+  // Add room for the context, if there is one.
+  if (ContextToSave != NULL)
+  {
+    TotalSize += sizeof( UNIT_TEST_SAVE_CONTEXT ) + (UINT32)ContextToSaveSize;
+  }
+
+  //
+  // Phew! That was a pain.
+  // Now that we know the size, we need to allocate space for the serialized output.
+  Header = AllocateZeroPool( TotalSize );
+  if (Header == NULL)
+  {
+    return NULL;
+  }
+
+  //
+  // Alright, let's start setting up some data.
+  Header->Version         = UNIT_TEST_PERSISTENCE_LIB_VERSION;
+  Header->FingerprintAlgorithm = UNIT_TEST_FINGERPRINT_ALGORITHM;
+  Header->BlobSize        = TotalSize;
+  Header->Compression     = UNIT_TEST_SAVE_COMPRESSION_NONE;
+  Header->ExpandedSize    = TotalSize;
+  CopyMem( &Header->Fingerprint[0], &Framework->Fingerprint[0], UNIT_TEST_FINGERPRINT_SIZE );
+  CopyMem( &Header->StartTime, &Framework->StartTime, sizeof( EFI_TIME ) );
+  Header->TestCount       = TestCount;
+  Header->HasSavedContext = FALSE;
+  Header->BootIsDirty     = Framework->BootIsDirty;
+  Header->CleanBootTestCount   = Framework->CleanBootTestCount;
+  Header->CleanBootRebootCount = Framework->CleanBootRebootCount;
+
+  //
+  // Start adding all of the test cases.
+  // Set the floating pointer to the start of the current test save buffer.
+  FloatingPointer = (UINT8*)Header + sizeof( UNIT_TEST_SAVE_HEADER );
+  // Iterate all suites.
+  SuiteListHead = &Framework->TestSuiteList;
+  for (Suite = GetFirstNode( SuiteListHead ); Suite != SuiteListHead; Suite = GetNextNode( SuiteListHead, Suite ))
+  {
+    // Iterate all tests within the suite.
+    TestListHead = &((UNIT_TEST_SUITE_LIST_ENTRY*)Suite)->UTS.TestCaseList;
+    for (Test = GetFirstNode( TestListHead ); Test != TestListHead; Test = GetNextNode( TestListHead, Test ))
+    {
+      UnitTest      = &((UNIT_TEST_LIST_ENTRY*)Test)->UT;
+      if (ChangedOnly && !HasTestChangedSinceSave( Framework, UnitTest ))
+      {
+        continue;
+      }
+      TestSaveData  = (UNIT_TEST_SAVE_TEST*)FloatingPointer;
+      
+      // Save the fingerprint.
+      CopyMem( &TestSaveData->Fingerprint[0], &UnitTest->Fingerprint[0], UNIT_TEST_FINGERPRINT_SIZE );
+      
+      // Save the result.
+      TestSaveData->Result = UnitTest->Result;
+
+      // Save the durations.
+      TestSaveData->PreReqDuration  = UnitTest->PreReqDuration;
+      TestSaveData->RunDuration     = UnitTest->RunDuration;
+      TestSaveData->CleanUpDuration = UnitTest->CleanUpDuration;
+
+      // Save the benchmark statistics. Everything else leaves them zeroed.
+      if (UnitTest->Benchmark != NULL)
+      {
+        TestSaveData->BenchmarkSamples            = UnitTest->Benchmark->Samples;
+        TestSaveData->BenchmarkOpsPerSample       = UnitTest->Benchmark->OpsPerSample;
+        TestSaveData->BenchmarkMinPicoSeconds     = UnitTest->Benchmark->MinPicoSeconds;
+        TestSaveData->BenchmarkMedianPicoSeconds  = UnitTest->Benchmark->MedianPicoSeconds;
+        TestSaveData->BenchmarkP99PicoSeconds     = UnitTest->Benchmark->P99PicoSeconds;
+        TestSaveData->BenchmarkMaxPicoSeconds     = UnitTest->Benchmark->MaxPicoSeconds;
+        TestSaveData->BenchmarkMeanPicoSeconds    = UnitTest->Benchmark->MeanPicoSeconds;
+      }
+      
+      // If there is a log, save the log.
+      FloatingPointer += sizeof( UNIT_TEST_SAVE_TEST );
+      if (UnitTest->Log.Head != NULL)
+      {
+        // Walk the chunks straight into the blob.
+        for (LogChunk = UnitTest->Log.Head; LogChunk != NULL; LogChunk = LogChunk->Next)
+        {
+          LogSize = LogChunk->Length * sizeof( CHAR16 );
+          CopyMem( FloatingPointer, LogChunk->Buffer, LogSize );
+          FloatingPointer += LogSize;
+        }
+        // Can't forget the NULL character. (The blob is zeroed, but be explicit.)
+        *(CHAR16*)FloatingPointer = L'\0';
+        FloatingPointer += sizeof( CHAR16 );
+      }
+
+      // Update the size once the structure is complete.
+      // NOTE: Should thise be a straight cast without validation?
+      //       Maybe.
+      //       Am I tired of writing code?
+      //       Yes.
+      TestSaveData->Size = (UINT32)(FloatingPointer - (UINT8*)TestSaveData);
+
+      // Assume the save will make it. If it doesn't, the next one starts the cache over.
+      UnitTest->SavedResult     = UnitTest->Result;
+      UnitTest->SavedLogLength  = UnitTest->Log.Length;
+    }
+  }
+
+  //
+  // If there is a context to save, let's do that now.
+  if (ContextToSave != NULL && Framework->CurrentTest != NULL)
+  {
+    TestSaveContext         = (UNIT_TEST_SAVE_CONTEXT*)FloatingPointer;
+    TestSaveContext->Size   = (UINT32)ContextToSaveSize;
+    CopyMem( &TestSaveContext->Fingerprint[0], &Framework->CurrentTest->Fingerprint[0], UNIT_TEST_FINGERPRINT_SIZE );
+    CopyMem( ((UINT8*)TestSaveContext + sizeof( UNIT_TEST_SAVE_CONTEXT )), ContextToSave, ContextToSaveSize );
+    Header->HasSavedContext = TRUE;
+  }
+
+  return Header;
+}
+
+
+STATIC
+EFI_STATUS
+SetUsbBootNext (
+  VOID
+  )
+{
+  EFI_STATUS  Status;
+  UINT16      BootOptionIndex;
+  CHAR16      BootOptionName[] = L"Boot0000";
+  UINT8       *OptionBuffer = NULL;
+  UINTN       OptionBufferSize = 0, VariableSize = 0;
+  BOOLEAN     IsUsbOptionFound = FALSE;
+
+  //
+  // Walk through each of the first 10 boot options looking for the
+  // generic USB boot option.
+  for (BootOptionIndex = 0; BootOptionIndex < 10; BootOptionIndex++)
+  {
+    // Construct the BootOption name for this boot option.
+    // Do this by altering the last character of the name.
+    BootOptionName[7] = L'0' + BootOptionIndex;
+
+    // Attempt to retrieve the option.
+    DEBUG(( DEBUG_VERBOSE, "%a - Checking for %s...\n", __FUNCTION__, BootOptionName ));
+    VariableSize = OptionBufferSize;
+    Status = gRT->GetVariable( BootOptionName,
+                               &gEfiGlobalVariableGuid,
+                               NULL,
+                               &VariableSize,
+                               OptionBuffer );
+    // If we need a larger buffer, let's do that now.
+    if (Status == EFI_BUFFER_TOO_SMALL)
+    {
+      // Free the existing buffer.
+      if (OptionBuffer != NULL)
+      {
+        FreePool( OptionBuffer );
+      }
+      // Allocate a larger buffer.
+      OptionBuffer = AllocatePool( VariableSize );
+      // If you fail to... we've gotta get out of here.
+      if (OptionBuffer == NULL)
+      {
+        return EFI_OUT_OF_RESOURCES;
+      }
+      OptionBufferSize = VariableSize;
+
+      // Now that we've got a larger buffer, try that again.
+      Status = gRT->GetVariable( BootOptionName,
+                                 &gEfiGlobalVariableGuid,
+                                 NULL,
+                                 &VariableSize,
+                                 OptionBuffer );
+    }
+
+    // If we failed to retrieve this option... move on with your life.
+    if (EFI_ERROR( Status ))
+    {
+      DEBUG(( DEBUG_VERBOSE, "%a - Failed to locate option. Moving on.\n", __FUNCTION__ ));
+      continue;
+    }
+
+    // If we found the option, check to see whether this is the generic USB option.
+    // For now... we're lazy... just check the last four bytes (which should be the
+    // optional data) and see whether it's "USB".
+    if (VariableSize > 4 &&
+        OptionBuffer[VariableSize - 4] == 'U' && OptionBuffer[VariableSize - 3] == 'S' &&
+        OptionBuffer[VariableSize - 2] == 'B' && OptionBuffer[VariableSize - 1] == 0x00 )
+    {
+      IsUsbOptionFound = TRUE;
+      break;
+    }
+  }
+
+  //
+  // If the correct boot option was found,
+  // set it to the BootNext variable.
+  if (IsUsbOptionFound)
+  {
+    Status = gRT->SetVariable( L"BootNext",
+                               &gEfiGlobalVariableGuid,
+                               (EFI_VARIABLE_BOOTSERVICE_ACCESS | EFI_VARIABLE_RUNTIME_ACCESS | EFI_VARIABLE_NON_VOLATILE),
+                               sizeof( BootOptionIndex ),
+                               &BootOptionIndex );
+  }
+  else
+  {
+    DEBUG(( DEBUG_WARN, "%a - Could not find generic USB boot option.\n", __FUNCTION__ ));
+    Status = EFI_NOT_FOUND;
+  }
+
+  // Always put away your toys.
+  if (OptionBuffer != NULL)
+  {
+    FreePool( OptionBuffer );
+  }
+
+  return Status;  
+} // SetUsbBootNext()
+
+
+EFI_STATUS
+EFIAPI
+SaveFrameworkState (
+  IN UNIT_TEST_FRAMEWORK_HANDLE FrameworkHandle,
+  IN UNIT_TEST_CONTEXT          ContextToSave     OPTIONAL,
+  IN UINTN                      ContextToSaveSize
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK         *Framework;
+  UNIT_TEST_SAVE_HEADER       *Header = NULL;
+
+  //
+  // First, let's not make assumptions about the parameters.
+  // You gotta call shenanigans in a hurry, son.
+  if (FrameworkHandle == NULL || (ContextToSave != NULL && ContextToSaveSize == 0) ||
+      ContextToSaveSize > MAX_UINT32)
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // Whatever has been folded into the baseline so far has to survive a reboot, too.
+  SavePerformanceBaseline( (UNIT_TEST_FRAMEWORK*)FrameworkHandle );
+
+  //
+  // Now, let's package up all the data for saving.
+  // Once the cache has everything in it, each save only needs to append what's changed.
+  Framework = (UNIT_TEST_FRAMEWORK*)FrameworkHandle;
+  Header = SerializeState( FrameworkHandle, ContextToSave, ContextToSaveSize, Framework->CacheIsJournaled );
+  if (Header == NULL)
+  {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  //
+  // All that should be left to do is save it using the associated persistence lib.
+  // If appending isn't supported, fall back to rewriting the whole cache from now on.
+  Status = EFI_UNSUPPORTED;
+  if (Framework->CacheIsJournaled)
+  {
+    Status = AppendUnitTestCache( FrameworkHandle, Header );
+    if (Status == EFI_UNSUPPORTED)
+    {
+      FreePool( Header );
+      Framework->CacheIsJournaled = FALSE;
+      Header = SerializeState( FrameworkHandle, ContextToSave, ContextToSaveSize, FALSE );
+      if (Header == NULL)
+      {
+        return EFI_OUT_OF_RESOURCES;
+      }
+    }
+  }
+  if (!Framework->CacheIsJournaled)
+  {
+    Status = SaveUnitTestCache( FrameworkHandle, Header );
+  }
+  if (EFI_ERROR( Status ))
+  {
+    DEBUG(( DEBUG_ERROR, "%a - Could not save state! %r\n", __FUNCTION__, Status ));
+    Status = EFI_DEVICE_ERROR;
+  }
+  //
+  // Only a cache that's known to be complete can be appended to.
+  Framework->CacheIsJournaled = !EFI_ERROR( Status );
+
+  //
+  // Free data that was used.
+  FreePool( Header );
+
+  return Status;
+} // SaveFrameworkState()
+
+
+/**
+  NOTE: Nothing runs after a successful gBS->Exit(), so the framework is freed
+        first. Once the state has been saved, the framework is gone, even if
+        this returns EFI_ABORTED because the exit didn't happen. The handle
+        must not be used again. Any other error means that nothing was saved
+        and the framework is still valid.
+
+**/
+EFI_STATUS
+EFIAPI
+SaveFrameworkStateAndQuit (
+  IN UNIT_TEST_FRAMEWORK_HANDLE FrameworkHandle,
+  IN UNIT_TEST_CONTEXT          ContextToSave     OPTIONAL,
+  IN UINTN                      ContextToSaveSize
+  )
+{
+  EFI_STATUS                  Status;
+
+  //
+  // First, let's not make assumptions about the parameters.
+  // You gotta call shenanigans in a hurry, son.
+  if (FrameworkHandle == NULL)
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // Now, save all the data associated with this framework.
+  Status = SaveFrameworkState( FrameworkHandle, ContextToSave, ContextToSaveSize );
+
+  //
+  // If we're all good, let's book...
+  if (!EFI_ERROR( Status ))
+  {
+    //
+    // Free data that was used.
+    FreeUnitTestFramework( (UNIT_TEST_FRAMEWORK*)FrameworkHandle );
+
+    //
+    // Quit like a champ!
+    gBS->Exit( gImageHandle, EFI_SUCCESS, 0, NULL );
+    DEBUG(( DEBUG_ERROR, "%a - Unit test failed to quit! Framework can no longer be used!\n", __FUNCTION__ ));
+
+    //
+    // We REALLY shouldn't be here.
+    Status = EFI_ABORTED;
+  }
+
+  return Status;
+} // SaveFrameworkStateAndQuit()
+
+
+/**
+  NOTE: Takes in a ResetType, but currently only supports EfiResetCold
+        and EfiResetWarm. All other types will return EFI_INVALID_PARAMETER.
+        If a more specific reset is required, use SaveFrameworkState() and
+        call gRT->ResetSystem() directly.
+
+  NOTE: The framework is not freed on the way down. If this returns at all,
+        the framework is still valid. EFI_ABORTED means that the state was
+        saved, but the reset didn't happen.
+
+**/
+EFI_STATUS
+EFIAPI
+SaveFrameworkStateAndReboot (
+  IN UNIT_TEST_FRAMEWORK_HANDLE FrameworkHandle,
+  IN UNIT_TEST_CONTEXT          ContextToSave     OPTIONAL,
+  IN UINTN                      ContextToSaveSize,
+  IN EFI_RESET_TYPE             ResetType
+  )
+{
+  EFI_STATUS                  Status;
+  BOOLEAN                     BootIsDirty;
+
+  //
+  // First, let's not make assumptions about the parameters.
+  // You gotta call shenanigans in a hurry, son.
+  if (FrameworkHandle == NULL ||
+      (ResetType != EfiResetCold && ResetType != EfiResetWarm))
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // Now, save all the data associated with this framework.
+  // Whatever has been done to this boot will be gone when we're back.
+  BootIsDirty = ((UNIT_TEST_FRAMEWORK*)FrameworkHandle)->BootIsDirty;
+  ((UNIT_TEST_FRAMEWORK*)FrameworkHandle)->BootIsDirty = FALSE;
+  Status = SaveFrameworkState( FrameworkHandle, ContextToSave, ContextToSaveSize );
+  ((UNIT_TEST_FRAMEWORK*)FrameworkHandle)->BootIsDirty = BootIsDirty;
+
+  //
+  // If we're all good, let's book...
+  if (!EFI_ERROR( Status ))
+  {
+    //
+    // Next, we want to update the BootNext variable to USB
+    // so that we have a fighting chance of coming back here.
+    // NOTE: TODO: This is *very* shell-specific and should be refactored
+    //             before any integration into driver unit tests.
+    SetUsbBootNext();
+
+    //
+    // Let go of anything the persistence lib is holding open, like the cache file.
+    // The framework itself is left alone. The reset takes it with everything else,
+    // and if the reset doesn't happen, the caller still has a framework to work with.
+    CloseUnitTestPersistence( FrameworkHandle );
+
+    //
+    // Reset like a champ!
+    gRT->ResetSystem( ResetType, EFI_SUCCESS, 0, NULL );
+    DEBUG(( DEBUG_ERROR, "%a - Unit test failed to reboot!\n", __FUNCTION__ ));
+
+    //
+    // We REALLY shouldn't be here.
+    Status = EFI_ABORTED;
+  }
+
+  return Status;
+} // SaveFrameworkStateAndReboot()
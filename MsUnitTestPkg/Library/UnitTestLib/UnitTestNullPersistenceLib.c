@@ -1,92 +1,181 @@
-/** @file -- UnitTestNullPersistenceLib.c
-This is an instance of the Unit Test Persistence Lib that does nothing.
-
-THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
-AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
-IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
-ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
-LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
-CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
-SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
-INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
-CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
-ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
-THE POSSIBILITY OF SUCH DAMAGE.
-
-Copyright (C) 2016 Microsoft Corporation. All Rights Reserved.
-
-**/
-
-#include <Library/UnitTestLib.h>
-#include <Library/DebugLib.h>
-
-#include "UnitTestPersistenceLib.h"
-
-
-/**
-  Determines whether a persistence cache already exists for
-  the given framework.
-
-  @param[in]  FrameworkHandle   A pointer to the framework that is being persisted.
-
-  @retval     TRUE
-  @retval     FALSE   Cache doesn't exist or an error occurred.
-
-**/
-BOOLEAN
-EFIAPI
-DoesCacheExist (
-  IN  UNIT_TEST_FRAMEWORK_HANDLE  FrameworkHandle
-  )
-{
-  return FALSE;
-} // DoesCacheExist()
-
-
-/**
-  Will save the data associated with an internal Unit Test Framework
-  state in a manner that can persist a Unit Test Application quit or
-  even a system reboot.
-
-  @param[in]  FrameworkHandle   A pointer to the framework that is being persisted.
-  @param[in]  SaveData          A pointer to the buffer containing the serialized
-                                framework internal state.
-
-  @retval     EFI_SUCCESS   Data is persisted and the test can be safely quit.
-  @retval     Others        Data is not persisted and test cannot be resumed upon exit.
-
-**/
-EFI_STATUS
-EFIAPI
-SaveUnitTestCache (
-  IN  UNIT_TEST_FRAMEWORK_HANDLE  FrameworkHandle,
-  IN  UNIT_TEST_SAVE_HEADER       *SaveData
-  )
-{
-  return EFI_UNSUPPORTED;
-} // SaveUnitTestCache()
-
-
-/**
-  Will retrieve any cached state associated with the given framework.
-  Will allocate a buffer to hold the loaded data.
-
-  @param[in]  FrameworkHandle   A pointer to the framework that is being persisted.
-  @param[in]  SaveData          A pointer pointer that will be updated with the address
-                                of the loaded data buffer.
-
-  @retval     EFI_SUCCESS       Data has been loaded successfully and SaveData is updated
-                                with a pointer to the buffer.
-  @retval     Others            An error has occurred and no data has been loaded. SaveData
-                                is set to NULL.
-
-**/
-EFI_STATUS
-EFIAPI
-LoadUnitTestCache (
-  IN  UNIT_TEST_FRAMEWORK_HANDLE  FrameworkHandle,
-  OUT UNIT_TEST_SAVE_HEADER       **SaveData
-  )
-{
-  return EFI_UNSUPPORTED;
-} // LoadUnitTestCache()
+/** @file -- UnitTestNullPersistenceLib.c
+This is an instance of the Unit Test Persistence Lib that does nothing.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+
+Copyright (C) 2016 Microsoft Corporation. All Rights Reserved.
+
+**/
+
+#include <Library/UnitTestLib.h>
+#include <Library/DebugLib.h>
+
+#include "UnitTestPersistenceLib.h"
+
+
+/**
+  Determines whether a persistence cache already exists for
+  the given framework.
+
+  @param[in]  FrameworkHandle   A pointer to the framework that is being persisted.
+
+  @retval     TRUE
+  @retval     FALSE   Cache doesn't exist or an error occurred.
+
+**/
+BOOLEAN
+EFIAPI
+DoesCacheExist (
+  IN  UNIT_TEST_FRAMEWORK_HANDLE  FrameworkHandle
+  )
+{
+  return FALSE;
+} // DoesCacheExist()
+
+
+/**
+  Will save the data associated with an internal Unit Test Framework
+  state in a manner that can persist a Unit Test Application quit or
+  even a system reboot.
+
+  @param[in]  FrameworkHandle   A pointer to the framework that is being persisted.
+  @param[in]  SaveData          A pointer to the buffer containing the serialized
+                                framework internal state.
+
+  @retval     EFI_SUCCESS   Data is persisted and the test can be safely quit.
+  @retval     Others        Data is not persisted and test cannot be resumed upon exit.
+
+**/
+EFI_STATUS
+EFIAPI
+SaveUnitTestCache (
+  IN  UNIT_TEST_FRAMEWORK_HANDLE  FrameworkHandle,
+  IN  UNIT_TEST_SAVE_HEADER       *SaveData
+  )
+{
+  return EFI_UNSUPPORTED;
+} // SaveUnitTestCache()
+
+
+/**
+  Will add a save to the end of the existing cache. SaveData only carries the
+  tests that have changed since the last save. Only used once the cache holds
+  a complete save from SaveUnitTestCache() or LoadUnitTestCache().
+
+  @param[in]  FrameworkHandle   A pointer to the framework that is being persisted.
+  @param[in]  SaveData          A pointer to the buffer containing the changes.
+
+  @retval     EFI_SUCCESS       Data is persisted and the test can be safely quit.
+  @retval     EFI_UNSUPPORTED   The cache can only be saved whole. Use SaveUnitTestCache().
+  @retval     Others            Data is not persisted and test cannot be resumed upon exit.
+
+**/
+EFI_STATUS
+EFIAPI
+AppendUnitTestCache (
+  IN  UNIT_TEST_FRAMEWORK_HANDLE  FrameworkHandle,
+  IN  UNIT_TEST_SAVE_HEADER       *SaveData
+  )
+{
+  return EFI_UNSUPPORTED;
+} // AppendUnitTestCache()
+
+
+/**
+  Will retrieve any cached state associated with the given framework.
+  Will allocate a buffer to hold the loaded data.
+
+  @param[in]  FrameworkHandle   A pointer to the framework that is being persisted.
+  @param[in]  SaveData          A pointer pointer that will be updated with the address
+                                of the loaded data buffer.
+
+  @retval     EFI_SUCCESS       Data has been loaded successfully and SaveData is updated
+                                with a pointer to the buffer.
+  @retval     Others            An error has occurred and no data has been loaded. SaveData
+                                is set to NULL.
+
+**/
+EFI_STATUS
+EFIAPI
+LoadUnitTestCache (
+  IN  UNIT_TEST_FRAMEWORK_HANDLE  FrameworkHandle,
+  OUT UNIT_TEST_SAVE_HEADER       **SaveData
+  )
+{
+  return EFI_UNSUPPORTED;
+} // LoadUnitTestCache()
+
+
+/**
+  Will save the performance baseline for the given framework. Unlike the
+  cache, the baseline is meant to stay around from one run to the next.
+
+  @param[in]  FrameworkHandle   A pointer to the framework that the baseline belongs to.
+  @param[in]  Baseline          A pointer to the serialized baseline.
+
+  @retval     EFI_SUCCESS   The baseline is persisted.
+  @retval     Others        The baseline is not persisted.
+
+**/
+EFI_STATUS
+EFIAPI
+SaveUnitTestBaseline (
+  IN  UNIT_TEST_FRAMEWORK_HANDLE  FrameworkHandle,
+  IN  UNIT_TEST_BASELINE_HEADER   *Baseline
+  )
+{
+  return EFI_UNSUPPORTED;
+} // SaveUnitTestBaseline()
+
+
+/**
+  Will retrieve the performance baseline for the given framework, if there is one.
+  Will allocate a buffer to hold the loaded data.
+
+  @param[in]  FrameworkHandle   A pointer to the framework that the baseline belongs to.
+  @param[in]  Baseline          A pointer pointer that will be updated with the address
+                                of the loaded data buffer.
+
+  @retval     EFI_SUCCESS       The baseline has been loaded and Baseline is updated with
+                                a pointer to the buffer. At least BlobSize bytes were read.
+  @retval     Others            There is no baseline or it couldn't be loaded. Baseline is
+                                set to NULL.
+
+**/
+EFI_STATUS
+EFIAPI
+LoadUnitTestBaseline (
+  IN  UNIT_TEST_FRAMEWORK_HANDLE  FrameworkHandle,
+  OUT UNIT_TEST_BASELINE_HEADER   **Baseline
+  )
+{
+  *Baseline = NULL;
+  return EFI_UNSUPPORTED;
+} // LoadUnitTestBaseline()
+
+
+/**
+  Lets go of anything the persistence lib has been holding on to for the
+  given framework between calls. Called when the framework is freed.
+
+  @param[in]  FrameworkHandle   A pointer to the framework that is being persisted.
+
+**/
+VOID
+EFIAPI
+CloseUnitTestPersistence (
+  IN  UNIT_TEST_FRAMEWORK_HANDLE  FrameworkHandle
+  )
+{
+  return;
+} // CloseUnitTestPersistence()
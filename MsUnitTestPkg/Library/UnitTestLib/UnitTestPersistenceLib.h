@@ -1,120 +1,259 @@
-/** @file -- UnitTestPersistenceLib.h
-This header file describes a library that contains functions to save and
-restore unit test internal state, in case the test needs to pause and resume
-(eg. a reboot-based test).
-
-THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
-AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
-IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
-ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
-LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
-CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
-SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
-INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
-CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
-ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
-THE POSSIBILITY OF SUCH DAMAGE.
-
-
-Copyright (C) 2016 Microsoft Corporation. All Rights Reserved.
-
-**/
-
-#ifndef _UNIT_TEST_PERSISTENCE_LIB_H_
-#define _UNIT_TEST_PERSISTENCE_LIB_H_
-
-#define UNIT_TEST_PERSISTENCE_LIB_VERSION   1
-
-#pragma pack (1)
-
-typedef struct
-{
-  UINT32            Size;
-  UINT8             Fingerprint[UNIT_TEST_FINGERPRINT_SIZE];      // Fingerprint of the test itself.
-  UNIT_TEST_STATUS  Result;
-  // CHAR16            Log[];
-} UNIT_TEST_SAVE_TEST;
-
-typedef struct
-{
-  UINT32            Size;
-  UINT8             Fingerprint[UNIT_TEST_FINGERPRINT_SIZE];      // Fingerprint of the corresponding test.
-  // UINT8          Data[];                                       // Actual data of the context.
-} UNIT_TEST_SAVE_CONTEXT;
-
-typedef struct
-{
-  UINT8             Version;
-  UINT32            BlobSize;
-  UINT8             Fingerprint[UNIT_TEST_FINGERPRINT_SIZE];      // Fingerprint of the framework that has been saved.
-  EFI_TIME          StartTime;
-  UINT32            TestCount;
-  BOOLEAN           HasSavedContext;
-  // UNIT_TEST_SAVE_TEST    Tests[];                              // Array of structures starts here.
-  // UNIT_TEST_SAVE_CONTEXT SavedContext[];                       // Saved context for the currently running test.
-  // CHAR16                 Log[];                                // NOTE: Not yet implemented!!
-} UNIT_TEST_SAVE_HEADER;
-
-#pragma pack ()
-
-
-/**
-  Determines whether a persistence cache already exists for
-  the given framework.
-
-  @param[in]  FrameworkHandle   A pointer to the framework that is being persisted.
-
-  @retval     TRUE
-  @retval     FALSE   Cache doesn't exist or an error occurred.
-
-**/
-BOOLEAN
-EFIAPI
-DoesCacheExist (
-  IN  UNIT_TEST_FRAMEWORK_HANDLE  FrameworkHandle
-  );
-
-
-/**
-  Will save the data associated with an internal Unit Test Framework
-  state in a manner that can persist a Unit Test Application quit or
-  even a system reboot.
-
-  @param[in]  FrameworkHandle   A pointer to the framework that is being persisted.
-  @param[in]  SaveData          A pointer to the buffer containing the serialized
-                                framework internal state.
-
-  @retval     EFI_SUCCESS   Data is persisted and the test can be safely quit.
-  @retval     Others        Data is not persisted and test cannot be resumed upon exit.
-
-**/
-EFI_STATUS
-EFIAPI
-SaveUnitTestCache (
-  IN  UNIT_TEST_FRAMEWORK_HANDLE  FrameworkHandle,
-  IN  UNIT_TEST_SAVE_HEADER       *SaveData
-  );
-
-
-/**
-  Will retrieve any cached state associated with the given framework.
-  Will allocate a buffer to hold the loaded data.
-
-  @param[in]  FrameworkHandle   A pointer to the framework that is being persisted.
-  @param[in]  SaveData          A pointer pointer that will be updated with the address
-                                of the loaded data buffer.
-
-  @retval     EFI_SUCCESS       Data has been loaded successfully and SaveData is updated
-                                with a pointer to the buffer.
-  @retval     Others            An error has occurred and no data has been loaded. SaveData
-                                is set to NULL.
-
-**/
-EFI_STATUS
-EFIAPI
-LoadUnitTestCache (
-  IN  UNIT_TEST_FRAMEWORK_HANDLE  FrameworkHandle,
-  OUT UNIT_TEST_SAVE_HEADER       **SaveData
-  );
-
-#endif // _UNIT_TEST_PERSISTENCE_LIB_H_
+/** @file -- UnitTestPersistenceLib.h
+This header file describes a library that contains functions to save and
+restore unit test internal state, in case the test needs to pause and resume
+(eg. a reboot-based test).
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+
+
+Copyright (C) 2016 Microsoft Corporation. All Rights Reserved.
+
+**/
+
+#ifndef _UNIT_TEST_PERSISTENCE_LIB_H_
+#define _UNIT_TEST_PERSISTENCE_LIB_H_
+
+#define UNIT_TEST_PERSISTENCE_LIB_VERSION   6
+#define UNIT_TEST_BASELINE_VERSION          1
+
+#pragma pack (1)
+
+typedef struct
+{
+  UINT32            Size;
+  UINT8             Fingerprint[UNIT_TEST_FINGERPRINT_SIZE];      // Fingerprint of the test itself.
+  UNIT_TEST_STATUS  Result;
+  UINT64            PreReqDuration;                               // Accumulated durations, in nanoseconds.
+  UINT64            RunDuration;
+  UINT64            CleanUpDuration;
+  UINT32            BenchmarkSamples;                             // Zero unless this is a benchmark that has run.
+  UINT32            BenchmarkOpsPerSample;
+  UINT64            BenchmarkMinPicoSeconds;                      // Per call.
+  UINT64            BenchmarkMedianPicoSeconds;
+  UINT64            BenchmarkP99PicoSeconds;
+  UINT64            BenchmarkMaxPicoSeconds;
+  UINT64            BenchmarkMeanPicoSeconds;
+  // CHAR16            Log[];
+} UNIT_TEST_SAVE_TEST;
+
+typedef struct
+{
+  UINT32            Size;
+  UINT8             Fingerprint[UNIT_TEST_FINGERPRINT_SIZE];      // Fingerprint of the corresponding test.
+  // UINT8          Data[];                                       // Actual data of the context.
+} UNIT_TEST_SAVE_CONTEXT;
+
+typedef struct
+{
+  UINT8             Version;
+  UINT8             FingerprintAlgorithm;                         // PcdUnitTestFingerprintAlgorithm of the build that saved this.
+  UINT8             Compression;                                  // UNIT_TEST_SAVE_COMPRESSION_* for everything after the header.
+  UINT8             Reserved;                                     // Keeps the logs that follow CHAR16-aligned.
+  UINT32            BlobSize;
+  UINT32            ExpandedSize;                                 // What BlobSize will be once expanded.
+  UINT8             Fingerprint[UNIT_TEST_FINGERPRINT_SIZE];      // Fingerprint of the framework that has been saved.
+  EFI_TIME          StartTime;
+  UINT32            TestCount;
+  BOOLEAN           HasSavedContext;
+  BOOLEAN           BootIsDirty;                                  // FALSE if the save was made on the way to a reboot.
+  UINT32            CleanBootTestCount;
+  UINT32            CleanBootRebootCount;
+  // UNIT_TEST_SAVE_TEST    Tests[];                              // Array of structures starts here.
+  // UNIT_TEST_SAVE_CONTEXT SavedContext[];                       // Saved context for the currently running test.
+  // CHAR16                 Log[];                                // NOTE: Not yet implemented!!
+} UNIT_TEST_SAVE_HEADER;
+
+//
+// A cache may hold several saves back to back, each with its own header. The first is
+// complete, and each one after it only has the tests that changed since the one before.
+// LoadUnitTestCache() merges them into a single save, where the last record for each test
+// wins and everything in the header (including any saved context) comes from the last save.
+//
+// Each save may be compressed on its own when it's stored (see PcdUnitTestCompressSavedState).
+// The header never is, so the saves can still be walked with BlobSize. Compressing and
+// expanding is entirely up to the persistence lib: UnitTestLib only ever hands over saves
+// with UNIT_TEST_SAVE_COMPRESSION_NONE, and LoadUnitTestCache() must return one the same.
+//
+// Values for UNIT_TEST_SAVE_HEADER.Compression. These are written to storage, so they must
+// never be renumbered.
+//
+#define UNIT_TEST_SAVE_COMPRESSION_NONE   0
+#define UNIT_TEST_SAVE_COMPRESSION_LZ     1
+
+//
+// Performance baselines are kept apart from the saved state, since they have to outlive it.
+// Each entry holds rolling statistics for one test's passing runs: RunDuration in nanoseconds
+// for ordinary tests, or the median in picoseconds per call for benchmarks.
+//
+typedef struct
+{
+  UINT8             Fingerprint[UNIT_TEST_FINGERPRINT_SIZE];      // Fingerprint of the test.
+  UINT32            Runs;                                         // Passing runs folded in so far. Saturates.
+  UINT64            Mean;                                         // Rolling mean. See UpdatePerformanceBaseline().
+  UINT64            Min;
+  UINT64            Max;
+} UNIT_TEST_BASELINE_ENTRY;
+
+typedef struct
+{
+  UINT8             Version;
+  UINT8             FingerprintAlgorithm;                         // PcdUnitTestFingerprintAlgorithm of the build that saved this.
+  UINT32            BlobSize;
+  UINT32            EntryCount;
+  // UNIT_TEST_BASELINE_ENTRY Entries[];                          // Array of structures starts here.
+} UNIT_TEST_BASELINE_HEADER;
+
+#pragma pack ()
+
+
+/**
+  Determines whether a persistence cache already exists for
+  the given framework.
+
+  @param[in]  FrameworkHandle   A pointer to the framework that is being persisted.
+
+  @retval     TRUE
+  @retval     FALSE   Cache doesn't exist or an error occurred.
+
+**/
+BOOLEAN
+EFIAPI
+DoesCacheExist (
+  IN  UNIT_TEST_FRAMEWORK_HANDLE  FrameworkHandle
+  );
+
+
+/**
+  Will save the data associated with an internal Unit Test Framework
+  state in a manner that can persist a Unit Test Application quit or
+  even a system reboot.
+
+  @param[in]  FrameworkHandle   A pointer to the framework that is being persisted.
+  @param[in]  SaveData          A pointer to the buffer containing the serialized
+                                framework internal state.
+
+  @retval     EFI_SUCCESS   Data is persisted and the test can be safely quit.
+  @retval     Others        Data is not persisted and test cannot be resumed upon exit.
+
+**/
+EFI_STATUS
+EFIAPI
+SaveUnitTestCache (
+  IN  UNIT_TEST_FRAMEWORK_HANDLE  FrameworkHandle,
+  IN  UNIT_TEST_SAVE_HEADER       *SaveData
+  );
+
+
+/**
+  Will add a save to the end of the existing cache. SaveData only carries the
+  tests that have changed since the last save. Only used once the cache holds
+  a complete save from SaveUnitTestCache() or LoadUnitTestCache().
+
+  @param[in]  FrameworkHandle   A pointer to the framework that is being persisted.
+  @param[in]  SaveData          A pointer to the buffer containing the changes.
+
+  @retval     EFI_SUCCESS       Data is persisted and the test can be safely quit.
+  @retval     EFI_UNSUPPORTED   The cache can only be saved whole. Use SaveUnitTestCache().
+  @retval     Others            Data is not persisted and test cannot be resumed upon exit.
+
+**/
+EFI_STATUS
+EFIAPI
+AppendUnitTestCache (
+  IN  UNIT_TEST_FRAMEWORK_HANDLE  FrameworkHandle,
+  IN  UNIT_TEST_SAVE_HEADER       *SaveData
+  );
+
+
+/**
+  Will retrieve any cached state associated with the given framework.
+  Will allocate a buffer to hold the loaded data.
+
+  @param[in]  FrameworkHandle   A pointer to the framework that is being persisted.
+  @param[in]  SaveData          A pointer pointer that will be updated with the address
+                                of the loaded data buffer.
+
+  @retval     EFI_SUCCESS             Data has been loaded successfully and SaveData is updated
+                                      with a pointer to the buffer. If the cache held more than
+                                      one save, they have been merged.
+  @retval     EFI_WARN_WRITE_FAILURE  Data has been loaded, but the merged saves could not be
+                                      written back. Nothing may be appended to the cache as it
+                                      is, so the next save must go to SaveUnitTestCache().
+  @retval     Others                  An error has occurred and no data has been loaded. SaveData
+                                      is set to NULL.
+
+**/
+EFI_STATUS
+EFIAPI
+LoadUnitTestCache (
+  IN  UNIT_TEST_FRAMEWORK_HANDLE  FrameworkHandle,
+  OUT UNIT_TEST_SAVE_HEADER       **SaveData
+  );
+
+
+/**
+  Will save the performance baseline for the given framework. Unlike the
+  cache, the baseline is meant to stay around from one run to the next.
+
+  @param[in]  FrameworkHandle   A pointer to the framework that the baseline belongs to.
+  @param[in]  Baseline          A pointer to the serialized baseline.
+
+  @retval     EFI_SUCCESS   The baseline is persisted.
+  @retval     Others        The baseline is not persisted.
+
+**/
+EFI_STATUS
+EFIAPI
+SaveUnitTestBaseline (
+  IN  UNIT_TEST_FRAMEWORK_HANDLE  FrameworkHandle,
+  IN  UNIT_TEST_BASELINE_HEADER   *Baseline
+  );
+
+
+/**
+  Will retrieve the performance baseline for the given framework, if there is one.
+  Will allocate a buffer to hold the loaded data.
+
+  @param[in]  FrameworkHandle   A pointer to the framework that the baseline belongs to.
+  @param[in]  Baseline          A pointer pointer that will be updated with the address
+                                of the loaded data buffer.
+
+  @retval     EFI_SUCCESS       The baseline has been loaded and Baseline is updated with
+                                a pointer to the buffer. At least BlobSize bytes were read.
+  @retval     Others            There is no baseline or it couldn't be loaded. Baseline is
+                                set to NULL.
+
+**/
+EFI_STATUS
+EFIAPI
+LoadUnitTestBaseline (
+  IN  UNIT_TEST_FRAMEWORK_HANDLE  FrameworkHandle,
+  OUT UNIT_TEST_BASELINE_HEADER   **Baseline
+  );
+
+
+/**
+  Lets go of anything the persistence lib has been holding on to for the
+  given framework between calls, such as an open cache file. Called when
+  the framework is freed.
+
+  @param[in]  FrameworkHandle   A pointer to the framework that is being persisted.
+
+**/
+VOID
+EFIAPI
+CloseUnitTestPersistence (
+  IN  UNIT_TEST_FRAMEWORK_HANDLE  FrameworkHandle
+  );
+
+#endif // _UNIT_TEST_PERSISTENCE_LIB_H_
@@ -0,0 +1,637 @@
+/** @file -- UnitTestVariablePersistenceLib.c
+This is an instance of the Unit Test Persistence Lib that will keep the
+serialized test state in non-volatile UEFI variables, so that it works
+without a writable filesystem next to the test app (such as when the
+tests are booted from read-only or network media).
+
+Anything larger than the platform will take in a single variable is split
+across numbered variables: "<ShortTitle>_Cache_0000", "<ShortTitle>_Cache_0001"
+and so on.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+
+Copyright (C) 2016 Microsoft Corporation. All Rights Reserved.
+
+**/
+
+#include <Library/UnitTestLib.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PcdLib.h>
+#include <Library/PrintLib.h>
+#include <Library/UefiRuntimeServicesTableLib.h>
+
+#include "UnitTestPersistenceLib.h"
+#include "Compress.h"
+
+//
+// Variables are named "<ShortTitle><Suffix>_<Index>", with a four-digit index.
+//
+#define UNIT_TEST_CACHE_VARIABLE_SUFFIX       L"_Cache"
+#define UNIT_TEST_BASELINE_VARIABLE_SUFFIX    L"_Baseline"
+#define UNIT_TEST_VARIABLE_INDEX_FORMAT       L"%s%s_%04d"
+#define UNIT_TEST_VARIABLE_INDEX_LENGTH       5       // "_0000"
+#define UNIT_TEST_VARIABLE_MAX_CHUNKS         10000
+
+#define UNIT_TEST_VARIABLE_ATTRIBUTES         (EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_BOOTSERVICE_ACCESS)
+
+//
+// Room left in each variable for the variable store's own header, which
+// QueryVariableInfo() counts against MaximumVariableSize along with the name.
+// Authenticated variable stores have the largest one.
+//
+#define UNIT_TEST_VARIABLE_HEADER_ALLOWANCE   (0x60)
+
+//
+// If the platform won't say how large a variable can be, this is small enough
+// for any variable store we know of.
+//
+#define UNIT_TEST_VARIABLE_DEFAULT_CHUNK_SIZE (0x400)
+
+
+/**
+  Allocates a buffer that's big enough for the name of any of the variables
+  for this file, without an index yet.
+
+  @retval     !NULL   A pool-allocated buffer of *NameSize bytes. Must be freed by the caller.
+  @retval     NULL    Out of resources.
+
+**/
+STATIC
+CHAR16*
+AllocateVariableName (
+  IN  UNIT_TEST_FRAMEWORK_HANDLE  FrameworkHandle,
+  IN  CONST CHAR16                *Suffix,
+  OUT UINTN                       *NameSize
+  )
+{
+  UNIT_TEST_FRAMEWORK   *Framework = (UNIT_TEST_FRAMEWORK*)FrameworkHandle;
+
+  *NameSize = StrSize( Framework->ShortTitle ) + StrLen( Suffix ) * sizeof( CHAR16 ) +
+              UNIT_TEST_VARIABLE_INDEX_LENGTH * sizeof( CHAR16 );
+  return AllocatePool( *NameSize );
+} // AllocateVariableName()
+
+
+/**
+  Works out how much of a blob can go in each variable on this platform.
+
+**/
+STATIC
+UINTN
+GetChunkSize (
+  IN  UINTN                       NameSize
+  )
+{
+  EFI_STATUS    Status;
+  UINT64        MaximumVariableStorageSize;
+  UINT64        RemainingVariableStorageSize;
+  UINT64        MaximumVariableSize;
+  UINTN         ChunkSize;
+
+  ChunkSize = UNIT_TEST_VARIABLE_DEFAULT_CHUNK_SIZE;
+
+  //
+  // QueryVariableInfo() is only in UEFI 2.0 and later.
+  if (gRT->Hdr.Revision >= EFI_2_00_SYSTEM_TABLE_REVISION)
+  {
+    Status = gRT->QueryVariableInfo( UNIT_TEST_VARIABLE_ATTRIBUTES,
+                                     &MaximumVariableStorageSize,
+                                     &RemainingVariableStorageSize,
+                                     &MaximumVariableSize );
+    if (!EFI_ERROR( Status ) && MaximumVariableSize > NameSize + UNIT_TEST_VARIABLE_HEADER_ALLOWANCE)
+    {
+      ChunkSize = (UINTN)MIN( MaximumVariableSize - NameSize - UNIT_TEST_VARIABLE_HEADER_ALLOWANCE, MAX_UINT32 );
+    }
+  }
+
+  //
+  // The platform can ask for smaller chunks than the variable store would take.
+  if (FixedPcdGet32( PcdUnitTestVariablePersistenceMaxChunkSize ) != 0)
+  {
+    ChunkSize = MIN( ChunkSize, FixedPcdGet32( PcdUnitTestVariablePersistenceMaxChunkSize ) );
+  }
+
+  return ChunkSize;
+} // GetChunkSize()
+
+
+/**
+  Writes chunk Index of a blob, or deletes it if Data is NULL.
+  Name is a buffer of NameSize bytes from AllocateVariableName().
+
+**/
+STATIC
+EFI_STATUS
+SetVariableChunk (
+  IN  UNIT_TEST_FRAMEWORK_HANDLE  FrameworkHandle,
+  IN  CONST CHAR16                *Suffix,
+  IN  CHAR16                      *Name,
+  IN  UINTN                       NameSize,
+  IN  UINTN                       Index,
+  IN  VOID                        *Data       OPTIONAL,
+  IN  UINTN                       DataSize
+  )
+{
+  EFI_STATUS    Status;
+
+  UnicodeSPrint( Name, NameSize, UNIT_TEST_VARIABLE_INDEX_FORMAT,
+                 ((UNIT_TEST_FRAMEWORK*)FrameworkHandle)->ShortTitle, Suffix, Index );
+  Status = gRT->SetVariable( Name,
+                             &gMsUnitTestPkgVariablePersistenceGuid,
+                             (Data != NULL) ? UNIT_TEST_VARIABLE_ATTRIBUTES : 0,
+                             (Data != NULL) ? DataSize : 0,
+                             Data );
+  if (EFI_ERROR( Status ) && Data != NULL)
+  {
+    DEBUG(( DEBUG_ERROR, "%a - Writing %s failed! %r\n", __FUNCTION__, Name, Status ));
+  }
+
+  return Status;
+} // SetVariableChunk()
+
+
+/**
+  Deletes chunk FirstIndex of a blob and onwards. Chunks are always
+  numbered from zero with no gaps, so the first one that isn't there is the end.
+
+**/
+STATIC
+VOID
+DeleteVariableChunks (
+  IN  UNIT_TEST_FRAMEWORK_HANDLE  FrameworkHandle,
+  IN  CONST CHAR16                *Suffix,
+  IN  CHAR16                      *Name,
+  IN  UINTN                       NameSize,
+  IN  UINTN                       FirstIndex
+  )
+{
+  UINTN         Index;
+
+  for (Index = FirstIndex; Index < UNIT_TEST_VARIABLE_MAX_CHUNKS; Index++)
+  {
+    if (EFI_ERROR( SetVariableChunk( FrameworkHandle, Suffix, Name, NameSize, Index, NULL, 0 ) ))
+    {
+      break;
+    }
+  }
+
+  return;
+} // DeleteVariableChunks()
+
+
+/**
+  Writes Size bytes of Data to "<ShortTitle><Suffix>_0000" and onwards, then
+  deletes any chunks that are left over from a larger blob.
+
+  The chunks are overwritten in place, so "_0000" is what marks the set as
+  complete: it is deleted before anything else is touched and written last.
+  ReadChunkedVariable() finds nothing without it. If a write fails, the rest
+  of the chunks are deleted too. Either way, a failure or a reset part way
+  through leaves no blob at all, never new chunks followed by old ones.
+
+**/
+STATIC
+EFI_STATUS
+WriteChunkedVariable (
+  IN  UNIT_TEST_FRAMEWORK_HANDLE  FrameworkHandle,
+  IN  CONST CHAR16                *Suffix,
+  IN  VOID                        *Data,
+  IN  UINTN                       Size
+  )
+{
+  EFI_STATUS    Status = EFI_SUCCESS;
+  CHAR16        *Name;
+  UINTN         NameSize, ChunkSize, ChunkCount, Index, Offset;
+  BOOLEAN       Started = FALSE;
+
+  Name = AllocateVariableName( FrameworkHandle, Suffix, &NameSize );
+  if (Name == NULL)
+  {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  ChunkSize   = GetChunkSize( NameSize );
+  ChunkCount  = (Size + ChunkSize - 1) / ChunkSize;
+  if (ChunkCount > UNIT_TEST_VARIABLE_MAX_CHUNKS)
+  {
+    DEBUG(( DEBUG_ERROR, "%a - %d bytes won't fit in %d variables of %d bytes.\n", __FUNCTION__,
+            Size, UNIT_TEST_VARIABLE_MAX_CHUNKS, ChunkSize ));
+    Status = EFI_BAD_BUFFER_SIZE;
+    goto Exit;
+  }
+
+  //
+  // If the first chunk can't be deleted, the old blob is still whole. Leave it be.
+  Status = SetVariableChunk( FrameworkHandle, Suffix, Name, NameSize, 0, NULL, 0 );
+  if (EFI_ERROR( Status ) && Status != EFI_NOT_FOUND)
+  {
+    DEBUG(( DEBUG_ERROR, "%a - Deleting %s failed! %r\n", __FUNCTION__, Name, Status ));
+    goto Exit;
+  }
+  Started = TRUE;
+
+  DEBUG(( DEBUG_INFO, "%a - Writing %d bytes in %d variables...\n", __FUNCTION__, Size, ChunkCount ));
+  for (Index = 1, Offset = ChunkSize; Index < ChunkCount; Index++, Offset += ChunkSize)
+  {
+    Status = SetVariableChunk( FrameworkHandle, Suffix, Name, NameSize, Index,
+                               (UINT8*)Data + Offset, MIN( ChunkSize, Size - Offset ) );
+    if (EFI_ERROR( Status ))
+    {
+      goto Exit;
+    }
+  }
+
+  //
+  // Clean up after a larger blob, then finish the set.
+  DeleteVariableChunks( FrameworkHandle, Suffix, Name, NameSize, ChunkCount );
+  Status = SetVariableChunk( FrameworkHandle, Suffix, Name, NameSize, 0, Data, MIN( ChunkSize, Size ) );
+  if (EFI_ERROR( Status ))
+  {
+    goto Exit;
+  }
+
+  DEBUG(( DEBUG_INFO, "%a - SUCCESS!\n", __FUNCTION__ ));
+
+Exit:
+  //
+  // Don't leave a partial set around to take up the variable store.
+  if (EFI_ERROR( Status ) && Started)
+  {
+    DeleteVariableChunks( FrameworkHandle, Suffix, Name, NameSize, 1 );
+  }
+  FreePool( Name );
+
+  return Status;
+} // WriteChunkedVariable()
+
+
+/**
+  Reads "<ShortTitle><Suffix>_0000" and onwards back into a single pool buffer.
+
+  @retval     EFI_SUCCESS   *Data points to a buffer of *Size bytes. Must be freed by the caller.
+  @retval     EFI_NOT_FOUND There are no chunks at all.
+  @retval     Others        Nothing was read. *Data is set to NULL.
+
+**/
+STATIC
+EFI_STATUS
+ReadChunkedVariable (
+  IN  UNIT_TEST_FRAMEWORK_HANDLE  FrameworkHandle,
+  IN  CONST CHAR16                *Suffix,
+  OUT VOID                        **Data,
+  OUT UINTN                       *Size
+  )
+{
+  EFI_STATUS    Status;
+  CHAR16        *Name;
+  UINTN         NameSize, Index, ChunkSize, BufferSize = 0;
+  UINT8         *Buffer = NULL, *NewBuffer;
+
+  *Data = NULL;
+  *Size = 0;
+
+  Name = AllocateVariableName( FrameworkHandle, Suffix, &NameSize );
+  if (Name == NULL)
+  {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  for (Index = 0; Index < UNIT_TEST_VARIABLE_MAX_CHUNKS; Index++)
+  {
+    UnicodeSPrint( Name, NameSize, UNIT_TEST_VARIABLE_INDEX_FORMAT,
+                   ((UNIT_TEST_FRAMEWORK*)FrameworkHandle)->ShortTitle, Suffix, Index );
+
+    //
+    // Find out how big this chunk is and make room for it on the end.
+    ChunkSize = 0;
+    Status = gRT->GetVariable( Name, &gMsUnitTestPkgVariablePersistenceGuid, NULL, &ChunkSize, NULL );
+    if (Status == EFI_NOT_FOUND)
+    {
+      break;
+    }
+    if (Status != EFI_BUFFER_TOO_SMALL)
+    {
+      DEBUG(( DEBUG_ERROR, "%a - Reading %s failed! %r\n", __FUNCTION__, Name, Status ));
+      goto Exit;
+    }
+
+    NewBuffer = ReallocatePool( BufferSize, BufferSize + ChunkSize, Buffer );
+    if (NewBuffer == NULL)
+    {
+      Status = EFI_OUT_OF_RESOURCES;
+      goto Exit;
+    }
+    Buffer = NewBuffer;
+
+    Status = gRT->GetVariable( Name, &gMsUnitTestPkgVariablePersistenceGuid, NULL, &ChunkSize, Buffer + BufferSize );
+    if (EFI_ERROR( Status ))
+    {
+      DEBUG(( DEBUG_ERROR, "%a - Reading %s failed! %r\n", __FUNCTION__, Name, Status ));
+      goto Exit;
+    }
+    BufferSize += ChunkSize;
+  }
+
+  Status = (Buffer != NULL) ? EFI_SUCCESS : EFI_NOT_FOUND;
+
+Exit:
+  FreePool( Name );
+
+  //
+  // If we're returning an error, make sure
+  // the state is sane.
+  if (EFI_ERROR( Status ) && Buffer != NULL)
+  {
+    FreePool( Buffer );
+    Buffer      = NULL;
+    BufferSize  = 0;
+  }
+
+  *Data = Buffer;
+  *Size = BufferSize;
+  return Status;
+} // ReadChunkedVariable()
+
+
+/**
+  Determines whether a persistence cache already exists for
+  the given framework.
+
+  @param[in]  FrameworkHandle   A pointer to the framework that is being persisted.
+
+  @retval     TRUE
+  @retval     FALSE   Cache doesn't exist or an error occurred.
+
+**/
+BOOLEAN
+EFIAPI
+DoesCacheExist (
+  IN  UNIT_TEST_FRAMEWORK_HANDLE  FrameworkHandle
+  )
+{
+  EFI_STATUS    Status;
+  CHAR16        *Name;
+  UINTN         NameSize, DataSize;
+
+  Name = AllocateVariableName( FrameworkHandle, UNIT_TEST_CACHE_VARIABLE_SUFFIX, &NameSize );
+  if (Name == NULL)
+  {
+    return FALSE;
+  }
+
+  //
+  // If the first chunk is there, the cache is there.
+  UnicodeSPrint( Name, NameSize, UNIT_TEST_VARIABLE_INDEX_FORMAT,
+                 ((UNIT_TEST_FRAMEWORK*)FrameworkHandle)->ShortTitle, UNIT_TEST_CACHE_VARIABLE_SUFFIX, 0 );
+  DataSize = 0;
+  Status = gRT->GetVariable( Name, &gMsUnitTestPkgVariablePersistenceGuid, NULL, &DataSize, NULL );
+  FreePool( Name );
+
+  DEBUG(( DEBUG_VERBOSE, "%a - Returning %d\n", __FUNCTION__, (Status == EFI_BUFFER_TOO_SMALL) ));
+
+  return (Status == EFI_BUFFER_TOO_SMALL);
+} // DoesCacheExist()
+
+
+/**
+  Will save the data associated with an internal Unit Test Framework
+  state in a manner that can persist a Unit Test Application quit or
+  even a system reboot.
+
+  @param[in]  FrameworkHandle   A pointer to the framework that is being persisted.
+  @param[in]  SaveData          A pointer to the buffer containing the serialized
+                                framework internal state.
+
+  @retval     EFI_SUCCESS   Data is persisted and the test can be safely quit.
+  @retval     Others        Data is not persisted and test cannot be resumed upon exit.
+
+**/
+EFI_STATUS
+EFIAPI
+SaveUnitTestCache (
+  IN  UNIT_TEST_FRAMEWORK_HANDLE  FrameworkHandle,
+  IN  UNIT_TEST_SAVE_HEADER       *SaveData
+  )
+{
+  EFI_STATUS                Status;
+  UNIT_TEST_SAVE_HEADER     *Compressed, *Data;
+
+  //
+  // Check the inputs for sanity.
+  if (FrameworkHandle == NULL || SaveData == NULL)
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // Every byte saved here is a byte less of variable store, so compress if that helps.
+  Compressed  = CompressUnitTestSave( SaveData );
+  Data        = (Compressed != NULL) ? Compressed : SaveData;
+  Status      = WriteChunkedVariable( FrameworkHandle, UNIT_TEST_CACHE_VARIABLE_SUFFIX, Data, Data->BlobSize );
+  if (Compressed != NULL)
+  {
+    FreePool( Compressed );
+  }
+
+  return Status;
+} // SaveUnitTestCache()
+
+
+/**
+  Will add a save to the end of the existing cache. SaveData only carries the
+  tests that have changed since the last save. Only used once the cache holds
+  a complete save from SaveUnitTestCache() or LoadUnitTestCache().
+
+  Variables can't be appended to without the platform supporting
+  EFI_VARIABLE_APPEND_WRITE for them, so this lib always saves the whole cache.
+
+  @param[in]  FrameworkHandle   A pointer to the framework that is being persisted.
+  @param[in]  SaveData          A pointer to the buffer containing the changes.
+
+  @retval     EFI_SUCCESS       Data is persisted and the test can be safely quit.
+  @retval     EFI_UNSUPPORTED   The cache can only be saved whole. Use SaveUnitTestCache().
+  @retval     Others            Data is not persisted and test cannot be resumed upon exit.
+
+**/
+EFI_STATUS
+EFIAPI
+AppendUnitTestCache (
+  IN  UNIT_TEST_FRAMEWORK_HANDLE  FrameworkHandle,
+  IN  UNIT_TEST_SAVE_HEADER       *SaveData
+  )
+{
+  return EFI_UNSUPPORTED;
+} // AppendUnitTestCache()
+
+
+/**
+  Will retrieve any cached state associated with the given framework.
+  Will allocate a buffer to hold the loaded data.
+
+  @param[in]  FrameworkHandle   A pointer to the framework that is being persisted.
+  @param[in]  SaveData          A pointer pointer that will be updated with the address
+                                of the loaded data buffer.
+
+  @retval     EFI_SUCCESS       Data has been loaded successfully and SaveData is updated
+                                with a pointer to the buffer. If the cache held more than
+                                one save, they have been merged.
+  @retval     Others            An error has occurred and no data has been loaded. SaveData
+                                is set to NULL.
+
+**/
+EFI_STATUS
+EFIAPI
+LoadUnitTestCache (
+  IN  UNIT_TEST_FRAMEWORK_HANDLE  FrameworkHandle,
+  OUT UNIT_TEST_SAVE_HEADER       **SaveData
+  )
+{
+  EFI_STATUS              Status;
+  UINTN                   DataSize;
+  UNIT_TEST_SAVE_HEADER   *Expanded;
+
+  //
+  // Check the inputs for sanity.
+  if (FrameworkHandle == NULL || SaveData == NULL)
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Status = ReadChunkedVariable( FrameworkHandle, UNIT_TEST_CACHE_VARIABLE_SUFFIX, (VOID**)SaveData, &DataSize );
+  if (EFI_ERROR( Status ))
+  {
+    return Status;
+  }
+
+  //
+  // Only ever one save, since there's no appending, but make sure all of it made it.
+  if (DataSize < sizeof( UNIT_TEST_SAVE_HEADER ) || DataSize < (*SaveData)->BlobSize)
+  {
+    DEBUG(( DEBUG_ERROR, "%a - Cache is truncated.\n", __FUNCTION__ ));
+    FreePool( *SaveData );
+    *SaveData = NULL;
+    return EFI_VOLUME_CORRUPTED;
+  }
+
+  //
+  // The framework only deals in expanded saves.
+  Status = ExpandUnitTestSave( *SaveData, &Expanded );
+  if (EFI_ERROR( Status ))
+  {
+    FreePool( *SaveData );
+    *SaveData = NULL;
+    return Status;
+  }
+  if (Expanded != *SaveData)
+  {
+    FreePool( *SaveData );
+    *SaveData = Expanded;
+  }
+
+  return EFI_SUCCESS;
+} // LoadUnitTestCache()
+
+
+/**
+  Will save the performance baseline for the given framework. Unlike the
+  cache, the baseline is meant to stay around from one run to the next.
+
+  @param[in]  FrameworkHandle   A pointer to the framework that the baseline belongs to.
+  @param[in]  Baseline          A pointer to the serialized baseline.
+
+  @retval     EFI_SUCCESS   The baseline is persisted.
+  @retval     Others        The baseline is not persisted.
+
+**/
+EFI_STATUS
+EFIAPI
+SaveUnitTestBaseline (
+  IN  UNIT_TEST_FRAMEWORK_HANDLE  FrameworkHandle,
+  IN  UNIT_TEST_BASELINE_HEADER   *Baseline
+  )
+{
+  if (FrameworkHandle == NULL || Baseline == NULL)
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  return WriteChunkedVariable( FrameworkHandle, UNIT_TEST_BASELINE_VARIABLE_SUFFIX, Baseline, Baseline->BlobSize );
+} // SaveUnitTestBaseline()
+
+
+/**
+  Will retrieve the performance baseline for the given framework, if there is one.
+  Will allocate a buffer to hold the loaded data.
+
+  @param[in]  FrameworkHandle   A pointer to the framework that the baseline belongs to.
+  @param[in]  Baseline          A pointer pointer that will be updated with the address
+                                of the loaded data buffer.
+
+  @retval     EFI_SUCCESS       The baseline has been loaded and Baseline is updated with
+                                a pointer to the buffer. At least BlobSize bytes were read.
+  @retval     Others            There is no baseline or it couldn't be loaded. Baseline is
+                                set to NULL.
+
+**/
+EFI_STATUS
+EFIAPI
+LoadUnitTestBaseline (
+  IN  UNIT_TEST_FRAMEWORK_HANDLE  FrameworkHandle,
+  OUT UNIT_TEST_BASELINE_HEADER   **Baseline
+  )
+{
+  EFI_STATUS    Status;
+  UINTN         DataSize;
+
+  if (FrameworkHandle == NULL || Baseline == NULL)
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Status = ReadChunkedVariable( FrameworkHandle, UNIT_TEST_BASELINE_VARIABLE_SUFFIX, (VOID**)Baseline, &DataSize );
+  if (EFI_ERROR( Status ))
+  {
+    return Status;
+  }
+
+  if (DataSize < sizeof( UNIT_TEST_BASELINE_HEADER ) || DataSize < (*Baseline)->BlobSize)
+  {
+    DEBUG(( DEBUG_ERROR, "%a - Baseline is truncated.\n", __FUNCTION__ ));
+    FreePool( *Baseline );
+    *Baseline = NULL;
+    return EFI_VOLUME_CORRUPTED;
+  }
+
+  return EFI_SUCCESS;
+} // LoadUnitTestBaseline()
+
+
+/**
+  Lets go of anything the persistence lib has been holding on to for the
+  given framework between calls. Called when the framework is freed.
+
+  @param[in]  FrameworkHandle   A pointer to the framework that is being persisted.
+
+**/
+VOID
+EFIAPI
+CloseUnitTestPersistence (
+  IN  UNIT_TEST_FRAMEWORK_HANDLE  FrameworkHandle
+  )
+{
+  // Nothing is kept open between calls.
+  return;
+} // CloseUnitTestPersistence()
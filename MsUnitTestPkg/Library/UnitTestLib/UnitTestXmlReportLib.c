@@ -0,0 +1,446 @@
+/** @file -- UnitTestXmlReportLib.c
+Writes the results of a unit test run as JUnit XML, next to the test app.
+This needs the shell, which is why it isn't part of UnitTestLib.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+
+Copyright (C) 2016 Microsoft Corporation. All Rights Reserved.
+
+**/
+
+#include <Uefi.h>
+#include <Library/UnitTestLib.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PrintLib.h>
+#include <Library/ShellLib.h>
+#include <Library/UnitTestFilePathLib.h>
+#include <Library/UnitTestXmlReportLib.h>
+
+//
+// The report is rendered as UTF-8 into one large buffer that only goes out to
+// the file when it fills up, so a typical report takes a handful of writes.
+// If the buffer can't be had, a small one on the stack does the same job in more writes.
+//
+#define UNIT_TEST_XML_BUFFER_SIZE           (32 * 1024)
+#define UNIT_TEST_XML_FALLBACK_BUFFER_SIZE  (1024)
+
+//
+// Markup is formatted straight into the buffer, so this much room is made first.
+// Nothing that comes from a test goes through the formatter; that's all escaped
+// and written by XmlWriteText(). The longest escape ("&quot;") is 6 bytes.
+//
+#define UNIT_TEST_XML_MAX_MARKUP_LENGTH     (256)
+#define UNIT_TEST_XML_MAX_CHARACTER_LENGTH  (6)
+
+typedef struct
+{
+  SHELL_FILE_HANDLE   File;
+  CHAR8               *Buffer;
+  UINTN               Length;           // Number of bytes in use.
+  UINTN               Size;             // Number of bytes available, not counting room for a NULL.
+  EFI_STATUS          Status;           // First error from writing the file, if any.
+} UNIT_TEST_XML_WRITER;
+
+
+/**
+  Writes everything in the buffer to the file and empties it.
+  Once a write fails, the writer stops trying and remembers the error.
+
+**/
+STATIC
+EFI_STATUS
+XmlFlush (
+  IN OUT UNIT_TEST_XML_WRITER   *Writer
+  )
+{
+  UINTN     WriteSize;
+
+  if (Writer->Length > 0 && !EFI_ERROR( Writer->Status ))
+  {
+    WriteSize = Writer->Length;
+    Writer->Status = ShellWriteFile( Writer->File, &WriteSize, Writer->Buffer );
+    if (!EFI_ERROR( Writer->Status ) && WriteSize != Writer->Length)
+    {
+      Writer->Status = EFI_VOLUME_FULL;
+    }
+  }
+  Writer->Length = 0;
+
+  return Writer->Status;
+} // XmlFlush()
+
+
+/**
+  Formats markup straight into the tail of the buffer. Only for the report's
+  own markup and numbers; see UNIT_TEST_XML_MAX_MARKUP_LENGTH.
+
+**/
+STATIC
+VOID
+XmlPrint (
+  IN OUT UNIT_TEST_XML_WRITER   *Writer,
+  IN CONST CHAR8                *Format,
+  ...
+  )
+{
+  VA_LIST   Marker;
+
+  if (Writer->Size - Writer->Length < UNIT_TEST_XML_MAX_MARKUP_LENGTH)
+  {
+    XmlFlush( Writer );
+  }
+
+  VA_START( Marker, Format );
+  Writer->Length += AsciiVSPrint( &Writer->Buffer[Writer->Length],
+                                  Writer->Size - Writer->Length + 1,
+                                  Format,
+                                  Marker );
+  VA_END( Marker );
+
+  return;
+} // XmlPrint()
+
+
+/**
+  Writes Length characters of text, converted to UTF-8, with the XML special
+  characters replaced by entities. Control characters that XML 1.0 can't
+  carry at all are replaced with '?'. UCS-2 never needs more than 3 bytes
+  per character.
+
+**/
+STATIC
+VOID
+XmlWriteText (
+  IN OUT UNIT_TEST_XML_WRITER   *Writer,
+  IN CONST CHAR16               *String,
+  IN UINTN                      Length
+  )
+{
+  UINTN           Index;
+  CHAR16          Char;
+  CONST CHAR8     *Entity;
+  CHAR8           *Out;
+
+  for (Index = 0; Index < Length; Index++)
+  {
+    if (Writer->Size - Writer->Length < UNIT_TEST_XML_MAX_CHARACTER_LENGTH)
+    {
+      XmlFlush( Writer );
+    }
+
+    Char = String[Index];
+    switch (Char)
+    {
+      case L'&':    Entity = "&amp;";   break;
+      case L'<':    Entity = "&lt;";    break;
+      case L'>':    Entity = "&gt;";    break;
+      case L'"':    Entity = "&quot;";  break;
+      case L'\t':   // Fall through...
+      case L'\n':   // Fall through...
+      case L'\r':   Entity = NULL;      break;
+      default:      Entity = (Char < L' ') ? "?" : NULL; break;
+    }
+
+    Out = &Writer->Buffer[Writer->Length];
+    if (Entity != NULL)
+    {
+      while (*Entity != '\0')
+      {
+        *Out++ = *Entity++;
+      }
+    }
+    else if (Char < 0x80)
+    {
+      *Out++ = (CHAR8)Char;
+    }
+    else if (Char < 0x800)
+    {
+      *Out++ = (CHAR8)(0xC0 | (Char >> 6));
+      *Out++ = (CHAR8)(0x80 | (Char & 0x3F));
+    }
+    else
+    {
+      *Out++ = (CHAR8)(0xE0 | (Char >> 12));
+      *Out++ = (CHAR8)(0x80 | ((Char >> 6) & 0x3F));
+      *Out++ = (CHAR8)(0x80 | (Char & 0x3F));
+    }
+    Writer->Length = Out - Writer->Buffer;
+  }
+
+  return;
+} // XmlWriteText()
+
+
+/**
+  Writes ' Name="Value"', escaping Value.
+
+**/
+STATIC
+VOID
+XmlPrintAttribute (
+  IN OUT UNIT_TEST_XML_WRITER   *Writer,
+  IN CONST CHAR8                *Name,
+  IN CONST CHAR16               *Value
+  )
+{
+  XmlPrint( Writer, " %a=\"", Name );
+  XmlWriteText( Writer, Value, StrLen( Value ) );
+  XmlPrint( Writer, "\"" );
+  return;
+} // XmlPrintAttribute()
+
+
+/**
+  JUnit wants times in seconds. Millisecond precision is plenty.
+
+**/
+STATIC
+VOID
+XmlPrintDuration (
+  IN OUT UNIT_TEST_XML_WRITER   *Writer,
+  IN UINT64                     NanoSeconds
+  )
+{
+  UINT64    Seconds;
+  UINT32    MilliSeconds;
+
+  Seconds = DivU64x32Remainder( DivU64x32( NanoSeconds, 1000000 ), 1000, &MilliSeconds );
+  XmlPrint( Writer, " time=\"%ld.%03d\"", Seconds, MilliSeconds );
+  return;
+} // XmlPrintDuration()
+
+
+/**
+  Renders the results as JUnit XML. Each suite becomes a <testsuite> and each
+  test a <testcase>, with the test log in <system-out>.
+
+  Failed tests are <failure>s. Tests that were left running (the app died or
+  the system reset out from under them) are <error>s. Everything else that
+  didn't pass (pending, prereq not met or filtered out) is <skipped>.
+
+**/
+STATIC
+EFI_STATUS
+RenderXmlReport (
+  IN     UNIT_TEST_FRAMEWORK    *Framework,
+  IN OUT UNIT_TEST_XML_WRITER   *Writer
+  )
+{
+  UNIT_TEST_SUITE_LIST_ENTRY  *Suite;
+  UNIT_TEST_LIST_ENTRY        *Test;
+  UNIT_TEST_LOG_CHUNK         *LogChunk;
+  UINTN                       SuiteId;
+  UINTN                       Tests, Failures, Errors, Skipped;
+  UINT64                      Duration;
+  CONST CHAR8                 *ResultElement;
+
+  RenderDeferredUnitTestLogs( Framework );
+
+  XmlPrint( Writer, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n" );
+  XmlPrint( Writer, "<testsuites" );
+  XmlPrintAttribute( Writer, "name", Framework->Title );
+  XmlPrint( Writer, ">\n" );
+
+  SuiteId = 0;
+  for (Suite = (UNIT_TEST_SUITE_LIST_ENTRY*)GetFirstNode( &Framework->TestSuiteList );
+       (LIST_ENTRY*)Suite != &Framework->TestSuiteList;
+       Suite = (UNIT_TEST_SUITE_LIST_ENTRY*)GetNextNode( &Framework->TestSuiteList, (LIST_ENTRY*)Suite ))
+  {
+    //
+    // The counts are attributes of the <testsuite>, so take a quick pass first.
+    Tests = Failures = Errors = Skipped = 0;
+    Duration = Suite->UTS.SetupDuration + Suite->UTS.TeardownDuration;
+    for (Test = (UNIT_TEST_LIST_ENTRY*)GetFirstNode( &Suite->UTS.TestCaseList );
+         (LIST_ENTRY*)Test != &Suite->UTS.TestCaseList;
+         Test = (UNIT_TEST_LIST_ENTRY*)GetNextNode( &Suite->UTS.TestCaseList, (LIST_ENTRY*)Test ))
+    {
+      Tests++;
+      switch (Test->UT.Result)
+      {
+        case UNIT_TEST_PASSED:                break;
+        case UNIT_TEST_ERROR_TEST_FAILED:     // Fall through...
+        case UNIT_TEST_ERROR_PERF_REGRESSION: Failures++; break;
+        case UNIT_TEST_RUNNING:               Errors++; break;
+        default:                              Skipped++; break;
+      }
+      Duration += Test->UT.PreReqDuration + Test->UT.RunDuration + Test->UT.CleanUpDuration;
+    }
+
+    XmlPrint( Writer, "  <testsuite" );
+    XmlPrintAttribute( Writer, "name", Suite->UTS.Title );
+    XmlPrintAttribute( Writer, "package", Framework->ShortTitle );
+    XmlPrint( Writer, " id=\"%d\" tests=\"%d\" failures=\"%d\" errors=\"%d\" skipped=\"%d\"",
+              SuiteId, Tests, Failures, Errors, Skipped );
+    XmlPrintDuration( Writer, Duration );
+    XmlPrint( Writer, " timestamp=\"%04d-%02d-%02dT%02d:%02d:%02d\">\n",
+              Framework->StartTime.Year, Framework->StartTime.Month, Framework->StartTime.Day,
+              Framework->StartTime.Hour, Framework->StartTime.Minute, Framework->StartTime.Second );
+    XmlPrint( Writer, "    <properties>\n      <property name=\"VersionString\"" );
+    XmlPrintAttribute( Writer, "value", Framework->VersionString );
+    XmlPrint( Writer, "/>\n    </properties>\n" );
+
+    for (Test = (UNIT_TEST_LIST_ENTRY*)GetFirstNode( &Suite->UTS.TestCaseList );
+         (LIST_ENTRY*)Test != &Suite->UTS.TestCaseList;
+         Test = (UNIT_TEST_LIST_ENTRY*)GetNextNode( &Suite->UTS.TestCaseList, (LIST_ENTRY*)Test ))
+    {
+      XmlPrint( Writer, "    <testcase" );
+      XmlPrintAttribute( Writer, "name", Test->UT.Description );
+      XmlPrintAttribute( Writer, "classname", Suite->UTS.Title );
+      XmlPrintDuration( Writer, Test->UT.PreReqDuration + Test->UT.RunDuration + Test->UT.CleanUpDuration );
+      XmlPrint( Writer, ">\n" );
+
+      switch (Test->UT.Result)
+      {
+        case UNIT_TEST_PASSED:                ResultElement = NULL; break;
+        case UNIT_TEST_ERROR_TEST_FAILED:     // Fall through...
+        case UNIT_TEST_ERROR_PERF_REGRESSION: ResultElement = "failure"; break;
+        case UNIT_TEST_RUNNING:               ResultElement = "error"; break;
+        default:                              ResultElement = "skipped"; break;
+      }
+      if (ResultElement != NULL)
+      {
+        XmlPrint( Writer, "      <%a message=\"%a\"/>\n", ResultElement, GetUnitTestStatusString( Test->UT.Result ) );
+      }
+
+      //
+      // Benchmark statistics go out as testcase properties, in picoseconds per call.
+      if (Test->UT.Benchmark != NULL && Test->UT.Benchmark->Samples > 0)
+      {
+        XmlPrint( Writer, "      <properties>\n" );
+        XmlPrint( Writer, "        <property name=\"Samples\" value=\"%d\"/>\n", Test->UT.Benchmark->Samples );
+        XmlPrint( Writer, "        <property name=\"OpsPerSample\" value=\"%d\"/>\n", Test->UT.Benchmark->OpsPerSample );
+        XmlPrint( Writer, "        <property name=\"MinPicoSecondsPerOp\" value=\"%ld\"/>\n", Test->UT.Benchmark->MinPicoSeconds );
+        XmlPrint( Writer, "        <property name=\"MedianPicoSecondsPerOp\" value=\"%ld\"/>\n", Test->UT.Benchmark->MedianPicoSeconds );
+        XmlPrint( Writer, "        <property name=\"P99PicoSecondsPerOp\" value=\"%ld\"/>\n", Test->UT.Benchmark->P99PicoSeconds );
+        XmlPrint( Writer, "        <property name=\"MaxPicoSecondsPerOp\" value=\"%ld\"/>\n", Test->UT.Benchmark->MaxPicoSeconds );
+        XmlPrint( Writer, "        <property name=\"MeanPicoSecondsPerOp\" value=\"%ld\"/>\n", Test->UT.Benchmark->MeanPicoSeconds );
+        XmlPrint( Writer, "      </properties>\n" );
+      }
+
+      //
+      // Logs can be any size, so they go out chunk by chunk.
+      if (Test->UT.Log.Head != NULL)
+      {
+        XmlPrint( Writer, "      <system-out>" );
+        for (LogChunk = Test->UT.Log.Head; LogChunk != NULL; LogChunk = LogChunk->Next)
+        {
+          XmlWriteText( Writer, LogChunk->Buffer, LogChunk->Length );
+        }
+        XmlPrint( Writer, "</system-out>\n" );
+      }
+
+      XmlPrint( Writer, "    </testcase>\n" );
+    }
+
+    XmlPrint( Writer, "  </testsuite>\n" );
+    SuiteId++;
+  }
+
+  XmlPrint( Writer, "</testsuites>\n" );
+
+  return XmlFlush( Writer );
+} // RenderXmlReport()
+
+
+/**
+  Writes the results as JUnit XML to "<ShortTitle>_JUnit.xml", in the same
+  directory as the test app. Any previous report is replaced.
+
+  The report is streamed through a fixed-size buffer, so memory use does not
+  depend on how much the tests have logged.
+
+**/
+EFI_STATUS
+EFIAPI
+SaveUnitTestXmlReport (
+  IN UNIT_TEST_FRAMEWORK  *Framework
+  )
+{
+  EFI_DEVICE_PATH_PROTOCOL    *FileDevicePath;
+  EFI_DEVICE_PATH_PROTOCOL    *DevicePath;
+  EFI_HANDLE                  FileDeviceHandle;
+  SHELL_FILE_HANDLE           FileHandle;
+  UNIT_TEST_XML_WRITER        Writer;
+  CHAR8                       FallbackBuffer[UNIT_TEST_XML_FALLBACK_BUFFER_SIZE];
+  EFI_STATUS                  Status;
+
+  if (Framework == NULL)
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  // NOTE: This devpath is allocated and must be freed.
+  FileDevicePath = GetUnitTestFileDevicePath( Framework, L"_JUnit.xml" );
+  if (FileDevicePath == NULL)
+  {
+    return EFI_NOT_FOUND;
+  }
+
+  //
+  // Opening a file that already exists won't truncate it,
+  // so get rid of any old report first.
+  // NOTE: ShellOpenFileByDevicePath() moves the device path pointer along, so hand it a copy.
+  DevicePath = FileDevicePath;
+  Status = ShellOpenFileByDevicePath( &DevicePath,
+                                      &FileDeviceHandle,
+                                      &FileHandle,
+                                      (EFI_FILE_MODE_READ | EFI_FILE_MODE_WRITE),
+                                      0 );
+  if (!EFI_ERROR( Status ))
+  {
+    ShellDeleteFile( &FileHandle );
+  }
+
+  DevicePath = FileDevicePath;
+  Status = ShellOpenFileByDevicePath( &DevicePath,
+                                      &FileDeviceHandle,
+                                      &FileHandle,
+                                      (EFI_FILE_MODE_READ | EFI_FILE_MODE_WRITE | EFI_FILE_MODE_CREATE),
+                                      0 );
+  if (EFI_ERROR( Status ))
+  {
+    DEBUG(( DEBUG_ERROR, "%a - Opening file for writing failed! %r\n", __FUNCTION__, Status ));
+    goto Exit;
+  }
+
+  ZeroMem( &Writer, sizeof( Writer ) );
+  Writer.File   = FileHandle;
+  Writer.Status = EFI_SUCCESS;
+  Writer.Buffer = AllocatePool( UNIT_TEST_XML_BUFFER_SIZE + 1 );
+  Writer.Size   = UNIT_TEST_XML_BUFFER_SIZE;
+  if (Writer.Buffer == NULL)
+  {
+    Writer.Buffer = FallbackBuffer;
+    Writer.Size   = sizeof( FallbackBuffer ) - 1;
+  }
+
+  Status = RenderXmlReport( Framework, &Writer );
+  if (EFI_ERROR( Status ))
+  {
+    DEBUG(( DEBUG_ERROR, "%a - Writing to file failed! %r\n", __FUNCTION__, Status ));
+  }
+
+  if (Writer.Buffer != FallbackBuffer)
+  {
+    FreePool( Writer.Buffer );
+  }
+  ShellCloseFile( &FileHandle );
+
+Exit:
+  FreePool( FileDevicePath );
+
+  return Status;
+} // SaveUnitTestXmlReport()
@@ -1,230 +1,252 @@
-/** @file -- SampleUnitTestApp.c
-This is a sample EFI Shell application to demostrate the usage of the Unit Test Library.
-
-THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
-AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
-IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
-ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
-LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
-CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
-SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
-INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
-CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
-ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
-THE POSSIBILITY OF SUCH DAMAGE.
-
-Copyright (C) 2016 Microsoft Corporation. All Rights Reserved.
-
-**/
-
-#include <Uefi.h>
-#include <Library/UefiLib.h>
-#include <Library/DebugLib.h>
-#include <Library/UnitTestLib.h>
-
-
-#define UNIT_TEST_APP_NAME        L"Sample Unit Test Library Application"
-#define UNIT_TEST_APP_SHORT_NAME  L"Sample_Unit_Test_Lib_App"
-#define UNIT_TEST_APP_VERSION     L"0.1"
-
-
-BOOLEAN       mSampleGlobalTestBoolean = FALSE;
-VOID          *mSampleGlobalTestPointer = NULL;
-
-
-///================================================================================================
-///================================================================================================
-///
-/// HELPER FUNCTIONS
-///
-///================================================================================================
-///================================================================================================
-
-
-//
-// Anything you think might be helpful that isn't a test itself.
-//
-
-UNIT_TEST_STATUS
-EFIAPI
-MakeSureThatPointerIsNull (
-  IN UNIT_TEST_FRAMEWORK_HANDLE  Framework,
-  IN UNIT_TEST_CONTEXT           Context
-  )
-{
-  return (mSampleGlobalTestPointer == NULL) ?
-         UNIT_TEST_PASSED :
-         UNIT_TEST_ERROR_TEST_FAILED;
-} 
-
-
-VOID
-EFIAPI
-ClearThePointer (
-  IN UNIT_TEST_FRAMEWORK_HANDLE  Framework
-  )
-{
-  mSampleGlobalTestPointer = NULL;
-  return;
-} 
-
-
-///================================================================================================
-///================================================================================================
-///
-/// TEST CASES
-///
-///================================================================================================
-///================================================================================================
-
-
-UNIT_TEST_STATUS
-EFIAPI
-OnePlusOneShouldEqualTwo (
-  IN UNIT_TEST_FRAMEWORK_HANDLE  Framework,
-  IN UNIT_TEST_CONTEXT           Context
-  )
-{
-  UINTN     A, B, C;
-
-  A = 1;
-  B = 1;
-  C = A + B;
-
-  return (C == 2) ?
-         UNIT_TEST_PASSED :
-         UNIT_TEST_ERROR_TEST_FAILED;
-} // OnePlusOneShouldEqualTwo()
-
-
-UNIT_TEST_STATUS
-EFIAPI
-GlobalBooleanShouldBeChangeable (
-  IN UNIT_TEST_FRAMEWORK_HANDLE  Framework,
-  IN UNIT_TEST_CONTEXT           Context
-  )
-{
-  UNIT_TEST_STATUS    Status = UNIT_TEST_PASSED;
-
-  mSampleGlobalTestBoolean = TRUE;
-  if (mSampleGlobalTestBoolean != TRUE)
-  {
-    Status = UNIT_TEST_ERROR_TEST_FAILED;
-  }
-
-  mSampleGlobalTestBoolean = FALSE;
-  if (mSampleGlobalTestBoolean != FALSE)
-  {
-    Status = UNIT_TEST_ERROR_TEST_FAILED;
-  }
-
-  return Status;
-} // GlobalBooleanShouldBeChangeable()
-
-
-UNIT_TEST_STATUS
-EFIAPI
-GlobalPointerShouldBeChangeable (
-  IN UNIT_TEST_FRAMEWORK_HANDLE  Framework,
-  IN UNIT_TEST_CONTEXT           Context
-  )
-{
-  UNIT_TEST_STATUS        Status = UNIT_TEST_PASSED;
-
-  mSampleGlobalTestPointer = (VOID*)-1;
-  if (mSampleGlobalTestPointer != (VOID*)-1)
-  {
-    Status = UNIT_TEST_ERROR_TEST_FAILED;
-  }
-
-  return Status;
-} // GlobalPointerShouldBeChangeable()
-
-
-///================================================================================================
-///================================================================================================
-///
-/// TEST ENGINE
-///
-///================================================================================================
-///================================================================================================
-
-
-/** 
-  SampleUnitTestApp
-  
-  @param[in] ImageHandle  The firmware allocated handle for the EFI image.
-  @param[in] SystemTable  A pointer to the EFI System Table.
-
-  @retval EFI_SUCCESS     The entry point executed successfully.
-  @retval other           Some error occured when executing this entry point.
-
-**/
-EFI_STATUS
-EFIAPI
-SampleUnitTestApp (
-  IN EFI_HANDLE        ImageHandle,
-  IN EFI_SYSTEM_TABLE  *SystemTable
-  )
-{
-  EFI_STATUS                Status;
-  UNIT_TEST_FRAMEWORK       *Fw = NULL;
-  UNIT_TEST_SUITE           *SimpleMathTests, *GlobalVarTests;
-  BOOLEAN                   TestsRun = FALSE;
-
-  DEBUG(( DEBUG_INFO, "%s v%s\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION ));
-
-  //
-  // Start setting up the test framework for running the tests.
-  //
-  Status = InitUnitTestFramework( &Fw, UNIT_TEST_APP_NAME, UNIT_TEST_APP_SHORT_NAME, UNIT_TEST_APP_VERSION );
-  if (EFI_ERROR( Status ))
-  {
-    DEBUG((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
-    goto EXIT;
-  }
-
-  //
-  // Populate the SimpleMathTests Unit Test Suite.
-  //
-  Status = CreateUnitTestSuite( &SimpleMathTests, Fw, L"Simple Math Tests", NULL, NULL );
-  if (EFI_ERROR( Status ))
-  {
-    DEBUG((DEBUG_ERROR, "Failed in CreateUnitTestSuite for SimpleMathTests\n"));
-    Status = EFI_OUT_OF_RESOURCES;
-    goto EXIT;
-  }
-  AddTestCase( SimpleMathTests, L"Adding 1 to 1 should produce 2", OnePlusOneShouldEqualTwo, NULL, NULL, NULL );
-
-  //
-  // Populate the GlobalVarTests Unit Test Suite.
-  //
-  Status = CreateUnitTestSuite( &GlobalVarTests, Fw, L"Global Variable Tests", NULL, NULL );
-  if (EFI_ERROR( Status ))
-  {
-    DEBUG((DEBUG_ERROR, "Failed in CreateUnitTestSuite for GlobalVarTests\n"));
-    Status = EFI_OUT_OF_RESOURCES;
-    goto EXIT;
-  }
-  AddTestCase( GlobalVarTests, L"You should be able to change a global BOOLEAN", GlobalBooleanShouldBeChangeable, NULL, NULL, NULL );
-  AddTestCase( GlobalVarTests, L"You should be able to change a global pointer", GlobalPointerShouldBeChangeable, MakeSureThatPointerIsNull, ClearThePointer, NULL );
-
-  //
-  // Execute the tests.
-  //
-  TestsRun = TRUE;
-  Status = RunAllTestSuites( Fw );
-
-EXIT:
-  if (TestsRun)
-  {
-    PrintUnitTestReport( Fw );
-  }
-
-  if (Fw)
-  {
-    FreeUnitTestFramework( Fw );
-  }
-
-  return Status;
+/** @file -- SampleUnitTestApp.c
+This is a sample EFI Shell application to demostrate the usage of the Unit Test Library.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+
+Copyright (C) 2016 Microsoft Corporation. All Rights Reserved.
+
+**/
+
+#include <Uefi.h>
+#include <Library/UefiLib.h>
+#include <Library/DebugLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/UnitTestLib.h>
+#include <Library/UnitTestXmlReportLib.h>
+
+
+#define UNIT_TEST_APP_NAME        L"Sample Unit Test Library Application"
+#define UNIT_TEST_APP_SHORT_NAME  L"Sample_Unit_Test_Lib_App"
+#define UNIT_TEST_APP_VERSION     L"0.1"
+
+
+BOOLEAN       mSampleGlobalTestBoolean = FALSE;
+VOID          *mSampleGlobalTestPointer = NULL;
+UINT8         mSampleGlobalTestBuffer[64] = { 0xDE, 0xAD, 0xBE, 0xEF };
+
+
+///================================================================================================
+///================================================================================================
+///
+/// HELPER FUNCTIONS
+///
+///================================================================================================
+///================================================================================================
+
+
+//
+// Anything you think might be helpful that isn't a test itself.
+//
+
+UNIT_TEST_STATUS
+EFIAPI
+MakeSureThatPointerIsNull (
+  IN UNIT_TEST_FRAMEWORK_HANDLE  Framework,
+  IN UNIT_TEST_CONTEXT           Context
+  )
+{
+  return (mSampleGlobalTestPointer == NULL) ?
+         UNIT_TEST_PASSED :
+         UNIT_TEST_ERROR_TEST_FAILED;
+} 
+
+
+VOID
+EFIAPI
+ClearThePointer (
+  IN UNIT_TEST_FRAMEWORK_HANDLE  Framework
+  )
+{
+  mSampleGlobalTestPointer = NULL;
+  return;
+} 
+
+
+///================================================================================================
+///================================================================================================
+///
+/// TEST CASES
+///
+///================================================================================================
+///================================================================================================
+
+
+UNIT_TEST_STATUS
+EFIAPI
+OnePlusOneShouldEqualTwo (
+  IN UNIT_TEST_FRAMEWORK_HANDLE  Framework,
+  IN UNIT_TEST_CONTEXT           Context
+  )
+{
+  UINTN     A, B, C;
+
+  A = 1;
+  B = 1;
+  C = A + B;
+
+  return (C == 2) ?
+         UNIT_TEST_PASSED :
+         UNIT_TEST_ERROR_TEST_FAILED;
+} // OnePlusOneShouldEqualTwo()
+
+
+UNIT_TEST_STATUS
+EFIAPI
+GlobalBooleanShouldBeChangeable (
+  IN UNIT_TEST_FRAMEWORK_HANDLE  Framework,
+  IN UNIT_TEST_CONTEXT           Context
+  )
+{
+  UNIT_TEST_STATUS    Status = UNIT_TEST_PASSED;
+
+  mSampleGlobalTestBoolean = TRUE;
+  if (mSampleGlobalTestBoolean != TRUE)
+  {
+    Status = UNIT_TEST_ERROR_TEST_FAILED;
+  }
+
+  mSampleGlobalTestBoolean = FALSE;
+  if (mSampleGlobalTestBoolean != FALSE)
+  {
+    Status = UNIT_TEST_ERROR_TEST_FAILED;
+  }
+
+  return Status;
+} // GlobalBooleanShouldBeChangeable()
+
+
+UNIT_TEST_STATUS
+EFIAPI
+GlobalPointerShouldBeChangeable (
+  IN UNIT_TEST_FRAMEWORK_HANDLE  Framework,
+  IN UNIT_TEST_CONTEXT           Context
+  )
+{
+  UNIT_TEST_STATUS        Status = UNIT_TEST_PASSED;
+
+  mSampleGlobalTestPointer = (VOID*)-1;
+  if (mSampleGlobalTestPointer != (VOID*)-1)
+  {
+    Status = UNIT_TEST_ERROR_TEST_FAILED;
+  }
+
+  return Status;
+} // GlobalPointerShouldBeChangeable()
+
+
+UNIT_TEST_STATUS
+EFIAPI
+GlobalBufferShouldBeCopyable (
+  IN UNIT_TEST_FRAMEWORK_HANDLE  Framework,
+  IN UNIT_TEST_CONTEXT           Context
+  )
+{
+  UINT8     Copy[sizeof( mSampleGlobalTestBuffer )];
+
+  CopyMem( &Copy[0], &mSampleGlobalTestBuffer[0], sizeof( Copy ) );
+
+  return UT_ASSERT_MEM_EQUAL( &Copy[0], &mSampleGlobalTestBuffer[0], sizeof( Copy ) ) ?
+         UNIT_TEST_PASSED :
+         UNIT_TEST_ERROR_TEST_FAILED;
+} // GlobalBufferShouldBeCopyable()
+
+
+///================================================================================================
+///================================================================================================
+///
+/// TEST ENGINE
+///
+///================================================================================================
+///================================================================================================
+
+
+/** 
+  SampleUnitTestApp
+  
+  @param[in] ImageHandle  The firmware allocated handle for the EFI image.
+  @param[in] SystemTable  A pointer to the EFI System Table.
+
+  @retval EFI_SUCCESS     The entry point executed successfully.
+  @retval other           Some error occured when executing this entry point.
+
+**/
+EFI_STATUS
+EFIAPI
+SampleUnitTestApp (
+  IN EFI_HANDLE        ImageHandle,
+  IN EFI_SYSTEM_TABLE  *SystemTable
+  )
+{
+  EFI_STATUS                Status;
+  UNIT_TEST_FRAMEWORK       *Fw = NULL;
+  UNIT_TEST_SUITE           *SimpleMathTests, *GlobalVarTests;
+  BOOLEAN                   TestsRun = FALSE;
+
+  DEBUG(( DEBUG_INFO, "%s v%s\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION ));
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework( &Fw, UNIT_TEST_APP_NAME, UNIT_TEST_APP_SHORT_NAME, UNIT_TEST_APP_VERSION );
+  if (EFI_ERROR( Status ))
+  {
+    DEBUG((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  //
+  // Populate the SimpleMathTests Unit Test Suite.
+  //
+  Status = CreateUnitTestSuite( &SimpleMathTests, Fw, L"Simple Math Tests", NULL, NULL );
+  if (EFI_ERROR( Status ))
+  {
+    DEBUG((DEBUG_ERROR, "Failed in CreateUnitTestSuite for SimpleMathTests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+  AddTestCase( SimpleMathTests, L"Adding 1 to 1 should produce 2", OnePlusOneShouldEqualTwo, NULL, NULL, NULL );
+
+  //
+  // Populate the GlobalVarTests Unit Test Suite.
+  //
+  Status = CreateUnitTestSuite( &GlobalVarTests, Fw, L"Global Variable Tests", NULL, NULL );
+  if (EFI_ERROR( Status ))
+  {
+    DEBUG((DEBUG_ERROR, "Failed in CreateUnitTestSuite for GlobalVarTests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+  AddTestCase( GlobalVarTests, L"You should be able to change a global BOOLEAN", GlobalBooleanShouldBeChangeable, NULL, NULL, NULL );
+  AddTestCase( GlobalVarTests, L"You should be able to change a global pointer", GlobalPointerShouldBeChangeable, MakeSureThatPointerIsNull, ClearThePointer, NULL );
+  AddTestCase( GlobalVarTests, L"You should be able to copy a global buffer", GlobalBufferShouldBeCopyable, NULL, NULL, NULL );
+
+  //
+  // Execute the tests.
+  //
+  TestsRun = TRUE;
+  Status = RunAllTestSuites( Fw );
+
+EXIT:
+  if (TestsRun)
+  {
+    PrintUnitTestReport( Fw );
+    SaveUnitTestXmlReport( Fw );
+  }
+
+  if (Fw)
+  {
+    FreeUnitTestFramework( Fw );
+  }
+
+  return Status;
 }
\ No newline at end of file
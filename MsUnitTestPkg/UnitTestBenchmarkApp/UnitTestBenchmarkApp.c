@@ -0,0 +1,481 @@
+/** @file -- UnitTestBenchmarkApp.c
+Microbenchmarks for the Unit Test Library itself, so that changes to the
+framework's hot paths can be measured rather than guessed at.
+Results are written to the test logs.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+
+Copyright (C) 2016 Microsoft Corporation. All Rights Reserved.
+
+**/
+
+#include <Uefi.h>
+#include <Library/UefiLib.h>
+#include <Library/DebugLib.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/TimerLib.h>
+#include <Library/PrintLib.h>
+#include <Library/PcdLib.h>
+#include <Library/UefiRuntimeServicesTableLib.h>
+#include <Library/UnitTestLib.h>
+#include <Library/UnitTestXmlReportLib.h>
+
+
+#define UNIT_TEST_APP_NAME        L"Unit Test Library Benchmarks"
+#define UNIT_TEST_APP_SHORT_NAME  L"Unit_Test_Lib_Benchmarks"
+#define UNIT_TEST_APP_VERSION     L"0.1"
+
+#define BENCHMARK_ITERATIONS          (1000000)
+#define BENCHMARK_VALUE_COUNT         (256)     // Must be a power of two.
+#define BENCHMARK_TEST_CASES          (10000)
+#define BENCHMARK_DESCRIPTION_LENGTH  (80)
+#define BENCHMARK_SAMPLES             (1000)
+#define BENCHMARK_COPY_SIZE           (4 * 1024)
+#define BENCHMARK_VARIABLE_NAME       L"UnitTestBenchmarkVariable"
+
+
+//
+// Two copies of the same values. They're filled in at runtime so that the
+// compiler can't prove the comparisons always pass and throw them away.
+//
+UINTN         mValuesA[BENCHMARK_VALUE_COUNT];
+UINTN         mValuesB[BENCHMARK_VALUE_COUNT];
+EFI_STATUS    mStatuses[BENCHMARK_VALUE_COUNT];
+
+//
+// Buffers for the CopyMem benchmark, and a volatile variable for the GetVariable
+// benchmark. The variable only exists while the Microbenchmarks suite is running,
+// and only if the suite setup managed to create it.
+//
+UINT8         mCopySource[BENCHMARK_COPY_SIZE];
+UINT8         mCopyDestination[BENCHMARK_COPY_SIZE];
+EFI_GUID      mBenchmarkVariableGuid = { 0x5B1C6E9A, 0x2D47, 0x4F3B, { 0x8A, 0x61, 0x0C, 0x9E, 0x47, 0xD2, 0x3B, 0x15 } };
+UINT64        mBenchmarkVariableData = 0x0123456789ABCDEF;
+EFI_STATUS    mBenchmarkVariableStatus = EFI_NOT_READY;
+
+
+///================================================================================================
+///================================================================================================
+///
+/// HELPER FUNCTIONS
+///
+///================================================================================================
+///================================================================================================
+
+
+/**
+  Converts the distance between two performance counter values to nanoseconds,
+  taking into account counters that count down and counters that wrap.
+
+**/
+STATIC
+UINT64
+GetElapsedNanoSeconds (
+  IN  UINT64    StartTicks,
+  IN  UINT64    EndTicks
+  )
+{
+  UINT64    CounterStart, CounterEnd, Ticks;
+
+  GetPerformanceCounterProperties( &CounterStart, &CounterEnd );
+  if (CounterStart < CounterEnd)
+  {
+    Ticks = (EndTicks >= StartTicks) ? (EndTicks - StartTicks) :
+                                       ((CounterEnd - StartTicks) + (EndTicks - CounterStart));
+  }
+  else
+  {
+    Ticks = (StartTicks >= EndTicks) ? (StartTicks - EndTicks) :
+                                       ((StartTicks - CounterEnd) + (CounterStart - EndTicks));
+  }
+
+  return GetTimeInNanoSecond( Ticks );
+} // GetElapsedNanoSeconds()
+
+
+/**
+  Logs the average cost of one iteration, in nanoseconds to three decimal places.
+
+**/
+STATIC
+VOID
+LogIterationCost (
+  IN UNIT_TEST_FRAMEWORK_HANDLE   Framework,
+  IN CONST CHAR8                  *Label,
+  IN UINT64                       NanoSeconds
+  )
+{
+  UINT64    PicoSeconds;
+  UINT32    Fraction;
+
+  PicoSeconds = DivU64x32( MultU64x32( NanoSeconds, 1000 ), BENCHMARK_ITERATIONS );
+  PicoSeconds = DivU64x32Remainder( PicoSeconds, 1000, &Fraction );
+  UT_LOG_INFO( "%a%ld.%03d ns per assertion\n", Label, PicoSeconds, Fraction );
+  return;
+} // LogIterationCost()
+
+
+VOID
+EFIAPI
+FillBenchmarkValues (
+  IN UNIT_TEST_FRAMEWORK_HANDLE  Framework
+  )
+{
+  UINTN     Index;
+
+  for (Index = 0; Index < BENCHMARK_VALUE_COUNT; Index++)
+  {
+    mValuesA[Index]  = Index * 0x9E3779B9;
+    mValuesB[Index]  = mValuesA[Index];
+    mStatuses[Index] = EFI_SUCCESS;
+  }
+  return;
+} // FillBenchmarkValues()
+
+
+VOID
+EFIAPI
+CreateBenchmarkVariable (
+  IN UNIT_TEST_FRAMEWORK_HANDLE  Framework
+  )
+{
+  SetMem( mCopySource, sizeof( mCopySource ), 0xA5 );
+  mBenchmarkVariableStatus = gRT->SetVariable( BENCHMARK_VARIABLE_NAME,
+                                               &mBenchmarkVariableGuid,
+                                               EFI_VARIABLE_BOOTSERVICE_ACCESS | EFI_VARIABLE_RUNTIME_ACCESS,
+                                               sizeof( mBenchmarkVariableData ),
+                                               &mBenchmarkVariableData );
+  if (EFI_ERROR( mBenchmarkVariableStatus ))
+  {
+    DEBUG((DEBUG_ERROR, "%a - Failed to create the benchmark variable. Status = %r\n", __FUNCTION__, mBenchmarkVariableStatus));
+  }
+  return;
+} // CreateBenchmarkVariable()
+
+
+VOID
+EFIAPI
+DeleteBenchmarkVariable (
+  IN UNIT_TEST_FRAMEWORK_HANDLE  Framework
+  )
+{
+  if (!EFI_ERROR( mBenchmarkVariableStatus ))
+  {
+    gRT->SetVariable( BENCHMARK_VARIABLE_NAME, &mBenchmarkVariableGuid, 0, 0, NULL );
+  }
+  mBenchmarkVariableStatus = EFI_NOT_READY;
+  return;
+} // DeleteBenchmarkVariable()
+
+
+///================================================================================================
+///================================================================================================
+///
+/// TEST CASES
+///
+///================================================================================================
+///================================================================================================
+
+
+/**
+  Compares a passing UT_ASSERT_EQUAL with the bare comparison it wraps and
+  with a direct call to the out-of-line UnitTestAssertEqual(), which is what
+  every assertion used to cost.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+PassingAssertEqualShouldBeCheap (
+  IN UNIT_TEST_FRAMEWORK_HANDLE  Framework,
+  IN UNIT_TEST_CONTEXT           Context
+  )
+{
+  UINTN     Index;
+  UINTN     Passed;
+  UINT64    Start;
+
+  Passed = 0;
+  Start  = GetPerformanceCounter();
+  for (Index = 0; Index < BENCHMARK_ITERATIONS; Index++)
+  {
+    Passed += (mValuesA[Index & (BENCHMARK_VALUE_COUNT - 1)] == mValuesB[Index & (BENCHMARK_VALUE_COUNT - 1)]);
+  }
+  LogIterationCost( Framework, "Comparison only:      ", GetElapsedNanoSeconds( Start, GetPerformanceCounter() ) );
+
+  Start = GetPerformanceCounter();
+  for (Index = 0; Index < BENCHMARK_ITERATIONS; Index++)
+  {
+    Passed += UT_ASSERT_EQUAL( mValuesA[Index & (BENCHMARK_VALUE_COUNT - 1)], mValuesB[Index & (BENCHMARK_VALUE_COUNT - 1)] );
+  }
+  LogIterationCost( Framework, "UT_ASSERT_EQUAL:      ", GetElapsedNanoSeconds( Start, GetPerformanceCounter() ) );
+
+  Start = GetPerformanceCounter();
+  for (Index = 0; Index < BENCHMARK_ITERATIONS; Index++)
+  {
+    Passed += UnitTestAssertEqual( Framework,
+                                   mValuesA[Index & (BENCHMARK_VALUE_COUNT - 1)],
+                                   mValuesB[Index & (BENCHMARK_VALUE_COUNT - 1)],
+                                   __FUNCTION__, __LINE__, "mValuesA[Index]", "mValuesB[Index]" );
+  }
+  LogIterationCost( Framework, "UnitTestAssertEqual(): ", GetElapsedNanoSeconds( Start, GetPerformanceCounter() ) );
+
+  return (Passed == 3 * BENCHMARK_ITERATIONS) ? UNIT_TEST_PASSED : UNIT_TEST_ERROR_TEST_FAILED;
+} // PassingAssertEqualShouldBeCheap()
+
+
+UNIT_TEST_STATUS
+EFIAPI
+PassingAssertNotEfiErrorShouldBeCheap (
+  IN UNIT_TEST_FRAMEWORK_HANDLE  Framework,
+  IN UNIT_TEST_CONTEXT           Context
+  )
+{
+  UINTN     Index;
+  UINTN     Passed;
+  UINT64    Start;
+
+  Passed = 0;
+  Start  = GetPerformanceCounter();
+  for (Index = 0; Index < BENCHMARK_ITERATIONS; Index++)
+  {
+    Passed += UT_ASSERT_NOT_EFI_ERROR( mStatuses[Index & (BENCHMARK_VALUE_COUNT - 1)] );
+  }
+  LogIterationCost( Framework, "UT_ASSERT_NOT_EFI_ERROR:     ", GetElapsedNanoSeconds( Start, GetPerformanceCounter() ) );
+
+  Start = GetPerformanceCounter();
+  for (Index = 0; Index < BENCHMARK_ITERATIONS; Index++)
+  {
+    Passed += UnitTestAssertNotEfiError( Framework, mStatuses[Index & (BENCHMARK_VALUE_COUNT - 1)],
+                                         __FUNCTION__, __LINE__, "mStatuses[Index]" );
+  }
+  LogIterationCost( Framework, "UnitTestAssertNotEfiError(): ", GetElapsedNanoSeconds( Start, GetPerformanceCounter() ) );
+
+  return (Passed == 2 * BENCHMARK_ITERATIONS) ? UNIT_TEST_PASSED : UNIT_TEST_ERROR_TEST_FAILED;
+} // PassingAssertNotEfiErrorShouldBeCheap()
+
+
+/**
+  Registers BENCHMARK_TEST_CASES tests, with descriptions of a realistic length,
+  in a scratch framework. Registration time is dominated by fingerprinting, so
+  build with each PcdUnitTestFingerprintAlgorithm to compare them.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+RegisteringManyTestsShouldBeQuick (
+  IN UNIT_TEST_FRAMEWORK_HANDLE  Framework,
+  IN UNIT_TEST_CONTEXT           Context
+  )
+{
+  EFI_STATUS            Status;
+  UNIT_TEST_FRAMEWORK   *Scratch = NULL;
+  UNIT_TEST_SUITE       *Suite;
+  CHAR16                *Descriptions;
+  UINTN                 Index;
+  UINT64                Start, NanoSeconds;
+
+  //
+  // Build the descriptions up front so that only registration is timed.
+  Descriptions = AllocatePool( BENCHMARK_TEST_CASES * BENCHMARK_DESCRIPTION_LENGTH * sizeof( CHAR16 ) );
+  if (!UT_ASSERT_NOT_EQUAL( (UINTN)Descriptions, (UINTN)NULL ))
+  {
+    return UNIT_TEST_ERROR_TEST_FAILED;
+  }
+  for (Index = 0; Index < BENCHMARK_TEST_CASES; Index++)
+  {
+    UnicodeSPrint( &Descriptions[Index * BENCHMARK_DESCRIPTION_LENGTH], BENCHMARK_DESCRIPTION_LENGTH * sizeof( CHAR16 ),
+                   L"Scratch test %d should be registered with its own fingerprint", Index );
+  }
+
+  Start  = GetPerformanceCounter();
+  Status = InitUnitTestFramework( &Scratch, L"Registration Benchmark Scratch Framework", L"Registration_Scratch", UNIT_TEST_APP_VERSION );
+  if (!EFI_ERROR( Status ))
+  {
+    Status = CreateUnitTestSuite( &Suite, Scratch, L"Scratch Suite", NULL, NULL );
+  }
+  for (Index = 0; Index < BENCHMARK_TEST_CASES && !EFI_ERROR( Status ); Index++)
+  {
+    Status = AddTestCase( Suite, &Descriptions[Index * BENCHMARK_DESCRIPTION_LENGTH], PassingAssertEqualShouldBeCheap, NULL, NULL, NULL );
+  }
+  NanoSeconds = GetElapsedNanoSeconds( Start, GetPerformanceCounter() );
+
+  FreePool( Descriptions );
+  if (Scratch != NULL)
+  {
+    FreeUnitTestFramework( Scratch );
+  }
+  if (!UT_ASSERT_NOT_EFI_ERROR( Status ))
+  {
+    return UNIT_TEST_ERROR_TEST_FAILED;
+  }
+
+  UT_LOG_INFO( "Fingerprint algorithm %d: %d tests registered in %ld us\n",
+               FixedPcdGet8( PcdUnitTestFingerprintAlgorithm ), BENCHMARK_TEST_CASES, DivU64x32( NanoSeconds, 1000 ) );
+  return UNIT_TEST_PASSED;
+} // RegisteringManyTestsShouldBeQuick()
+
+
+/**
+  The benchmark functions below are called once per operation by the framework,
+  which does the timing. See AddBenchmarkCase().
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+CopyMemBenchmark (
+  IN UNIT_TEST_FRAMEWORK_HANDLE  Framework,
+  IN UNIT_TEST_CONTEXT           Context
+  )
+{
+  CopyMem( mCopyDestination, mCopySource, BENCHMARK_COPY_SIZE );
+  return UNIT_TEST_PASSED;
+} // CopyMemBenchmark()
+
+
+UNIT_TEST_STATUS
+EFIAPI
+GetVariableBenchmark (
+  IN UNIT_TEST_FRAMEWORK_HANDLE  Framework,
+  IN UNIT_TEST_CONTEXT           Context
+  )
+{
+  EFI_STATUS    Status;
+  UINT64        Data;
+  UINTN         DataSize;
+
+  //
+  // Nothing to time if the suite setup couldn't create the variable.
+  //
+  if (EFI_ERROR( mBenchmarkVariableStatus ))
+  {
+    return UNIT_TEST_ERROR_PREREQ_NOT_MET;
+  }
+
+  DataSize = sizeof( Data );
+  Status   = gRT->GetVariable( BENCHMARK_VARIABLE_NAME, &mBenchmarkVariableGuid, NULL, &DataSize, &Data );
+  if (!UT_ASSERT_NOT_EFI_ERROR( Status ))
+  {
+    return UNIT_TEST_ERROR_TEST_FAILED;
+  }
+  if (!UT_ASSERT_EQUAL( Data, mBenchmarkVariableData ))
+  {
+    return UNIT_TEST_ERROR_TEST_FAILED;
+  }
+
+  return UNIT_TEST_PASSED;
+} // GetVariableBenchmark()
+
+
+///================================================================================================
+///================================================================================================
+///
+/// TEST ENGINE
+///
+///================================================================================================
+///================================================================================================
+
+
+/**
+  UnitTestBenchmarkApp
+
+  @param[in] ImageHandle  The firmware allocated handle for the EFI image.
+  @param[in] SystemTable  A pointer to the EFI System Table.
+
+  @retval EFI_SUCCESS     The entry point executed successfully.
+  @retval other           Some error occured when executing this entry point.
+
+**/
+EFI_STATUS
+EFIAPI
+UnitTestBenchmarkApp (
+  IN EFI_HANDLE        ImageHandle,
+  IN EFI_SYSTEM_TABLE  *SystemTable
+  )
+{
+  EFI_STATUS                Status;
+  UNIT_TEST_FRAMEWORK       *Fw = NULL;
+  UNIT_TEST_SUITE           *AssertionTests, *RegistrationTests, *Microbenchmarks;
+  BOOLEAN                   TestsRun = FALSE;
+
+  DEBUG(( DEBUG_INFO, "%s v%s\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION ));
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework( &Fw, UNIT_TEST_APP_NAME, UNIT_TEST_APP_SHORT_NAME, UNIT_TEST_APP_VERSION );
+  if (EFI_ERROR( Status ))
+  {
+    DEBUG((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  //
+  // Populate the AssertionTests Unit Test Suite.
+  //
+  Status = CreateUnitTestSuite( &AssertionTests, Fw, L"Assertion Overhead", FillBenchmarkValues, NULL );
+  if (EFI_ERROR( Status ))
+  {
+    DEBUG((DEBUG_ERROR, "Failed in CreateUnitTestSuite for AssertionTests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+  AddTestCase( AssertionTests, L"A passing UT_ASSERT_EQUAL should cost about as much as the comparison", PassingAssertEqualShouldBeCheap, NULL, NULL, NULL );
+  AddTestCase( AssertionTests, L"A passing UT_ASSERT_NOT_EFI_ERROR should not call out of line", PassingAssertNotEfiErrorShouldBeCheap, NULL, NULL, NULL );
+
+  //
+  // Populate the RegistrationTests Unit Test Suite.
+  //
+  Status = CreateUnitTestSuite( &RegistrationTests, Fw, L"Registration Overhead", NULL, NULL );
+  if (EFI_ERROR( Status ))
+  {
+    DEBUG((DEBUG_ERROR, "Failed in CreateUnitTestSuite for RegistrationTests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+  AddTestCase( RegistrationTests, L"Registering 10000 tests should be quick", RegisteringManyTestsShouldBeQuick, NULL, NULL, NULL );
+
+  //
+  // Populate the Microbenchmarks Unit Test Suite.
+  //
+  Status = CreateUnitTestSuite( &Microbenchmarks, Fw, L"Microbenchmarks", CreateBenchmarkVariable, DeleteBenchmarkVariable );
+  if (EFI_ERROR( Status ))
+  {
+    DEBUG((DEBUG_ERROR, "Failed in CreateUnitTestSuite for Microbenchmarks\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+  AddBenchmarkCase( Microbenchmarks, L"CopyMem of 4 KiB", CopyMemBenchmark, NULL, BENCHMARK_SAMPLES );
+  AddBenchmarkCase( Microbenchmarks, L"GetVariable of an 8-byte volatile variable", GetVariableBenchmark, NULL, BENCHMARK_SAMPLES );
+
+  //
+  // Execute the tests.
+  //
+  TestsRun = TRUE;
+  Status = RunAllTestSuites( Fw );
+
+EXIT:
+  if (TestsRun)
+  {
+    PrintUnitTestReport( Fw );
+    SaveUnitTestXmlReport( Fw );
+  }
+
+  if (Fw)
+  {
+    FreeUnitTestFramework( Fw );
+  }
+
+  return Status;
+}